@@ -1,6 +1,7 @@
 #include "Sprite.h"
 #include "SpriteCommon.h"
 #include "TextureManager.h"
+#include <cstring>
 
 using namespace Math;
 
@@ -8,63 +9,92 @@ void Sprite::Initialize(SpriteCommon* spriteCommon, std::string textureFilePath)
 	// 引数をメンバ変数にセット
 	this->spriteCommon_ = spriteCommon;
 
-	// Sprite用のリソースを作る
-	vertexResource = spriteCommon_->GetDirectXCommon()->CreateBufferResource(sizeof(VertexData) * 4);
+	// transformの初期化
+	transform = { {1.0f,1.0f,1.0f},{0.0f,0.0f,0.0f} ,{0.0f,0.0f,0.0f} };
 
-	// Indexの頂点リソース
-	indexResource = spriteCommon_->GetDirectXCommon()->CreateBufferResource(sizeof(uint32_t) * 6);
+	// 初期サイズを小さくする
+	size = { 64.0f, 64.0f };   // ← 好きなサイズ
 
-	// Vertexバッファビュー設定
-	vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
-	vertexBufferView.SizeInBytes = UINT(sizeof(VertexData) * 4);
-	vertexBufferView.StrideInBytes = sizeof(VertexData);
+	// テクスチャの読み込みとテクスチャインデックスの取得（読み込み済みなら引くだけ）
+	textureIndex = TextureManager::GetInstance()->LoadTexture(textureFilePath);
 
-	// Indexバッファビュー設定
-	indexBufferView.BufferLocation = indexResource->GetGPUVirtualAddress();
-	indexBufferView.SizeInBytes = sizeof(uint32_t) * 6;
-	indexBufferView.Format = DXGI_FORMAT_R32_UINT;
+	// テクスチャサイズを取得してスプライトサイズに反映
+	AbjustSizeToTexture();
+}
 
-	// マテリアルリソースを作成する
-	materialResource = spriteCommon_->GetDirectXCommon()->CreateBufferResource(sizeof(Material));
+Sprite::~Sprite() {
+	if (individualSlot != SpriteCommon::kInvalidSlot) {
+		spriteCommon_->ReleaseIndividualSlot(individualSlot);
+	}
+}
 
-	// マテリアルリソースにデータを書き込む為のアドレスを取得
-	materialResource->Map(0, nullptr, reinterpret_cast<void**>(&materialData));
+void Sprite::Update() {
 
-	// マテリアルデータの初期化
-	materialData->color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
-	materialData->enableLighting = false; // スプライトにライティングは不要
-	materialData->uvTranseform = makeIdentity4x4();
+	// 描画方式が変わったら全部作り直す
+	if (lastDrawMode != spriteCommon_->GetDrawMode()) {
+		lastDrawMode = spriteCommon_->GetDrawMode();
+		dirtyFlags = kDirtyAll;
+	}
 
-	// 座標変換リソースを作れる
-	transformationMatrixResource = spriteCommon_->GetDirectXCommon()->CreateBufferResource(sizeof(TransfomationMatrix));
+	// 変更がなければ何もしない
+	if (dirtyFlags == 0) {
+		return;
+	}
 
-	// 座標変換リソースにデータを書き込む為のアドレスを取得してtransformationMatrixDataにセット
-	transformationMatrixResource->Map(0, nullptr, reinterpret_cast<void**>(&transeformationMatrixData));
+	// 個別描画の領域はどのフレームコンテキストの分も書き直す
+	uploadedFrameMask = 0;
 
-	// 単位行列を書き込む
-	transeformationMatrixData->WVP = makeIdentity4x4();
-	transeformationMatrixData->World = makeIdentity4x4();
+	// 頂点の再計算
+	if (dirtyFlags & kDirtyVertex) {
+		UpdateVertices();
+	}
 
-	// transformの初期化
-	transform = { {1.0f,1.0f,1.0f},{0.0f,0.0f,0.0f} ,{0.0f,0.0f,0.0f} };
+	// 座標変換の再計算
+	if (dirtyFlags & kDirtyTransform) {
+		/// ============= 諸々の処理 =================
+		transform.translate = { position.x,position.y,0.0f };
 
-	// 初期サイズを小さくする
-	size = { 64.0f, 64.0f };   // ← 好きなサイズ
+		transform.rotate = { 0.0f,0.0f,rotation };
 
-	//
-	TextureManager::GetInstance()->LoadTexture(textureFilePath);
+		// サイズ反映
+		transform.scale = { size.x,size.y,1.0f };
 
-	// テクスチャの読み込みとテクスチャインデックスの取得
-	textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(textureFilePath);
+		// スプライト用のレンダリングパイプライン（ビューは単位行列なので省略）
+		worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+		wvpMatrix = Multiply(worldMatrix, spriteCommon_->GetProjectionMatrix());
+	}
 
-	// テクスチャサイズを取得してスプライトサイズに反映
-	AbjustSizeToTexture();
-}
+	switch (spriteCommon_->GetDrawMode()) {
+	case SpriteCommon::DrawMode::kIndividual:
+		// 個別描画のときはDrawで、まだ書き込んでいないフレームコンテキストの領域にだけ書き込む
+		break;
+
+	case SpriteCommon::DrawMode::kBatch:
+		// バッチ描画のときは頂点を座標変換しておく（色はDrawで渡す）
+		if (dirtyFlags & (kDirtyVertex | kDirtyTransform)) {
+			for (uint32_t i = 0; i < 4; ++i) {
+				Vector3 position = MakeTransform(wvpMatrix, { vertices[i].position.x,vertices[i].position.y,vertices[i].position.z });
+				batchVertices[i].position = { position.x,position.y,position.z,1.0f };
+				batchVertices[i].texcoord = vertices[i].texcoord;
+				batchVertices[i].nomal = vertices[i].nomal;
+			}
+		}
+		break;
+
+	case SpriteCommon::DrawMode::kInstanced:
+		// インスタンス描画のときはインスタンスデータに詰める
+		instanceData = SpriteInstancer::Pack(
+			wvpMatrix, color, uvRect, anchorPoint, isFlipX, isFlipY);
+		break;
+	}
 
-void Sprite::Update() {
+	// 再計算したスプライトとして数える
+	spriteCommon_->CountRecomputedSprite();
 
-	// 頂点リソースにデータを書き込む(4点分)
-	vertexResource->Map(0, nullptr, reinterpret_cast<void**>(&vertexData));
+	dirtyFlags = 0;
+}
+
+void Sprite::UpdateVertices() {
 
 	// アンカーポイントを考慮した頂点座標の計算
 	float left = 0.0f - anchorPoint.x;
@@ -93,79 +123,118 @@ void Sprite::Update() {
 	float tex_top = textureLeftTop.y / metadata.height;
 	float tex_right = (textureLeftTop.x + textureSize.x) / metadata.width;
 	float tex_bottom = (textureLeftTop.y + textureSize.y) / metadata.height;
+	uvRect = { tex_left,tex_top,tex_right,tex_bottom };
 
 	/// 頂点データの設定
 	// 左下
-	vertexData[0].position = { left,bottom,0.0f,1.0f };
-	vertexData[0].texcoord = { tex_left,tex_bottom };
+	vertices[0].position = { left,bottom,0.0f,1.0f };
+	vertices[0].texcoord = { tex_left,tex_bottom };
 
 	// 上
-	vertexData[1].position = { left,top,0.0f,1.0f };
-	vertexData[1].texcoord = { tex_left,tex_top };
+	vertices[1].position = { left,top,0.0f,1.0f };
+	vertices[1].texcoord = { tex_left,tex_top };
 
 	// 右下
-	vertexData[2].position = { right,bottom,0.0f,1.0f };
-	vertexData[2].texcoord = { tex_right,tex_bottom };
+	vertices[2].position = { right,bottom,0.0f,1.0f };
+	vertices[2].texcoord = { tex_right,tex_bottom };
 
 	// 右上
-	vertexData[3].position = { right,top,0.0f,1.0f };
-	vertexData[3].texcoord = { tex_right,tex_top };
+	vertices[3].position = { right,top,0.0f,1.0f };
+	vertices[3].texcoord = { tex_right,tex_top };
 
 	// 法線
-	vertexData[0].nomal = { 0.0f,0.0f,1.0f };
-	vertexData[1].nomal = { 0.0f,0.0f,1.0f };
-	vertexData[2].nomal = { 0.0f,0.0f,1.0f };
-	vertexData[3].nomal = { 0.0f,0.0f,-1.0f };
+	vertices[0].nomal = { 0.0f,0.0f,1.0f };
+	vertices[1].nomal = { 0.0f,0.0f,1.0f };
+	vertices[2].nomal = { 0.0f,0.0f,1.0f };
+	vertices[3].nomal = { 0.0f,0.0f,-1.0f };
+}
 
-	// インデックスリソースにデータを書き込む
-	indexResource->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
-	indexData[0] = 0; indexData[1] = 1; indexData[2] = 2;
-	indexData[3] = 1; indexData[4] = 3; indexData[5] = 2;
+void Sprite::Draw() {
 
-	// 書き込む為のアドレスを取得
-	transformationMatrixResource->Map(0, nullptr, reinterpret_cast<void**>(&transeformationMatrixData));
+	// バッチ描画のときは登録だけする
+	if (spriteCommon_->GetDrawMode() == SpriteCommon::DrawMode::kBatch) {
+		spriteCommon_->SubmitSprite(textureIndex, color, batchVertices);
+		return;
+	}
 
-	// 単位行列を書き込む
-	transeformationMatrixData->World = makeIdentity4x4();
+	// インスタンス描画のときも登録だけする
+	if (spriteCommon_->GetDrawMode() == SpriteCommon::DrawMode::kInstanced) {
+		spriteCommon_->SubmitInstance(textureIndex, instanceData);
+		return;
+	}
 
-	/// ============= 諸々の処理 =================
-	transform.translate = { position.x,position.y,0.0f };
+	DirectXCommon* dxCommon = spriteCommon_->GetDirectXCommon();
 
-	transform.rotate = { 0.0f,0.0f,rotation };
+	// 頂点、マテリアル、座標変換を書き込む領域（一度借りたら破棄するまで使う）
+	if (individualSlot == SpriteCommon::kInvalidSlot) {
+		individualSlot = spriteCommon_->AcquireIndividualSlot();
+	}
 
-	// サイズ反映
-	transform.scale = { size.x,size.y,1.0f };
+	D3D12_GPU_VIRTUAL_ADDRESS address = 0;
+	SpriteCommon::IndividualSpriteData* data = nullptr;
+	bool needsUpload = true;
+	if (individualSlot != SpriteCommon::kInvalidSlot) {
+		// 今のフレームコンテキストの分に今の内容が書き込み済みなら、書き込まずにそのまま使う
+		uint32_t frameIndex = dxCommon->GetFrameContexts().GetCurrentIndex();
+		data = spriteCommon_->GetIndividualSlotData(individualSlot, frameIndex, &address);
+		needsUpload = (uploadedFrameMask & (1u << frameIndex)) == 0;
+		uploadedFrameMask |= 1u << frameIndex;
+	} else {
+		// 借りられなかったときは今のフレームのアップロード領域に毎フレーム書き込む
+		// 足りなければこのスプライトは描かない
+		data = dxCommon->AllocateUpload<SpriteCommon::IndividualSpriteData>(1, &address);
+		if (data == nullptr) {
+			spriteCommon_->CountDroppedSprite();
+			return;
+		}
+	}
 
-	// スプライト用のレンダリングパイプライン
-	Matrix4x4 worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
-	Matrix4x4 viewmatrixSprite = makeIdentity4x4();
-	Matrix4x4 projectionMatrixSprite = MakeOrthographicMatrix(0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight), 0.0f, 100.0f);
-	transeformationMatrixData->WVP = Multiply(Multiply(worldMatrix, viewmatrixSprite), projectionMatrixSprite);
-	transeformationMatrixData->World = worldMatrix;
-}
+	if (needsUpload) {
+		// 頂点を書き込む(4点分)
+		std::memcpy(data->vertices, vertices, sizeof(vertices));
 
-void Sprite::Draw() {
+		// マテリアルを書き込む
+		data->material.color = color;
+		data->material.enableLighting = false; // スプライトにライティングは不要
+		data->material.uvTranseform = makeIdentity4x4();
+
+		// 座標変換を書き込む
+		data->transformationMatrix.WVP = wvpMatrix;
+		data->transformationMatrix.World = worldMatrix;
+
+		spriteCommon_->CountUploadedSprite();
+	}
+
+	D3D12_GPU_VIRTUAL_ADDRESS vertexAddress = address + offsetof(SpriteCommon::IndividualSpriteData, vertices);
+	D3D12_GPU_VIRTUAL_ADDRESS materialAddress = address + offsetof(SpriteCommon::IndividualSpriteData, material);
+	D3D12_GPU_VIRTUAL_ADDRESS transformationMatrixAddress = address + offsetof(SpriteCommon::IndividualSpriteData, transformationMatrix);
+
+	// Vertexバッファビュー設定
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
+	vertexBufferView.BufferLocation = vertexAddress;
+	vertexBufferView.SizeInBytes = UINT(sizeof(vertices));
+	vertexBufferView.StrideInBytes = sizeof(VertexData);
 
 	// 頂点バッファをセット
-	spriteCommon_->GetDirectXCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
+	dxCommon->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
 
-	// インデックスバッファをセット
-	spriteCommon_->GetDirectXCommon()->GetCommandList()->IASetIndexBuffer(&indexBufferView);
+	// インデックスバッファをセット（全スプライトで共有）
+	dxCommon->GetCommandList()->IASetIndexBuffer(&spriteCommon_->GetQuadIndexBufferView());
 
 	// 形状の設定
-	spriteCommon_->GetDirectXCommon()->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	dxCommon->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	// スプライト用のマテリアルCBufferを設定
-	spriteCommon_->GetDirectXCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
+	dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialAddress);
 
 	// スプライト用のTransformationMatrixCBufferを設定
-	spriteCommon_->GetDirectXCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixResource->GetGPUVirtualAddress());
+	dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixAddress);
 
 	// スプライト用のSRVのDescriptorTableを設定
-	spriteCommon_->GetDirectXCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSRVHandleGPU(textureIndex));
+	dxCommon->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSRVHandleGPU(textureIndex));
 
 	// 描画コマンド
-	spriteCommon_->GetDirectXCommon()->GetCommandList()->DrawIndexedInstanced(6, 1, 0, 0, 0);
+	dxCommon->GetCommandList()->DrawIndexedInstanced(6, 1, 0, 0, 0);
 }
 
 void Sprite::AbjustSizeToTexture() {
@@ -179,4 +248,4 @@ void Sprite::AbjustSizeToTexture() {
 
 	// 画像サイズをテクスチャサイズに合わせる
 	size = textureSize;
-}
\ No newline at end of file
+}
@@ -3,12 +3,21 @@
 #include <d3d12.h>
 #include "mymath.h"
 #include <string>  
-
-class  SpriteCommon;
+#include "SpriteCommon.h"
+#include "ViewCulling.h"
 
 class Sprite {
 public:
 
+	Sprite() = default;
+
+	// 借りた個別描画の領域を返す
+	~Sprite();
+
+	// コピー禁止（借りた領域を二重に返さないように）
+	Sprite(const Sprite&) = delete;
+	Sprite& operator=(const Sprite&) = delete;
+
 	void Initialize(SpriteCommon* spriteCommon, std::string textureFilePath);
 
 	void Update();
@@ -17,93 +26,85 @@ public:
 
 	const Math::Vector2& GetPosition() { return position; }
 
-	void SetPosition(const Math::Vector2& pos) { this->position = pos; }
+	void SetPosition(const Math::Vector2& pos) {
+		if (position != pos) { position = pos; dirtyFlags |= kDirtyTransform; }
+	}
 
 	float GetRotation() { return rotation; }
-	void SetRotation(float rot) { this->rotation = rot; }
+	void SetRotation(float rot) {
+		if (rotation != rot) { rotation = rot; dirtyFlags |= kDirtyTransform; }
+	}
 
 	// 色変更
-	const Math::Vector4& GetColor() { return materialData->color; }
-	void SetColor(const Math::Vector4& color) { this->materialData->color = color; }
+	const Math::Vector4& GetColor() { return color; }
+	void SetColor(const Math::Vector4& color) {
+		if (this->color != color) { this->color = color; dirtyFlags |= kDirtyColor; }
+	}
 
 	// サイズ変更
 	const Math::Vector2& GetSize()const { return size; }
-	void SetSize(const Math::Vector2& size) { this->size = size; }
+	void SetSize(const Math::Vector2& size) {
+		if (this->size != size) { this->size = size; dirtyFlags |= kDirtyTransform; }
+	}
 
 	// アンカーのゲッター
 	const Math::Vector2& GetAnchorPoint() const { return anchorPoint; }
 	// アンカーのセッター
-	void SetAnchorPoint(const Math::Vector2& anchor) { anchorPoint = anchor; }
+	void SetAnchorPoint(const Math::Vector2& anchor) {
+		if (anchorPoint != anchor) { anchorPoint = anchor; dirtyFlags |= kDirtyVertex; }
+	}
 
 	// 左右フリップのゲッター
 	bool GetFlipX() const { return isFlipX; }
 
 	// 左右フリップのセッター
-	void SetFlipX(bool flip) { isFlipX = flip; }
+	void SetFlipX(bool flip) {
+		if (isFlipX != flip) { isFlipX = flip; dirtyFlags |= kDirtyVertex; }
+	}
 
 	// 上下フリップのゲッター
 	bool GetFlipY() const { return isFlipY; }
 
 	// 上下フリップのセッター
-	void SetFlipY(bool flip) { isFlipY = flip; }
+	void SetFlipY(bool flip) {
+		if (isFlipY != flip) { isFlipY = flip; dirtyFlags |= kDirtyVertex; }
+	}
 
 	// テクスチャ切り出し左上座標のセッター
-	void SetTextureLeftTop(const Math::Vector2& leftTop) { textureLeftTop = leftTop; }
+	void SetTextureLeftTop(const Math::Vector2& leftTop) {
+		if (textureLeftTop != leftTop) { textureLeftTop = leftTop; dirtyFlags |= kDirtyVertex; }
+	}
 	// テクスチャ切り出しサイズのセッター
-	void SetTextureSize(const Math::Vector2& size) { textureSize = size; }
+	void SetTextureSize(const Math::Vector2& size) {
+		if (textureSize != size) { textureSize = size; dirtyFlags |= kDirtyVertex; }
+	}
 	// テクスチャ切り出し左上座標のゲッター
 	const Math::Vector2& GetTextureLeftTop() const { return textureLeftTop; }
 	// テクスチャ切り出しサイズのゲッター
 	const Math::Vector2& GetTextureSize() const { return textureSize; }
 
+	// 画面上で占める矩形（アンカー・サイズ・回転・フリップ込み。カリング用）
+	ViewCulling::Rect GetScreenRect() const {
+		return ViewCulling::MakeSpriteRect(position, size, rotation, anchorPoint, isFlipX, isFlipY);
+	}
+
 private:
 	SpriteCommon* spriteCommon_ = nullptr;
 
+	// 変更があった部分のビット
+	static const uint32_t kDirtyVertex = 1u << 0;    // 頂点（アンカー・フリップ・切り出し）
+	static const uint32_t kDirtyTransform = 1u << 1; // 座標変換（位置・回転・サイズ）
+	static const uint32_t kDirtyColor = 1u << 2;     // 色
+	static const uint32_t kDirtyAll = kDirtyVertex | kDirtyTransform | kDirtyColor;
+
 	// 頂点データ
-	struct VertexData {
-		Math::Vector4 position; // 頂点の位置
-		Math::Vector2 texcoord;
-		Math::Vector3 nomal;
-	};
+	using VertexData = SpriteCommon::VertexData;
 
 	// マテリアルデータ
-	struct Material {
-		Math::Vector4 color;
-		int32_t enableLighting;
-		float padding[3]; // パディングを追加して16バイト境界に揃える
-		Math::Matrix4x4 uvTranseform;
-	};
+	using Material = SpriteCommon::Material;
 
 	// 座標変換データ
-	struct TransfomationMatrix {
-		Math::Matrix4x4 WVP;
-		Math::Matrix4x4 World;
-	};
-
-	// Sprite用のリソースを作る
-	Microsoft::WRL::ComPtr <ID3D12Resource> vertexResource;
-	// Indexの頂点リソース
-	Microsoft::WRL::ComPtr <ID3D12Resource> indexResource;
-
-	// バッファリソース内のデータを指すポインタ
-	VertexData* vertexData = nullptr;
-	uint32_t* indexData = nullptr;
-
-	// バッファリソースの使い道を補足するバッファビュー
-	D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
-	D3D12_INDEX_BUFFER_VIEW indexBufferView;
-
-	// マテリアルのリソースを作成する
-	Microsoft::WRL::ComPtr <ID3D12Resource> materialResource;
-
-	// マテリアルのデータを作成する
-	Material* materialData = nullptr;
-
-	// TransformationMatrixのリソースを作成する
-	Microsoft::WRL::ComPtr <ID3D12Resource> transformationMatrixResource;
-
-	// バッファリソース内のデータを指すポインタ
-	TransfomationMatrix* transeformationMatrixData = nullptr;
+	using TransfomationMatrix = SpriteCommon::TransfomationMatrix;
 
 	// transformの初期化
 	Math::TransForm transform;
@@ -129,6 +130,40 @@ private:
 	// テクスチャ切り出しサイズ
 	Math::Vector2 textureSize = { 100.0f,100.0f };
 
+	// 色
+	Math::Vector4 color = { 1.0f,1.0f,1.0f,1.0f };
+
+	// 変更があった部分（最初は全部作る）
+	uint32_t dirtyFlags = kDirtyAll;
+
+	// 前回Updateしたときの描画方式
+	SpriteCommon::DrawMode lastDrawMode = SpriteCommon::DrawMode::kIndividual;
+
+	// 個別描画で持ち続ける領域の番号
+	uint32_t individualSlot = SpriteCommon::kInvalidSlot;
+
+	// 今の内容を書き込み済みのフレームコンテキスト（ビットごと。変更があったら全部書き直す）
+	uint32_t uploadedFrameMask = 0;
+
+	// 頂点（ローカル座標）
+	VertexData vertices[4] = {};
+
+	// テクスチャの切り出し範囲（左, 上, 右, 下）
+	Math::Vector4 uvRect = { 0.0f,0.0f,1.0f,1.0f };
+
+	// ワールド行列とWVP行列
+	Math::Matrix4x4 worldMatrix = {};
+	Math::Matrix4x4 wvpMatrix = {};
+
+	// バッチ描画用の座標変換済み頂点
+	VertexData batchVertices[4] = {};
+
+	// インスタンス描画用のデータ
+	SpriteInstancer::InstanceData instanceData{};
+
 	// テクスチャサイズをイメージに合わせる
 	void AbjustSizeToTexture();
+
+	// 頂点とテクスチャの切り出し範囲を作り直す
+	void UpdateVertices();
 };
\ No newline at end of file
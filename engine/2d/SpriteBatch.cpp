@@ -0,0 +1,63 @@
+#include "SpriteBatch.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace Math;
+
+void SpriteBatch::Begin() {
+	// 前のフレームの内容を破棄（容量は使い回す）
+	entries.clear();
+	order.clear();
+	vertices.clear();
+	runs.clear();
+}
+
+void SpriteBatch::Submit(uint32_t textureIndex, const Vector4& color, const VertexData* vertices) {
+	Entry& entry = entries.emplace_back();
+	entry.textureIndex = textureIndex;
+	entry.color = color;
+	std::copy(vertices, vertices + kVertexPerSprite, entry.vertices);
+}
+
+void SpriteBatch::End() {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// テクスチャ番号で並べ替える（同じテクスチャ内は登録順を保つ）
+	order.resize(entries.size());
+	for (uint32_t i = 0; i < order.size(); ++i) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(),
+		[this](uint32_t a, uint32_t b) {
+			return entries[a].textureIndex < entries[b].textureIndex;
+		});
+
+	// 並べた順に頂点を詰めて、テクスチャか色が変わるところで区切る
+	vertices.resize(entries.size() * kVertexPerSprite);
+	for (uint32_t i = 0; i < order.size(); ++i) {
+		const Entry& entry = entries[order[i]];
+		std::copy(entry.vertices, entry.vertices + kVertexPerSprite, &vertices[i * kVertexPerSprite]);
+
+		bool isNewRun = runs.empty() ||
+			runs.back().textureIndex != entry.textureIndex ||
+			runs.back().color.x != entry.color.x ||
+			runs.back().color.y != entry.color.y ||
+			runs.back().color.z != entry.color.z ||
+			runs.back().color.w != entry.color.w;
+
+		if (isNewRun) {
+			runs.push_back({ entry.textureIndex, entry.color, i * kIndexPerSprite, 0 });
+		}
+		runs.back().indexCount += kIndexPerSprite;
+	}
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	buildMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double SpriteBatch::GetSpritesPerMillisecond() const {
+	if (buildMilliseconds <= 0.0) {
+		return 0.0;
+	}
+	return static_cast<double>(entries.size()) / buildMilliseconds;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Mymath.h"
+
+// 複数のスプライトを一つの頂点列にまとめるクラス
+// GPUに依存しないので単体で計測できる
+class SpriteBatch {
+public:
+
+	// 頂点データ
+	struct VertexData {
+		Math::Vector4 position; // 頂点の位置
+		Math::Vector2 texcoord;
+		Math::Vector3 nomal;
+	};
+
+	// 同じテクスチャ・色で連続する描画範囲
+	struct Run {
+		uint32_t textureIndex;
+		Math::Vector4 color;
+		uint32_t indexStart;
+		uint32_t indexCount;
+	};
+
+	// 1スプライトあたりの頂点数とインデックス数
+	static const uint32_t kVertexPerSprite = 4;
+	static const uint32_t kIndexPerSprite = 6;
+
+	// 収集開始
+	void Begin();
+
+	// スプライトを追加（頂点は座標変換済みのもの）
+	void Submit(uint32_t textureIndex, const Math::Vector4& color, const VertexData* vertices);
+
+	// テクスチャ順に並べ替えて頂点列を作る
+	void End();
+
+	// 並べ替え済みの頂点列
+	const std::vector<VertexData>& GetVertices() const { return vertices; }
+
+	// 描画範囲のリスト
+	const std::vector<Run>& GetRuns() const { return runs; }
+
+	// 追加されたスプライト数
+	uint32_t GetSpriteCount() const { return static_cast<uint32_t>(entries.size()); }
+
+	// Endにかかった時間（ミリ秒）
+	double GetBuildMilliseconds() const { return buildMilliseconds; }
+
+	// 1ミリ秒あたりに処理できたスプライト数
+	double GetSpritesPerMillisecond() const;
+
+private:
+
+	// 追加されたスプライト一枚分
+	struct Entry {
+		uint32_t textureIndex;
+		Math::Vector4 color;
+		VertexData vertices[kVertexPerSprite];
+	};
+
+	// 追加されたスプライト
+	std::vector<Entry> entries;
+
+	// 並べ替え用の番号
+	std::vector<uint32_t> order;
+
+	// 出力する頂点列
+	std::vector<VertexData> vertices;
+
+	// 出力する描画範囲
+	std::vector<Run> runs;
+
+	// 計測時間
+	double buildMilliseconds = 0.0;
+};
@@ -1,12 +1,64 @@
 #include "SpriteCommon.h"
+#include "Logger.h"
+#include "TextureManager.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace Math;
+using namespace Logeer;
+
+// 定数バッファと頂点の配置が、それぞれの境界に揃っているか
+static_assert(offsetof(SpriteCommon::IndividualSpriteData, vertices) % UploadRingAllocator::kVertexAlignment == 0);
+static_assert(offsetof(SpriteCommon::IndividualSpriteData, transformationMatrix) % UploadRingAllocator::kDefaultAlignment == 0);
+static_assert(sizeof(SpriteCommon::IndividualSpriteData) % UploadRingAllocator::kDefaultAlignment == 0);
 
 void SpriteCommon::Initialize(DirectXCommon* dxCommon) {
 
 	// 引数をメンバ変数にセット
 	dxCommon_ = dxCommon;
 
+	// スプライト用の正射影行列
+	projectionMatrix = MakeOrthographicMatrix(0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight), 0.0f, 100.0f);
+
 	// グラフィックスパイプラインの作成
 	CreateGraphicsPipeline();
+
+	// バッチ用リソースの作成
+	CreateBatchResources();
+
+	// インスタンス描画用のパイプラインとリソースの作成
+	CreateInstancedGraphicsPipeline();
+	CreateInstancedResources();
+
+	// 個別描画のスプライトが持ち続ける領域
+	individualSpritePool = dxCommon_->CreateMappedBufferResource<IndividualSpriteData>(kMaxIndividualSprites * DirectXCommon::kFramesInFlight);
+	freeIndividualSlots.resize(kMaxIndividualSprites);
+	for (uint32_t i = 0; i < kMaxIndividualSprites; ++i) {
+		// 小さい番号から借りられるように後ろから積む
+		freeIndividualSlots[i] = kMaxIndividualSprites - 1 - i;
+	}
+}
+
+uint32_t SpriteCommon::AcquireIndividualSlot() {
+	if (freeIndividualSlots.empty()) {
+		return kInvalidSlot;
+	}
+	uint32_t slot = freeIndividualSlots.back();
+	freeIndividualSlots.pop_back();
+	return slot;
+}
+
+void SpriteCommon::ReleaseIndividualSlot(uint32_t slot) {
+	assert(slot < kMaxIndividualSprites);
+	freeIndividualSlots.push_back(slot);
+}
+
+SpriteCommon::IndividualSpriteData* SpriteCommon::GetIndividualSlotData(uint32_t slot, uint32_t frameIndex, D3D12_GPU_VIRTUAL_ADDRESS* gpuAddress) {
+	assert(slot < kMaxIndividualSprites && frameIndex < DirectXCommon::kFramesInFlight);
+	uint32_t index = frameIndex * kMaxIndividualSprites + slot;
+	*gpuAddress = individualSpritePool.GetGPUVirtualAddress() + sizeof(IndividualSpriteData) * index;
+	return &individualSpritePool[index];
 }
 
 void SpriteCommon::CreateRootSignature() {
@@ -152,4 +204,303 @@ void SpriteCommon::SetCommonDrawSetting() {
 
 	// プリミティブトポロジーを設定
 	dxCommon_->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// 再計算した数と書き込んだ数をフレームごとに区切る
+	lastRecomputedSpriteCount = recomputedSpriteCount;
+	recomputedSpriteCount = 0;
+	lastUploadedSpriteCount = uploadedSpriteCount;
+	uploadedSpriteCount = 0;
+	lastDroppedSpriteCount = droppedSpriteCount;
+	droppedSpriteCount = 0;
+
+	// バッチの収集開始
+	spriteBatch.Begin();
+	spriteInstancer.Begin();
+}
+
+void SpriteCommon::CountDroppedSprite(uint32_t count) {
+	droppedSpriteCount += count;
+	LOGEER_LOG(Level::kWarning, Category::kGraphics, "Sprite : upload allocation failed, {} sprites not drawn", count);
+}
+
+void SpriteCommon::SubmitSprite(uint32_t textureIndex, const Vector4& color, const VertexData* vertices) {
+	spriteBatch.Submit(textureIndex, color, vertices);
+}
+
+void SpriteCommon::SubmitInstance(uint32_t textureIndex, const SpriteInstancer::InstanceData& instance) {
+	spriteInstancer.Submit(textureIndex, instance);
+}
+
+void SpriteCommon::DrawBatch() {
+	switch (drawMode) {
+	case DrawMode::kBatch:
+		DrawSpriteBatch();
+		break;
+	case DrawMode::kInstanced:
+		DrawInstances();
+		break;
+	default:
+		break;
+	}
+}
+
+void SpriteCommon::DrawSpriteBatch() {
+
+	// テクスチャ順に並べ替えて頂点列を作る
+	spriteBatch.End();
+	batchDrawCallCount = 0;
+
+	if (spriteBatch.GetSpriteCount() == 0) {
+		return;
+	}
+
+	// 頂点をまとめて今のフレームのアップロード領域に書き込む
+	const std::vector<VertexData>& vertices = spriteBatch.GetVertices();
+	D3D12_GPU_VIRTUAL_ADDRESS vertexAddress = 0;
+	VertexData* vertexData = dxCommon_->AllocateUpload<VertexData>(vertices.size(), &vertexAddress, UploadRingAllocator::kVertexAlignment);
+	if (vertexData == nullptr) {
+		CountDroppedSprite(spriteBatch.GetSpriteCount());
+		return;
+	}
+	std::memcpy(vertexData, vertices.data(), sizeof(VertexData) * vertices.size());
+
+	// 座標変換済みの頂点は毎フレーム全部書き込む
+	CountUploadedSprite(spriteBatch.GetSpriteCount());
+
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
+	vertexBufferView.BufferLocation = vertexAddress;
+	vertexBufferView.SizeInBytes = UINT(sizeof(VertexData) * vertices.size());
+	vertexBufferView.StrideInBytes = sizeof(VertexData);
+
+	ID3D12GraphicsCommandList* commandList = dxCommon_->GetCommandList();
+
+	// 頂点バッファとインデックスバッファは一度だけセット
+	commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+	commandList->IASetIndexBuffer(&batchIndexBufferView);
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// 座標変換は単位行列
+	commandList->SetGraphicsRootConstantBufferView(1, batchTransformationMatrixResource->GetGPUVirtualAddress());
+
+	// 描画範囲ごとに描画する
+	// インデックスバッファはkMaxBatchSprites個分なので、その区切りをまたぐ範囲は分けて、
+	// 区切りごとに頂点の開始位置（BaseVertexLocation）をずらす
+	for (const SpriteBatch::Run& run : spriteBatch.GetRuns()) {
+
+		// 描画範囲ごとのマテリアル（256バイト境界で確保される）
+		D3D12_GPU_VIRTUAL_ADDRESS materialAddress = 0;
+		Material* material = dxCommon_->AllocateUpload<Material>(1, &materialAddress);
+		if (material == nullptr) {
+			continue;
+		}
+		material->color = run.color;
+		material->enableLighting = false;
+		material->uvTranseform = makeIdentity4x4();
+
+		commandList->SetGraphicsRootConstantBufferView(0, materialAddress);
+		commandList->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSRVHandleGPU(run.textureIndex));
+
+		uint32_t spriteStart = run.indexStart / SpriteBatch::kIndexPerSprite;
+		uint32_t spriteEnd = spriteStart + run.indexCount / SpriteBatch::kIndexPerSprite;
+		while (spriteStart < spriteEnd) {
+			uint32_t chunkStart = spriteStart - spriteStart % kMaxBatchSprites;
+			uint32_t chunkEnd = std::min<uint32_t>(spriteEnd, chunkStart + kMaxBatchSprites);
+			commandList->DrawIndexedInstanced((chunkEnd - spriteStart) * SpriteBatch::kIndexPerSprite, 1,
+				(spriteStart - chunkStart) * SpriteBatch::kIndexPerSprite,
+				static_cast<INT>(chunkStart * SpriteBatch::kVertexPerSprite), 0);
+			++batchDrawCallCount;
+			spriteStart = chunkEnd;
+		}
+	}
+}
+
+void SpriteCommon::CreateBatchResources() {
+
+	// 頂点とマテリアルは毎フレームDirectXCommonのアップロード領域から確保する
+	// インデックスは毎フレーム同じなので最初に全部書いておく
+	batchIndexResource = dxCommon_->CreateBufferResource(sizeof(uint32_t) * SpriteBatch::kIndexPerSprite * kMaxBatchSprites);
+	uint32_t* indexData = nullptr;
+	batchIndexResource->Map(0, nullptr, reinterpret_cast<void**>(&indexData));
+	for (uint32_t i = 0; i < kMaxBatchSprites; ++i) {
+		uint32_t base = i * SpriteBatch::kVertexPerSprite;
+		uint32_t* index = &indexData[i * SpriteBatch::kIndexPerSprite];
+		index[0] = base + 0; index[1] = base + 1; index[2] = base + 2;
+		index[3] = base + 1; index[4] = base + 3; index[5] = base + 2;
+	}
+	batchIndexResource->Unmap(0, nullptr);
+
+	batchIndexBufferView.BufferLocation = batchIndexResource->GetGPUVirtualAddress();
+	batchIndexBufferView.SizeInBytes = UINT(sizeof(uint32_t) * SpriteBatch::kIndexPerSprite * kMaxBatchSprites);
+	batchIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+
+	// 座標変換リソース
+	batchTransformationMatrixResource = dxCommon_->CreateBufferResource(sizeof(TransfomationMatrix));
+	TransfomationMatrix* transformationMatrixData = nullptr;
+	batchTransformationMatrixResource->Map(0, nullptr, reinterpret_cast<void**>(&transformationMatrixData));
+	transformationMatrixData->WVP = makeIdentity4x4();
+	transformationMatrixData->World = makeIdentity4x4();
+	batchTransformationMatrixResource->Unmap(0, nullptr);
+}
+
+void SpriteCommon::DrawInstances() {
+
+	// テクスチャ順に並べ替える
+	spriteInstancer.End();
+
+	if (spriteInstancer.GetInstanceCount() == 0) {
+		return;
+	}
+
+	// 今のフレームのアップロード領域に書き込む（GPUが読み終わるまで上書きされない）
+	const std::vector<SpriteInstancer::InstanceData>& instances = spriteInstancer.GetInstances();
+	D3D12_GPU_VIRTUAL_ADDRESS instanceAddress = 0;
+	SpriteInstancer::InstanceData* instanceData =
+		dxCommon_->AllocateUpload<SpriteInstancer::InstanceData>(instances.size(), &instanceAddress, UploadRingAllocator::kVertexAlignment);
+	if (instanceData == nullptr) {
+		CountDroppedSprite(spriteInstancer.GetInstanceCount());
+		return;
+	}
+	std::memcpy(instanceData, instances.data(), sizeof(SpriteInstancer::InstanceData) * instances.size());
+
+	// インスタンスも毎フレーム全部書き込む
+	CountUploadedSprite(spriteInstancer.GetInstanceCount());
+
+	ID3D12GraphicsCommandList* commandList = dxCommon_->GetCommandList();
+
+	// インスタンス描画用のパイプラインに切り替える
+	commandList->SetGraphicsRootSignature(instancedRootSignature.Get());
+	commandList->SetPipelineState(instancedGraphicsPipelineState.Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// 共有の四角形をセット
+	commandList->IASetVertexBuffers(0, 1, &quadVertexBufferView);
+	commandList->IASetIndexBuffer(&quadIndexBufferView);
+
+	// インスタンスデータをセット
+	commandList->SetGraphicsRootShaderResourceView(1, instanceAddress);
+
+	// テクスチャごとに一回だけ描画する
+	for (const SpriteInstancer::Run& run : spriteInstancer.GetRuns()) {
+		// SV_InstanceIDは0から始まるので開始位置をルート定数で渡す
+		commandList->SetGraphicsRoot32BitConstant(0, run.instanceStart, 0);
+		commandList->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSRVHandleGPU(run.textureIndex));
+		commandList->DrawIndexedInstanced(SpriteBatch::kIndexPerSprite, run.instanceCount, 0, 0, 0);
+	}
+
+	// 通常のパイプラインに戻す
+	commandList->SetGraphicsRootSignature(rootSignature.Get());
+	commandList->SetPipelineState(graphicsPipelineState.Get());
+}
+
+void SpriteCommon::CreateInstancedRootSignature() {
+
+	D3D12_ROOT_SIGNATURE_DESC description{};
+	description.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+	// テクスチャのDescriptorRange
+	D3D12_DESCRIPTOR_RANGE textureRange{};
+	textureRange.BaseShaderRegister = 0;
+	textureRange.NumDescriptors = 1;
+	textureRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	textureRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+	D3D12_ROOT_PARAMETER parameters[3] = {};
+
+	// インスタンスの開始位置（b0）
+	parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+	parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	parameters[0].Constants.ShaderRegister = 0;
+	parameters[0].Constants.Num32BitValues = 1;
+
+	// インスタンスデータ（t1）
+	parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+	parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	parameters[1].Descriptor.ShaderRegister = 1;
+
+	// テクスチャ（t0）
+	parameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	parameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	parameters[2].DescriptorTable.pDescriptorRanges = &textureRange;
+	parameters[2].DescriptorTable.NumDescriptorRanges = 1;
+
+	description.pParameters = parameters;
+	description.NumParameters = _countof(parameters);
+
+	// サンプラーは通常の描画と同じもの
+	description.pStaticSamplers = staticSamlers;
+	description.NumStaticSamplers = _countof(staticSamlers);
+
+	Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob;
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+
+	HRESULT hr = D3D12SerializeRootSignature(
+		&description,
+		D3D_ROOT_SIGNATURE_VERSION_1,
+		&signatureBlob,
+		&errorBlob
+	);
+	assert(SUCCEEDED(hr));
+
+	hr = dxCommon_->GetDevice()->CreateRootSignature(
+		0,
+		signatureBlob->GetBufferPointer(),
+		signatureBlob->GetBufferSize(),
+		IID_PPV_ARGS(&instancedRootSignature)
+	);
+	assert(SUCCEEDED(hr));
+}
+
+void SpriteCommon::CreateInstancedGraphicsPipeline() {
+
+	// RootSignature を作成
+	CreateInstancedRootSignature();
+
+	// Shader
+	Microsoft::WRL::ComPtr <IDxcBlob> vsBlob = dxCommon_->CompileShader(
+		L"resources/shaders/SpriteInstanced.VS.hlsl", L"vs_6_0");
+	Microsoft::WRL::ComPtr <IDxcBlob> psBlob = dxCommon_->CompileShader(
+		L"resources/shaders/SpriteInstanced.PS.hlsl", L"ps_6_0");
+	assert(vsBlob && psBlob);
+
+	// ブレンド・ラスタライザ・InputLayoutは通常の描画と同じ
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = graphicsPipelineStateDesc;
+	desc.pRootSignature = instancedRootSignature.Get();
+	desc.VS = { vsBlob->GetBufferPointer(), vsBlob->GetBufferSize() };
+	desc.PS = { psBlob->GetBufferPointer(), psBlob->GetBufferSize() };
+
+	HRESULT hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(
+		&desc,
+		IID_PPV_ARGS(&instancedGraphicsPipelineState));
+	assert(SUCCEEDED(hr));
+}
+
+void SpriteCommon::CreateInstancedResources() {
+
+	// 0~1の四角形（Spriteと同じ頂点順）
+	quadVertexResource = dxCommon_->CreateBufferResource(sizeof(VertexData) * SpriteBatch::kVertexPerSprite);
+	VertexData* quadVertexData = nullptr;
+	quadVertexResource->Map(0, nullptr, reinterpret_cast<void**>(&quadVertexData));
+	quadVertexData[0] = { { 0.0f,1.0f,0.0f,1.0f },{ 0.0f,1.0f },{ 0.0f,0.0f,-1.0f } }; // 左下
+	quadVertexData[1] = { { 0.0f,0.0f,0.0f,1.0f },{ 0.0f,0.0f },{ 0.0f,0.0f,-1.0f } }; // 左上
+	quadVertexData[2] = { { 1.0f,1.0f,0.0f,1.0f },{ 1.0f,1.0f },{ 0.0f,0.0f,-1.0f } }; // 右下
+	quadVertexData[3] = { { 1.0f,0.0f,0.0f,1.0f },{ 1.0f,0.0f },{ 0.0f,0.0f,-1.0f } }; // 右上
+	quadVertexResource->Unmap(0, nullptr);
+
+	quadVertexBufferView.BufferLocation = quadVertexResource->GetGPUVirtualAddress();
+	quadVertexBufferView.SizeInBytes = UINT(sizeof(VertexData) * SpriteBatch::kVertexPerSprite);
+	quadVertexBufferView.StrideInBytes = sizeof(VertexData);
+
+	// インデックス
+	quadIndexResource = dxCommon_->CreateBufferResource(sizeof(uint32_t) * SpriteBatch::kIndexPerSprite);
+	uint32_t* quadIndexData = nullptr;
+	quadIndexResource->Map(0, nullptr, reinterpret_cast<void**>(&quadIndexData));
+	quadIndexData[0] = 0; quadIndexData[1] = 1; quadIndexData[2] = 2;
+	quadIndexData[3] = 1; quadIndexData[4] = 3; quadIndexData[5] = 2;
+	quadIndexResource->Unmap(0, nullptr);
+
+	quadIndexBufferView.BufferLocation = quadIndexResource->GetGPUVirtualAddress();
+	quadIndexBufferView.SizeInBytes = sizeof(uint32_t) * SpriteBatch::kIndexPerSprite;
+	quadIndexBufferView.Format = DXGI_FORMAT_R32_UINT;
+
+	// インスタンスデータは毎フレームDirectXCommonのアップロード領域から確保する
 }
\ No newline at end of file
@@ -1,8 +1,58 @@
 #pragma once
+#include <cstddef>
+#include <vector>
 #include "DirectXCommon.h"
+#include "SpriteBatch.h"
+#include "SpriteInstancer.h"
 
 class SpriteCommon {
 public:
+
+	// 描画方式
+	enum class DrawMode {
+		kIndividual, // スプライトごとに描画
+		kBatch,      // 一つの頂点バッファにまとめて描画
+		kInstanced,  // 共有の四角形をインスタンス描画
+	};
+
+	// 頂点データ
+	using VertexData = SpriteBatch::VertexData;
+
+	// マテリアルデータ
+	struct Material {
+		Math::Vector4 color;
+		int32_t enableLighting;
+		float padding[3]; // パディングを追加して16バイト境界に揃える
+		Math::Matrix4x4 uvTranseform;
+	};
+
+	// 座標変換データ
+	struct TransfomationMatrix {
+		Math::Matrix4x4 WVP;
+		Math::Matrix4x4 World;
+	};
+
+	// 個別描画で1スプライト分をまとめて確保するデータ
+	// 定数バッファは256バイト境界に置くので、マテリアルの後ろの余りに頂点を入れる（1スプライト512バイト）
+	// 並べても境界がずれないように、全体も256バイトの倍数にする
+	struct IndividualSpriteData {
+		Material material;
+		VertexData vertices[4];
+		uint8_t padding[256 - sizeof(Material) - sizeof(VertexData) * 4];
+		TransfomationMatrix transformationMatrix;
+		uint8_t tailPadding[256 - sizeof(TransfomationMatrix)];
+	};
+
+	// 個別描画で領域を持ち続けられるスプライトの最大数（超えた分は毎フレームアップロード領域に書き込む）
+	static const uint32_t kMaxIndividualSprites = 4096;
+
+	// 領域を借りていないときの番号
+	static const uint32_t kInvalidSlot = UINT32_MAX;
+
+	// 一回の描画で使うスプライトの最大数（共有のインデックスバッファの大きさ）
+	// これより多いときは、この数ごとに頂点の開始位置をずらして描画する
+	static const uint32_t kMaxBatchSprites = 4096;
+
 	
 	void Initialize(DirectXCommon* dxCommon);
 	
@@ -10,6 +60,63 @@ public:
 	
 	// 共通描画設定
 	void SetCommonDrawSetting();
+
+	// バッチにスプライトを追加（頂点は座標変換済み）
+	void SubmitSprite(uint32_t textureIndex, const Math::Vector4& color, const VertexData* vertices);
+
+	// インスタンスを追加
+	void SubmitInstance(uint32_t textureIndex, const SpriteInstancer::InstanceData& instance);
+
+	// バッチにたまったスプライトを描画
+	void DrawBatch();
+
+	// 描画方式の取得・設定
+	DrawMode GetDrawMode() const { return drawMode; }
+	void SetDrawMode(DrawMode mode) { drawMode = mode; }
+
+	// バッチの取得（計測用）
+	const SpriteBatch& GetSpriteBatch() const { return spriteBatch; }
+
+	// 前のフレームのバッチ描画で発行した描画回数（描画範囲をkMaxBatchSpritesの区切りで分けた数）
+	uint32_t GetBatchDrawCallCount() const { return batchDrawCallCount; }
+
+	// インスタンサーの取得（計測用）
+	const SpriteInstancer& GetSpriteInstancer() const { return spriteInstancer; }
+
+	// 共有する四角形のインデックスバッファ（0,1,2,1,3,2）
+	const D3D12_INDEX_BUFFER_VIEW& GetQuadIndexBufferView() const { return quadIndexBufferView; }
+
+	// スプライト用の正射影行列
+	const Math::Matrix4x4& GetProjectionMatrix() const { return projectionMatrix; }
+
+	// 個別描画のスプライトが持ち続ける領域を借りる（足りなければkInvalidSlot）
+	uint32_t AcquireIndividualSlot();
+
+	// 借りた領域を返す
+	void ReleaseIndividualSlot(uint32_t slot);
+
+	// 借りた領域のうち、フレームコンテキストframeIndex用のデータ
+	// 前のフレームをGPUが読んでいる間も書き込めるように、フレームコンテキストごとに分けてある
+	IndividualSpriteData* GetIndividualSlotData(uint32_t slot, uint32_t frameIndex, D3D12_GPU_VIRTUAL_ADDRESS* gpuAddress);
+
+	// 再計算したスプライトを数える
+	void CountRecomputedSprite() { recomputedSpriteCount++; }
+
+	// 前のフレームで再計算したスプライト数
+	uint32_t GetRecomputedSpriteCount() const { return lastRecomputedSpriteCount; }
+
+	// GPUから見える領域に書き込んだスプライトを数える
+	void CountUploadedSprite(uint32_t count = 1) { uploadedSpriteCount += count; }
+
+	// 前のフレームで書き込んだスプライト数
+	uint32_t GetUploadedSpriteCount() const { return lastUploadedSpriteCount; }
+
+	// アップロード領域が確保できずに描画しなかったスプライトを数える（警告をログに出す）
+	void CountDroppedSprite(uint32_t count = 1);
+
+	// 前のフレームで描画しなかったスプライト数
+	uint32_t GetDroppedSpriteCount() const { return lastDroppedSpriteCount; }
+
 private:
 
 	DirectXCommon* dxCommon_;
@@ -46,9 +153,83 @@ private:
 	// DescriptorRange（SRV）
 	D3D12_DESCRIPTOR_RANGE descriptorRange{};
 
+	// スプライト用の正射影行列（画面サイズは変わらないので一度だけ作る）
+	Math::Matrix4x4 projectionMatrix = {};
+
+	// 今のフレームで再計算したスプライト数
+	uint32_t recomputedSpriteCount = 0;
+
+	// 前のフレームで再計算したスプライト数
+	uint32_t lastRecomputedSpriteCount = 0;
+
+	// 今のフレームと前のフレームで書き込んだスプライト数
+	uint32_t uploadedSpriteCount = 0;
+	uint32_t lastUploadedSpriteCount = 0;
+
+	// 今のフレームと前のフレームで描画しなかったスプライト数
+	uint32_t droppedSpriteCount = 0;
+	uint32_t lastDroppedSpriteCount = 0;
+
+	// 個別描画のスプライトが持ち続ける領域（[フレームコンテキスト][スロット]の順に並ぶ）
+	MappedBuffer<IndividualSpriteData> individualSpritePool;
+
+	// 空いているスロット
+	std::vector<uint32_t> freeIndividualSlots;
+
+	// 描画方式
+	DrawMode drawMode = DrawMode::kIndividual;
+
+	// スプライトバッチ
+	SpriteBatch spriteBatch;
+
+	// バッチ描画で発行した描画回数
+	uint32_t batchDrawCallCount = 0;
+
+	// バッチ用のインデックスリソース
+	Microsoft::WRL::ComPtr <ID3D12Resource> batchIndexResource;
+	D3D12_INDEX_BUFFER_VIEW batchIndexBufferView{};
+
+	// バッチ用の座標変換リソース（頂点は変換済みなので単位行列）
+	Microsoft::WRL::ComPtr <ID3D12Resource> batchTransformationMatrixResource;
+
+	// スプライトインスタンサー
+	SpriteInstancer spriteInstancer;
+
+	// インスタンス描画用のルートシグネチャー
+	Microsoft::WRL::ComPtr <ID3D12RootSignature> instancedRootSignature = nullptr;
+
+	// インスタンス描画用のPSO
+	Microsoft::WRL::ComPtr <ID3D12PipelineState> instancedGraphicsPipelineState = nullptr;
+
+	// 共有する四角形の頂点リソース
+	Microsoft::WRL::ComPtr <ID3D12Resource> quadVertexResource;
+	D3D12_VERTEX_BUFFER_VIEW quadVertexBufferView{};
+
+	// 共有する四角形のインデックスリソース
+	Microsoft::WRL::ComPtr <ID3D12Resource> quadIndexResource;
+	D3D12_INDEX_BUFFER_VIEW quadIndexBufferView{};
+
 	// ルートシグネチャーの作成
 	void CreateRootSignature();
 
 	// グラフィックスパイプラインの作成
 	void CreateGraphicsPipeline();
+
+	// バッチ用リソースの作成
+	void CreateBatchResources();
+
+	// インスタンス描画用のルートシグネチャーの作成
+	void CreateInstancedRootSignature();
+
+	// インスタンス描画用のグラフィックスパイプラインの作成
+	void CreateInstancedGraphicsPipeline();
+
+	// インスタンス描画用リソースの作成
+	void CreateInstancedResources();
+
+	// 頂点バッファにまとめたスプライトを描画
+	void DrawSpriteBatch();
+
+	// インスタンスをまとめて描画
+	void DrawInstances();
 };
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "SpriteInstancer.h"
+#include "SpriteBatch.h"
+#include <algorithm>
+
+using namespace Math;
+
+namespace {
+	// コミット済みバッファ1つあたりの最小確保サイズ（D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT）
+	const uint64_t kCommittedResourceAlignment = 65536;
+
+	// 従来のSpriteが持っていたリソースのサイズ
+	const uint64_t kLegacyVertexBytes = sizeof(SpriteBatch::VertexData) * SpriteBatch::kVertexPerSprite;
+	const uint64_t kLegacyIndexBytes = sizeof(uint32_t) * SpriteBatch::kIndexPerSprite;
+	const uint64_t kLegacyMaterialBytes = sizeof(Vector4) + sizeof(int32_t) + sizeof(float) * 3 + sizeof(Matrix4x4);
+	const uint64_t kLegacyTransformBytes = sizeof(Matrix4x4) * 2;
+}
+
+SpriteInstancer::InstanceData SpriteInstancer::Pack(
+	const Matrix4x4& wvp, const Vector4& color,
+	const Vector4& uvRect, const Vector2& anchorPoint,
+	bool isFlipX, bool isFlipY) {
+
+	InstanceData instance{};
+	instance.WVP = wvp;
+	instance.color = color;
+	instance.uvRect = uvRect;
+	instance.anchorPoint = anchorPoint;
+	instance.flipFlags = (isFlipX ? kFlipX : 0u) | (isFlipY ? kFlipY : 0u);
+	return instance;
+}
+
+SpriteInstancer::MemoryReport SpriteInstancer::MakeMemoryReport(uint32_t instanceBufferFrames) {
+	MemoryReport report{};
+
+	// 従来方式は頂点・インデックス・マテリアル・座標変換の4リソース
+	report.legacyResourcesPerSprite = 4;
+	report.legacyPayloadBytesPerSprite =
+		kLegacyVertexBytes + kLegacyIndexBytes + kLegacyMaterialBytes + kLegacyTransformBytes;
+	report.legacyCommittedBytesPerSprite = kCommittedResourceAlignment * report.legacyResourcesPerSprite;
+
+	// インスタンス方式はフレーム数分のインスタンスデータだけ
+	report.instancedBytesPerSprite = sizeof(InstanceData) * instanceBufferFrames;
+	report.instancedSharedBytes = kLegacyVertexBytes + kLegacyIndexBytes;
+	return report;
+}
+
+void SpriteInstancer::Begin() {
+	// 前のフレームの内容を破棄（容量は使い回す）
+	entries.clear();
+	order.clear();
+	instances.clear();
+	runs.clear();
+}
+
+void SpriteInstancer::Submit(uint32_t textureIndex, const InstanceData& instance) {
+	entries.push_back({ textureIndex, instance });
+}
+
+void SpriteInstancer::End() {
+
+	// テクスチャ番号で並べ替える（同じテクスチャ内は登録順を保つ）
+	order.resize(entries.size());
+	for (uint32_t i = 0; i < order.size(); ++i) {
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(),
+		[this](uint32_t a, uint32_t b) {
+			return entries[a].textureIndex < entries[b].textureIndex;
+		});
+
+	// 並べた順に詰めて、テクスチャが変わるところで区切る
+	instances.resize(entries.size());
+	for (uint32_t i = 0; i < order.size(); ++i) {
+		const Entry& entry = entries[order[i]];
+		instances[i] = entry.instance;
+
+		if (runs.empty() || runs.back().textureIndex != entry.textureIndex) {
+			runs.push_back({ entry.textureIndex, i, 0 });
+		}
+		runs.back().instanceCount++;
+	}
+}
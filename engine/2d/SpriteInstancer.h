@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Mymath.h"
+
+// スプライトをインスタンス描画用のデータに詰めるクラス
+// GPUに依存しないので単体で確認できる
+class SpriteInstancer {
+public:
+
+	// フリップのビット
+	static const uint32_t kFlipX = 1u << 0;
+	static const uint32_t kFlipY = 1u << 1;
+
+	// インスタンス1つ分のデータ（StructuredBufferと同じ並び）
+	struct InstanceData {
+		Math::Matrix4x4 WVP;
+		Math::Vector4 color;
+		Math::Vector4 uvRect; // 左, 上, 右, 下（0~1）
+		Math::Vector2 anchorPoint;
+		uint32_t flipFlags;
+		float padding; // 16バイト境界に揃える
+	};
+
+	// 同じテクスチャで連続するインスタンスの範囲
+	struct Run {
+		uint32_t textureIndex;
+		uint32_t instanceStart;
+		uint32_t instanceCount;
+	};
+
+	// スプライト1枚あたりのメモリ比較
+	struct MemoryReport {
+		uint32_t legacyResourcesPerSprite;     // 従来方式のコミット済みリソース数
+		uint64_t legacyPayloadBytesPerSprite;  // 従来方式で実際に使うバイト数
+		uint64_t legacyCommittedBytesPerSprite; // 従来方式で確保されるバイト数
+		uint64_t instancedBytesPerSprite;      // インスタンス方式のバイト数
+		uint64_t instancedSharedBytes;         // インスタンス方式で共有するバイト数
+	};
+
+	// スプライトのパラメータをインスタンスデータに詰める
+	static InstanceData Pack(
+		const Math::Matrix4x4& wvp, const Math::Vector4& color,
+		const Math::Vector4& uvRect, const Math::Vector2& anchorPoint,
+		bool isFlipX, bool isFlipY);
+
+	// 従来方式とインスタンス方式のメモリ比較を作る
+	static MemoryReport MakeMemoryReport(uint32_t instanceBufferFrames);
+
+	// 収集開始
+	void Begin();
+
+	// インスタンスを追加
+	void Submit(uint32_t textureIndex, const InstanceData& instance);
+
+	// テクスチャ順に並べ替える
+	void End();
+
+	// 並べ替え済みのインスタンス
+	const std::vector<InstanceData>& GetInstances() const { return instances; }
+
+	// 描画範囲のリスト
+	const std::vector<Run>& GetRuns() const { return runs; }
+
+	// 追加されたインスタンス数
+	uint32_t GetInstanceCount() const { return static_cast<uint32_t>(entries.size()); }
+
+private:
+
+	// 追加されたインスタンス一つ分
+	struct Entry {
+		uint32_t textureIndex;
+		InstanceData instance;
+	};
+
+	// 追加されたインスタンス
+	std::vector<Entry> entries;
+
+	// 並べ替え用の番号
+	std::vector<uint32_t> order;
+
+	// 出力するインスタンス
+	std::vector<InstanceData> instances;
+
+	// 出力する描画範囲
+	std::vector<Run> runs;
+};
@@ -1,7 +1,12 @@
 #include "TextureManager.h"
 #include "StringUtility.h"
+#include "Logger.h"
+#include <chrono>
+#include <filesystem>
+#include <format>
 
 using namespace StringUtility;
+using namespace Logeer;
 
 // インスタンスの初期化
 TextureManager* TextureManager::instance = nullptr;
@@ -20,55 +25,228 @@ void TextureManager::Initialize(DirectXCommon* dxCommon) {
 	this->dxCommon_ = dxCommon;
 	// SRVの数と同数
 	textureDatas.reserve(DirectXCommon::kMaxSRVCount);
+
+	// デコード用のワーカーを起動（WICを使うのでスレッドごとにCOMを初期化する）
+	threadPool.Initialize(ThreadPool::GetDefaultThreadCount(),
+		[]() { HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED); assert(SUCCEEDED(hr)); },
+		[]() { CoUninitialize(); });
+}
+
+uint32_t TextureManager::LoadTexture(const std::string& filePath) {
+
+	// 読み込みを頼んで、使えるようになるまで待つ
+	uint32_t textureIndex = LoadTextureAsync(filePath);
+	if (!IsTextureReady(textureIndex)) {
+		WaitForAll();
+	}
+	return textureIndex;
 }
 
-void TextureManager::LoadTexture(const std::string& filePath) {
+uint32_t TextureManager::LoadTextureAsync(const std::string& filePath) {
 
 	// 読み込みテクスチャを検索
-	auto it = std::find_if(
-		textureDatas.begin(), textureDatas.end(),
-		[&](const TextuerData& data) {
-			return data.filePath == filePath;
-		});
-
-	if (it != textureDatas.end()) {
-		// 既に読み込まれている場合は終了
-		return;
+	uint32_t dataIndex = pathTable.Find(filePath);
+
+	if (dataIndex != TexturePathTable::kInvalidIndex) {
+		// 既に読み込まれている（読み込み中）場合は番号を返して終了
+		return dataIndex + kSRVtIndexTop;
 	}
 
 	// テクスチャの上限数をチェック
 	assert(textureDatas.size() + kSRVtIndexTop < DirectXCommon::kMaxSRVCount);
 
-	// テクスチャファイルを読んでプログラムで扱えるようにする
-	std::wstring wFilePath = ConvertString(filePath);
-	HRESULT hr = DirectX::LoadFromWICFile(wFilePath.c_str(), DirectX::WIC_FLAGS_NONE, nullptr, image);
-	assert(SUCCEEDED(hr));
-
-	// ミップマップを生成する
-	DirectX::ScratchImage mipImage{};
-	hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImage);
-	assert(SUCCEEDED(hr));
-
 	// テクスチャデータを追加
 	textureDatas.resize(textureDatas.size() + 1);
+	dataIndex = static_cast<uint32_t>(textureDatas.size() - 1);
 
 	// 追加したテクスチャデータの参照を取得する
 	TextuerData& textureData = textureDatas.back();
 
 	// ファイルパスを保存
 	textureData.filePath = filePath;
-	// メタデータを保存
-	textureData.metadata = mipImage.GetMetadata();
-	// テクスチャリソースを生成
-	textureData.resource = dxCommon_->CreateTextuerResource(textureData.metadata);
+	pathTable.Insert(filePath, dataIndex);
+
+	// デコードが終わるまではリソースを作らない
+	textureData.state = LoadState::kDecoding;
+	textureData.uploadFenceValue = 0;
+	textureData.uploadExecutedCount = 0;
+	textureData.isFailed = false;
+	textureData.isCooked = false;
+	textureData.decodeMilliseconds = 0.0;
+	textureData.gpuBytes = 0;
 
 	// テクスチャデータの要素数番号をSRVのインデックス番号とする
-	uint32_t srvIndex = static_cast<uint32_t>(textureDatas.size() - 1) + kSRVtIndexTop;
+	uint32_t srvIndex = dataIndex + kSRVtIndexTop;
 	// SRVのCPUハンドルを取得
 	textureData.srvHandleCPU = dxCommon_->GetSRVCPUDescriptorHandle(srvIndex);
 	// SRVのGPUハンドルを取得
 	textureData.srvHandleGPU = dxCommon_->GetSRVGPUDescriptorHandle(srvIndex);
 
+	// デコードとミップマップ生成はワーカーで行う
+	threadPool.Submit([this, dataIndex, filePath]() {
+		DecodedTexture decoded;
+		decoded.dataIndex = dataIndex;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		// 失敗してもメインスレッドに結果を渡して、代わりのテクスチャを使う
+		decoded.result = DecodeTexture(filePath, decoded.mipImage, true, &decoded.isCooked);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		decoded.decodeMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+		// メインスレッドに渡す
+		std::lock_guard<std::mutex> lock(decodedMutex);
+		decodedTextures.push_back(std::move(decoded));
+	});
+
+	return srvIndex;
+}
+
+bool TextureManager::IsTextureReady(uint32_t textureIndex) const {
+	assert(textureIndex >= kSRVtIndexTop);
+	uint32_t dataIndex = textureIndex - kSRVtIndexTop;
+	assert(dataIndex < textureDatas.size());
+	return textureDatas[dataIndex].state == LoadState::kReady;
+}
+
+bool TextureManager::IsTextureFailed(uint32_t textureIndex) const {
+	assert(textureIndex >= kSRVtIndexTop);
+	uint32_t dataIndex = textureIndex - kSRVtIndexTop;
+	assert(dataIndex < textureDatas.size());
+	return textureDatas[dataIndex].isFailed;
+}
+
+HRESULT TextureManager::DecodeTexture(const std::string& filePath, DirectX::ScratchImage& mipImage,
+	bool preferCooked, bool* isCooked) {
+
+	// 焼いたDDSがあればそのまま読む（圧縮済み・ミップマップ入り）
+	// パスは確保せずに変換する
+	WideStringBuffer wFilePath;
+	const wchar_t* wCookedFilePath = ConvertString(GetCookedFilePath(filePath), wFilePath);
+	bool useCooked = preferCooked && std::filesystem::exists(wCookedFilePath);
+	if (isCooked) {
+		*isCooked = useCooked;
+	}
+	if (useCooked) {
+		return DirectX::LoadFromDDSFile(wCookedFilePath, DirectX::DDS_FLAGS_NONE, nullptr, mipImage);
+	}
+
+	// テクスチャファイルを読んでプログラムで扱えるようにする
+	DirectX::ScratchImage image{};
+	HRESULT hr = DirectX::LoadFromWICFile(ConvertString(filePath, wFilePath), DirectX::WIC_FLAGS_NONE, nullptr, image);
+	if (FAILED(hr)) {
+		return hr;
+	}
+
+	// ミップマップを生成する
+	return DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImage);
+}
+
+HRESULT TextureManager::CreateFallbackImage(DirectX::ScratchImage& image) {
+	HRESULT hr = image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, 1, 1, 1, 1);
+	if (FAILED(hr)) {
+		return hr;
+	}
+
+	// 読み込めていないことが画面でわかるようにマゼンタにする
+	uint8_t* pixel = image.GetPixels();
+	pixel[0] = 255;
+	pixel[1] = 0;
+	pixel[2] = 255;
+	pixel[3] = 255;
+	return S_OK;
+}
+
+std::string TextureManager::GetCookedFilePath(const std::string& filePath) {
+	std::filesystem::path cookedFilePath(filePath);
+	cookedFilePath.replace_extension(".dds");
+	return cookedFilePath.generic_string();
+}
+
+void TextureManager::Update() {
+
+	// ワーカーからデコードが終わったテクスチャを受け取る
+	std::vector<DecodedTexture> decoded;
+	{
+		std::lock_guard<std::mutex> lock(decodedMutex);
+		decoded.swap(decodedTextures);
+	}
+
+	// 転送を今のフレームのコマンドリストにまとめて積む
+	for (DecodedTexture& decodedTexture : decoded) {
+		RecordUpload(decodedTexture);
+	}
+
+	// 転送を積んだコマンドリストが実行されていたら、そのときのフェンス値で完了を待つ
+	// （記録した時点の次のフェンス値は、実行前にWaitForGPUでSignalされることがあるので使わない）
+	uint64_t executedCount = dxCommon_->GetExecutedCommandListCount();
+	uint64_t executedFenceValue = dxCommon_->GetExecutedFenceValue();
+
+	// 転送が終わったテクスチャを使えるようにする
+	uint64_t completedFenceValue = dxCommon_->GetCompletedFenceValue();
+	for (size_t i = 0; i < uploadingIndices.size();) {
+		TextuerData& textureData = textureDatas[uploadingIndices[i]];
+		if (textureData.uploadFenceValue == 0 && textureData.uploadExecutedCount < executedCount) {
+			// 後から実行したコマンドリストのフェンス値でも、それ以前の転送の完了は保証される
+			textureData.uploadFenceValue = executedFenceValue;
+		}
+		if (textureData.uploadFenceValue != 0 && textureData.uploadFenceValue <= completedFenceValue) {
+			textureData.state = LoadState::kReady;
+			textureData.intermediateResource.Reset();
+			readyTextureCount++;
+
+			// 末尾と入れ替えて取り除く
+			uploadingIndices[i] = uploadingIndices.back();
+			uploadingIndices.pop_back();
+		} else {
+			++i;
+		}
+	}
+}
+
+void TextureManager::WaitForAll() {
+
+	// デコードが全部終わるのを待つ
+	threadPool.WaitIdle();
+
+	// 転送をまとめて積んで、一回だけ実行して待つ
+	Update();
+	ExecuteAndWait();
+
+	// 転送が終わったので使えるようにする
+	Update();
+}
+
+void TextureManager::RecordUpload(DecodedTexture& decoded) {
+
+	// 追加したテクスチャデータの参照を取得する
+	TextuerData& textureData = textureDatas[decoded.dataIndex];
+
+	// 読み込めなかったときは記録して、代わりのテクスチャを同じSRVに作る
+	if (FAILED(decoded.result)) {
+		LOGEER_LOG(Level::kError, Category::kTexture, "Texture {} : failed to load (hr = 0x{:08X}), using fallback",
+			textureData.filePath, static_cast<uint32_t>(decoded.result));
+		HRESULT hr = CreateFallbackImage(decoded.mipImage);
+		assert(SUCCEEDED(hr));
+		decoded.isCooked = false;
+		textureData.isFailed = true;
+		failedTextureCount++;
+	}
+
+	// メタデータを保存
+	textureData.metadata = decoded.mipImage.GetMetadata();
+	// テクスチャリソースを生成
+	textureData.resource = dxCommon_->CreateTextuerResource(textureData.metadata);
+
+	// 計測用の値を保存
+	textureData.isCooked = decoded.isCooked;
+	textureData.decodeMilliseconds = decoded.decodeMilliseconds;
+	textureData.gpuBytes = dxCommon_->GetTextureAllocationSize(textureData.metadata);
+	cookedTextureCount += textureData.isCooked ? 1 : 0;
+	totalDecodeMilliseconds += textureData.decodeMilliseconds;
+	totalGpuBytes += textureData.gpuBytes;
+	LOGEER_LOG(Level::kInfo, Category::kTexture, "Texture {} : {} {:.3f} ms {} KiB",
+		textureData.filePath, textureData.isCooked ? "dds" : "wic",
+		textureData.decodeMilliseconds, textureData.gpuBytes / 1024);
+
 	// SRVを設定
 	srvDesc.Format = textureData.metadata.format;
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
@@ -81,36 +259,31 @@ void TextureManager::LoadTexture(const std::string& filePath) {
 		&srvDesc, // SRVの設定
 		textureData.srvHandleCPU); // ハンドル
 
-	// すぐに転送完了をまつ
-	Microsoft::WRL::ComPtr<ID3D12Resource> intermediateResource =
-		dxCommon_->UploadTextureData(textureData.resource, mipImage);
+	// 転送を積む（転送元は完了まで持っておく）
+	textureData.intermediateResource =
+		dxCommon_->UploadTextureData(textureData.resource, decoded.mipImage);
+	textureData.uploadFenceValue = 0;
+	textureData.uploadExecutedCount = dxCommon_->GetExecutedCommandListCount();
+	textureData.state = LoadState::kUploading;
+	uploadingIndices.push_back(decoded.dataIndex);
+}
+
+void TextureManager::ExecuteAndWait() {
 
 	// commandListをCloseし、commandQueueに投げる
-	ID3D12CommandList* commandLists[] = {
-		dxCommon_->GetCommandList()
-	};
-	dxCommon_->GetCommandList()->Close();
-	dxCommon_->GetCommandQueue()->ExecuteCommandLists(1, commandLists);
+	dxCommon_->ExecuteCommandList();
 
 	// 実行完了を待つ（Fence）
 	dxCommon_->WaitForGPU();
 
 	// コマンドアロケーターとコマンドリストをリセット
-	dxCommon_->GetCommandAllocator()->Reset();
 	dxCommon_->ResetCommandList();
 }
 
 uint32_t TextureManager::GetTextureIndexByFilePath(const std::string& filePath) {
-	auto it = std::find_if(
-		textureDatas.begin(), textureDatas.end(),
-		[&filePath](const TextuerData& data) {
-			return data.filePath == filePath;
-		});
+	uint32_t dataIndex = pathTable.Find(filePath);
 
-	assert(it != textureDatas.end());
-
-	uint32_t dataIndex =
-		static_cast<uint32_t>(std::distance(textureDatas.begin(), it));
+	assert(dataIndex != TexturePathTable::kInvalidIndex);
 
 	// ★ ここが重要 ★
 	return dataIndex + kSRVtIndexTop;
@@ -134,10 +307,12 @@ const DirectX::TexMetadata& TextureManager::GetTextureMetadata(uint32_t textureI
 	uint32_t dataIndex = textureIndex - kSRVtIndexTop;
 	// 実際のテクスチャ数を超えていないか
 	assert(dataIndex < textureDatas.size());
+	// デコードが終わっていないとメタデータはない
+	assert(textureDatas[dataIndex].state != LoadState::kDecoding);
 	return textureDatas[dataIndex].metadata;
 }
 
 void TextureManager::Finalize() {
 	delete instance;
 	instance = nullptr;
-}
\ No newline at end of file
+}
@@ -4,8 +4,11 @@
 #include <d3d12.h>
 #include <vector>
 #include <cstdint>
+#include <mutex>
 #include "DirectXTex/DirectXTex.h"
 #include "DirectXCommon.h"
+#include "TexturePathTable.h"
+#include "ThreadPool.h"
 
 // 前方宣言
 class DirectXCommon;
@@ -21,8 +24,47 @@ public:
 	// 終了
 	static void Finalize();
 
-	// LoadTexture関数
-	void LoadTexture(const std::string& filePath);
+	// LoadTexture関数（読み込み済みならそのテクスチャ番号を返すだけ）
+	// 使えるようになるまで待つ
+	uint32_t LoadTexture(const std::string& filePath);
+
+	// 非同期の読み込み（テクスチャ番号をすぐに返し、デコードとミップマップ生成はワーカーで行う）
+	// 使えるようになったかはIsTextureReadyで確認する
+	uint32_t LoadTextureAsync(const std::string& filePath);
+
+	// テクスチャが使えるようになったか
+	bool IsTextureReady(uint32_t textureIndex) const;
+
+	// デコードが終わったテクスチャの転送を今のフレームのコマンドリストにまとめて積み、
+	// 転送が終わったテクスチャを使えるようにする（メインスレッドで毎フレーム呼ぶ）
+	void Update();
+
+	// 読み込み中のテクスチャを全部使えるようにする（転送は一回の実行・一回のフェンスでまとめて待つ）
+	void WaitForAll();
+
+	// テクスチャファイルを読んでミップマップを作る（GPUを使わないのでどのスレッドからでも呼べる）
+	// preferCookedなら同じ名前の.ddsがあればそちらを読む（ミップマップ入りなので生成しない）
+	static HRESULT DecodeTexture(const std::string& filePath, DirectX::ScratchImage& mipImage,
+		bool preferCooked = true, bool* isCooked = nullptr);
+
+	// TextureCookerが書き出すDDSのパス（拡張子を.ddsにしたもの）
+	static std::string GetCookedFilePath(const std::string& filePath);
+
+	// 読み込みを頼まれたテクスチャ数と使えるようになったテクスチャ数
+	uint32_t GetTextureCount() const { return static_cast<uint32_t>(textureDatas.size()); }
+	uint32_t GetReadyTextureCount() const { return readyTextureCount; }
+
+	// 読み込めずに代わりのテクスチャを使っているか、その数
+	bool IsTextureFailed(uint32_t textureIndex) const;
+	uint32_t GetFailedTextureCount() const { return failedTextureCount; }
+
+	// 読み込んだテクスチャのうちDDSから読んだ数、デコードにかかった時間の合計、GPUメモリの合計
+	uint32_t GetCookedTextureCount() const { return cookedTextureCount; }
+	double GetTotalDecodeMilliseconds() const { return totalDecodeMilliseconds; }
+	uint64_t GetTotalGpuBytes() const { return totalGpuBytes; }
+
+	// デコード用のワーカー（計測用）
+	ThreadPool* GetThreadPool() { return &threadPool; }
 
 	// SRVインデックスの開始番号
 	uint32_t GetTextureIndexByFilePath(const std::string& filePath);
@@ -30,7 +72,7 @@ public:
 	// テクスチャ番号からSRVのGPUハンドルを取得
 	D3D12_GPU_DESCRIPTOR_HANDLE GetSRVHandleGPU(uint32_t textureIndex);
 
-	// メタデータを取得
+	// メタデータを取得（非同期読み込みのときはデコードが終わってから）
 	const DirectX::TexMetadata& GetTextureMetadata(uint32_t textureIndex);
 
 private:
@@ -41,6 +83,13 @@ private:
 	TextureManager(TextureManager&) = delete;
 	TextureManager& operator=(const TextureManager&) = delete;
 
+	// 読み込みの状態
+	enum class LoadState {
+		kDecoding,  // ワーカーでデコード中
+		kUploading, // GPUへ転送中
+		kReady,     // 使える
+	};
+
 	// テクスチャ一枚分のデータ
 	struct TextuerData {
 		std::string filePath;
@@ -48,16 +97,71 @@ private:
 		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
 		D3D12_CPU_DESCRIPTOR_HANDLE srvHandleCPU;
 		D3D12_GPU_DESCRIPTOR_HANDLE srvHandleGPU;
+		LoadState state;
+		// 転送元のリソース（転送が終わるまで持っておく）
+		Microsoft::WRL::ComPtr<ID3D12Resource> intermediateResource;
+		// このフェンス値が完了したら転送が終わっている（0のときは転送を積んだコマンドリストがまだ実行されていない）
+		uint64_t uploadFenceValue;
+		// 転送を積んだときの実行済みコマンドリスト数（これより増えたら実行された）
+		uint64_t uploadExecutedCount;
+		// 読み込めずに代わりのテクスチャを使っているか
+		bool isFailed;
+		// DDSから読んだか
+		bool isCooked;
+		// デコードにかかった時間
+		double decodeMilliseconds;
+		// GPU上のサイズ
+		uint64_t gpuBytes;
+	};
+
+	// ワーカーでデコードが終わったテクスチャ
+	struct DecodedTexture {
+		uint32_t dataIndex;
+		// デコードの結果（失敗したときはmipImageが空）
+		HRESULT result;
+		DirectX::ScratchImage mipImage;
+		bool isCooked;
+		double decodeMilliseconds;
 	};
 
 	// テクスチャデータ
 	std::vector<TextuerData> textureDatas;
 
+	// ファイルパスからtextureDatasの番号を引く表
+	TexturePathTable pathTable;
+
+	// デコードが終わったテクスチャ（ワーカーから渡される）
+	std::vector<DecodedTexture> decodedTextures;
+	std::mutex decodedMutex;
+
+	// 転送中のテクスチャの番号
+	std::vector<uint32_t> uploadingIndices;
+
+	// 使えるようになったテクスチャ数と、そのうち読み込めなかったテクスチャ数
+	uint32_t readyTextureCount = 0;
+	uint32_t failedTextureCount = 0;
+
+	// 計測用の合計
+	uint32_t cookedTextureCount = 0;
+	double totalDecodeMilliseconds = 0.0;
+	uint64_t totalGpuBytes = 0;
+
 	DirectXCommon* dxCommon_;
 
 	// SRVインデックスの開始番号
 	static uint32_t kSRVtIndexTop;
 
-	DirectX::ScratchImage image{};
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+
+	// デコードしたテクスチャのリソースとSRVを作って転送を積む（失敗していたら代わりのテクスチャを積む）
+	void RecordUpload(DecodedTexture& decoded);
+
+	// 読み込めなかったテクスチャの代わりに使う1x1のマゼンタの画像を作る
+	static HRESULT CreateFallbackImage(DirectX::ScratchImage& image);
+
+	// 積んだコマンドを実行して完了を待つ
+	void ExecuteAndWait();
+
+	// デコード用のワーカー（他のメンバより先に止めるので最後に置く）
+	ThreadPool threadPool;
 };
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "TexturePathTable.h"
+#include <cassert>
+
+std::string TexturePathTable::Normalize(std::string_view filePath) {
+	std::string result;
+	result.reserve(filePath.size());
+
+	for (size_t i = 0; i < filePath.size(); ++i) {
+		char c = filePath[i];
+
+		// 区切りは'/'にそろえる
+		if (c == '\\') {
+			c = '/';
+		}
+
+		if (c == '/') {
+			// 重複した'/'は一つにする
+			if (!result.empty() && result.back() == '/') {
+				continue;
+			}
+		} else if (c == '.' && (result.empty() || result.back() == '/')) {
+			// "./"は取り除く
+			size_t next = i + 1;
+			if (next < filePath.size() && (filePath[next] == '/' || filePath[next] == '\\')) {
+				++i;
+				continue;
+			}
+		} else if (c >= 'A' && c <= 'Z') {
+			// Windowsのパスは大文字小文字を区別しない
+			c = static_cast<char>(c - 'A' + 'a');
+		}
+
+		result.push_back(c);
+	}
+	return result;
+}
+
+uint64_t TexturePathTable::Hash(std::string_view normalizedPath) {
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (char c : normalizedPath) {
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+void TexturePathTable::Insert(std::string_view filePath, uint32_t index) {
+	std::string normalizedPath = Normalize(filePath);
+	uint64_t id = Hash(normalizedPath);
+
+	auto [it, inserted] = indices.try_emplace(id, index);
+	if (!inserted) {
+		// 違うパスが同じIDになっていないか
+		assert(paths[it->second] == normalizedPath);
+		return;
+	}
+
+	// 番号はパスの並びと同じ
+	assert(index == paths.size());
+	paths.push_back(std::move(normalizedPath));
+}
+
+uint32_t TexturePathTable::Find(std::string_view filePath) const {
+	std::string normalizedPath = Normalize(filePath);
+	uint32_t index = Find(Hash(normalizedPath));
+
+	// IDが同じでも違うパスなら見つからない
+	if (index == kInvalidIndex || paths[index] != normalizedPath) {
+		return kInvalidIndex;
+	}
+	return index;
+}
+
+uint32_t TexturePathTable::Find(uint64_t id) const {
+	auto it = indices.find(id);
+	if (it == indices.end()) {
+		return kInvalidIndex;
+	}
+	return it->second;
+}
+
+void TexturePathTable::Clear() {
+	indices.clear();
+	paths.clear();
+}
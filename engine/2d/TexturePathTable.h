@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// テクスチャのファイルパスを番号に引く表
+// パスは正規化してからハッシュ値（ID）にするので、同じファイルを指す書き方の違いは同じIDになる
+class TexturePathTable {
+public:
+
+	// 見つからなかったときの番号
+	static const uint32_t kInvalidIndex = UINT32_MAX;
+
+	// パスの正規化（区切りを'/'にそろえ、"./"と重複した'/'を除き、英字を小文字にする）
+	static std::string Normalize(std::string_view filePath);
+
+	// 正規化済みのパスからIDを作る（FNV-1a 64bit）
+	static uint64_t Hash(std::string_view normalizedPath);
+
+	// パスからIDを作る（何度も引くときは先に作っておく）
+	static uint64_t MakeId(std::string_view filePath) { return Hash(Normalize(filePath)); }
+
+	// 登録（既に登録されていたら何もしない）
+	void Insert(std::string_view filePath, uint32_t index);
+
+	// 番号を引く（見つからなければkInvalidIndex）
+	// パスで引くときは登録したパスと一致するかも確かめるので、IDが衝突した別のパスは見つからない扱いになる
+	uint32_t Find(std::string_view filePath) const;
+
+	// IDで引く（パスとの照合はしないので、IDは登録したパスから作ったものを使う）
+	uint32_t Find(uint64_t id) const;
+
+	// 登録数
+	uint32_t GetCount() const { return static_cast<uint32_t>(paths.size()); }
+
+	// 全部消す
+	void Clear();
+
+private:
+
+	// IDから番号
+	std::unordered_map<uint64_t, uint32_t> indices;
+
+	// 登録した正規化済みのパス（IDの衝突の確認用）
+	std::vector<std::string> paths;
+};
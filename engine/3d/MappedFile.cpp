@@ -0,0 +1,84 @@
+#include "MappedFile.h"
+#include <psapi.h>
+#include <algorithm>
+#include <vector>
+#include "StringUtility.h"
+
+bool MappedFile::Open(const std::string& filePath) {
+	Close();
+
+	// 順に読むことをOSに伝えて先読みを効かせる
+	StringUtility::WideStringBuffer wFilePath;
+	file = CreateFileW(StringUtility::ConvertString(filePath, wFilePath), GENERIC_READ, FILE_SHARE_READ,
+		nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize)) {
+		Close();
+		return false;
+	}
+	size = static_cast<size_t>(fileSize.QuadPart);
+
+	// 空のファイルはマップできないので、開いただけにする
+	if (size == 0) {
+		return true;
+	}
+
+	mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		Close();
+		return false;
+	}
+
+	view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::Close() {
+	if (view != nullptr) {
+		UnmapViewOfFile(view);
+		view = nullptr;
+	}
+	if (mapping != nullptr) {
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+	if (file != INVALID_HANDLE_VALUE) {
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+	size = 0;
+}
+
+size_t MappedFile::GetResidentSize() const {
+	if (view == nullptr) {
+		return 0;
+	}
+	SYSTEM_INFO systemInfo{};
+	GetSystemInfo(&systemInfo);
+	size_t pageSize = systemInfo.dwPageSize;
+	size_t pageCount = (size + pageSize - 1) / pageSize;
+
+	// ページごとにワーキングセットに入っているかを問い合わせる
+	std::vector<PSAPI_WORKING_SET_EX_INFORMATION> pages(pageCount);
+	for (size_t i = 0; i < pageCount; ++i) {
+		pages[i].VirtualAddress = const_cast<char*>(static_cast<const char*>(view)) + i * pageSize;
+	}
+	if (!QueryWorkingSetEx(GetCurrentProcess(), pages.data(), static_cast<DWORD>(sizeof(pages[0]) * pageCount))) {
+		return 0;
+	}
+	size_t residentPages = 0;
+	for (const PSAPI_WORKING_SET_EX_INFORMATION& page : pages) {
+		if (page.VirtualAttributes.Valid) {
+			++residentPages;
+		}
+	}
+	return std::min<size_t>(residentPages * pageSize, size);
+}
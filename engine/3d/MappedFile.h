@@ -0,0 +1,46 @@
+#pragma once
+#include <windows.h>
+#include <cstddef>
+#include <string>
+
+// ファイルを読み取り専用でメモリにマップするクラス
+// 読み込み用のバッファを確保せず、OSのページキャッシュをそのまま参照する
+class MappedFile {
+public:
+
+	MappedFile() = default;
+	~MappedFile() { Close(); }
+
+	// コピーはしない
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// 開く（失敗したらfalse。空のファイルは開けてサイズ0になる）
+	bool Open(const std::string& filePath);
+
+	// 閉じる
+	void Close();
+
+	// 開いているか
+	bool IsOpen() const { return file != INVALID_HANDLE_VALUE; }
+
+	// 先頭アドレスとサイズ
+	const char* GetData() const { return static_cast<const char*>(view); }
+	size_t GetSize() const { return size; }
+
+	// マップした範囲のうち、いまこのプロセスの物理メモリに載っているバイト数（ページ単位）
+	// 触っていないページは読み込まれていないので、開いた直後はほとんど0になる
+	size_t GetResidentSize() const;
+
+private:
+
+	// ファイルとマッピングのハンドル
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+
+	// マップした先頭アドレス
+	const void* view = nullptr;
+
+	// ファイルサイズ
+	size_t size = 0;
+};
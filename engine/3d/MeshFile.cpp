@@ -0,0 +1,147 @@
+#include "MeshFile.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "StringUtility.h"
+
+namespace {
+
+	// 境界に切り上げる
+	inline uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// 境界まで0で埋める
+	void WritePadding(std::ofstream& file, uint64_t alignment) {
+		static const char kZeros[MeshFile::kBlobAlignment] = {};
+		uint64_t position = static_cast<uint64_t>(file.tellp());
+		file.write(kZeros, static_cast<std::streamsize>(AlignUp(position, alignment) - position));
+	}
+}
+
+bool MeshFile::Save(const std::string& filePath, const IndexedMesh& mesh,
+	const std::vector<Submesh>& submeshes, const std::vector<Material>& materials) {
+
+	// 位置を決める
+	Header fileHeader{};
+	fileHeader.magic = kMagic;
+	fileHeader.version = kVersion;
+	fileHeader.vertexStride = sizeof(IndexedMesh::VertexData);
+	fileHeader.indexStride = mesh.GetIndexStride();
+	fileHeader.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+	fileHeader.indexCount = static_cast<uint32_t>(mesh.indices.size());
+	fileHeader.submeshCount = static_cast<uint32_t>(submeshes.size());
+	fileHeader.materialCount = static_cast<uint32_t>(materials.size());
+	uint64_t tableEnd = sizeof(Header) + sizeof(Submesh) * submeshes.size() + sizeof(Material) * materials.size();
+	fileHeader.vertexOffset = AlignUp(tableEnd, kBlobAlignment);
+	fileHeader.indexOffset = AlignUp(fileHeader.vertexOffset + mesh.GetVertexBytes(), kBlobAlignment);
+
+	std::ofstream file(StringUtility::ConvertToPath(filePath), std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+	file.write(reinterpret_cast<const char*>(submeshes.data()), sizeof(Submesh) * submeshes.size());
+	file.write(reinterpret_cast<const char*>(materials.data()), sizeof(Material) * materials.size());
+
+	// 頂点
+	WritePadding(file, kBlobAlignment);
+	file.write(reinterpret_cast<const char*>(mesh.vertices.data()), static_cast<std::streamsize>(mesh.GetVertexBytes()));
+
+	// インデックス（GPUで使う幅にしてから書く）
+	WritePadding(file, kBlobAlignment);
+	std::vector<uint8_t> indexBytes(mesh.GetIndexBytes());
+	mesh.WriteIndices(indexBytes.data());
+	file.write(reinterpret_cast<const char*>(indexBytes.data()), static_cast<std::streamsize>(indexBytes.size()));
+	return file.good();
+}
+
+bool MeshFile::CookObjFile(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool) {
+	ObjLoader::ModelData modelData = ObjLoader::LoadObjFile(directoryPath, filename, threadPool);
+
+	// 同じ頂点をまとめる（インデックスは元の頂点の順なので、描画範囲の位置はそのまま使える）
+	IndexedMesh mesh = MeshWelder::Weld(modelData.vertices);
+
+	// 描画範囲ごとにキャッシュに合わせて並べ替える
+	std::vector<Submesh> submeshes;
+	std::vector<MeshOptimizer::IndexRange> ranges;
+	for (const ObjLoader::SubmeshData& submeshData : modelData.submeshes) {
+		submeshes.push_back({ submeshData.vertexStart, submeshData.vertexCount, submeshData.materialIndex, 0 });
+		ranges.push_back({ submeshData.vertexStart, submeshData.vertexCount });
+	}
+	MeshOptimizer::Optimize(mesh, ranges);
+
+	std::vector<Material> materials(modelData.materials.size());
+	for (size_t i = 0; i < materials.size(); ++i) {
+		const ObjLoader::MaterialData& materialData = modelData.materials[i];
+		size_t pathLength = std::min<size_t>(materialData.textureFilePath.size(), kMaxPathLength - 1);
+		std::memcpy(materials[i].textureFilePath, materialData.textureFilePath.data(), pathLength);
+		materials[i].textureFilePath[pathLength] = '\0';
+		materials[i].color = materialData.color;
+	}
+
+	return Save(GetCookedFilePath(directoryPath + "/" + filename), mesh, submeshes, materials);
+}
+
+std::string MeshFile::GetCookedFilePath(const std::string& filePath) {
+	std::filesystem::path cookedFilePath = StringUtility::ConvertToPath(filePath);
+	cookedFilePath.replace_extension(".mesh");
+	return StringUtility::ConvertPathToString(cookedFilePath);
+}
+
+bool MeshFile::Open(const std::string& filePath) {
+	Close();
+	if (!file.Open(filePath) || file.GetSize() < sizeof(Header)) {
+		Close();
+		return false;
+	}
+
+	// 形式と範囲を確かめる（中身の頂点は見ない）
+	const Header* fileHeader = reinterpret_cast<const Header*>(file.GetData());
+	uint64_t tableEnd = sizeof(Header) + sizeof(Submesh) * uint64_t(fileHeader->submeshCount) +
+		sizeof(Material) * uint64_t(fileHeader->materialCount);
+	bool isValid = fileHeader->magic == kMagic && fileHeader->version == kVersion &&
+		fileHeader->vertexStride == sizeof(IndexedMesh::VertexData) &&
+		(fileHeader->indexStride == 2 || fileHeader->indexStride == 4) &&
+		tableEnd <= fileHeader->vertexOffset &&
+		fileHeader->vertexOffset + uint64_t(fileHeader->vertexStride) * fileHeader->vertexCount <= fileHeader->indexOffset &&
+		fileHeader->indexOffset + uint64_t(fileHeader->indexStride) * fileHeader->indexCount <= file.GetSize();
+	if (isValid) {
+		// 描画範囲がインデックスとマテリアルの中に収まっているか
+		const Submesh* submeshes = reinterpret_cast<const Submesh*>(file.GetData() + sizeof(Header));
+		for (uint32_t i = 0; i < fileHeader->submeshCount && isValid; ++i) {
+			isValid = uint64_t(submeshes[i].indexStart) + submeshes[i].indexCount <= fileHeader->indexCount &&
+				submeshes[i].materialIndex < fileHeader->materialCount;
+		}
+	}
+	if (!isValid) {
+		Close();
+		return false;
+	}
+	header = fileHeader;
+	return true;
+}
+
+void MeshFile::Close() {
+	file.Close();
+	header = nullptr;
+}
+
+const MeshFile::Submesh* MeshFile::GetSubmeshes() const {
+	return reinterpret_cast<const Submesh*>(file.GetData() + sizeof(Header));
+}
+
+const MeshFile::Material* MeshFile::GetMaterials() const {
+	return reinterpret_cast<const Material*>(file.GetData() + sizeof(Header) + sizeof(Submesh) * header->submeshCount);
+}
+
+const void* MeshFile::GetVertexData() const {
+	return file.GetData() + header->vertexOffset;
+}
+
+const void* MeshFile::GetIndexData() const {
+	return file.GetData() + header->indexOffset;
+}
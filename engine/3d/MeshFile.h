@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "MeshWelder.h"
+
+// 前方宣言
+class ThreadPool;
+
+// 焼いたメッシュファイル（.mesh）の形式と読み書きを行うクラス
+// [Header][Submesh × submeshCount][Material × materialCount][頂点][インデックス]
+// 頂点とインデックスはkBlobAlignment境界に置き、読み込み時は解析せずにアップロード用のバッファへそのままコピーできる
+class MeshFile {
+public:
+
+	// ファイルの先頭の識別子（"MESH"）と形式のバージョン（変えたら上げる）
+	static const uint32_t kMagic = 0x4853454Du;
+	static const uint32_t kVersion = 1;
+
+	// 頂点とインデックスを置く境界
+	static const uint32_t kBlobAlignment = 16;
+
+	// マテリアルのテクスチャパスの最大長（終端込み）
+	static const uint32_t kMaxPathLength = 260;
+
+	// ヘッダ
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t vertexStride;  // sizeof(VertexData)
+		uint32_t indexStride;   // 2 or 4
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t submeshCount;
+		uint32_t materialCount;
+		uint64_t vertexOffset;  // ファイル先頭からのバイト数
+		uint64_t indexOffset;
+	};
+
+	// 描画範囲（インデックスの範囲と使うマテリアル）
+	struct Submesh {
+		uint32_t indexStart;
+		uint32_t indexCount;
+		uint32_t materialIndex;
+		uint32_t reserved;
+	};
+
+	// マテリアル
+	struct Material {
+		char textureFilePath[kMaxPathLength]; // テクスチャファイルのパス（無ければ空）
+		Math::Vector4 color; // 拡散反射色
+	};
+
+	~MeshFile() { Close(); }
+
+	// 書き出す
+	static bool Save(const std::string& filePath, const IndexedMesh& mesh,
+		const std::vector<Submesh>& submeshes, const std::vector<Material>& materials);
+
+	// Objファイルを読み込み、頂点をまとめて並べ替えてから.meshに書き出す
+	static bool CookObjFile(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool = nullptr);
+
+	// Objファイルのパスから焼いたファイルのパスを作る（拡張子を.meshにする）
+	static std::string GetCookedFilePath(const std::string& filePath);
+
+	// ファイルをメモリにマップして開く（形式が合わなければfalse）
+	bool Open(const std::string& filePath);
+
+	// 閉じる
+	void Close();
+
+	// 中身（Openが成功している間だけ有効）
+	const Header& GetHeader() const { return *header; }
+	const Submesh* GetSubmeshes() const;
+	const Material* GetMaterials() const;
+	const void* GetVertexData() const;
+	const void* GetIndexData() const;
+	uint64_t GetVertexBytes() const { return uint64_t(header->vertexStride) * header->vertexCount; }
+	uint64_t GetIndexBytes() const { return uint64_t(header->indexStride) * header->indexCount; }
+
+private:
+
+	// マップしたファイル
+	MappedFile file;
+
+	// ファイルの先頭
+	const Header* header = nullptr;
+};
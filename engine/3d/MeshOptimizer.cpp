@@ -0,0 +1,402 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+	// Forsythの方法で使うLRUキャッシュの大きさと重み
+	const int32_t kForsythCacheSize = 32;
+	const float kCacheDecayPower = 1.5f;
+	const float kLastTriangleScore = 0.75f;
+	const float kValenceBoostScale = 2.0f;
+	const float kValenceBoostPower = 0.5f;
+
+	// 点数表に持つ残り三角形数の上限（それより多いものは上限と同じ点数にする）
+	const uint32_t kMaxValence = 64;
+
+	// 頂点の点数表（[キャッシュ内の位置 + 1][残り三角形数]。位置0はキャッシュ外）
+	struct VertexScoreTable {
+		float scores[kForsythCacheSize + 1][kMaxValence + 1];
+
+		VertexScoreTable() {
+			for (int32_t position = -1; position < kForsythCacheSize; ++position) {
+				for (uint32_t valence = 0; valence <= kMaxValence; ++valence) {
+					float score = 0.0f;
+					if (valence == 0) {
+						// 使い終わった頂点
+						score = -1.0f;
+					} else {
+						if (position >= 0 && position < 3) {
+							// 直前の三角形の頂点は、続けて同じ三角形を使い回さないように固定の点数
+							score = kLastTriangleScore;
+						} else if (position >= 3) {
+							float scaler = 1.0f / (kForsythCacheSize - 3);
+							score = std::pow(1.0f - (position - 3) * scaler, kCacheDecayPower);
+						}
+						// 残りが少ない頂点を優先して使い切る
+						score += kValenceBoostScale * std::pow(float(valence), -kValenceBoostPower);
+					}
+					scores[position + 1][valence] = score;
+				}
+			}
+		}
+
+		float Get(int32_t cachePosition, uint32_t valence) const {
+			return scores[cachePosition + 1][std::min(valence, kMaxValence)];
+		}
+	};
+
+	// FIFOキャッシュのシミュレーションで三角形ごとのキャッシュミス数を数える
+	void SimulateFifo(const uint32_t* indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize,
+		std::vector<uint8_t>* triangleMisses, uint32_t* transformedVertexCount, uint32_t* usedVertexCount) {
+
+		// 頂点がキャッシュに入った時刻（時刻の差がキャッシュの大きさ以下なら残っている）
+		std::vector<uint32_t> timestamps(vertexCount, 0);
+		uint32_t time = cacheSize + 1;
+		uint32_t transformed = 0;
+		uint32_t used = 0;
+		if (triangleMisses != nullptr) {
+			triangleMisses->assign(indexCount / 3, 0);
+		}
+		for (size_t i = 0; i < indexCount; ++i) {
+			uint32_t vertex = indices[i];
+			if (timestamps[vertex] == 0) {
+				used++;
+			}
+			if (time - timestamps[vertex] > cacheSize) {
+				timestamps[vertex] = time++;
+				transformed++;
+				if (triangleMisses != nullptr) {
+					(*triangleMisses)[i / 3]++;
+				}
+			}
+		}
+		*transformedVertexCount = transformed;
+		if (usedVertexCount != nullptr) {
+			*usedVertexCount = used;
+		}
+	}
+
+	// 三角形の面積つき法線（辺の外積）と重心
+	void GetTriangleGeometry(const IndexedMesh& mesh, size_t triangle, Math::Vector3& weightedNormal, Math::Vector3& centroid) {
+		const Math::Vector4& p0 = mesh.vertices[mesh.indices[triangle * 3 + 0]].position;
+		const Math::Vector4& p1 = mesh.vertices[mesh.indices[triangle * 3 + 1]].position;
+		const Math::Vector4& p2 = mesh.vertices[mesh.indices[triangle * 3 + 2]].position;
+		float ax = p1.x - p0.x, ay = p1.y - p0.y, az = p1.z - p0.z;
+		float bx = p2.x - p0.x, by = p2.y - p0.y, bz = p2.z - p0.z;
+		weightedNormal = { ay * bz - az * by, az * bx - ax * bz, ax * by - ay * bx };
+		centroid = { (p0.x + p1.x + p2.x) / 3.0f, (p0.y + p1.y + p2.y) / 3.0f, (p0.z + p1.z + p2.z) / 3.0f };
+	}
+}
+
+MeshOptimizer::CacheStatistics MeshOptimizer::AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+	uint32_t cacheSize) {
+
+	CacheStatistics statistics;
+	uint32_t usedVertexCount = 0;
+	SimulateFifo(indices, indexCount, vertexCount, cacheSize, nullptr, &statistics.transformedVertexCount, &usedVertexCount);
+	size_t triangleCount = indexCount / 3;
+	statistics.acmr = triangleCount != 0 ? float(statistics.transformedVertexCount) / float(triangleCount) : 0.0f;
+	statistics.atvr = usedVertexCount != 0 ? float(statistics.transformedVertexCount) / float(usedVertexCount) : 0.0f;
+	return statistics;
+}
+
+void MeshOptimizer::OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount) {
+	static const VertexScoreTable scoreTable;
+
+	const size_t triangleCount = indexCount / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	// 頂点ごとの残り三角形数と、その三角形の一覧（残っているものを前に詰める）
+	std::vector<uint32_t> valences(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; ++i) {
+		valences[indices[i]]++;
+	}
+	std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+		adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + valences[vertex];
+	}
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	{
+		std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i = 0; i < triangleCount * 3; ++i) {
+			adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	// 点数
+	std::vector<int32_t> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex) {
+		vertexScores[vertex] = scoreTable.Get(-1, valences[vertex]);
+	}
+	std::vector<bool> isEmitted(triangleCount, false);
+	uint32_t bestTriangle = 0;
+	float bestScore = -1.0f;
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+		float score = vertexScores[indices[triangle * 3 + 0]] +
+			vertexScores[indices[triangle * 3 + 1]] + vertexScores[indices[triangle * 3 + 2]];
+		if (score > bestScore) {
+			bestScore = score;
+			bestTriangle = static_cast<uint32_t>(triangle);
+		}
+	}
+
+	// LRUキャッシュ（新しい三角形の3頂点が押し出す分だけ大きく持つ）
+	int32_t cache[kForsythCacheSize + 3];
+	int32_t cacheCount = 0;
+
+	std::vector<uint32_t> output(triangleCount * 3);
+	size_t scanCursor = 0;
+	for (size_t outputTriangle = 0; outputTriangle < triangleCount; ++outputTriangle) {
+
+		// 見つからなければ、まだ出していない三角形を先頭から探す
+		if (bestScore < 0.0f) {
+			while (isEmitted[scanCursor]) {
+				scanCursor++;
+			}
+			bestTriangle = static_cast<uint32_t>(scanCursor);
+		}
+
+		// 三角形を出して、各頂点の一覧から外す
+		isEmitted[bestTriangle] = true;
+		const uint32_t* triangleVertices = &indices[size_t(bestTriangle) * 3];
+		for (int32_t corner = 0; corner < 3; ++corner) {
+			uint32_t vertex = triangleVertices[corner];
+			output[outputTriangle * 3 + corner] = vertex;
+			uint32_t* begin = &adjacency[adjacencyOffsets[vertex]];
+			uint32_t* end = begin + valences[vertex];
+			uint32_t* found = std::find(begin, end, bestTriangle);
+			std::swap(*found, *(end - 1));
+			valences[vertex]--;
+		}
+
+		// 3頂点をキャッシュの先頭に入れ、残りを後ろにずらす
+		int32_t newCache[kForsythCacheSize + 3];
+		int32_t newCacheCount = 0;
+		for (int32_t corner = 0; corner < 3; ++corner) {
+			newCache[newCacheCount++] = static_cast<int32_t>(triangleVertices[corner]);
+		}
+		for (int32_t i = 0; i < cacheCount; ++i) {
+			int32_t vertex = cache[i];
+			if (vertex != newCache[0] && vertex != newCache[1] && vertex != newCache[2]) {
+				newCache[newCacheCount++] = vertex;
+			}
+		}
+
+		// キャッシュ内の頂点の点数を更新する（押し出された頂点はキャッシュ外になる）
+		for (int32_t i = 0; i < newCacheCount; ++i) {
+			int32_t vertex = newCache[i];
+			cachePositions[vertex] = i < kForsythCacheSize ? i : -1;
+			vertexScores[vertex] = scoreTable.Get(cachePositions[vertex], valences[vertex]);
+		}
+
+		// 点数の変わった頂点を使う三角形から次を選ぶ
+		bestScore = -1.0f;
+		for (int32_t i = 0; i < newCacheCount; ++i) {
+			int32_t vertex = newCache[i];
+			const uint32_t* begin = &adjacency[adjacencyOffsets[vertex]];
+			for (uint32_t j = 0; j < valences[vertex]; ++j) {
+				uint32_t triangle = begin[j];
+				float score = vertexScores[indices[size_t(triangle) * 3 + 0]] +
+					vertexScores[indices[size_t(triangle) * 3 + 1]] + vertexScores[indices[size_t(triangle) * 3 + 2]];
+				if (score > bestScore) {
+					bestScore = score;
+					bestTriangle = triangle;
+				}
+			}
+		}
+
+		cacheCount = std::min(newCacheCount, kForsythCacheSize);
+		std::copy(newCache, newCache + cacheCount, cache);
+	}
+
+	std::copy(output.begin(), output.end(), indices);
+}
+
+uint32_t MeshOptimizer::OptimizeOverdraw(IndexedMesh& mesh, float threshold) {
+	return OptimizeOverdraw(mesh, IndexRange{ 0, static_cast<uint32_t>(mesh.indices.size()) }, threshold);
+}
+
+uint32_t MeshOptimizer::OptimizeOverdraw(IndexedMesh& mesh, const IndexRange& range, float threshold) {
+	assert(range.indexStart % 3 == 0 && size_t(range.indexStart) + range.indexCount <= mesh.indices.size());
+	uint32_t* indices = mesh.indices.data() + range.indexStart;
+	const size_t triangleCount = range.indexCount / 3;
+	if (triangleCount == 0) {
+		return 0;
+	}
+
+	// 今の並びでのキャッシュミス数
+	std::vector<uint8_t> triangleMisses;
+	uint32_t transformedVertexCount = 0;
+	SimulateFifo(indices, triangleCount * 3, mesh.vertices.size(), kDefaultCacheSize,
+		&triangleMisses, &transformedVertexCount, nullptr);
+
+	// 3頂点とも読み直しになる所（キャッシュが一度切れる所）で大きく分ける
+	std::vector<uint32_t> hardBoundaries;
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+		if (triangle == 0 || triangleMisses[triangle] == 3) {
+			hardBoundaries.push_back(static_cast<uint32_t>(triangle));
+		}
+	}
+	hardBoundaries.push_back(static_cast<uint32_t>(triangleCount));
+
+	// その中で、キャッシュを空にしてから描き始めてもACMRが全体のthreshold倍以下に収まる所でさらに分ける
+	// （並べ替えた後は前のクラスタの頂点がキャッシュに残っていないので、空の状態から数え直す）
+	std::vector<uint32_t> timestamps(mesh.vertices.size(), 0);
+	uint32_t time = kDefaultCacheSize + 1;
+	auto countMisses = [&](uint32_t triangle) {
+		uint32_t misses = 0;
+		for (int32_t corner = 0; corner < 3; ++corner) {
+			uint32_t vertex = indices[size_t(triangle) * 3 + corner];
+			if (time - timestamps[vertex] > kDefaultCacheSize) {
+				timestamps[vertex] = time++;
+				misses++;
+			}
+		}
+		return misses;
+	};
+	std::vector<uint32_t> clusterStarts;
+	for (size_t hard = 0; hard + 1 < hardBoundaries.size(); ++hard) {
+		uint32_t hardBegin = hardBoundaries[hard];
+		uint32_t hardEnd = hardBoundaries[hard + 1];
+		uint32_t hardMisses = 0;
+		for (uint32_t triangle = hardBegin; triangle < hardEnd; ++triangle) {
+			hardMisses += triangleMisses[triangle];
+		}
+		float limit = float(hardMisses) / float(hardEnd - hardBegin) * threshold;
+
+		// キャッシュを空にして数え始める
+		time += kDefaultCacheSize + 1;
+		uint32_t clusterBegin = hardBegin;
+		uint32_t clusterMisses = 0;
+		clusterStarts.push_back(clusterBegin);
+		for (uint32_t triangle = hardBegin; triangle < hardEnd; ++triangle) {
+			clusterMisses += countMisses(triangle);
+			if (triangle + 1 < hardEnd && float(clusterMisses) <= float(triangle + 1 - clusterBegin) * limit) {
+				time += kDefaultCacheSize + 1;
+				clusterBegin = triangle + 1;
+				clusterMisses = 0;
+				clusterStarts.push_back(clusterBegin);
+			}
+		}
+	}
+	clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+	const uint32_t clusterCount = static_cast<uint32_t>(clusterStarts.size() - 1);
+
+	// 範囲全体の重心（面積の重み付き）
+	std::vector<Math::Vector3> weightedNormals(triangleCount);
+	std::vector<Math::Vector3> centroids(triangleCount);
+	Math::Vector3 meshCentroid = { 0.0f,0.0f,0.0f };
+	float meshArea = 0.0f;
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+		GetTriangleGeometry(mesh, range.indexStart / 3 + triangle, weightedNormals[triangle], centroids[triangle]);
+		const Math::Vector3& n = weightedNormals[triangle];
+		float area = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+		meshCentroid = { meshCentroid.x + centroids[triangle].x * area,
+			meshCentroid.y + centroids[triangle].y * area, meshCentroid.z + centroids[triangle].z * area };
+		meshArea += area;
+	}
+	if (meshArea > 0.0f) {
+		meshCentroid = { meshCentroid.x / meshArea, meshCentroid.y / meshArea, meshCentroid.z / meshArea };
+	}
+
+	// クラスタごとに「重心から外向きにどれだけ出ているか」を求める（大きいほど手前に来やすい）
+	std::vector<float> sortKeys(clusterCount);
+	for (uint32_t cluster = 0; cluster < clusterCount; ++cluster) {
+		Math::Vector3 normal = { 0.0f,0.0f,0.0f };
+		Math::Vector3 centroid = { 0.0f,0.0f,0.0f };
+		float area = 0.0f;
+		for (uint32_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; ++triangle) {
+			const Math::Vector3& n = weightedNormals[triangle];
+			float triangleArea = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+			normal = { normal.x + n.x, normal.y + n.y, normal.z + n.z };
+			centroid = { centroid.x + centroids[triangle].x * triangleArea,
+				centroid.y + centroids[triangle].y * triangleArea, centroid.z + centroids[triangle].z * triangleArea };
+			area += triangleArea;
+		}
+		float normalLength = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		if (area <= 0.0f || normalLength <= 0.0f) {
+			sortKeys[cluster] = 0.0f;
+			continue;
+		}
+		sortKeys[cluster] = ((centroid.x / area - meshCentroid.x) * normal.x +
+			(centroid.y / area - meshCentroid.y) * normal.y +
+			(centroid.z / area - meshCentroid.z) * normal.z) / normalLength;
+	}
+
+	// 外向きのクラスタから順に並べる
+	std::vector<uint32_t> clusterOrder(clusterCount);
+	for (uint32_t cluster = 0; cluster < clusterCount; ++cluster) {
+		clusterOrder[cluster] = cluster;
+	}
+	std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+		[&sortKeys](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+	std::vector<uint32_t> sortedIndices;
+	sortedIndices.reserve(triangleCount * 3);
+	for (uint32_t cluster : clusterOrder) {
+		sortedIndices.insert(sortedIndices.end(),
+			indices + size_t(clusterStarts[cluster]) * 3,
+			indices + size_t(clusterStarts[cluster + 1]) * 3);
+	}
+	std::copy(sortedIndices.begin(), sortedIndices.end(), indices);
+	return clusterCount;
+}
+
+void MeshOptimizer::OptimizeVertexFetch(IndexedMesh& mesh) {
+	const uint32_t kUnused = 0xFFFFFFFFu;
+
+	// 最初に使われた順に新しい番号を振る
+	std::vector<uint32_t> remap(mesh.vertices.size(), kUnused);
+	uint32_t nextIndex = 0;
+	for (uint32_t& index : mesh.indices) {
+		if (remap[index] == kUnused) {
+			remap[index] = nextIndex++;
+		}
+		index = remap[index];
+	}
+
+	// 使われない頂点は後ろに回す
+	for (uint32_t& index : remap) {
+		if (index == kUnused) {
+			index = nextIndex++;
+		}
+	}
+
+	std::vector<IndexedMesh::VertexData> vertices(mesh.vertices.size());
+	for (size_t vertex = 0; vertex < mesh.vertices.size(); ++vertex) {
+		vertices[remap[vertex]] = mesh.vertices[vertex];
+	}
+	mesh.vertices.swap(vertices);
+}
+
+MeshOptimizer::Report MeshOptimizer::Optimize(IndexedMesh& mesh, bool optimizeOverdraw, float overdrawThreshold) {
+	std::vector<IndexRange> ranges = { IndexRange{ 0, static_cast<uint32_t>(mesh.indices.size()) } };
+	return Optimize(mesh, ranges, optimizeOverdraw, overdrawThreshold);
+}
+
+MeshOptimizer::Report MeshOptimizer::Optimize(IndexedMesh& mesh, const std::vector<IndexRange>& ranges,
+	bool optimizeOverdraw, float overdrawThreshold) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	Report report;
+	report.before = AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+
+	// 三角形は範囲の中でだけ並べ替える（範囲ごとに描くので、範囲をまたいで動かすと描画範囲が崩れる）
+	for (const IndexRange& range : ranges) {
+		OptimizeVertexCache(mesh.indices.data() + range.indexStart, range.indexCount, mesh.vertices.size());
+		if (optimizeOverdraw) {
+			report.clusterCount += OptimizeOverdraw(mesh, range, overdrawThreshold);
+		}
+	}
+	OptimizeVertexFetch(mesh);
+
+	report.after = AnalyzeVertexCache(mesh.indices.data(), mesh.indices.size(), mesh.vertices.size());
+	report.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return report;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MeshWelder.h"
+
+// インデックス付きメッシュの三角形と頂点の並びをGPU向けに並べ替えるクラス
+// 頂点キャッシュ（Forsythの方法）→ 重なり描き（クラスタの並べ替え）→ 頂点の読み込み順の順に行う
+// 効果はCPU上のFIFOキャッシュのシミュレーションで測るので、GPUが無くても確かめられる
+class MeshOptimizer {
+public:
+
+	// シミュレーションするFIFOキャッシュの大きさ
+	static const uint32_t kDefaultCacheSize = 16;
+
+	// 頂点キャッシュのシミュレーション結果
+	struct CacheStatistics {
+		uint32_t transformedVertexCount = 0; // 頂点シェーダーが走る回数
+		float acmr = 0.0f; // 三角形あたりの頂点シェーダーの回数（0.5~3、小さいほど良い）
+		float atvr = 0.0f; // 使われている頂点あたりの頂点シェーダーの回数（1以上、小さいほど良い）
+	};
+
+	// インデックスの範囲（サブメッシュ。三角形はこの中でだけ並べ替える）
+	struct IndexRange {
+		uint32_t indexStart; // 3の倍数
+		uint32_t indexCount;
+	};
+
+	// 最適化の結果
+	struct Report {
+		CacheStatistics before;
+		CacheStatistics after;
+		uint32_t clusterCount = 0; // 重なり描きのために分けたクラスタ数（しなければ0）
+		double milliseconds = 0.0;
+	};
+
+	// FIFOキャッシュをシミュレーションする
+	static CacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+		uint32_t cacheSize = kDefaultCacheSize);
+
+	// 頂点キャッシュで再利用されやすいように三角形を並べ替える
+	static void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+	// キャッシュの効率がthreshold倍より悪くならない範囲でクラスタに分け、外向きのものから描くように並べ替える
+	// 戻り値はクラスタ数
+	static uint32_t OptimizeOverdraw(IndexedMesh& mesh, float threshold = 1.05f);
+	static uint32_t OptimizeOverdraw(IndexedMesh& mesh, const IndexRange& range, float threshold = 1.05f);
+
+	// 頂点を使われる順に並べ替える（使われない頂点は後ろに回す）
+	static void OptimizeVertexFetch(IndexedMesh& mesh);
+
+	// 全部をまとめて行う（rangesを渡すと範囲ごとに並べ替え、範囲の位置と大きさは変えない）
+	static Report Optimize(IndexedMesh& mesh, bool optimizeOverdraw = true, float overdrawThreshold = 1.05f);
+	static Report Optimize(IndexedMesh& mesh, const std::vector<IndexRange>& ranges,
+		bool optimizeOverdraw = true, float overdrawThreshold = 1.05f);
+};
@@ -0,0 +1,91 @@
+#include "MeshWelder.h"
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+	using VertexData = IndexedMesh::VertexData;
+
+	// 比較とハッシュはビット列で行うので、詰め物が無いことを確認しておく
+	static_assert(sizeof(VertexData) == sizeof(float) * 9, "VertexData must be tightly packed");
+
+	// ハッシュ表の空き
+	const uint32_t kEmpty = 0xFFFFFFFFu;
+
+	// 頂点のビット列のハッシュ
+	inline uint32_t HashVertex(const VertexData& vertex) {
+		uint32_t words[9];
+		std::memcpy(words, &vertex, sizeof(words));
+		uint32_t hash = 2166136261u;
+		for (uint32_t word : words) {
+			hash = (hash ^ word) * 16777619u;
+		}
+		// 下位ビットに偏りが出ないように混ぜる
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6Bu;
+		hash ^= hash >> 13;
+		return hash;
+	}
+
+	// 2のべき乗に切り上げる
+	inline size_t RoundUpPowerOfTwo(size_t value) {
+		size_t result = 16;
+		while (result < value) {
+			result <<= 1;
+		}
+		return result;
+	}
+}
+
+void IndexedMesh::WriteIndices(void* destination) const {
+	if (GetIndexStride() == 4) {
+		std::memcpy(destination, indices.data(), sizeof(uint32_t) * indices.size());
+		return;
+	}
+	uint16_t* output = static_cast<uint16_t*>(destination);
+	for (size_t i = 0; i < indices.size(); ++i) {
+		output[i] = static_cast<uint16_t>(indices[i]);
+	}
+}
+
+IndexedMesh MeshWelder::Weld(const IndexedMesh::VertexData* vertices, size_t vertexCount, Report* report) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	IndexedMesh mesh;
+	mesh.indices.resize(vertexCount);
+	mesh.vertices.reserve(vertexCount);
+
+	// 半分以上空くようにして、探す距離を短くする
+	const size_t tableSize = RoundUpPowerOfTwo(vertexCount * 2);
+	const size_t mask = tableSize - 1;
+	std::vector<uint32_t> table(tableSize, kEmpty);
+
+	for (size_t i = 0; i < vertexCount; ++i) {
+		const VertexData& vertex = vertices[i];
+		size_t slot = HashVertex(vertex) & mask;
+
+		// 同じ頂点か空きが見つかるまで隣を探す
+		while (table[slot] != kEmpty && std::memcmp(&mesh.vertices[table[slot]], &vertex, sizeof(VertexData)) != 0) {
+			slot = (slot + 1) & mask;
+		}
+		if (table[slot] == kEmpty) {
+			table[slot] = static_cast<uint32_t>(mesh.vertices.size());
+			mesh.vertices.push_back(vertex);
+		}
+		mesh.indices[i] = table[slot];
+	}
+
+	// 余った分を返す
+	mesh.vertices.shrink_to_fit();
+
+	if (report != nullptr) {
+		report->inputVertexCount = static_cast<uint32_t>(vertexCount);
+		report->outputVertexCount = static_cast<uint32_t>(mesh.vertices.size());
+		report->indexCount = static_cast<uint32_t>(mesh.indices.size());
+		report->indexStride = mesh.GetIndexStride();
+		report->inputBytes = uint64_t(sizeof(VertexData)) * vertexCount;
+		report->outputBytes = mesh.GetVertexBytes() + mesh.GetIndexBytes();
+		report->milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+	return mesh;
+}
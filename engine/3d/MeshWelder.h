@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ObjLoader.h"
+
+// インデックス付きのメッシュ
+struct IndexedMesh {
+	using VertexData = ObjLoader::VertexData;
+
+	// 重複のない頂点
+	std::vector<VertexData> vertices;
+
+	// 三角形ごとに3つ（加工しやすいように32bitで持ち、GPUへはGetIndexStride()の幅で書き込む）
+	std::vector<uint32_t> indices;
+
+	// 頂点数が16bitで表せるなら2、そうでなければ4
+	uint32_t GetIndexStride() const { return vertices.size() <= 0x10000 ? 2u : 4u; }
+
+	// GPUに置くときのバイト数
+	uint64_t GetVertexBytes() const { return uint64_t(sizeof(VertexData)) * vertices.size(); }
+	uint64_t GetIndexBytes() const { return uint64_t(GetIndexStride()) * indices.size(); }
+
+	// インデックスをGPU用の幅で書き込む（destinationはGetIndexBytes()分）
+	void WriteIndices(void* destination) const;
+};
+
+// 位置・UV・法線がまったく同じ頂点を一つにまとめ、インデックスバッファを作るクラス
+// ハッシュ表（開番地法）で一度なめるだけなので、頂点数に比例した時間で終わる
+class MeshWelder {
+public:
+
+	// まとめた結果
+	struct Report {
+		uint32_t inputVertexCount = 0;  // まとめる前の頂点数
+		uint32_t outputVertexCount = 0; // まとめた後の頂点数
+		uint32_t indexCount = 0;        // インデックス数
+		uint32_t indexStride = 0;       // インデックスの幅（2 or 4）
+		uint64_t inputBytes = 0;        // まとめる前の頂点バッファのバイト数
+		uint64_t outputBytes = 0;       // まとめた後の頂点バッファとインデックスバッファのバイト数
+		double milliseconds = 0.0;      // かかった時間
+
+		// 頂点が何分の1になったか
+		float GetReductionRatio() const {
+			return outputVertexCount != 0 ? float(inputVertexCount) / float(outputVertexCount) : 0.0f;
+		}
+
+		// 減ったバイト数（増えた場合は負）
+		int64_t GetSavedBytes() const { return int64_t(inputBytes) - int64_t(outputBytes); }
+	};
+
+	// 三角形ごとに3頂点並んだ配列をまとめる（最初に出てきた順に番号を振る）
+	static IndexedMesh Weld(const IndexedMesh::VertexData* vertices, size_t vertexCount, Report* report = nullptr);
+	static IndexedMesh Weld(const std::vector<IndexedMesh::VertexData>& vertices, Report* report = nullptr) {
+		return Weld(vertices.data(), vertices.size(), report);
+	}
+};
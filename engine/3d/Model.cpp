@@ -0,0 +1,112 @@
+#include "Model.h"
+#include <cassert>
+#include <cstring>
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "MeshWelder.h"
+#include "TextureManager.h"
+
+using namespace Math;
+
+void Model::Initialize(ModelCommon* modelCommon, const std::string& directoryPath, const std::string& filename,
+	ThreadPool* threadPool) {
+
+	// 焼いたものがあれば解析せずにそのままコピーする
+	MeshFile meshFile;
+	if (!meshFile.Open(MeshFile::GetCookedFilePath(directoryPath + "/" + filename))) {
+		Initialize(modelCommon, ObjLoader::LoadObjFile(directoryPath, filename, threadPool));
+		return;
+	}
+
+	// 引数をメンバ変数にセット
+	modelCommon_ = modelCommon;
+	modelIndex = modelCommon_->RegisterModel(this);
+
+	const MeshFile::Header& header = meshFile.GetHeader();
+	CreateBuffers(meshFile.GetVertexBytes(), meshFile.GetIndexBytes(), header.indexStride);
+	std::memcpy(vertexBuffer.GetData(), meshFile.GetVertexData(), vertexBuffer.GetSizeInBytes());
+	std::memcpy(indexBuffer.GetData(), meshFile.GetIndexData(), indexBuffer.GetSizeInBytes());
+
+	for (uint32_t i = 0; i < header.submeshCount; ++i) {
+		const MeshFile::Submesh& submesh = meshFile.GetSubmeshes()[i];
+		submeshes.push_back({ submesh.indexStart, submesh.indexCount, submesh.materialIndex });
+	}
+	for (uint32_t i = 0; i < header.materialCount; ++i) {
+		const MeshFile::Material& material = meshFile.GetMaterials()[i];
+		CreateMaterial(material.textureFilePath, material.color);
+	}
+}
+
+void Model::Initialize(ModelCommon* modelCommon, const ObjLoader::ModelData& modelData) {
+
+	// 引数をメンバ変数にセット
+	modelCommon_ = modelCommon;
+	modelIndex = modelCommon_->RegisterModel(this);
+
+	// 同じ頂点をまとめ、描画範囲ごとにキャッシュに合わせて並べ替える
+	IndexedMesh mesh = MeshWelder::Weld(modelData.vertices);
+	std::vector<MeshOptimizer::IndexRange> ranges;
+	for (const ObjLoader::SubmeshData& submesh : modelData.submeshes) {
+		submeshes.push_back({ submesh.vertexStart, submesh.vertexCount, submesh.materialIndex });
+		ranges.push_back({ submesh.vertexStart, submesh.vertexCount });
+	}
+	MeshOptimizer::Optimize(mesh, ranges);
+
+	CreateBuffers(mesh.GetVertexBytes(), mesh.GetIndexBytes(), mesh.GetIndexStride());
+	std::memcpy(vertexBuffer.GetData(), mesh.vertices.data(), vertexBuffer.GetSizeInBytes());
+	mesh.WriteIndices(indexBuffer.GetData());
+
+	for (const ObjLoader::MaterialData& material : modelData.materials) {
+		CreateMaterial(material.textureFilePath, material.color);
+	}
+}
+
+void Model::Draw(const Matrix4x4& worldMatrix) {
+
+	// 座標変換はモデルで一つ、描画はサブメッシュごと
+	Draw(modelCommon_->AddTransform(worldMatrix));
+}
+
+void Model::Draw(uint32_t transformIndex) {
+	if (transformIndex == ModelCommon::kInvalidTransform) {
+		return;
+	}
+	for (const Submesh& submesh : submeshes) {
+		const MaterialResource& material = materials[submesh.materialIndex];
+		modelCommon_->SubmitDraw({ modelIndex, material.textureIndex, material.materialIndex, transformIndex,
+			submesh.indexStart, submesh.indexCount });
+	}
+}
+
+void Model::CreateBuffers(uint64_t vertexBytes, uint64_t indexBytes, uint32_t indexStride) {
+	DirectXCommon* dxCommon = modelCommon_->GetDirectXCommon();
+
+	// 頂点リソース（アップロードヒープなのでマップしたままにする）
+	assert(vertexBytes % sizeof(ObjLoader::VertexData) == 0);
+	vertexBuffer = dxCommon->CreateMappedBufferResource<ObjLoader::VertexData>(
+		static_cast<size_t>(vertexBytes / sizeof(ObjLoader::VertexData)));
+	vertexBufferView.BufferLocation = vertexBuffer.GetGPUVirtualAddress();
+	vertexBufferView.SizeInBytes = UINT(vertexBytes);
+	vertexBufferView.StrideInBytes = sizeof(ObjLoader::VertexData);
+
+	// インデックスリソース（頂点数が少なければ16bit）
+	indexBuffer = dxCommon->CreateMappedBufferResource<uint8_t>(static_cast<size_t>(indexBytes));
+	indexBufferView.BufferLocation = indexBuffer.GetGPUVirtualAddress();
+	indexBufferView.SizeInBytes = UINT(indexBytes);
+	indexBufferView.Format = indexStride == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+}
+
+void Model::CreateMaterial(const std::string& textureFilePath, const Vector4& color) {
+	MaterialResource& material = materials.emplace_back();
+
+	// テクスチャが無ければ既定のものを使う
+	material.textureIndex = TextureManager::GetInstance()->LoadTexture(
+		textureFilePath.empty() ? ModelCommon::kDefaultTextureFilePath : textureFilePath);
+
+	// 定数バッファ
+	material.buffer = modelCommon_->GetDirectXCommon()->CreateMappedBufferResource<ModelCommon::Material>();
+	material.buffer->color = color;
+	material.buffer->enableLighting = true;
+	material.buffer->uvTranseform = makeIdentity4x4();
+	material.materialIndex = modelCommon_->RegisterMaterial(material.buffer.GetGPUVirtualAddress());
+}
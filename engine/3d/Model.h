@@ -0,0 +1,80 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <wrl.h>
+#include <d3d12.h>
+#include "MappedBuffer.h"
+#include "Mymath.h"
+#include "ObjLoader.h"
+#include "ModelCommon.h"
+
+// 前方宣言
+class ThreadPool;
+
+// 複数のサブメッシュとマテリアルを持つモデル
+// 頂点とインデックスはモデル全体で一つのバッファにまとめ、サブメッシュはその中のインデックスの範囲として描く
+class Model {
+public:
+
+	// 描画範囲
+	struct Submesh {
+		uint32_t indexStart;
+		uint32_t indexCount;
+		uint32_t materialIndex; // このモデルのマテリアルの番号
+	};
+
+	// 読み込む（MeshCookerで焼いた.meshがあればそちらを読み、無ければObjを読んでまとめる）
+	void Initialize(ModelCommon* modelCommon, const std::string& directoryPath, const std::string& filename,
+		ThreadPool* threadPool = nullptr);
+
+	// 読み込み済みのObjから作る
+	void Initialize(ModelCommon* modelCommon, const ObjLoader::ModelData& modelData);
+
+	// 描画を追加する（実際に描くのはModelCommon::DrawModels）
+	void Draw(const Math::Matrix4x4& worldMatrix);
+
+	// ModelCommon::AddTransformsで書き込んだ座標変換の番号で描画を追加する
+	void Draw(uint32_t transformIndex);
+
+	// 頂点・インデックスバッファビュー
+	const D3D12_VERTEX_BUFFER_VIEW& GetVertexBufferView() const { return vertexBufferView; }
+	const D3D12_INDEX_BUFFER_VIEW& GetIndexBufferView() const { return indexBufferView; }
+
+	// 描画範囲とマテリアル数
+	const std::vector<Submesh>& GetSubmeshes() const { return submeshes; }
+	uint32_t GetMaterialCount() const { return static_cast<uint32_t>(materials.size()); }
+
+private:
+
+	// マテリアル一つ分
+	struct MaterialResource {
+		MappedBuffer<ModelCommon::Material> buffer; // 定数バッファ
+		uint32_t textureIndex;  // テクスチャ番号
+		uint32_t materialIndex; // ModelCommonに登録した番号
+	};
+
+	ModelCommon* modelCommon_ = nullptr;
+
+	// ModelCommonに登録した番号
+	uint32_t modelIndex = 0;
+
+	// 頂点リソース（破棄するときにUnmapする）
+	MappedBuffer<ObjLoader::VertexData> vertexBuffer;
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
+
+	// インデックスリソース（16bitか32bitなのでバイト単位で持つ）
+	MappedBuffer<uint8_t> indexBuffer;
+	D3D12_INDEX_BUFFER_VIEW indexBufferView{};
+
+	// 描画範囲
+	std::vector<Submesh> submeshes;
+
+	// マテリアル
+	std::vector<MaterialResource> materials;
+
+	// 頂点とインデックスのバッファを作る（書き込み先はvertexBufferとindexBuffer）
+	void CreateBuffers(uint64_t vertexBytes, uint64_t indexBytes, uint32_t indexStride);
+
+	// マテリアルを作る
+	void CreateMaterial(const std::string& textureFilePath, const Math::Vector4& color);
+};
@@ -0,0 +1,246 @@
+#include "ModelCommon.h"
+#include <cassert>
+#include "Model.h"
+#include "TextureManager.h"
+#include "TransformSystem.h"
+
+using namespace Math;
+
+const std::string ModelCommon::kDefaultTextureFilePath = "resources/uvChecker.png";
+
+void ModelCommon::Initialize(DirectXCommon* dxCommon) {
+
+	// 引数をメンバ変数にセット
+	dxCommon_ = dxCommon;
+
+	// グラフィックスパイプラインの作成
+	CreateGraphicsPipeline();
+}
+
+uint32_t ModelCommon::RegisterModel(Model* model) {
+	models.push_back(model);
+	return static_cast<uint32_t>(models.size() - 1);
+}
+
+uint32_t ModelCommon::RegisterMaterial(D3D12_GPU_VIRTUAL_ADDRESS materialAddress) {
+	materialAddresses.push_back(materialAddress);
+	return static_cast<uint32_t>(materialAddresses.size() - 1);
+}
+
+void ModelCommon::SetCommonDrawSetting(const Matrix4x4& viewProjectionMatrix) {
+
+	// このフレームのカメラ
+	viewProjection = viewProjectionMatrix;
+
+	// 描画の収集開始
+	transformAddresses.clear();
+	drawList.Begin();
+}
+
+uint32_t ModelCommon::AddTransform(const Matrix4x4& worldMatrix) {
+	D3D12_GPU_VIRTUAL_ADDRESS transformAddress = 0;
+	TransfomationMatrix* transformData = dxCommon_->AllocateUpload<TransfomationMatrix>(1, &transformAddress);
+	if (transformData == nullptr) {
+		return kInvalidTransform;
+	}
+	transformData->WVP = Multiply(worldMatrix, viewProjection);
+	transformData->World = worldMatrix;
+	transformAddresses.push_back(transformAddress);
+	return static_cast<uint32_t>(transformAddresses.size() - 1);
+}
+
+uint32_t ModelCommon::AddTransforms(const TransformSystem& transforms, ThreadPool* threadPool) {
+	uint32_t count = transforms.GetCount();
+	if (count == 0) {
+		return kInvalidTransform;
+	}
+
+	// 定数バッファは境界に揃える必要があるので、1つ分ずつ境界の間隔で並べる
+	const size_t kStride = static_cast<size_t>(UploadRingAllocator::kDefaultAlignment);
+	static_assert(sizeof(TransfomationMatrix) == sizeof(TransformSystem::TransformationMatrix));
+	static_assert(sizeof(TransfomationMatrix) <= UploadRingAllocator::kDefaultAlignment);
+	DirectXCommon::UploadAllocation allocation = dxCommon_->AllocateUpload(kStride * count);
+	if (allocation.cpuAddress == nullptr) {
+		return kInvalidTransform;
+	}
+
+	// 一時配列を通さずにアップロード領域へ書き込む
+	transforms.Update(viewProjection, allocation.cpuAddress, kStride, threadPool);
+
+	uint32_t firstIndex = static_cast<uint32_t>(transformAddresses.size());
+	for (uint32_t i = 0; i < count; ++i) {
+		transformAddresses.push_back(allocation.gpuAddress + kStride * i);
+	}
+	return firstIndex;
+}
+
+void ModelCommon::DrawModels() {
+
+	// 並べ替えて、切り替え回数を数える
+	drawList.End(isSortEnabled);
+
+	const std::vector<ModelDrawList::DrawItem>& items = drawList.GetDrawItems();
+	if (items.empty()) {
+		return;
+	}
+
+	ID3D12GraphicsCommandList* commandList = dxCommon_->GetCommandList();
+
+	// パイプラインとライトは一度だけセット
+	commandList->SetGraphicsRootSignature(rootSignature.Get());
+	commandList->SetPipelineState(graphicsPipelineState.Get());
+	commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	D3D12_GPU_VIRTUAL_ADDRESS directionalLightAddress = 0;
+	DirectionalLight* directionalLightData = dxCommon_->AllocateUpload<DirectionalLight>(1, &directionalLightAddress);
+	if (directionalLightData == nullptr) {
+		return;
+	}
+	*directionalLightData = directionalLight;
+	commandList->SetGraphicsRootConstantBufferView(3, directionalLightAddress);
+
+	// 前の描画と変わったものだけセットする（ModelDrawList::CountStateChangesと同じ数え方）
+	const ModelDrawList::DrawItem* previous = nullptr;
+	for (const ModelDrawList::DrawItem& item : items) {
+		if (previous == nullptr || previous->geometryIndex != item.geometryIndex) {
+			const Model* model = models[item.geometryIndex];
+			commandList->IASetVertexBuffers(0, 1, &model->GetVertexBufferView());
+			commandList->IASetIndexBuffer(&model->GetIndexBufferView());
+		}
+		if (previous == nullptr || previous->textureIndex != item.textureIndex) {
+			commandList->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSRVHandleGPU(item.textureIndex));
+		}
+		if (previous == nullptr || previous->materialIndex != item.materialIndex) {
+			commandList->SetGraphicsRootConstantBufferView(0, materialAddresses[item.materialIndex]);
+		}
+		if (previous == nullptr || previous->transformIndex != item.transformIndex) {
+			commandList->SetGraphicsRootConstantBufferView(1, transformAddresses[item.transformIndex]);
+		}
+		commandList->DrawIndexedInstanced(item.indexCount, 1, item.indexStart, 0, 0);
+		previous = &item;
+	}
+}
+
+void ModelCommon::CreateRootSignature() {
+
+	D3D12_ROOT_SIGNATURE_DESC description{};
+	description.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+	// テクスチャのDescriptorRange
+	D3D12_DESCRIPTOR_RANGE textureRange{};
+	textureRange.BaseShaderRegister = 0;
+	textureRange.NumDescriptors = 1;
+	textureRange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+	textureRange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+
+	// Spriteと同じ並び（マテリアル、座標変換、テクスチャ、平行光源）
+	D3D12_ROOT_PARAMETER parameters[4] = {};
+	parameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	parameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	parameters[0].Descriptor.ShaderRegister = 0;
+
+	parameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	parameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;
+	parameters[1].Descriptor.ShaderRegister = 0;
+
+	parameters[2].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+	parameters[2].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	parameters[2].DescriptorTable.pDescriptorRanges = &textureRange;
+	parameters[2].DescriptorTable.NumDescriptorRanges = 1;
+
+	parameters[3].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	parameters[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	parameters[3].Descriptor.ShaderRegister = 1;
+
+	description.pParameters = parameters;
+	description.NumParameters = _countof(parameters);
+
+	D3D12_STATIC_SAMPLER_DESC staticSamplers[1] = {};
+	staticSamplers[0].Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+	staticSamplers[0].AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	staticSamplers[0].AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	staticSamplers[0].AddressW = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	staticSamplers[0].ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
+	staticSamplers[0].MaxLOD = D3D12_FLOAT32_MAX;
+	staticSamplers[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
+	description.pStaticSamplers = staticSamplers;
+	description.NumStaticSamplers = _countof(staticSamplers);
+
+	Microsoft::WRL::ComPtr<ID3DBlob> signatureBlob;
+	Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+
+	HRESULT hr = D3D12SerializeRootSignature(
+		&description,
+		D3D_ROOT_SIGNATURE_VERSION_1,
+		&signatureBlob,
+		&errorBlob
+	);
+	assert(SUCCEEDED(hr));
+
+	hr = dxCommon_->GetDevice()->CreateRootSignature(
+		0,
+		signatureBlob->GetBufferPointer(),
+		signatureBlob->GetBufferSize(),
+		IID_PPV_ARGS(&rootSignature)
+	);
+	assert(SUCCEEDED(hr));
+}
+
+void ModelCommon::CreateGraphicsPipeline() {
+
+	// RootSignature を作成
+	CreateRootSignature();
+
+	// Shader
+	Microsoft::WRL::ComPtr <IDxcBlob> vsBlob = dxCommon_->CompileShader(
+		L"resources/shaders/Object3D.VS.hlsl", L"vs_6_0");
+	Microsoft::WRL::ComPtr <IDxcBlob> psBlob = dxCommon_->CompileShader(
+		L"resources/shaders/Object3D.PS.hlsl", L"ps_6_0");
+	assert(vsBlob && psBlob);
+
+	// InputLayout（ObjLoader::VertexDataと同じ並び）
+	D3D12_INPUT_ELEMENT_DESC inputElementDescs[3] = {};
+	inputElementDescs[0] = {
+		"POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT,
+		0, D3D12_APPEND_ALIGNED_ELEMENT,
+		D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0
+	};
+	inputElementDescs[1] = {
+		"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT,
+		0, D3D12_APPEND_ALIGNED_ELEMENT,
+		D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0
+	};
+	inputElementDescs[2] = {
+		"NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT,
+		0, D3D12_APPEND_ALIGNED_ELEMENT,
+		D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0
+	};
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC desc{};
+	desc.pRootSignature = rootSignature.Get();
+	desc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
+	desc.VS = { vsBlob->GetBufferPointer(), vsBlob->GetBufferSize() };
+	desc.PS = { psBlob->GetBufferPointer(), psBlob->GetBufferSize() };
+	desc.BlendState.RenderTarget[0].RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+
+	// 裏面（時計回りでない面）は描かない
+	desc.RasterizerState.FillMode = D3D12_FILL_MODE_SOLID;
+	desc.RasterizerState.CullMode = D3D12_CULL_MODE_BACK;
+	desc.RasterizerState.DepthClipEnable = TRUE;
+
+	// 深度を書き込み、近いものだけ描く
+	desc.DepthStencilState.DepthEnable = TRUE;
+	desc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
+	desc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS_EQUAL;
+	desc.DSVFormat = DXGI_FORMAT_D24_UNORM_S8_UINT;
+
+	desc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	desc.NumRenderTargets = 1;
+	desc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+	desc.SampleDesc.Count = 1;
+	desc.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+
+	HRESULT hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(
+		&desc,
+		IID_PPV_ARGS(&graphicsPipelineState));
+	assert(SUCCEEDED(hr));
+}
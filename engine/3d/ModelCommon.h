@@ -0,0 +1,117 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "DirectXCommon.h"
+#include "ModelDrawList.h"
+#include "Mymath.h"
+
+// 前方宣言
+class Model;
+class ThreadPool;
+class TransformSystem;
+
+// モデル描画の共通部分
+// Model::Drawはサブメッシュごとの描画を集めるだけで、DrawModelsで状態の切り替えが少ない順に並べてまとめて描く
+class ModelCommon {
+public:
+
+	// マテリアルデータ（Object3d.PS.hlslのMaterialと同じ並び）
+	struct Material {
+		Math::Vector4 color;
+		int32_t enableLighting;
+		float padding[3]; // パディングを追加して16バイト境界に揃える
+		Math::Matrix4x4 uvTranseform;
+	};
+
+	// 座標変換データ
+	struct TransfomationMatrix {
+		Math::Matrix4x4 WVP;
+		Math::Matrix4x4 World;
+	};
+
+	// 平行光源
+	struct DirectionalLight {
+		Math::Vector4 color; // ライトの色
+		Math::Vector3 direction; // ライトの向き
+		float intensity; // 輝度
+	};
+
+	// テクスチャの無いマテリアルに使うテクスチャ
+	static const std::string kDefaultTextureFilePath;
+
+	void Initialize(DirectXCommon* dxCommon);
+
+	DirectXCommon* GetDirectXCommon() { return dxCommon_; }
+
+	// モデルを登録して番号をもらう（頂点・インデックスバッファを切り替えるかの判定に使う）
+	uint32_t RegisterModel(Model* model);
+
+	// マテリアルの定数バッファを登録して番号をもらう
+	uint32_t RegisterMaterial(D3D12_GPU_VIRTUAL_ADDRESS materialAddress);
+
+	// 共通描画設定（パイプラインを設定して描画の収集を始める）
+	void SetCommonDrawSetting(const Math::Matrix4x4& viewProjectionMatrix);
+
+	// 座標変換を確保できなかったときの番号
+	static const uint32_t kInvalidTransform = UINT32_MAX;
+
+	// 描くモデルの座標変換を今のフレームのアップロード領域に書き込み、番号を返す
+	// アップロード領域が足りなければkInvalidTransformを返すので、そのモデルは描かない
+	uint32_t AddTransform(const Math::Matrix4x4& worldMatrix);
+
+	// TransformSystemの全部の座標変換を今のフレームのアップロード領域へ直接計算し、最初の番号を返す
+	// i番目の番号は戻り値+iになる（足りなければkInvalidTransformを返すので、どれも描かない）
+	uint32_t AddTransforms(const TransformSystem& transforms, ThreadPool* threadPool = nullptr);
+
+	// サブメッシュの描画を追加
+	void SubmitDraw(const ModelDrawList::DrawItem& item) { drawList.Submit(item); }
+
+	// 集めた描画を並べ替えて描く
+	void DrawModels();
+
+	// 並べ替えるか（計測用。falseなら追加した順に描く）
+	bool IsSortEnabled() const { return isSortEnabled; }
+	void SetSortEnabled(bool isEnabled) { isSortEnabled = isEnabled; }
+
+	// 平行光源
+	const DirectionalLight& GetDirectionalLight() const { return directionalLight; }
+	void SetDirectionalLight(const DirectionalLight& light) { directionalLight = light; }
+
+	// 前のフレームの描画（描画数と状態の切り替え回数）
+	const ModelDrawList& GetDrawList() const { return drawList; }
+
+private:
+
+	DirectXCommon* dxCommon_;
+
+	// ルートシグネチャー
+	Microsoft::WRL::ComPtr <ID3D12RootSignature> rootSignature = nullptr;
+
+	// PSO
+	Microsoft::WRL::ComPtr <ID3D12PipelineState> graphicsPipelineState = nullptr;
+
+	// 登録されたモデル（番号はRegisterModelの戻り値）
+	std::vector<Model*> models;
+
+	// 登録されたマテリアルの定数バッファ（番号はRegisterMaterialの戻り値）
+	std::vector<D3D12_GPU_VIRTUAL_ADDRESS> materialAddresses;
+
+	// 今のフレームの座標変換
+	std::vector<D3D12_GPU_VIRTUAL_ADDRESS> transformAddresses;
+
+	// 今のフレームのビュー・プロジェクション行列
+	Math::Matrix4x4 viewProjection = {};
+
+	// 平行光源
+	DirectionalLight directionalLight = { { 1.0f,1.0f,1.0f,1.0f }, { 0.0f,-1.0f,0.0f }, 1.0f };
+
+	// 描画の並べ替え
+	ModelDrawList drawList;
+	bool isSortEnabled = true;
+
+	// ルートシグネチャーの作成
+	void CreateRootSignature();
+
+	// グラフィックスパイプラインの作成
+	void CreateGraphicsPipeline();
+};
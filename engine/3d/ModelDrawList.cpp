@@ -0,0 +1,62 @@
+#include "ModelDrawList.h"
+#include <algorithm>
+#include <chrono>
+
+void ModelDrawList::Begin() {
+	// 前のフレームの内容を破棄（容量は使い回す）
+	items.clear();
+	sortedItems.clear();
+}
+
+void ModelDrawList::Submit(const DrawItem& item) {
+	items.push_back(item);
+}
+
+void ModelDrawList::End(bool isSorted) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	sortedItems = items;
+	if (isSorted) {
+		// 切り替えの重いものから順に比べる（同じものの中は追加した順を保つ）
+		std::stable_sort(sortedItems.begin(), sortedItems.end(),
+			[](const DrawItem& a, const DrawItem& b) {
+				if (a.textureIndex != b.textureIndex) {
+					return a.textureIndex < b.textureIndex;
+				}
+				if (a.materialIndex != b.materialIndex) {
+					return a.materialIndex < b.materialIndex;
+				}
+				if (a.geometryIndex != b.geometryIndex) {
+					return a.geometryIndex < b.geometryIndex;
+				}
+				return a.transformIndex < b.transformIndex;
+			});
+	}
+	stateChanges = CountStateChanges(sortedItems.data(), sortedItems.size());
+	submittedStateChanges = CountStateChanges(items.data(), items.size());
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	buildMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+ModelDrawList::StateChanges ModelDrawList::CountStateChanges(const DrawItem* items, size_t count) {
+	StateChanges changes;
+	for (size_t i = 0; i < count; ++i) {
+		// 最初の描画は全部セットする
+		const DrawItem& item = items[i];
+		const DrawItem* previous = i > 0 ? &items[i - 1] : nullptr;
+		if (previous == nullptr || previous->geometryIndex != item.geometryIndex) {
+			changes.geometry++;
+		}
+		if (previous == nullptr || previous->textureIndex != item.textureIndex) {
+			changes.texture++;
+		}
+		if (previous == nullptr || previous->materialIndex != item.materialIndex) {
+			changes.material++;
+		}
+		if (previous == nullptr || previous->transformIndex != item.transformIndex) {
+			changes.transform++;
+		}
+	}
+	return changes;
+}
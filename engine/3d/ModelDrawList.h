@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// モデルのサブメッシュの描画を集めて、状態の切り替えが少なくなる順に並べ替えるクラス
+// テクスチャ→マテリアル→頂点・インデックスバッファ→座標変換の順に並べ、それぞれが変わった回数を数える
+// GPUに依存しないので単体で計測できる
+class ModelDrawList {
+public:
+
+	// サブメッシュ一つ分の描画
+	struct DrawItem {
+		uint32_t geometryIndex;  // 頂点・インデックスバッファ（モデルの番号）
+		uint32_t textureIndex;   // テクスチャ番号
+		uint32_t materialIndex;  // マテリアルの定数バッファ（全モデルを通した番号）
+		uint32_t transformIndex; // 座標変換（描くモデルの番号）
+		uint32_t indexStart;
+		uint32_t indexCount;
+	};
+
+	// 状態を切り替えた回数
+	struct StateChanges {
+		uint32_t geometry = 0;  // IASetVertexBuffers/IASetIndexBuffer
+		uint32_t texture = 0;   // SRVのDescriptorTable
+		uint32_t material = 0;  // マテリアルのCBV
+		uint32_t transform = 0; // 座標変換のCBV
+
+		// 全部の合計
+		uint32_t GetTotal() const { return geometry + texture + material + transform; }
+	};
+
+	// 収集開始
+	void Begin();
+
+	// 描画を追加
+	void Submit(const DrawItem& item);
+
+	// 並べ替える（isSortedがfalseなら追加した順のまま）
+	void End(bool isSorted = true);
+
+	// 描く順の描画
+	const std::vector<DrawItem>& GetDrawItems() const { return sortedItems; }
+
+	// 描く順で切り替えが起きる回数と、追加した順に描いた場合の回数
+	const StateChanges& GetStateChanges() const { return stateChanges; }
+	const StateChanges& GetSubmittedStateChanges() const { return submittedStateChanges; }
+
+	// 並べた順に描いたときの切り替え回数を数える
+	static StateChanges CountStateChanges(const DrawItem* items, size_t count);
+
+	// 追加された描画数
+	uint32_t GetDrawCount() const { return static_cast<uint32_t>(items.size()); }
+
+	// Endにかかった時間（ミリ秒）
+	double GetBuildMilliseconds() const { return buildMilliseconds; }
+
+private:
+
+	// 追加された順の描画
+	std::vector<DrawItem> items;
+
+	// 描く順の描画
+	std::vector<DrawItem> sortedItems;
+
+	// 切り替え回数
+	StateChanges stateChanges;
+	StateChanges submittedStateChanges;
+
+	// 計測時間
+	double buildMilliseconds = 0.0;
+};
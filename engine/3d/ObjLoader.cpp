@@ -0,0 +1,532 @@
+#include "ObjLoader.h"
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include "MappedFile.h"
+#include "ThreadPool.h"
+
+using namespace Math;
+
+namespace {
+
+	// 行の種類
+	enum class LineType {
+		kPosition,        // v
+		kTexcoord,        // vt
+		kNormal,          // vn
+		kFace,            // f
+		kMaterialLibrary, // mtllib
+		kObject,          // o
+		kGroup,           // g
+		kUseMaterial,     // usemtl
+		kOther,
+	};
+
+	// 描画範囲を区切る行（o/g/usemtl）とmtllib
+	struct GroupEvent {
+		LineType type;
+		uint32_t triangle; // この行より前にある塊の中の三角形数
+		const char* name;  // 引数（前後の空白を除く）
+		const char* nameEnd;
+	};
+
+	// 解析する塊（行の途中では切らない）
+	struct Chunk {
+		const char* begin = nullptr;
+		const char* end = nullptr;
+
+		// この塊にある数
+		uint32_t positionCount = 0;
+		uint32_t texcoordCount = 0;
+		uint32_t normalCount = 0;
+		uint32_t triangleCount = 0;
+
+		// 前の塊までの数（書き込み開始位置）
+		uint32_t positionStart = 0;
+		uint32_t texcoordStart = 0;
+		uint32_t normalStart = 0;
+		uint32_t triangleStart = 0;
+
+		// この塊にあるo/g/usemtl/mtllib（出てきた順）
+		std::vector<GroupEvent> events;
+	};
+
+	inline bool IsSpace(char c) {
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	// 空白を飛ばす
+	inline const char* SkipSpace(const char* p, const char* lineEnd) {
+		while (p < lineEnd && IsSpace(*p)) {
+			++p;
+		}
+		return p;
+	}
+
+	// 空白以外を飛ばす
+	inline const char* SkipToken(const char* p, const char* lineEnd) {
+		while (p < lineEnd && !IsSpace(*p)) {
+			++p;
+		}
+		return p;
+	}
+
+	// 末尾の空白を除いた終わり
+	inline const char* TrimEnd(const char* begin, const char* lineEnd) {
+		while (lineEnd > begin && IsSpace(lineEnd[-1])) {
+			--lineEnd;
+		}
+		return lineEnd;
+	}
+
+	// 改行の位置（なければend）
+	inline const char* FindLineEnd(const char* p, const char* end) {
+		const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+		return lineEnd != nullptr ? lineEnd : end;
+	}
+
+	// 行頭のキーワードを調べて、引数の先頭を返す
+	inline LineType ClassifyLine(const char*& p, const char* lineEnd) {
+		p = SkipSpace(p, lineEnd);
+		const char* keywordEnd = SkipToken(p, lineEnd);
+		size_t length = keywordEnd - p;
+		LineType type = LineType::kOther;
+		if (length == 1 && p[0] == 'v') {
+			type = LineType::kPosition;
+		} else if (length == 1 && p[0] == 'f') {
+			type = LineType::kFace;
+		} else if (length == 2 && p[0] == 'v' && p[1] == 't') {
+			type = LineType::kTexcoord;
+		} else if (length == 2 && p[0] == 'v' && p[1] == 'n') {
+			type = LineType::kNormal;
+		} else if (length == 1 && p[0] == 'o') {
+			type = LineType::kObject;
+		} else if (length == 1 && p[0] == 'g') {
+			type = LineType::kGroup;
+		} else if (length == 6 && std::memcmp(p, "mtllib", 6) == 0) {
+			type = LineType::kMaterialLibrary;
+		} else if (length == 6 && std::memcmp(p, "usemtl", 6) == 0) {
+			type = LineType::kUseMaterial;
+		}
+		p = keywordEnd;
+		return type;
+	}
+
+	// 浮動小数を読む（読めなければ0）
+	inline const char* ParseFloat(const char* p, const char* lineEnd, float& value) {
+		p = SkipSpace(p, lineEnd);
+		if (p < lineEnd && *p == '+') {
+			++p;
+		}
+		std::from_chars_result result = std::from_chars(p, lineEnd, value);
+		if (result.ec != std::errc()) {
+			value = 0.0f;
+		}
+		return result.ptr;
+	}
+
+	// 整数を読む（読めなければ0）
+	inline const char* ParseInt(const char* p, const char* tokenEnd, int32_t& value) {
+		std::from_chars_result result = std::from_chars(p, tokenEnd, value);
+		if (result.ec != std::errc()) {
+			value = 0;
+		}
+		return result.ptr;
+	}
+
+	// Objのインデックス（1始まり、負の数は直前からの相対）を0始まりにする。範囲外は-1
+	inline int32_t ResolveIndex(int32_t index, uint32_t definedCount, uint32_t totalCount) {
+		int64_t resolved = -1;
+		if (index > 0) {
+			resolved = int64_t(index) - 1;
+		} else if (index < 0) {
+			resolved = int64_t(definedCount) + index;
+		}
+		return (resolved >= 0 && resolved < int64_t(totalCount)) ? int32_t(resolved) : -1;
+	}
+
+	// 面の頂点一つ分（位置/UV/法線。無いものは-1）
+	struct FaceVertex {
+		int32_t position;
+		int32_t texcoord;
+		int32_t normal;
+	};
+
+	// 塊ごとに処理する（threadPoolがなければ順に）
+	template <typename Function>
+	void ForEachChunk(std::vector<Chunk>& chunks, ThreadPool* threadPool, const Function& function) {
+		if (threadPool == nullptr || chunks.size() <= 1) {
+			for (Chunk& chunk : chunks) {
+				function(chunk);
+			}
+			return;
+		}
+		threadPool->ParallelFor(static_cast<uint32_t>(chunks.size()), 1, [&chunks, &function](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; ++i) {
+				function(chunks[i]);
+			}
+		});
+	}
+
+	// 1段目: 数を数える
+	void CountChunk(Chunk& chunk) {
+		for (const char* p = chunk.begin; p < chunk.end;) {
+			const char* lineEnd = FindLineEnd(p, chunk.end);
+			LineType type = ClassifyLine(p, lineEnd);
+			switch (type) {
+			case LineType::kPosition: chunk.positionCount++; break;
+			case LineType::kTexcoord: chunk.texcoordCount++; break;
+			case LineType::kNormal: chunk.normalCount++; break;
+			case LineType::kFace: {
+				// 頂点がn個ならn-2個の三角形に分ける
+				uint32_t vertexCount = 0;
+				for (p = SkipSpace(p, lineEnd); p < lineEnd; p = SkipSpace(SkipToken(p, lineEnd), lineEnd)) {
+					vertexCount++;
+				}
+				if (vertexCount >= 3) {
+					chunk.triangleCount += vertexCount - 2;
+				}
+				break;
+			}
+			case LineType::kMaterialLibrary:
+			case LineType::kObject:
+			case LineType::kGroup:
+			case LineType::kUseMaterial: {
+				const char* name = SkipSpace(p, lineEnd);
+				chunk.events.push_back({ type, chunk.triangleCount, name, TrimEnd(name, lineEnd) });
+				break;
+			}
+			default:
+				break;
+			}
+			p = lineEnd + 1;
+		}
+	}
+
+	// 2段目: 位置・UV・法線を読む
+	void ParseAttributeChunk(const Chunk& chunk, Vector4* positions, Vector2* texcoords, Vector3* normals) {
+		Vector4* position = positions + chunk.positionStart;
+		Vector2* texcoord = texcoords + chunk.texcoordStart;
+		Vector3* normal = normals + chunk.normalStart;
+		for (const char* p = chunk.begin; p < chunk.end;) {
+			const char* lineEnd = FindLineEnd(p, chunk.end);
+			switch (ClassifyLine(p, lineEnd)) {
+			case LineType::kPosition:
+				p = ParseFloat(p, lineEnd, position->x);
+				p = ParseFloat(p, lineEnd, position->y);
+				p = ParseFloat(p, lineEnd, position->z);
+				position->x *= -1.0f; // X軸を反転する（DirectXとOpenGLで座標系が異なるため）
+				position->w = 1.0f;
+				++position;
+				break;
+			case LineType::kTexcoord:
+				p = ParseFloat(p, lineEnd, texcoord->x);
+				p = ParseFloat(p, lineEnd, texcoord->y);
+				texcoord->y = 1.0f - texcoord->y; // OpenGLとDirectXでY軸の方向が逆なので反転
+				++texcoord;
+				break;
+			case LineType::kNormal:
+				p = ParseFloat(p, lineEnd, normal->x);
+				p = ParseFloat(p, lineEnd, normal->y);
+				p = ParseFloat(p, lineEnd, normal->z);
+				normal->x *= -1.0f; // 法線も反転する
+				++normal;
+				break;
+			default:
+				break;
+			}
+			p = lineEnd + 1;
+		}
+	}
+
+	// 3段目: 面を読んで三角形の頂点を書き込む
+	void ParseFaceChunk(const Chunk& chunk, const std::vector<Vector4>& positions,
+		const std::vector<Vector2>& texcoords, const std::vector<Vector3>& normals, ObjLoader::VertexData* vertices) {
+
+		const uint32_t positionTotal = static_cast<uint32_t>(positions.size());
+		const uint32_t texcoordTotal = static_cast<uint32_t>(texcoords.size());
+		const uint32_t normalTotal = static_cast<uint32_t>(normals.size());
+
+		// 負のインデックスのために、ここまでに定義された数を数えておく
+		uint32_t positionDefined = chunk.positionStart;
+		uint32_t texcoordDefined = chunk.texcoordStart;
+		uint32_t normalDefined = chunk.normalStart;
+
+		ObjLoader::VertexData* output = vertices + size_t(chunk.triangleStart) * 3;
+		for (const char* p = chunk.begin; p < chunk.end;) {
+			const char* lineEnd = FindLineEnd(p, chunk.end);
+			switch (ClassifyLine(p, lineEnd)) {
+			case LineType::kPosition: positionDefined++; break;
+			case LineType::kTexcoord: texcoordDefined++; break;
+			case LineType::kNormal: normalDefined++; break;
+			case LineType::kFace: {
+				// 多角形は最初の頂点を中心に扇状に分ける
+				FaceVertex first{}, previous{};
+				uint32_t vertexCount = 0;
+				for (p = SkipSpace(p, lineEnd); p < lineEnd; p = SkipSpace(p, lineEnd)) {
+					const char* tokenEnd = SkipToken(p, lineEnd);
+
+					// 「位置/UV/法線」の順。UVと法線は省略されることがある
+					int32_t indices[3] = {};
+					for (int32_t element = 0; element < 3 && p < tokenEnd; ++element) {
+						if (*p != '/') {
+							p = ParseInt(p, tokenEnd, indices[element]);
+						}
+						const char* slash = static_cast<const char*>(std::memchr(p, '/', tokenEnd - p));
+						p = slash != nullptr ? slash + 1 : tokenEnd;
+					}
+					p = tokenEnd;
+
+					FaceVertex current = {
+						ResolveIndex(indices[0], positionDefined, positionTotal),
+						ResolveIndex(indices[1], texcoordDefined, texcoordTotal),
+						ResolveIndex(indices[2], normalDefined, normalTotal) };
+					if (vertexCount == 0) {
+						first = current;
+					} else if (vertexCount >= 2) {
+						// 頂点を逆順に登録する
+						const FaceVertex* corners[3] = { &current, &previous, &first };
+						for (int32_t corner = 0; corner < 3; ++corner) {
+							const FaceVertex& faceVertex = *corners[corner];
+							ObjLoader::VertexData& vertex = output[corner];
+							vertex.position = faceVertex.position >= 0 ? positions[faceVertex.position] : Vector4{ 0.0f,0.0f,0.0f,1.0f };
+							vertex.texcoord = faceVertex.texcoord >= 0 ? texcoords[faceVertex.texcoord] : Vector2{ 0.0f,0.0f };
+							vertex.normal = faceVertex.normal >= 0 ? normals[faceVertex.normal] : Vector3{ 0.0f,0.0f,0.0f };
+						}
+
+						// 法線が無い頂点は面の法線にする
+						if (current.normal < 0 || previous.normal < 0 || first.normal < 0) {
+							const Vector4& p0 = output[0].position;
+							const Vector4& p1 = output[1].position;
+							const Vector4& p2 = output[2].position;
+							float ax = p1.x - p0.x, ay = p1.y - p0.y, az = p1.z - p0.z;
+							float bx = p2.x - p0.x, by = p2.y - p0.y, bz = p2.z - p0.z;
+							Vector3 faceNormal = { ay * bz - az * by, az * bx - ax * bz, ax * by - ay * bx };
+							float length = std::sqrt(faceNormal.x * faceNormal.x + faceNormal.y * faceNormal.y + faceNormal.z * faceNormal.z);
+							if (length != 0.0f) {
+								faceNormal = { faceNormal.x / length, faceNormal.y / length, faceNormal.z / length };
+							}
+							for (int32_t corner = 0; corner < 3; ++corner) {
+								if (corners[corner]->normal < 0) {
+									output[corner].normal = faceNormal;
+								}
+							}
+						}
+						output += 3;
+					}
+					previous = current;
+					vertexCount++;
+				}
+				break;
+			}
+			default:
+				break;
+			}
+			p = lineEnd + 1;
+		}
+	}
+
+	// テキストを行の途中で切らないように塊に分ける
+	std::vector<Chunk> SplitChunks(const char* text, size_t size, size_t chunkSize) {
+		std::vector<Chunk> chunks;
+		const char* end = text + size;
+		for (const char* begin = text; begin < end;) {
+			const char* chunkEnd = end;
+			if (size_t(end - begin) > chunkSize) {
+				chunkEnd = FindLineEnd(begin + chunkSize, end);
+				chunkEnd = chunkEnd < end ? chunkEnd + 1 : end;
+			}
+			Chunk chunk;
+			chunk.begin = begin;
+			chunk.end = chunkEnd;
+			chunks.push_back(chunk);
+			begin = chunkEnd;
+		}
+		return chunks;
+	}
+}
+
+ObjLoader::ModelData ObjLoader::LoadObjFile(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool) {
+	// ファイルをメモリにマップする
+	MappedFile file;
+	bool isOpened = file.Open(directoryPath + "/" + filename);
+	assert(isOpened);
+
+	return ParseObj(file.GetData(), file.GetSize(), directoryPath, threadPool);
+}
+
+ObjLoader::ModelData ObjLoader::ParseObj(const char* text, size_t size, const std::string& directoryPath,
+	ThreadPool* threadPool, size_t chunkSize) {
+
+	ModelData modelData;
+
+	// 並行しないときは全体を一つの塊にする
+	std::vector<Chunk> chunks;
+	if (size != 0) {
+		chunks = SplitChunks(text, size, threadPool != nullptr ? chunkSize : size);
+	}
+
+	// 1段目: 数を数えて、各塊の書き込み開始位置を決める
+	ForEachChunk(chunks, threadPool, [](Chunk& chunk) { CountChunk(chunk); });
+	uint32_t positionCount = 0, texcoordCount = 0, normalCount = 0, triangleCount = 0;
+	for (Chunk& chunk : chunks) {
+		chunk.positionStart = positionCount;
+		chunk.texcoordStart = texcoordCount;
+		chunk.normalStart = normalCount;
+		chunk.triangleStart = triangleCount;
+		positionCount += chunk.positionCount;
+		texcoordCount += chunk.texcoordCount;
+		normalCount += chunk.normalCount;
+		triangleCount += chunk.triangleCount;
+	}
+
+	// 2段目: 位置・UV・法線を読む
+	std::vector<Vector4> positions(positionCount);
+	std::vector<Vector2> texcoords(texcoordCount);
+	std::vector<Vector3> normals(normalCount);
+	ForEachChunk(chunks, threadPool, [&](Chunk& chunk) {
+		ParseAttributeChunk(chunk, positions.data(), texcoords.data(), normals.data());
+	});
+
+	// 3段目: 面を読む
+	modelData.vertices.resize(size_t(triangleCount) * 3);
+	ForEachChunk(chunks, threadPool, [&](Chunk& chunk) {
+		ParseFaceChunk(chunk, positions, texcoords, normals, modelData.vertices.data());
+	});
+
+	// o/g/usemtlの位置で描画範囲に分ける（マテリアルは名前で持っておき、Mtlを読んでから番号にする）
+	std::vector<std::string> materialLibraries;
+	std::vector<std::string> submeshMaterialNames;
+	std::string objectName, groupName, materialName;
+	uint32_t rangeStart = 0;
+	auto closeRange = [&](uint32_t rangeEnd) {
+		if (rangeEnd == rangeStart) {
+			return;
+		}
+		const std::string& name = groupName.empty() ? objectName : groupName;
+		if (!modelData.submeshes.empty() && modelData.submeshes.back().name == name &&
+			submeshMaterialNames.back() == materialName) {
+			// 同じ名前とマテリアルが続くならつなげる
+			modelData.submeshes.back().vertexCount += (rangeEnd - rangeStart) * 3;
+		} else {
+			SubmeshData& submesh = modelData.submeshes.emplace_back();
+			submesh.name = name;
+			submesh.vertexStart = rangeStart * 3;
+			submesh.vertexCount = (rangeEnd - rangeStart) * 3;
+			submeshMaterialNames.push_back(materialName);
+		}
+		rangeStart = rangeEnd;
+	};
+	for (const Chunk& chunk : chunks) {
+		for (const GroupEvent& event : chunk.events) {
+			closeRange(chunk.triangleStart + event.triangle);
+			switch (event.type) {
+			case LineType::kObject:
+				objectName.assign(event.name, event.nameEnd);
+				groupName.clear();
+				break;
+			case LineType::kGroup:
+				groupName.assign(event.name, event.nameEnd);
+				break;
+			case LineType::kUseMaterial:
+				materialName.assign(event.name, event.nameEnd);
+				break;
+			case LineType::kMaterialLibrary:
+				// 空白区切りで複数書ける
+				for (const char* p = event.name; p < event.nameEnd; p = SkipSpace(p, event.nameEnd)) {
+					const char* nameEnd = SkipToken(p, event.nameEnd);
+					std::string library(p, nameEnd);
+					if (std::find(materialLibraries.begin(), materialLibraries.end(), library) == materialLibraries.end()) {
+						materialLibraries.push_back(library);
+					}
+					p = nameEnd;
+				}
+				break;
+			default:
+				break;
+			}
+		}
+	}
+	closeRange(triangleCount);
+
+	// マテリアルファイルの読み込み（同じ名前は先に読んだものを使う）
+	for (const std::string& library : materialLibraries) {
+		for (MaterialData& material : LoadMaterialTemplateFile(directoryPath, library)) {
+			bool isDefined = std::any_of(modelData.materials.begin(), modelData.materials.end(),
+				[&material](const MaterialData& defined) { return defined.name == material.name; });
+			if (!isDefined) {
+				modelData.materials.push_back(std::move(material));
+			}
+		}
+	}
+
+	// usemtlより前の面は最初のマテリアルで描く
+	if (modelData.materials.empty()) {
+		modelData.materials.emplace_back();
+	}
+
+	// マテリアルの名前を番号にする（Mtlに無いものは白の既定のものを足す）
+	for (size_t i = 0; i < modelData.submeshes.size(); ++i) {
+		const std::string& name = submeshMaterialNames[i];
+		if (name.empty()) {
+			modelData.submeshes[i].materialIndex = 0;
+			continue;
+		}
+		auto found = std::find_if(modelData.materials.begin(), modelData.materials.end(),
+			[&name](const MaterialData& material) { return material.name == name; });
+		if (found == modelData.materials.end()) {
+			modelData.materials.emplace_back().name = name;
+			found = modelData.materials.end() - 1;
+		}
+		modelData.submeshes[i].materialIndex = static_cast<uint32_t>(found - modelData.materials.begin());
+	}
+	return modelData;
+}
+
+std::vector<ObjLoader::MaterialData> ObjLoader::LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename) {
+	// ファイルをメモリにマップする
+	MappedFile file;
+	bool isOpened = file.Open(directoryPath + "/" + filename);
+	assert(isOpened);
+
+	return ParseMaterialTemplate(file.GetData(), file.GetSize(), directoryPath);
+}
+
+std::vector<ObjLoader::MaterialData> ObjLoader::ParseMaterialTemplate(const char* text, size_t size, const std::string& directoryPath) {
+	std::vector<MaterialData> materials;
+	const char* end = text + size;
+	for (const char* p = text; p < end;) {
+		const char* lineEnd = FindLineEnd(p, end);
+		p = SkipSpace(p, lineEnd);
+		const char* keywordEnd = SkipToken(p, lineEnd);
+		size_t length = keywordEnd - p;
+
+		// newmtlより前に書かれたものは名前の無いマテリアルに入れる
+		bool isMaterialLine = (length == 6 && std::memcmp(p, "map_Kd", 6) == 0) || (length == 2 && p[0] == 'K' && p[1] == 'd');
+		if (isMaterialLine && materials.empty()) {
+			materials.emplace_back();
+		}
+
+		// identifierに応じた処理
+		if (length == 6 && std::memcmp(p, "newmtl", 6) == 0) {
+			// 新しいマテリアルを始める
+			const char* name = SkipSpace(keywordEnd, lineEnd);
+			materials.emplace_back().name.assign(name, TrimEnd(name, lineEnd));
+		} else if (length == 6 && std::memcmp(p, "map_Kd", 6) == 0) {
+			// 連結して、ファイルパスにする
+			const char* name = SkipSpace(keywordEnd, lineEnd);
+			materials.back().textureFilePath = directoryPath + "/" + std::string(name, SkipToken(name, lineEnd));
+		} else if (length == 2 && p[0] == 'K' && p[1] == 'd') {
+			// 拡散反射色をcolorに設定、アルファ値は1.0固定
+			MaterialData& materialData = materials.back();
+			p = ParseFloat(keywordEnd, lineEnd, materialData.color.x);
+			p = ParseFloat(p, lineEnd, materialData.color.y);
+			p = ParseFloat(p, lineEnd, materialData.color.z);
+			materialData.color.w = 1.0f;
+		}
+		p = lineEnd + 1;
+	}
+	return materials;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Mymath.h"
+
+// 前方宣言
+class ThreadPool;
+
+// Objファイルを読み込むクラス
+// ファイルはメモリにマップし、行ごとの文字列を作らずにその場で数値へ変換する
+// 数える→属性を読む→面を読むの3段階で、配列は最初に一度だけ確保する
+// o/g/usemtlで区切られた面は、一つの頂点列の中の描画範囲（サブメッシュ）として残す
+class ObjLoader {
+public:
+
+	// 頂点データ（シェーダーのVertexShaderInputと同じ並び）
+	struct VertexData {
+		Math::Vector4 position;
+		Math::Vector2 texcoord;
+		Math::Vector3 normal;
+	};
+
+	// マテリアルデータ
+	struct MaterialData {
+		std::string name; // newmtlの名前
+		std::string textureFilePath; // テクスチャファイルのパス
+		Math::Vector4 color = { 1.0f,1.0f,1.0f,1.0f }; // 拡散反射色
+	};
+
+	// 描画範囲（同じ名前・同じマテリアルで連続する三角形）
+	struct SubmeshData {
+		std::string name; // gの名前（無ければoの名前）
+		uint32_t vertexStart = 0; // verticesの中の開始位置（まとめた後のインデックスの位置と同じ）
+		uint32_t vertexCount = 0;
+		uint32_t materialIndex = 0; // materialsの番号
+	};
+
+	// モデルデータ（三角形ごとに3頂点）
+	struct ModelData {
+		std::vector<VertexData> vertices; // 頂点データ
+		std::vector<SubmeshData> submeshes; // 描画範囲（面があれば一つ以上、ファイルに出てきた順）
+		std::vector<MaterialData> materials; // マテリアルの表（一つ以上。Mtlが無ければ白の既定のもの）
+	};
+
+	// 並行に解析するときの1塊あたりのバイト数の目安（行の途中では切らない）
+	static const size_t kDefaultChunkSize = 1u << 20;
+
+	// Objファイルを読み込む（threadPoolを渡すと塊ごとに並行で解析する）
+	static ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename,
+		ThreadPool* threadPool = nullptr);
+
+	// メモリ上のObjテキストを解析する（mtllibはdirectoryPathから読む）
+	static ModelData ParseObj(const char* text, size_t size, const std::string& directoryPath,
+		ThreadPool* threadPool = nullptr, size_t chunkSize = kDefaultChunkSize);
+
+	// マテリアルファイルを読み込む（newmtlごとに一つ）
+	static std::vector<MaterialData> LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename);
+
+	// メモリ上のMtlテキストを解析する
+	static std::vector<MaterialData> ParseMaterialTemplate(const char* text, size_t size, const std::string& directoryPath);
+};
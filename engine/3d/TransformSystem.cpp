@@ -0,0 +1,249 @@
+#include "TransformSystem.h"
+#include "ThreadPool.h"
+#include <cassert>
+
+#if MATH_USE_SIMD
+#include <emmintrin.h>
+#endif
+
+using namespace Math;
+
+#if MATH_USE_SIMD
+namespace {
+
+	// 4つ分のsinとcosを一度に求める（Cephesの多項式近似。|x| < 8192程度で誤差は数ULP）
+	void SinCos(__m128 x, __m128& outSin, __m128& outCos) {
+		const __m128 kSignMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000)));
+
+		// 符号を外して、pi/4単位でどの区間にいるかを求める
+		__m128 signSin = _mm_and_ps(x, kSignMask);
+		x = _mm_andnot_ps(kSignMask, x);
+		__m128i quadrant = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+		quadrant = _mm_and_si128(_mm_add_epi32(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+		__m128 y = _mm_cvtepi32_ps(quadrant);
+
+		// 区間によってsinとcosの符号と、どちらの多項式を使うかが変わる
+		__m128 swapSignSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(4)), 29));
+		__m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(2)), _mm_setzero_si128()));
+		__m128 signCos = _mm_castsi128_ps(_mm_slli_epi32(
+			_mm_andnot_si128(_mm_sub_epi32(quadrant, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		signSin = _mm_xor_ps(signSin, swapSignSin);
+
+		// [-pi/4, pi/4]に縮める（pi/4を3つに分けて精度を保つ）
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+		__m128 z = _mm_mul_ps(x, x);
+
+		// cosの多項式
+		__m128 polyCos = _mm_set1_ps(2.443315711809948e-5f);
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(-1.388731625493765e-3f));
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(4.166664568298827e-2f));
+		polyCos = _mm_mul_ps(_mm_mul_ps(polyCos, z), z);
+		polyCos = _mm_sub_ps(polyCos, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		polyCos = _mm_add_ps(polyCos, _mm_set1_ps(1.0f));
+
+		// sinの多項式
+		__m128 polySin = _mm_set1_ps(-1.9515295891e-4f);
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(8.3321608736e-3f));
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(-1.6666654611e-1f));
+		polySin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(polySin, z), x), x);
+
+		// 区間に合わせて入れ替えて符号をつける
+		__m128 sinValue = _mm_or_ps(_mm_and_ps(polyMask, polySin), _mm_andnot_ps(polyMask, polyCos));
+		__m128 cosValue = _mm_or_ps(_mm_and_ps(polyMask, polyCos), _mm_andnot_ps(polyMask, polySin));
+		outSin = _mm_xor_ps(sinValue, signSin);
+		outCos = _mm_xor_ps(cosValue, signCos);
+	}
+
+	// 4つ分のSRT（要素ごと）から4つ分のWVPとワールド行列を作る
+	void UpdateFour(const float* scaleX, const float* scaleY, const float* scaleZ,
+		const float* rotateX, const float* rotateY, const float* rotateZ,
+		const float* translateX, const float* translateY, const float* translateZ,
+		const __m128 viewProjection[4][4], unsigned char* output, size_t outputStride) {
+
+		__m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+		SinCos(_mm_loadu_ps(rotateX), sinX, cosX);
+		SinCos(_mm_loadu_ps(rotateY), sinY, cosY);
+		SinCos(_mm_loadu_ps(rotateZ), sinZ, cosZ);
+
+		// 回転行列（Y * X * Z）を展開した式で、4つ分の各要素を作る（MakeAffineMatrixと同じ式）
+		__m128 sinYsinX = _mm_mul_ps(sinY, sinX);
+		__m128 cosYsinX = _mm_mul_ps(cosY, sinX);
+		__m128 scale[3] = { _mm_loadu_ps(scaleX), _mm_loadu_ps(scaleY), _mm_loadu_ps(scaleZ) };
+		__m128 world[4][4];
+		world[0][0] = _mm_sub_ps(_mm_mul_ps(cosY, cosZ), _mm_mul_ps(sinYsinX, sinZ));
+		world[0][1] = _mm_add_ps(_mm_mul_ps(cosY, sinZ), _mm_mul_ps(sinYsinX, cosZ));
+		world[0][2] = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sinY, cosX));
+		world[1][0] = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(cosX, sinZ));
+		world[1][1] = _mm_mul_ps(cosX, cosZ);
+		world[1][2] = sinX;
+		world[2][0] = _mm_add_ps(_mm_mul_ps(sinY, cosZ), _mm_mul_ps(cosYsinX, sinZ));
+		world[2][1] = _mm_sub_ps(_mm_mul_ps(sinY, sinZ), _mm_mul_ps(cosYsinX, cosZ));
+		world[2][2] = _mm_mul_ps(cosY, cosX);
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				world[i][j] = _mm_mul_ps(scale[i], world[i][j]);
+			}
+			world[i][3] = _mm_setzero_ps();
+		}
+		world[3][0] = _mm_loadu_ps(translateX);
+		world[3][1] = _mm_loadu_ps(translateY);
+		world[3][2] = _mm_loadu_ps(translateZ);
+		world[3][3] = _mm_set1_ps(1.0f);
+
+		// WVP = World * ViewProjection（ワールド行列の4列目は0,0,0,1なのでその分は省く）
+		__m128 wvp[4][4];
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				__m128 value = _mm_mul_ps(world[i][0], viewProjection[0][j]);
+				value = _mm_add_ps(value, _mm_mul_ps(world[i][1], viewProjection[1][j]));
+				value = _mm_add_ps(value, _mm_mul_ps(world[i][2], viewProjection[2][j]));
+				if (i == 3) {
+					value = _mm_add_ps(value, viewProjection[3][j]);
+				}
+				wvp[i][j] = value;
+			}
+		}
+
+		// 要素ごとの並びから行列ごとの並びに転置して、行列の順に書き出す
+		for (int i = 0; i < 4; i++) {
+			_MM_TRANSPOSE4_PS(wvp[i][0], wvp[i][1], wvp[i][2], wvp[i][3]);
+			_MM_TRANSPOSE4_PS(world[i][0], world[i][1], world[i][2], world[i][3]);
+		}
+		for (int n = 0; n < 4; n++) {
+			TransformSystem::TransformationMatrix* matrix =
+				reinterpret_cast<TransformSystem::TransformationMatrix*>(output + outputStride * n);
+			for (int i = 0; i < 4; i++) {
+				_mm_storeu_ps(matrix->WVP.m[i], wvp[i][n]);
+			}
+			for (int i = 0; i < 4; i++) {
+				_mm_storeu_ps(matrix->World.m[i], world[i][n]);
+			}
+		}
+	}
+}
+#endif
+
+void TransformSystem::Reserve(uint32_t capacity) {
+	for (std::vector<float>* values : { &scaleX, &scaleY, &scaleZ, &rotateX, &rotateY, &rotateZ, &translateX, &translateY, &translateZ }) {
+		values->reserve(capacity);
+	}
+}
+
+uint32_t TransformSystem::Add(const TransForm& transform) {
+	uint32_t index = GetCount();
+	for (std::vector<float>* values : { &scaleX, &scaleY, &scaleZ, &rotateX, &rotateY, &rotateZ, &translateX, &translateY, &translateZ }) {
+		values->push_back(0.0f);
+	}
+	SetTransform(index, transform);
+	return index;
+}
+
+void TransformSystem::Clear() {
+	for (std::vector<float>* values : { &scaleX, &scaleY, &scaleZ, &rotateX, &rotateY, &rotateZ, &translateX, &translateY, &translateZ }) {
+		values->clear();
+	}
+}
+
+void TransformSystem::SetTransform(uint32_t index, const TransForm& transform) {
+	assert(index < GetCount());
+	scaleX[index] = transform.scale.x;
+	scaleY[index] = transform.scale.y;
+	scaleZ[index] = transform.scale.z;
+	rotateX[index] = transform.rotate.x;
+	rotateY[index] = transform.rotate.y;
+	rotateZ[index] = transform.rotate.z;
+	translateX[index] = transform.translate.x;
+	translateY[index] = transform.translate.y;
+	translateZ[index] = transform.translate.z;
+}
+
+TransForm TransformSystem::GetTransform(uint32_t index) const {
+	assert(index < GetCount());
+	return {
+		{ scaleX[index], scaleY[index], scaleZ[index] },
+		{ rotateX[index], rotateY[index], rotateZ[index] },
+		{ translateX[index], translateY[index], translateZ[index] },
+	};
+}
+
+void TransformSystem::Update(const Matrix4x4& viewProjection, TransformationMatrix* output,
+	ThreadPool* threadPool, uint32_t chunkSize) const {
+	Update(viewProjection, output, sizeof(TransformationMatrix), threadPool, chunkSize);
+}
+
+void TransformSystem::Update(const Matrix4x4& viewProjection, void* output, size_t outputStride,
+	ThreadPool* threadPool, uint32_t chunkSize) const {
+
+	assert(output || GetCount() == 0);
+	assert(outputStride >= sizeof(TransformationMatrix));
+	assert(chunkSize % 4 == 0);
+	unsigned char* outputBytes = static_cast<unsigned char*>(output);
+
+	// 1スレッドで全部計算する
+	if (!threadPool) {
+		UpdateRange(viewProjection, outputBytes, outputStride, 0, GetCount());
+		return;
+	}
+
+	// 塊ごとにワーカーで並行に計算する（塊は4の倍数なので端数は最後の塊だけ）
+	threadPool->ParallelFor(GetCount(), chunkSize,
+		[this, &viewProjection, outputBytes, outputStride](uint32_t begin, uint32_t end) {
+			UpdateRange(viewProjection, outputBytes, outputStride, begin, end);
+		});
+}
+
+void TransformSystem::UpdateRange(const Matrix4x4& viewProjection, unsigned char* output, size_t outputStride,
+	uint32_t begin, uint32_t end) const {
+
+#if MATH_USE_SIMD
+	// ViewProjectionの各要素を4つに複製しておく
+	__m128 viewProjectionSplat[4][4];
+	for (int i = 0; i < 4; i++) {
+		for (int j = 0; j < 4; j++) {
+			viewProjectionSplat[i][j] = _mm_set1_ps(viewProjection.m[i][j]);
+		}
+	}
+
+	// 4つずつ計算する
+	uint32_t index = begin;
+	for (; index + 4 <= end; index += 4) {
+		UpdateFour(&scaleX[index], &scaleY[index], &scaleZ[index],
+			&rotateX[index], &rotateY[index], &rotateZ[index],
+			&translateX[index], &translateY[index], &translateZ[index],
+			viewProjectionSplat, output + outputStride * index, outputStride);
+	}
+
+	// 端数は4つ分に詰め直して同じ計算をする（結果がずれないように）
+	uint32_t remainder = end - index;
+	if (remainder > 0) {
+		float values[9][4] = {};
+		for (uint32_t n = 0; n < remainder; ++n) {
+			values[0][n] = scaleX[index + n];
+			values[1][n] = scaleY[index + n];
+			values[2][n] = scaleZ[index + n];
+			values[3][n] = rotateX[index + n];
+			values[4][n] = rotateY[index + n];
+			values[5][n] = rotateZ[index + n];
+			values[6][n] = translateX[index + n];
+			values[7][n] = translateY[index + n];
+			values[8][n] = translateZ[index + n];
+		}
+		TransformationMatrix results[4];
+		UpdateFour(values[0], values[1], values[2], values[3], values[4], values[5], values[6], values[7], values[8],
+			viewProjectionSplat, reinterpret_cast<unsigned char*>(results), sizeof(TransformationMatrix));
+		for (uint32_t n = 0; n < remainder; ++n) {
+			*reinterpret_cast<TransformationMatrix*>(output + outputStride * (index + n)) = results[n];
+		}
+	}
+#else
+	// スカラーのときは一つずつ計算する
+	for (uint32_t index = begin; index < end; ++index) {
+		TransForm transform = GetTransform(index);
+		TransformationMatrix* matrix = reinterpret_cast<TransformationMatrix*>(output + outputStride * index);
+		matrix->World = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+		matrix->WVP = Multiply(matrix->World, viewProjection);
+	}
+#endif
+}
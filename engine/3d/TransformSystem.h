@@ -0,0 +1,60 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Mymath.h"
+
+// 前方宣言
+class ThreadPool;
+
+// たくさんのオブジェクトのSRTを要素ごとの配列（SoA）で持ち、ワールド行列とWVP行列をまとめて計算するクラス
+// 結果はシェーダーのTransformationMatrixと同じ並びで、インスタンスバッファなどに直接書き込む
+class TransformSystem {
+public:
+
+	// 書き出す行列（シェーダーのTransformationMatrixと同じ並び）
+	struct TransformationMatrix {
+		Math::Matrix4x4 WVP;
+		Math::Matrix4x4 World;
+	};
+
+	// 並行処理するときの1塊あたりの数（4の倍数）
+	static const uint32_t kDefaultChunkSize = 1024;
+
+	// 確保（数が分かっているときに先に呼ぶ）
+	void Reserve(uint32_t capacity);
+
+	// 追加して番号を返す
+	uint32_t Add(const Math::TransForm& transform);
+
+	// 全部消す
+	void Clear();
+
+	// SRTの設定と取得
+	void SetTransform(uint32_t index, const Math::TransForm& transform);
+	Math::TransForm GetTransform(uint32_t index) const;
+
+	// 数
+	uint32_t GetCount() const { return static_cast<uint32_t>(scaleX.size()); }
+
+	// 全部のワールド行列とWVP行列を計算してoutputに書き込む（outputはGetCount()個分）
+	// threadPoolを渡すとchunkSizeずつ並行に計算する
+	void Update(const Math::Matrix4x4& viewProjection, TransformationMatrix* output,
+		ThreadPool* threadPool = nullptr, uint32_t chunkSize = kDefaultChunkSize) const;
+
+	// outputStrideバイトおきに書き込む（定数バッファの境界ごとに並べたアップロード領域などに直接書き込む）
+	// 各要素の先頭にTransformationMatrixを書き、残りのバイトには触らない
+	void Update(const Math::Matrix4x4& viewProjection, void* output, size_t outputStride,
+		ThreadPool* threadPool = nullptr, uint32_t chunkSize = kDefaultChunkSize) const;
+
+private:
+
+	// [begin, end)を計算する
+	void UpdateRange(const Math::Matrix4x4& viewProjection, unsigned char* output, size_t outputStride,
+		uint32_t begin, uint32_t end) const;
+
+	// 要素ごとの配列
+	std::vector<float> scaleX, scaleY, scaleZ;
+	std::vector<float> rotateX, rotateY, rotateZ;
+	std::vector<float> translateX, translateY, translateZ;
+};
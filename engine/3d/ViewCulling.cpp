@@ -0,0 +1,253 @@
+#include "ViewCulling.h"
+#include <cmath>
+
+#if MATH_USE_SIMD
+#include <emmintrin.h>
+#endif
+
+using namespace Math;
+
+namespace {
+
+	// 4つ分の判定結果のビットから、見えるものの番号を分岐せずに詰める（outは4つ分の余裕が必要）
+	inline uint32_t AppendVisible(uint32_t mask, uint32_t base, uint32_t* out) {
+		uint32_t count = 0;
+		out[count] = base + 0; count += (mask >> 0) & 1;
+		out[count] = base + 1; count += (mask >> 1) & 1;
+		out[count] = base + 2; count += (mask >> 2) & 1;
+		out[count] = base + 3; count += (mask >> 3) & 1;
+		return count;
+	}
+
+	// 平面を正規化する
+	ViewCulling::Plane NormalizePlane(float x, float y, float z, float d) {
+		float length = std::sqrt(x * x + y * y + z * z);
+		if (length == 0.0f) {
+			return { x, y, z, d };
+		}
+		float invLength = 1.0f / length;
+		return { x * invLength, y * invLength, z * invLength, d * invLength };
+	}
+
+	// 一つ分の判定（SIMDで処理しきれない端数用。SIMDと同じ式）
+	inline bool IsRectVisible(const ViewCulling::Rect& view, float left, float top, float right, float bottom) {
+		return right >= view.left && left <= view.right && bottom >= view.top && top <= view.bottom;
+	}
+
+	inline bool IsSphereVisible(const ViewCulling::Frustum& frustum, float x, float y, float z, float radius) {
+		for (const ViewCulling::Plane& plane : frustum.planes) {
+			float distance = plane.x * x + plane.y * y + plane.z * z + plane.d;
+			if (distance < -radius) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	inline bool IsAABBVisible(const ViewCulling::Frustum& frustum,
+		float centerX, float centerY, float centerZ, float extentX, float extentY, float extentZ) {
+		for (const ViewCulling::Plane& plane : frustum.planes) {
+			// 法線方向に一番遠い頂点までの距離
+			float distance = plane.x * centerX + plane.y * centerY + plane.z * centerZ + plane.d;
+			float radius = std::fabs(plane.x) * extentX + std::fabs(plane.y) * extentY + std::fabs(plane.z) * extentZ;
+			if (distance < -radius) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+ViewCulling::Frustum ViewCulling::MakeFrustum(const Matrix4x4& viewProjection) {
+	// 行ベクトル（v * M）なので、クリップ座標の各成分は列との内積になる
+	const Matrix4x4& m = viewProjection;
+	auto combine = [&m](float sign, int k) {
+		// 4列目 + sign * k列目
+		return NormalizePlane(
+			m.m[0][3] + sign * m.m[0][k],
+			m.m[1][3] + sign * m.m[1][k],
+			m.m[2][3] + sign * m.m[2][k],
+			m.m[3][3] + sign * m.m[3][k]);
+	};
+
+	Frustum frustum{};
+	frustum.planes[0] = combine(1.0f, 0);  // 左 -w <= x
+	frustum.planes[1] = combine(-1.0f, 0); // 右  x <= w
+	frustum.planes[2] = combine(1.0f, 1);  // 下 -w <= y
+	frustum.planes[3] = combine(-1.0f, 1); // 上  y <= w
+	frustum.planes[4] = NormalizePlane(m.m[0][2], m.m[1][2], m.m[2][2], m.m[3][2]); // 近 0 <= z
+	frustum.planes[5] = combine(-1.0f, 2); // 遠  z <= w
+	return frustum;
+}
+
+ViewCulling::Rect ViewCulling::MakeSpriteRect(const Vector2& position, const Vector2& size, float rotation,
+	const Vector2& anchorPoint, bool isFlipX, bool isFlipY) {
+
+	// Sprite::UpdateVerticesと同じローカル座標の範囲（フリップは符号を反転）
+	float left = 0.0f - anchorPoint.x;
+	float right = 1.0f - anchorPoint.x;
+	float top = 0.0f - anchorPoint.y;
+	float bottom = 1.0f - anchorPoint.y;
+	if (isFlipX) {
+		left = -left;
+		right = -right;
+	}
+	if (isFlipY) {
+		top = -top;
+		bottom = -bottom;
+	}
+
+	// サイズをかけた中心と半分の大きさ
+	float centerX = (left + right) * 0.5f * size.x;
+	float centerY = (top + bottom) * 0.5f * size.y;
+	float extentX = std::fabs((right - left) * 0.5f * size.x);
+	float extentY = std::fabs((bottom - top) * 0.5f * size.y);
+
+	// Z軸回転（MakeRotZMatrixと同じ向き）をかけて位置を足す
+	float s = std::sin(rotation);
+	float c = std::cos(rotation);
+	float worldX = centerX * c - centerY * s + position.x;
+	float worldY = centerX * s + centerY * c + position.y;
+	float worldExtentX = std::fabs(c) * extentX + std::fabs(s) * extentY;
+	float worldExtentY = std::fabs(s) * extentX + std::fabs(c) * extentY;
+	return { worldX - worldExtentX, worldY - worldExtentY, worldX + worldExtentX, worldY + worldExtentY };
+}
+
+void ViewCulling::Clear() {
+	for (std::vector<float>* values : { &rectLeft, &rectTop, &rectRight, &rectBottom,
+		&sphereX, &sphereY, &sphereZ, &sphereRadius,
+		&aabbCenterX, &aabbCenterY, &aabbCenterZ, &aabbExtentX, &aabbExtentY, &aabbExtentZ }) {
+		values->clear();
+	}
+	visibleRects.clear();
+	visibleSpheres.clear();
+	visibleAABBs.clear();
+}
+
+uint32_t ViewCulling::AddRect(const Rect& rect) {
+	rectLeft.push_back(rect.left);
+	rectTop.push_back(rect.top);
+	rectRight.push_back(rect.right);
+	rectBottom.push_back(rect.bottom);
+	return GetRectCount() - 1;
+}
+
+uint32_t ViewCulling::AddSphere(const Vector3& center, float radius) {
+	sphereX.push_back(center.x);
+	sphereY.push_back(center.y);
+	sphereZ.push_back(center.z);
+	sphereRadius.push_back(radius);
+	return GetSphereCount() - 1;
+}
+
+uint32_t ViewCulling::AddAABB(const Vector3& min, const Vector3& max) {
+	aabbCenterX.push_back((min.x + max.x) * 0.5f);
+	aabbCenterY.push_back((min.y + max.y) * 0.5f);
+	aabbCenterZ.push_back((min.z + max.z) * 0.5f);
+	aabbExtentX.push_back((max.x - min.x) * 0.5f);
+	aabbExtentY.push_back((max.y - min.y) * 0.5f);
+	aabbExtentZ.push_back((max.z - min.z) * 0.5f);
+	return GetAABBCount() - 1;
+}
+
+void ViewCulling::CullRects(const Rect& view) {
+	uint32_t count = GetRectCount();
+	visibleRects.resize(count + 4);
+	uint32_t* out = visibleRects.data();
+	uint32_t visibleCount = 0;
+	uint32_t index = 0;
+
+#if MATH_USE_SIMD
+	__m128 viewLeft = _mm_set1_ps(view.left);
+	__m128 viewTop = _mm_set1_ps(view.top);
+	__m128 viewRight = _mm_set1_ps(view.right);
+	__m128 viewBottom = _mm_set1_ps(view.bottom);
+	for (; index + 4 <= count; index += 4) {
+		__m128 visible = _mm_and_ps(
+			_mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(&rectRight[index]), viewLeft), _mm_cmple_ps(_mm_loadu_ps(&rectLeft[index]), viewRight)),
+			_mm_and_ps(_mm_cmpge_ps(_mm_loadu_ps(&rectBottom[index]), viewTop), _mm_cmple_ps(_mm_loadu_ps(&rectTop[index]), viewBottom)));
+		visibleCount += AppendVisible(_mm_movemask_ps(visible), index, out + visibleCount);
+	}
+#endif
+
+	// 端数
+	for (; index < count; ++index) {
+		out[visibleCount] = index;
+		visibleCount += IsRectVisible(view, rectLeft[index], rectTop[index], rectRight[index], rectBottom[index]) ? 1 : 0;
+	}
+	visibleRects.resize(visibleCount);
+}
+
+void ViewCulling::CullSpheres(const Frustum& frustum) {
+	uint32_t count = GetSphereCount();
+	visibleSpheres.resize(count + 4);
+	uint32_t* out = visibleSpheres.data();
+	uint32_t visibleCount = 0;
+	uint32_t index = 0;
+
+#if MATH_USE_SIMD
+	for (; index + 4 <= count; index += 4) {
+		__m128 x = _mm_loadu_ps(&sphereX[index]);
+		__m128 y = _mm_loadu_ps(&sphereY[index]);
+		__m128 z = _mm_loadu_ps(&sphereZ[index]);
+		__m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&sphereRadius[index]));
+
+		// 6平面すべての内側（半径分の余裕込み）にあれば見える
+		__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const Plane& plane : frustum.planes) {
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(plane.x), x), _mm_mul_ps(_mm_set1_ps(plane.y), y)),
+				_mm_mul_ps(_mm_set1_ps(plane.z), z)), _mm_set1_ps(plane.d));
+			visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, negativeRadius));
+		}
+		visibleCount += AppendVisible(_mm_movemask_ps(visible), index, out + visibleCount);
+	}
+#endif
+
+	// 端数
+	for (; index < count; ++index) {
+		out[visibleCount] = index;
+		visibleCount += IsSphereVisible(frustum, sphereX[index], sphereY[index], sphereZ[index], sphereRadius[index]) ? 1 : 0;
+	}
+	visibleSpheres.resize(visibleCount);
+}
+
+void ViewCulling::CullAABBs(const Frustum& frustum) {
+	uint32_t count = GetAABBCount();
+	visibleAABBs.resize(count + 4);
+	uint32_t* out = visibleAABBs.data();
+	uint32_t visibleCount = 0;
+	uint32_t index = 0;
+
+#if MATH_USE_SIMD
+	for (; index + 4 <= count; index += 4) {
+		__m128 centerX = _mm_loadu_ps(&aabbCenterX[index]);
+		__m128 centerY = _mm_loadu_ps(&aabbCenterY[index]);
+		__m128 centerZ = _mm_loadu_ps(&aabbCenterZ[index]);
+		__m128 extentX = _mm_loadu_ps(&aabbExtentX[index]);
+		__m128 extentY = _mm_loadu_ps(&aabbExtentY[index]);
+		__m128 extentZ = _mm_loadu_ps(&aabbExtentZ[index]);
+
+		// 6平面すべてについて、法線方向に一番遠い頂点が内側にあれば見える
+		__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const Plane& plane : frustum.planes) {
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(plane.x), centerX), _mm_mul_ps(_mm_set1_ps(plane.y), centerY)),
+				_mm_mul_ps(_mm_set1_ps(plane.z), centerZ)), _mm_set1_ps(plane.d));
+			__m128 radius = _mm_add_ps(_mm_add_ps(
+				_mm_mul_ps(_mm_set1_ps(std::fabs(plane.x)), extentX), _mm_mul_ps(_mm_set1_ps(std::fabs(plane.y)), extentY)),
+				_mm_mul_ps(_mm_set1_ps(std::fabs(plane.z)), extentZ));
+			visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, _mm_sub_ps(_mm_setzero_ps(), radius)));
+		}
+		visibleCount += AppendVisible(_mm_movemask_ps(visible), index, out + visibleCount);
+	}
+#endif
+
+	// 端数
+	for (; index < count; ++index) {
+		out[visibleCount] = index;
+		visibleCount += IsAABBVisible(frustum, aabbCenterX[index], aabbCenterY[index], aabbCenterZ[index],
+			aabbExtentX[index], aabbExtentY[index], aabbExtentZ[index]) ? 1 : 0;
+	}
+	visibleAABBs.resize(visibleCount);
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Mymath.h"
+
+// 画面や視錐台の外にあるものを描画前に省くクラス
+// 境界は要素ごとの配列（SoA）で持ち、4つずつまとめて判定して見えるものの番号だけを詰めて返す
+// GPUに依存しないので単体で計測できる
+class ViewCulling {
+public:
+
+	// 平面（x*px + y*py + z*pz + d >= 0 が内側。法線は正規化済み）
+	struct Plane {
+		float x, y, z, d;
+	};
+
+	// 視錐台（左, 右, 下, 上, 近, 遠）
+	struct Frustum {
+		Plane planes[6];
+	};
+
+	// 画面上の矩形（y下向き）
+	struct Rect {
+		float left, top, right, bottom;
+	};
+
+	// ViewProjection行列から視錐台の平面を取り出す（クリップ空間のzは0~w）
+	static Frustum MakeFrustum(const Math::Matrix4x4& viewProjection);
+
+	// スプライトの四角形（アンカー・サイズ・回転・フリップ込み）を囲む矩形
+	static Rect MakeSpriteRect(const Math::Vector2& position, const Math::Vector2& size, float rotation,
+		const Math::Vector2& anchorPoint, bool isFlipX, bool isFlipY);
+
+	// 全部消す（容量は使い回す）
+	void Clear();
+
+	// 境界を追加して番号を返す
+	uint32_t AddRect(const Rect& rect);
+	uint32_t AddSphere(const Math::Vector3& center, float radius);
+	uint32_t AddAABB(const Math::Vector3& min, const Math::Vector3& max);
+
+	// 判定して、見えるものの番号を追加した順に詰める
+	void CullRects(const Rect& view);
+	void CullSpheres(const Frustum& frustum);
+	void CullAABBs(const Frustum& frustum);
+
+	// 見えるものの番号
+	const std::vector<uint32_t>& GetVisibleRects() const { return visibleRects; }
+	const std::vector<uint32_t>& GetVisibleSpheres() const { return visibleSpheres; }
+	const std::vector<uint32_t>& GetVisibleAABBs() const { return visibleAABBs; }
+
+	// 追加された数
+	uint32_t GetRectCount() const { return static_cast<uint32_t>(rectLeft.size()); }
+	uint32_t GetSphereCount() const { return static_cast<uint32_t>(sphereX.size()); }
+	uint32_t GetAABBCount() const { return static_cast<uint32_t>(aabbCenterX.size()); }
+
+private:
+
+	// 矩形（左, 上, 右, 下）
+	std::vector<float> rectLeft, rectTop, rectRight, rectBottom;
+
+	// 球（中心と半径）
+	std::vector<float> sphereX, sphereY, sphereZ, sphereRadius;
+
+	// AABB（中心と半分の大きさ）
+	std::vector<float> aabbCenterX, aabbCenterY, aabbCenterZ;
+	std::vector<float> aabbExtentX, aabbExtentY, aabbExtentZ;
+
+	// 見えるものの番号
+	std::vector<uint32_t> visibleRects;
+	std::vector<uint32_t> visibleSpheres;
+	std::vector<uint32_t> visibleAABBs;
+};
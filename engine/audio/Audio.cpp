@@ -0,0 +1,427 @@
+#include "Audio.h"
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#pragma comment(lib, "xaudio2.lib")
+
+Audio* Audio::instance = nullptr;
+
+Audio* Audio::GetInstance() {
+	if (instance == nullptr) {
+		instance = new Audio();
+	}
+	return instance;
+}
+
+void Audio::Initialize() {
+	HRESULT result = XAudio2Create(&xAudio2, 0, XAUDIO2_DEFAULT_PROCESSOR);
+	assert(SUCCEEDED(result));
+
+	result = xAudio2->CreateMasteringVoice(&masterVoice);
+	assert(SUCCEEDED(result));
+
+	// ソースボイスは再生するときに形式に合わせて作る
+	for (Voice& voice : voices) {
+		voice.callback.voice = &voice;
+	}
+
+	// ソフトウェアミキサーの出力は一つのボイスで鳴らし続ける
+	mixer.Initialize();
+	CreateMixerVoice();
+}
+
+void Audio::Finalize() {
+	if (instance == nullptr) {
+		return;
+	}
+
+	// DestroyVoiceはコールバックが終わるまで待つので、その後はストリームを閉じてよい
+	for (Voice& voice : instance->voices) {
+		if (voice.sourceVoice != nullptr) {
+			voice.sourceVoice->DestroyVoice();
+			voice.sourceVoice = nullptr;
+		}
+	}
+	if (instance->mixerVoice.sourceVoice != nullptr) {
+		instance->mixerVoice.sourceVoice->DestroyVoice();
+		instance->mixerVoice.sourceVoice = nullptr;
+	}
+	if (instance->masterVoice != nullptr) {
+		instance->masterVoice->DestroyVoice();
+		instance->masterVoice = nullptr;
+	}
+	instance->xAudio2.Reset();
+
+	delete instance;
+	instance = nullptr;
+}
+
+void Audio::Update() {
+	for (Voice& voice : voices) {
+		if (!voice.isActive) {
+			continue;
+		}
+
+		if (voice.isStopping) {
+			// Stopが効いた後なら再生中のバッファも消える
+			voice.sourceVoice->FlushSourceBuffers();
+		} else if (voice.isStream) {
+			// 詰める前に全部再生し終わっていたら間に合わなかった
+			if (!voice.isStreamEnd && voice.ring.IsEmpty()) {
+				++streamUnderruns;
+			}
+			FillStream(voice);
+		}
+
+		// 渡したバッファが全部返ってきたら空きに戻す
+		if (voice.finishedBuffers.load(std::memory_order_acquire) != voice.submittedBuffers) {
+			continue;
+		}
+		voice.sourceVoice->Stop();
+		if (voice.isStream) {
+			finishedStreamBytes += voice.stream.GetReadBytes();
+			voice.stream.Close();
+			voice.ring.Reset();
+		}
+		voice.storage.reset();
+		voice.isActive = false;
+		voice.isStopping = false;
+	}
+
+	// ミキサーで鳴らしているものがあれば、空いたブロックに混ぜて詰める
+	// 鳴らすものが無くなったら詰めるのをやめ、ボイスは無音のまま待たせる
+	if (mixer.GetActiveVoiceCount() > 0) {
+		if (isMixerRunning && mixerVoice.ring.IsEmpty()) {
+			++mixerUnderruns;
+		}
+		mixer.Render(&mixerSink);
+		isMixerRunning = true;
+	} else {
+		isMixerRunning = false;
+	}
+}
+
+SoundData Audio::LoadWave(const std::string& filePath) {
+
+	// ファイルオープン
+	std::ifstream file(filePath, std::ios_base::binary);
+	assert(file.is_open());
+
+	// ヘッダだけを解析する（LIST、JUNKなどのチャンクがどこにあってもよい）
+	WaveFile::Info info;
+	bool isParsed = WaveFile::ReadHeader(file, info);
+	assert(isParsed);
+	if (!isParsed) {
+		return {};
+	}
+
+	// 波形だけをちょうどのサイズで読む
+	std::shared_ptr<std::vector<uint8_t>> storage = std::make_shared<std::vector<uint8_t>>(info.dataSize);
+	file.seekg(std::streamoff(info.dataOffset), std::ios_base::beg);
+	file.read(reinterpret_cast<char*>(storage->data()), std::streamsize(info.dataSize));
+
+	// ヘッダより短いファイルは読めた分だけにする
+	uint32_t readSize = uint32_t(file.gcount());
+	readSize -= readSize % info.format.blockAlign;
+	storage->resize(readSize);
+
+	SoundData soundData = {};
+	soundData.format = info.format;
+	soundData.pBuffer = storage->data();
+	soundData.bufferSize = readSize;
+	soundData.storage = std::move(storage);
+	return soundData;
+}
+
+void Audio::UnloadWave(SoundData* soundData) {
+
+	// 再生中のボイスが持っていれば、再生が終わったときに解放される
+	soundData->storage.reset();
+	soundData->pBuffer = nullptr;
+	soundData->bufferSize = 0;
+	soundData->format = {};
+}
+
+uint32_t Audio::PlayWave(const SoundData& soundData, float volume, bool isLooping) {
+	if (soundData.pBuffer == nullptr || soundData.bufferSize == 0) {
+		return kInvalidHandle;
+	}
+	Voice* voice = AcquireVoice(soundData.format);
+	if (voice == nullptr) {
+		return kInvalidHandle;
+	}
+	voice->storage = soundData.storage;
+
+	// 音声データを一つのバッファで渡す
+	XAUDIO2_BUFFER buffer = {};
+	buffer.pAudioData = soundData.pBuffer;
+	buffer.AudioBytes = soundData.bufferSize;
+	buffer.Flags = XAUDIO2_END_OF_STREAM;
+	buffer.LoopCount = isLooping ? XAUDIO2_LOOP_INFINITE : 0;
+	HRESULT result = voice->sourceVoice->SubmitSourceBuffer(&buffer);
+	assert(SUCCEEDED(result));
+	++voice->submittedBuffers;
+
+	voice->sourceVoice->SetVolume(volume);
+	result = voice->sourceVoice->Start();
+	assert(SUCCEEDED(result));
+	return MakeHandle(*voice);
+}
+
+uint32_t Audio::PlayStream(const std::string& filePath, float volume, bool isLooping) {
+
+	// 形式を知るためにヘッダを先に読む
+	WaveStream stream;
+	if (!stream.Open(filePath)) {
+		assert(0);
+		return kInvalidHandle;
+	}
+	Voice* voice = AcquireVoice(stream.GetInfo().format);
+	if (voice == nullptr) {
+		return kInvalidHandle;
+	}
+	voice->stream = std::move(stream);
+	voice->isStream = true;
+	voice->isLooping = isLooping;
+	voice->isStreamEnd = false;
+
+	// リングは最初にストリーミングで使うときに確保して、以降は使い回す
+	if (voice->ring.GetBlockCount() == 0) {
+		voice->ring.Initialize(kStreamBlockSize, kStreamBlockCount);
+	}
+
+	// 全ブロックを詰めてから鳴らす
+	FillStream(*voice);
+	voice->sourceVoice->SetVolume(volume);
+	HRESULT result = voice->sourceVoice->Start();
+	assert(SUCCEEDED(result));
+	return MakeHandle(*voice);
+}
+
+uint32_t Audio::PlayMixed(const SoundData& soundData, float gain, float pan, bool isLooping) {
+	AudioMixer::Source source;
+	source.data = soundData.pBuffer;
+	source.size = soundData.bufferSize;
+	source.format = soundData.format;
+	source.owner = soundData.storage;
+	return mixer.Play(source, gain, pan, isLooping);
+}
+
+void Audio::Stop(uint32_t handle) {
+	Voice* voice = FindVoice(handle);
+	if (voice != nullptr) {
+		ReleaseVoice(*voice);
+	}
+}
+
+void Audio::StopAll() {
+	for (Voice& voice : voices) {
+		if (voice.isActive) {
+			ReleaseVoice(voice);
+		}
+	}
+	mixer.StopAll();
+}
+
+bool Audio::IsPlaying(uint32_t handle) const {
+	return FindVoice(handle) != nullptr;
+}
+
+Audio::Statistics Audio::GetStatistics() const {
+	Statistics statistics = {};
+	statistics.createdVoices = createdVoices;
+	statistics.reusedVoices = reusedVoices;
+	statistics.rejectedPlays = rejectedPlays;
+	statistics.streamUnderruns = streamUnderruns;
+	statistics.streamedBytes = finishedStreamBytes;
+	statistics.mixerVoices = mixer.GetActiveVoiceCount();
+	statistics.mixerUnderruns = mixerUnderruns;
+	for (const Voice& voice : voices) {
+		if (!voice.isActive) {
+			continue;
+		}
+		++statistics.activeVoices;
+		if (voice.isStream) {
+			statistics.streamedBytes += voice.stream.GetReadBytes();
+		}
+	}
+	return statistics;
+}
+
+void Audio::VoiceCallback::OnBufferEnd(void* bufferContext) {
+	(void)bufferContext;
+
+	// ストリーミングのブロックは渡した順に返ってくる
+	if (voice->isStream) {
+		voice->ring.ReleaseBlock();
+	}
+	voice->finishedBuffers.fetch_add(1, std::memory_order_release);
+}
+
+uint32_t Audio::MixerSink::GetWritableBlockCount() {
+	return voice->ring.GetBlockCount() - voice->ring.GetQueuedCount();
+}
+
+void Audio::MixerSink::Write(const float* samples, uint32_t frameCount) {
+	uint8_t* block = voice->ring.AcquireBlock();
+	assert(block != nullptr);
+	size_t size = size_t(frameCount) * AudioMixer::kOutputChannels * sizeof(float);
+	std::memcpy(block, samples, size);
+
+	XAUDIO2_BUFFER buffer = {};
+	buffer.pAudioData = block;
+	buffer.AudioBytes = static_cast<UINT32>(size);
+	voice->ring.SubmitBlock();
+	++voice->submittedBuffers;
+	HRESULT result = voice->sourceVoice->SubmitSourceBuffer(&buffer);
+	assert(SUCCEEDED(result));
+}
+
+Audio::Voice* Audio::AcquireVoice(const WaveFile::Format& format) {
+
+	// 同じ形式の空きがあれば作らずに使う。無ければまだ作っていない空き、それも無ければ違う形式の空きを作り直す
+	Voice* sameFormatVoice = nullptr;
+	Voice* emptyVoice = nullptr;
+	Voice* otherFormatVoice = nullptr;
+	for (Voice& voice : voices) {
+		if (voice.isActive) {
+			continue;
+		}
+		if (voice.sourceVoice == nullptr) {
+			if (emptyVoice == nullptr) {
+				emptyVoice = &voice;
+			}
+		} else if (std::memcmp(&voice.format, &format, sizeof(format)) == 0) {
+			sameFormatVoice = &voice;
+			break;
+		} else if (otherFormatVoice == nullptr) {
+			otherFormatVoice = &voice;
+		}
+	}
+
+	Voice* voice = sameFormatVoice;
+	if (voice != nullptr) {
+		++reusedVoices;
+	} else {
+		voice = emptyVoice != nullptr ? emptyVoice : otherFormatVoice;
+		if (voice == nullptr) {
+			++rejectedPlays;
+			return nullptr;
+		}
+		if (voice->sourceVoice != nullptr) {
+			voice->sourceVoice->DestroyVoice();
+			voice->sourceVoice = nullptr;
+		}
+
+		// FormatはWAVEFORMATEXTENSIBLEと同じ並び
+		HRESULT result = xAudio2->CreateSourceVoice(&voice->sourceVoice,
+			reinterpret_cast<const WAVEFORMATEX*>(&format), 0, XAUDIO2_DEFAULT_FREQ_RATIO, &voice->callback);
+		assert(SUCCEEDED(result));
+		if (FAILED(result)) {
+			voice->sourceVoice = nullptr;
+			++rejectedPlays;
+			return nullptr;
+		}
+		voice->format = format;
+		++createdVoices;
+	}
+
+	// 前の再生の状態を消す（バッファは全部返ってきている）
+	voice->generation = (voice->generation + 1) & 0xFFFFFF;
+	voice->isActive = true;
+	voice->isStopping = false;
+	voice->submittedBuffers = 0;
+	voice->finishedBuffers.store(0, std::memory_order_relaxed);
+	voice->isStream = false;
+	voice->isLooping = false;
+	voice->isStreamEnd = false;
+	return voice;
+}
+
+Audio::Voice* Audio::FindVoice(uint32_t handle) {
+	return const_cast<Voice*>(static_cast<const Audio*>(this)->FindVoice(handle));
+}
+
+const Audio::Voice* Audio::FindVoice(uint32_t handle) const {
+	uint32_t index = handle & 0xFF;
+	if (handle == kInvalidHandle || index >= kMaxVoices) {
+		return nullptr;
+	}
+	const Voice& voice = voices[index];
+	if (!voice.isActive || voice.isStopping || voice.generation != (handle >> 8)) {
+		return nullptr;
+	}
+	return &voice;
+}
+
+uint32_t Audio::MakeHandle(const Voice& voice) const {
+	uint32_t index = static_cast<uint32_t>(&voice - voices.data());
+	return (voice.generation << 8) | index;
+}
+
+void Audio::FillStream(Voice& voice) {
+	while (!voice.isStreamEnd) {
+		uint8_t* block = voice.ring.AcquireBlock();
+		if (block == nullptr) {
+			break;
+		}
+
+		// ループしないなら、最後まで読んだブロックで終わりを知らせる
+		size_t size = voice.stream.Read(block, voice.ring.GetBlockSize(), voice.isLooping);
+		if (size == 0) {
+			voice.isStreamEnd = true;
+			break;
+		}
+		voice.isStreamEnd = !voice.isLooping && voice.stream.IsEnd();
+
+		XAUDIO2_BUFFER buffer = {};
+		buffer.pAudioData = block;
+		buffer.AudioBytes = static_cast<UINT32>(size);
+		buffer.Flags = voice.isStreamEnd ? XAUDIO2_END_OF_STREAM : 0;
+
+		// コールバックが来る前に渡したことにしておく
+		voice.ring.SubmitBlock();
+		++voice.submittedBuffers;
+		HRESULT result = voice.sourceVoice->SubmitSourceBuffer(&buffer);
+		assert(SUCCEEDED(result));
+	}
+}
+
+void Audio::ReleaseVoice(Voice& voice) {
+	if (voice.isStopping) {
+		return;
+	}
+
+	// 返ってきていないバッファはUpdateで消し、全部返ってきたら空きに戻す
+	voice.isStopping = true;
+	voice.isStreamEnd = true;
+	voice.sourceVoice->Stop();
+	voice.sourceVoice->FlushSourceBuffers();
+}
+
+void Audio::CreateMixerVoice() {
+
+	// ミキサーの出力と同じ、floatのステレオ
+	WaveFile::Format format = {};
+	format.formatTag = WaveFile::kFormatFloat;
+	format.channelCount = AudioMixer::kOutputChannels;
+	format.sampleRate = mixer.GetSampleRate();
+	format.bitsPerSample = 32;
+	format.blockAlign = uint16_t(format.channelCount * sizeof(float));
+	format.byteRate = format.sampleRate * format.blockAlign;
+
+	// 再生し終わったブロックはストリーミングと同じくコールバックで返す
+	mixerVoice.callback.voice = &mixerVoice;
+	mixerVoice.isStream = true;
+	mixerVoice.format = format;
+	mixerVoice.ring.Initialize(size_t(mixer.GetBlockFrames()) * format.blockAlign, kMixerBlockCount);
+	mixerSink.voice = &mixerVoice;
+
+	HRESULT result = xAudio2->CreateSourceVoice(&mixerVoice.sourceVoice,
+		reinterpret_cast<const WAVEFORMATEX*>(&format), 0, XAUDIO2_DEFAULT_FREQ_RATIO, &mixerVoice.callback);
+	assert(SUCCEEDED(result));
+	result = mixerVoice.sourceVoice->Start();
+	assert(SUCCEEDED(result));
+}
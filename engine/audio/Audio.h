@@ -0,0 +1,187 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wrl.h>
+#include <xaudio2.h>
+#include "AudioMixer.h"
+#include "AudioRingBuffer.h"
+#include "SoundData.h"
+#include "WaveFile.h"
+#include "WaveStream.h"
+
+// 音声の再生
+// ソースボイスは最初に決めた数までしか作らず、再生が終わったものを同じ形式の次の再生に使い回す
+// 長い音声はファイルから少しずつ読み、ブロックのリングで再生中に次を詰めていく
+// PlayMixedで鳴らしたものはソフトウェアミキサーで混ぜ、一つのボイスにまとめて渡す
+class Audio {
+public:
+
+	// ボイスの数（同時に鳴らせる数）
+	static const uint32_t kMaxVoices = 32;
+
+	// ストリーミングのブロックのサイズとブロック数
+	static const size_t kStreamBlockSize = 64 * 1024;
+	static const uint32_t kStreamBlockCount = AudioRingBuffer::kDefaultBlockCount;
+
+	// ミキサーの出力のブロック数（1ブロック1024フレームで約21ミリ秒）
+	static const uint32_t kMixerBlockCount = 4;
+
+	// 再生できなかったときのハンドル
+	static const uint32_t kInvalidHandle = 0xFFFFFFFF;
+
+	// ボイスの使われ方
+	struct Statistics {
+		uint32_t activeVoices;    // 再生中のボイス数
+		uint32_t createdVoices;   // 作ったボイスの数（作り直しも数える）
+		uint32_t reusedVoices;    // 作らずに使い回した回数
+		uint32_t rejectedPlays;   // ボイスが足りず再生できなかった回数
+		uint32_t streamUnderruns; // ストリーミングで次のブロックが間に合わなかった回数
+		uint64_t streamedBytes;   // ストリーミングで読んだバイト数
+		uint32_t mixerVoices;     // ミキサーで鳴らしているボイス数
+		uint32_t mixerUnderruns;  // ミキサーの出力が間に合わなかった回数
+	};
+
+	// シングルトンインスタンスの取得
+	static Audio* GetInstance();
+
+	// 初期化
+	void Initialize();
+
+	// 終了
+	static void Finalize();
+
+	// 再生の終わったボイスを空きに戻し、ストリーミングの次のブロックを詰める（毎フレーム呼ぶ）
+	void Update();
+
+	// WAVファイルを読み込む（波形以外のチャンクは読み飛ばす）
+	static SoundData LoadWave(const std::string& filePath);
+
+	// 音声データの解放
+	static void UnloadWave(SoundData* soundData);
+
+	// 読み込んだ音声を再生する（ボイスが足りなければkInvalidHandle）
+	uint32_t PlayWave(const SoundData& soundData, float volume = 1.0f, bool isLooping = false);
+
+	// WAVファイルをストリーミングで再生する
+	uint32_t PlayStream(const std::string& filePath, float volume = 1.0f, bool isLooping = false);
+
+	// 読み込んだ音声をソフトウェアミキサーで鳴らす（ハンドルはAudioMixerのもの）
+	uint32_t PlayMixed(const SoundData& soundData, float gain = 1.0f, float pan = 0.0f, bool isLooping = false);
+
+	// ソフトウェアミキサー（止める、音量やパンを変える、変換方法を選ぶ）
+	AudioMixer* GetMixer() { return &mixer; }
+
+	// 止める（StopAllはミキサーで鳴らしているものも止める）
+	void Stop(uint32_t handle);
+	void StopAll();
+
+	// 再生中か（終わったハンドルや使い回されたハンドルはfalse）
+	bool IsPlaying(uint32_t handle) const;
+
+	Statistics GetStatistics() const;
+
+private:
+
+	struct Voice;
+
+	// ボイスのコールバック（XAudio2のスレッドから呼ばれる）
+	class VoiceCallback : public IXAudio2VoiceCallback {
+	public:
+		Voice* voice = nullptr;
+
+		void STDMETHODCALLTYPE OnVoiceProcessingPassStart(UINT32) override {}
+		void STDMETHODCALLTYPE OnVoiceProcessingPassEnd() override {}
+		void STDMETHODCALLTYPE OnStreamEnd() override {}
+		void STDMETHODCALLTYPE OnBufferStart(void*) override {}
+		void STDMETHODCALLTYPE OnBufferEnd(void* bufferContext) override;
+		void STDMETHODCALLTYPE OnLoopEnd(void*) override {}
+		void STDMETHODCALLTYPE OnVoiceError(void*, HRESULT) override {}
+	};
+
+	// ボイス一つ分
+	struct Voice {
+		IXAudio2SourceVoice* sourceVoice = nullptr;
+		WaveFile::Format format = {}; // ソースボイスを作った形式
+		VoiceCallback callback;
+
+		// ハンドルの使い回しを見分ける番号
+		uint32_t generation = 0;
+
+		// 再生中か、止めている途中か
+		bool isActive = false;
+		bool isStopping = false;
+
+		// 渡したバッファ数と、再生し終わったバッファ数（コールバックで進む）
+		uint32_t submittedBuffers = 0;
+		std::atomic<uint32_t> finishedBuffers{ 0 };
+
+		// 再生中の読み込み済みの音声（再生中に解放されないように持っておく）
+		std::shared_ptr<const void> storage;
+
+		// ストリーミング
+		bool isStream = false;
+		bool isLooping = false;
+		bool isStreamEnd = false;
+		WaveStream stream;
+		AudioRingBuffer ring;
+	};
+
+	// ミキサーの出力をボイスのリングに詰める出力先
+	class MixerSink : public IAudioSink {
+	public:
+		Voice* voice = nullptr;
+
+		uint32_t GetWritableBlockCount() override;
+		void Write(const float* samples, uint32_t frameCount) override;
+	};
+
+	static Audio* instance;
+
+	Audio() = default;
+	~Audio() = default;
+	Audio(Audio&) = delete;
+	Audio& operator=(const Audio&) = delete;
+
+	Microsoft::WRL::ComPtr<IXAudio2> xAudio2;
+	IXAudio2MasteringVoice* masterVoice = nullptr;
+
+	// ボイス（数は変わらない）
+	std::array<Voice, kMaxVoices> voices;
+
+	// ソフトウェアミキサーと、その出力を鳴らすfloatのステレオのボイス
+	AudioMixer mixer;
+	Voice mixerVoice;
+	MixerSink mixerSink;
+	bool isMixerRunning = false;
+
+	// 統計
+	uint32_t createdVoices = 0;
+	uint32_t reusedVoices = 0;
+	uint32_t rejectedPlays = 0;
+	uint32_t streamUnderruns = 0;
+	uint64_t finishedStreamBytes = 0;
+	uint32_t mixerUnderruns = 0;
+
+	// 形式に合う空きボイスを探す（無ければ空きを作り直す。空きが無ければnullptr）
+	Voice* AcquireVoice(const WaveFile::Format& format);
+
+	// ハンドルのボイス（終わっていればnullptr）
+	Voice* FindVoice(uint32_t handle);
+	const Voice* FindVoice(uint32_t handle) const;
+
+	// ハンドルを作る（下位8bitがボイス番号）
+	uint32_t MakeHandle(const Voice& voice) const;
+
+	// ストリーミングのボイスの空いたブロックに次を詰める
+	void FillStream(Voice& voice);
+
+	// ミキサーの出力のボイスを作る
+	void CreateMixerVoice();
+
+	// ボイスを止めて、バッファが全部返ってきたら空きに戻す
+	void ReleaseVoice(Voice& voice);
+};
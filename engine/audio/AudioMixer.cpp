@@ -0,0 +1,572 @@
+#include "AudioMixer.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include "Mymath.h"
+
+#if MATH_USE_SIMD
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+	// sincの遮断周波数（ナイキスト周波数に対する比。窓の裾の分だけ下げる）
+	const double kSincCutoff = 0.92;
+
+	const double kPi = 3.14159265358979323846;
+
+	// 固定小数の位置の小数部を24bitにしたものと、それを0～1にする係数
+	inline int32_t GetFraction24(uint64_t position) {
+		return int32_t(uint32_t(position) >> 8);
+	}
+	const float kFraction24Scale = 1.0f / 16777216.0f;
+
+	// パンから左右の音量を求める
+	// モノラルは左右の和の電力が一定になるように、ステレオは反対側だけを絞る
+	void ComputeGains(float gain, float pan, uint32_t channelCount, float* left, float* right) {
+		pan = std::clamp(pan, -1.0f, 1.0f);
+		if (channelCount == 1) {
+			float angle = float((pan + 1.0f) * kPi * 0.25);
+			*left = gain * std::cos(angle);
+			*right = gain * std::sin(angle);
+		} else {
+			*left = gain * (pan > 0.0f ? 1.0f - pan : 1.0f);
+			*right = gain * (pan < 0.0f ? 1.0f + pan : 1.0f);
+		}
+	}
+
+	// 16bitのPCMをfloatにする（rightがnullptrなら左だけ）
+	void ConvertPcm16(const uint8_t* source, uint32_t stride, uint32_t channelCount, uint32_t count,
+		float* left, float* right) {
+		const float scale = 1.0f / 32768.0f;
+		uint32_t i = 0;
+
+#if MATH_USE_SIMD
+		__m128 scaleVector = _mm_set1_ps(scale);
+		if (channelCount == 2 && stride == 4 && right != nullptr) {
+			// 4フレーム（左右交互の8サンプル）を32bitに符号拡張して左右に分ける
+			for (; i + 4 <= count; i += 4) {
+				__m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+				__m128i leftSamples = _mm_srai_epi32(_mm_slli_epi32(samples, 16), 16);
+				__m128i rightSamples = _mm_srai_epi32(samples, 16);
+				_mm_storeu_ps(left + i, _mm_mul_ps(_mm_cvtepi32_ps(leftSamples), scaleVector));
+				_mm_storeu_ps(right + i, _mm_mul_ps(_mm_cvtepi32_ps(rightSamples), scaleVector));
+			}
+		} else if (channelCount == 1 && stride == 2) {
+			// 8サンプルを上位16bitに置いてから算術シフトで符号拡張する
+			for (; i + 8 <= count; i += 8) {
+				__m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 2));
+				__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+				__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+				_mm_storeu_ps(left + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scaleVector));
+				_mm_storeu_ps(left + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scaleVector));
+			}
+		}
+#endif
+
+		// 端数（3チャンネル以上は先頭の2チャンネルを使う）
+		for (; i < count; ++i) {
+			const uint8_t* frame = source + size_t(i) * stride;
+			int16_t sample;
+			std::memcpy(&sample, frame, sizeof(sample));
+			left[i] = sample * scale;
+			if (right != nullptr) {
+				std::memcpy(&sample, frame + 2, sizeof(sample));
+				right[i] = sample * scale;
+			}
+		}
+	}
+
+	// 24bitのPCMをfloatにする（3バイトずつなのでスカラーで読む）
+	void ConvertPcm24(const uint8_t* source, uint32_t stride, uint32_t count, float* left, float* right) {
+		const float scale = 1.0f / 8388608.0f;
+		for (uint32_t i = 0; i < count; ++i) {
+			const uint8_t* frame = source + size_t(i) * stride;
+
+			// 上位24bitに置いてから算術シフトで符号拡張する
+			int32_t sample = int32_t((uint32_t(frame[0]) << 8) | (uint32_t(frame[1]) << 16) | (uint32_t(frame[2]) << 24)) >> 8;
+			left[i] = sample * scale;
+			if (right != nullptr) {
+				sample = int32_t((uint32_t(frame[3]) << 8) | (uint32_t(frame[4]) << 16) | (uint32_t(frame[5]) << 24)) >> 8;
+				right[i] = sample * scale;
+			}
+		}
+	}
+
+	// 32bitのfloatを左右に分ける
+	void ConvertFloat(const uint8_t* source, uint32_t stride, uint32_t channelCount, uint32_t count,
+		float* left, float* right) {
+		uint32_t i = 0;
+		if (channelCount == 1 && stride == 4) {
+			std::memcpy(left, source, size_t(count) * sizeof(float));
+			return;
+		}
+
+#if MATH_USE_SIMD
+		if (channelCount == 2 && stride == 8 && right != nullptr) {
+			// 4フレーム（8サンプル）を偶数番目と奇数番目に分ける
+			for (; i + 4 <= count; i += 4) {
+				const float* samples = reinterpret_cast<const float*>(source + i * 8);
+				__m128 a = _mm_loadu_ps(samples);
+				__m128 b = _mm_loadu_ps(samples + 4);
+				_mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+			}
+		}
+#endif
+
+		for (; i < count; ++i) {
+			const uint8_t* frame = source + size_t(i) * stride;
+			std::memcpy(&left[i], frame, sizeof(float));
+			if (right != nullptr) {
+				std::memcpy(&right[i], frame + 4, sizeof(float));
+			}
+		}
+	}
+
+	// 線形補間でサンプリングレートを変える（sourceは位置0のフレーム、positionはその小数部から始まる固定小数）
+	void ResampleLinear(const float* source, uint64_t position, uint64_t step, uint32_t count, float* output) {
+		uint32_t i = 0;
+
+#if MATH_USE_SIMD
+		// 読む位置がばらばらなので読み込みはスカラー、補間を4つずつまとめる
+		__m128 fractionScale = _mm_set1_ps(kFraction24Scale);
+		for (; i + 4 <= count; i += 4) {
+			uint64_t p0 = position;
+			uint64_t p1 = p0 + step;
+			uint64_t p2 = p1 + step;
+			uint64_t p3 = p2 + step;
+			const float* s0 = source + (p0 >> 32);
+			const float* s1 = source + (p1 >> 32);
+			const float* s2 = source + (p2 >> 32);
+			const float* s3 = source + (p3 >> 32);
+			__m128 a = _mm_setr_ps(s0[0], s1[0], s2[0], s3[0]);
+			__m128 b = _mm_setr_ps(s0[1], s1[1], s2[1], s3[1]);
+			__m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_setr_epi32(
+				GetFraction24(p0), GetFraction24(p1), GetFraction24(p2), GetFraction24(p3))), fractionScale);
+			_mm_storeu_ps(output + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)));
+			position = p3 + step;
+		}
+#endif
+
+		for (; i < count; ++i) {
+			const float* s = source + (position >> 32);
+			float t = float(GetFraction24(position)) * kFraction24Scale;
+			output[i] = s[0] + (s[1] - s[0]) * t;
+			position += step;
+		}
+	}
+
+	// 窓付きsincでサンプリングレートを変える（sourceの前にhistoryFrames、後ろにtaps / 2フレームが要る）
+	// tableは小数位置ごとにtapsずつ並んだ係数
+	void ResampleSinc(const float* source, uint64_t position, uint64_t step, uint32_t count,
+		const float* table, uint32_t taps, uint32_t historyFrames, float* output) {
+		uint32_t i = 0;
+
+		// 小数位置に一番近い係数の行
+		auto getCoefficients = [table, taps](uint64_t p) {
+			uint32_t phase = uint32_t((uint64_t(uint32_t(p)) * AudioMixer::kSincPhases + 0x80000000ull) >> 32);
+			return table + size_t(phase) * taps;
+		};
+
+#if MATH_USE_SIMD
+		// 4フレーム分のタップの積を縦に足しておき、最後に転置して横の和をまとめて求める
+		assert(taps % 4 == 0);
+		for (; i + 4 <= count; i += 4) {
+			__m128 sums[4];
+			for (uint32_t j = 0; j < 4; ++j) {
+				const float* s = source + (position >> 32) - historyFrames;
+				const float* c = getCoefficients(position);
+				__m128 sum = _mm_setzero_ps();
+				for (uint32_t k = 0; k < taps; k += 4) {
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(s + k), _mm_loadu_ps(c + k)));
+				}
+				sums[j] = sum;
+				position += step;
+			}
+			_MM_TRANSPOSE4_PS(sums[0], sums[1], sums[2], sums[3]);
+			_mm_storeu_ps(output + i, _mm_add_ps(_mm_add_ps(sums[0], sums[1]), _mm_add_ps(sums[2], sums[3])));
+		}
+#endif
+
+		for (; i < count; ++i) {
+			const float* s = source + (position >> 32) - historyFrames;
+			const float* c = getCoefficients(position);
+			float sum = 0.0f;
+			for (uint32_t k = 0; k < taps; ++k) {
+				sum += s[k] * c[k];
+			}
+			output[i] = sum;
+			position += step;
+		}
+	}
+
+	// 音量をstartGainからendGainへ少しずつ変えながらdestinationに足す
+	void AccumulateWithGain(const float* source, float* destination, uint32_t count, float startGain, float endGain) {
+		float delta = (endGain - startGain) / float(count);
+		uint32_t i = 0;
+
+#if MATH_USE_SIMD
+		__m128 gain = _mm_setr_ps(startGain, startGain + delta, startGain + delta * 2.0f, startGain + delta * 3.0f);
+		__m128 gainStep = _mm_set1_ps(delta * 4.0f);
+		for (; i + 4 <= count; i += 4) {
+			__m128 sum = _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(_mm_loadu_ps(source + i), gain));
+			_mm_storeu_ps(destination + i, sum);
+			gain = _mm_add_ps(gain, gainStep);
+		}
+#endif
+
+		for (; i < count; ++i) {
+			destination[i] += source[i] * (startGain + delta * float(i));
+		}
+	}
+
+	// 左右を交互に並べ、-1～1に収める
+	void InterleaveStereo(const float* left, const float* right, uint32_t count, float* output) {
+		uint32_t i = 0;
+
+#if MATH_USE_SIMD
+		__m128 minimum = _mm_set1_ps(-1.0f);
+		__m128 maximum = _mm_set1_ps(1.0f);
+		for (; i + 4 <= count; i += 4) {
+			__m128 l = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(left + i), minimum), maximum);
+			__m128 r = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(right + i), minimum), maximum);
+			_mm_storeu_ps(output + i * 2, _mm_unpacklo_ps(l, r));
+			_mm_storeu_ps(output + i * 2 + 4, _mm_unpackhi_ps(l, r));
+		}
+#endif
+
+		for (; i < count; ++i) {
+			output[i * 2] = std::clamp(left[i], -1.0f, 1.0f);
+			output[i * 2 + 1] = std::clamp(right[i], -1.0f, 1.0f);
+		}
+	}
+}
+
+void NullAudioSink::Write(const float* samples, uint32_t frameCount) {
+	for (uint32_t i = 0; i < frameCount * AudioMixer::kOutputChannels; ++i) {
+		peak = std::max(peak, std::fabs(samples[i]));
+	}
+	writtenFrames += frameCount;
+}
+
+void AudioMixer::Initialize(uint32_t outputSampleRate, uint32_t outputBlockFrames) {
+	assert(outputSampleRate > 0 && outputBlockFrames > 0);
+	sampleRate = outputSampleRate;
+	blockFrames = outputBlockFrames;
+
+	StopAll();
+
+	// 1ブロックで読む音声のフレーム数は、レートの比の分とsincの前後と線形補間の1フレーム
+	size_t maxSourceFrames = size_t(blockFrames) * kMaxRateRatio + kMaxSincTaps + 2;
+	sourceLeft.assign(maxSourceFrames, 0.0f);
+	sourceRight.assign(maxSourceFrames, 0.0f);
+	resampledLeft.assign(blockFrames, 0.0f);
+	resampledRight.assign(blockFrames, 0.0f);
+	mixLeft.assign(blockFrames, 0.0f);
+	mixRight.assign(blockFrames, 0.0f);
+	blockOutput.assign(size_t(blockFrames) * kOutputChannels, 0.0f);
+
+	// 出力より高いレートの係数は、その音声を鳴らすときに作る
+	sincKernels.assign(size_t(kMaxRateRatio - 1) * kSincRatioSteps + 1, SincKernel());
+	CreateSincKernel(0);
+}
+
+uint32_t AudioMixer::Play(const Source& source, float gain, float pan, bool isLooping) {
+	const WaveFile::Format& format = source.format;
+
+	// 扱える形式か
+	SampleType sampleType;
+	uint16_t sampleFormat = format.GetSampleFormat();
+	if (sampleFormat == WaveFile::kFormatPcm && format.bitsPerSample == 16) {
+		sampleType = SampleType::kPcm16;
+	} else if (sampleFormat == WaveFile::kFormatPcm && format.bitsPerSample == 24) {
+		sampleType = SampleType::kPcm24;
+	} else if (sampleFormat == WaveFile::kFormatFloat && format.bitsPerSample == 32) {
+		sampleType = SampleType::kFloat;
+	} else {
+		return kInvalidHandle;
+	}
+	if (source.data == nullptr || format.channelCount == 0 || format.sampleRate == 0 ||
+		format.blockAlign < format.channelCount * (format.bitsPerSample / 8) ||
+		format.sampleRate > sampleRate * kMaxRateRatio) {
+		return kInvalidHandle;
+	}
+	uint32_t frameCount = source.size / format.blockAlign;
+	if (frameCount == 0) {
+		return kInvalidHandle;
+	}
+
+	// 空きボイス
+	Voice* voice = nullptr;
+	for (Voice& candidate : voices) {
+		if (!candidate.isActive) {
+			voice = &candidate;
+			break;
+		}
+	}
+	if (voice == nullptr) {
+		return kInvalidHandle;
+	}
+
+	voice->source = source;
+	voice->sampleType = sampleType;
+	voice->channelCount = format.channelCount;
+	voice->frameCount = frameCount;
+	voice->position = 0;
+	voice->step = (uint64_t(format.sampleRate) << 32) / sampleRate;
+	voice->sincKernelIndex = GetSincKernelIndex(voice->step);
+	CreateSincKernel(voice->sincKernelIndex);
+	voice->gain = gain;
+	voice->pan = pan;
+	ComputeGains(gain, pan, voice->channelCount, &voice->currentLeftGain, &voice->currentRightGain);
+	voice->generation = (voice->generation + 1) % 0xFFFFFF;
+	voice->isActive = true;
+	voice->isLooping = isLooping;
+	++activeVoiceCount;
+
+	// 下位8bitがボイス番号
+	uint32_t index = static_cast<uint32_t>(voice - voices.data());
+	return (voice->generation << 8) | index;
+}
+
+void AudioMixer::Stop(uint32_t handle) {
+	Voice* voice = FindVoice(handle);
+	if (voice != nullptr) {
+		ReleaseVoice(*voice);
+	}
+}
+
+void AudioMixer::StopAll() {
+	for (Voice& voice : voices) {
+		if (voice.isActive) {
+			ReleaseVoice(voice);
+		}
+	}
+}
+
+bool AudioMixer::IsPlaying(uint32_t handle) const {
+	return FindVoice(handle) != nullptr;
+}
+
+void AudioMixer::SetGain(uint32_t handle, float gain) {
+	Voice* voice = FindVoice(handle);
+	if (voice != nullptr) {
+		voice->gain = gain;
+	}
+}
+
+void AudioMixer::SetPan(uint32_t handle, float pan) {
+	Voice* voice = FindVoice(handle);
+	if (voice != nullptr) {
+		voice->pan = pan;
+	}
+}
+
+void AudioMixer::Mix(float* output, uint32_t frameCount) {
+	assert(frameCount <= blockFrames);
+	if (frameCount == 0) {
+		return;
+	}
+
+	std::fill(mixLeft.begin(), mixLeft.begin() + frameCount, 0.0f);
+	std::fill(mixRight.begin(), mixRight.begin() + frameCount, 0.0f);
+
+	for (Voice& voice : voices) {
+		if (!voice.isActive) {
+			continue;
+		}
+		if (!MixVoice(voice, frameCount)) {
+			ReleaseVoice(voice);
+		}
+		++mixedVoiceBlocks;
+	}
+
+	InterleaveStereo(mixLeft.data(), mixRight.data(), frameCount, output);
+	mixedFrames += frameCount;
+}
+
+void AudioMixer::Render(IAudioSink* sink) {
+	uint32_t blockCount = sink->GetWritableBlockCount();
+	for (uint32_t i = 0; i < blockCount; ++i) {
+		Mix(blockOutput.data(), blockFrames);
+		sink->Write(blockOutput.data(), blockFrames);
+	}
+}
+
+uint32_t AudioMixer::GetSincKernelIndex(uint64_t step) {
+	const uint64_t one = 1ull << 32;
+	if (step <= one) {
+		return 0;
+	}
+
+	// 比を1/kSincRatioSteps刻みで切り上げる（遮断周波数は少し低めになる側に寄せる）
+	uint64_t index = ((step - one) * kSincRatioSteps + one - 1) >> 32;
+	return uint32_t(std::min<uint64_t>(index, uint64_t(kMaxRateRatio - 1) * kSincRatioSteps));
+}
+
+void AudioMixer::CreateSincKernel(uint32_t index) {
+	SincKernel& kernel = sincKernels[index];
+	if (!kernel.table.empty()) {
+		return;
+	}
+
+	// 出力より高いレートは、遮断周波数を比の分だけ下げて出力のナイキスト周波数より上を落とし、
+	// 係数の零点の間隔が広がる分だけタップを増やす（4の倍数に切り上げる）
+	double ratio = 1.0 + double(index) / kSincRatioSteps;
+	double cutoff = kSincCutoff / ratio;
+	uint32_t taps = (uint32_t(std::ceil(kSincTaps * ratio)) + 3) / 4 * 4;
+	assert(taps <= kMaxSincTaps);
+	kernel.taps = taps;
+	kernel.historyFrames = taps / 2 - 1;
+
+	// 小数位置ごとに、Blackman窓を掛けたsincを合計が1になるように並べる
+	// 位置0.0と1.0の両端を含めるのでkSincPhases + 1行
+	kernel.table.assign(size_t(kSincPhases + 1) * taps, 0.0f);
+	for (uint32_t phase = 0; phase <= kSincPhases; ++phase) {
+		double fraction = double(phase) / kSincPhases;
+		float* row = &kernel.table[size_t(phase) * taps];
+		double sum = 0.0;
+		for (uint32_t k = 0; k < taps; ++k) {
+
+			// タップkの音声のフレームと、いまの位置との距離
+			double distance = double(k) - double(kernel.historyFrames) - fraction;
+			double x = distance * cutoff;
+			double sinc = std::fabs(x) < 1e-9 ? 1.0 : std::sin(kPi * x) / (kPi * x);
+
+			// 窓は距離-taps/2～taps/2で0～1～0になる
+			double t = (distance + taps * 0.5) / taps;
+			double window = 0.42 - 0.5 * std::cos(2.0 * kPi * t) + 0.08 * std::cos(4.0 * kPi * t);
+			double weight = (t <= 0.0 || t >= 1.0) ? 0.0 : sinc * window;
+			row[k] = float(weight);
+			sum += weight;
+		}
+		for (uint32_t k = 0; k < taps; ++k) {
+			row[k] = float(row[k] / sum);
+		}
+	}
+}
+
+AudioMixer::Voice* AudioMixer::FindVoice(uint32_t handle) {
+	return const_cast<Voice*>(static_cast<const AudioMixer*>(this)->FindVoice(handle));
+}
+
+const AudioMixer::Voice* AudioMixer::FindVoice(uint32_t handle) const {
+	if (handle == kInvalidHandle) {
+		return nullptr;
+	}
+	const Voice& voice = voices[handle & 0xFF];
+	if (!voice.isActive || voice.generation != (handle >> 8)) {
+		return nullptr;
+	}
+	return &voice;
+}
+
+bool AudioMixer::MixVoice(Voice& voice, uint32_t frameCount) {
+	bool isStereo = voice.channelCount >= 2;
+
+	// このブロックで読む音声の範囲（今の位置の前後にsincのタップの分）
+	int64_t baseFrame = int64_t(voice.position >> 32);
+	uint64_t fraction = voice.position & 0xFFFFFFFFull;
+	uint32_t lastOffset = uint32_t((fraction + voice.step * (frameCount - 1)) >> 32);
+	const SincKernel& kernel = sincKernels[voice.sincKernelIndex];
+	uint32_t decodeCount = lastOffset + kernel.taps + 1;
+	DecodeFrames(voice, baseFrame - kernel.historyFrames, decodeCount, sourceLeft.data(), sourceRight.data());
+	const float* sourceL = sourceLeft.data() + kernel.historyFrames;
+	const float* sourceR = isStereo ? sourceRight.data() + kernel.historyFrames : sourceL;
+
+	// 出力のサンプリングレートにする（同じレートで位置が整数ならそのまま使う）
+	const float* left = sourceL;
+	const float* right = sourceR;
+	if (voice.step != (1ull << 32) || fraction != 0) {
+		if (currentResampler == Resampler::kLinear) {
+			ResampleLinear(sourceL, fraction, voice.step, frameCount, resampledLeft.data());
+			if (isStereo) {
+				ResampleLinear(sourceR, fraction, voice.step, frameCount, resampledRight.data());
+			}
+		} else {
+			ResampleSinc(sourceL, fraction, voice.step, frameCount,
+				kernel.table.data(), kernel.taps, kernel.historyFrames, resampledLeft.data());
+			if (isStereo) {
+				ResampleSinc(sourceR, fraction, voice.step, frameCount,
+					kernel.table.data(), kernel.taps, kernel.historyFrames, resampledRight.data());
+			}
+		}
+		left = resampledLeft.data();
+		right = isStereo ? resampledRight.data() : left;
+	}
+
+	// 前のブロックの音量から目標の音量へ変えながら足す（急に変えるとプツッと鳴る）
+	float leftGain;
+	float rightGain;
+	ComputeGains(voice.gain, voice.pan, voice.channelCount, &leftGain, &rightGain);
+	AccumulateWithGain(left, mixLeft.data(), frameCount, voice.currentLeftGain, leftGain);
+	AccumulateWithGain(right, mixRight.data(), frameCount, voice.currentRightGain, rightGain);
+	voice.currentLeftGain = leftGain;
+	voice.currentRightGain = rightGain;
+
+	// 進める（ループなら先頭に戻す）
+	voice.position += voice.step * frameCount;
+	uint64_t end = uint64_t(voice.frameCount) << 32;
+	if (voice.position >= end) {
+		if (!voice.isLooping) {
+			return false;
+		}
+		voice.position %= end;
+	}
+	return true;
+}
+
+void AudioMixer::DecodeFrames(const Voice& voice, int64_t startFrame, uint32_t count, float* left, float* right) const {
+	const WaveFile::Format& format = voice.source.format;
+	int64_t frameCount = voice.frameCount;
+	if (voice.channelCount < 2) {
+		right = nullptr;
+	}
+
+	uint32_t written = 0;
+	int64_t frame = startFrame;
+	while (written < count) {
+		uint32_t remaining = count - written;
+
+		// 範囲外（ループしないなら0、ループするなら反対側から続ける）
+		int64_t sourceFrame = frame;
+		if (voice.isLooping) {
+			sourceFrame = ((frame % frameCount) + frameCount) % frameCount;
+		} else if (frame < 0 || frame >= frameCount) {
+			uint32_t silentCount = frame < 0 ? uint32_t(std::min<int64_t>(remaining, -frame)) : remaining;
+			std::fill(left + written, left + written + silentCount, 0.0f);
+			if (right != nullptr) {
+				std::fill(right + written, right + written + silentCount, 0.0f);
+			}
+			written += silentCount;
+			frame += silentCount;
+			continue;
+		}
+
+		// 音声の終わりまでまとめて変換する
+		uint32_t runCount = uint32_t(std::min<int64_t>(remaining, frameCount - sourceFrame));
+		const uint8_t* source = voice.source.data + size_t(sourceFrame) * format.blockAlign;
+		float* runRight = right != nullptr ? right + written : nullptr;
+		switch (voice.sampleType) {
+		case SampleType::kPcm16:
+			ConvertPcm16(source, format.blockAlign, voice.channelCount, runCount, left + written, runRight);
+			break;
+		case SampleType::kPcm24:
+			ConvertPcm24(source, format.blockAlign, runCount, left + written, runRight);
+			break;
+		case SampleType::kFloat:
+			ConvertFloat(source, format.blockAlign, voice.channelCount, runCount, left + written, runRight);
+			break;
+		}
+		written += runCount;
+		frame += runCount;
+	}
+}
+
+void AudioMixer::ReleaseVoice(Voice& voice) {
+	voice.isActive = false;
+	voice.source = {};
+	--activeVoiceCount;
+}
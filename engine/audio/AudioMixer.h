@@ -0,0 +1,210 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "WaveFile.h"
+
+// ミキサーの出力先
+class IAudioSink {
+public:
+	virtual ~IAudioSink() = default;
+
+	// いま受け取れるブロック数
+	virtual uint32_t GetWritableBlockCount() = 0;
+
+	// 1ブロック分の波形（ステレオのfloatを左右交互に並べたもの）を渡す
+	virtual void Write(const float* samples, uint32_t frameCount) = 0;
+};
+
+// どこにも鳴らさない出力先（ヘッドレスでの実行や計測用）
+// 毎回決まった数のブロックを受け取り、受け取ったフレーム数と最大振幅だけを数える
+class NullAudioSink : public IAudioSink {
+public:
+
+	// 一回のRenderで受け取るブロック数
+	void SetWritableBlockCount(uint32_t count) { writableBlockCount = count; }
+
+	uint32_t GetWritableBlockCount() override { return writableBlockCount; }
+	void Write(const float* samples, uint32_t frameCount) override;
+
+	// 受け取ったフレーム数と最大振幅
+	uint64_t GetWrittenFrames() const { return writtenFrames; }
+	float GetPeak() const { return peak; }
+
+private:
+	uint32_t writableBlockCount = 1;
+	uint64_t writtenFrames = 0;
+	float peak = 0.0f;
+};
+
+// ソフトウェアのミキサー
+// PCM16/PCM24/floatの音声を出力のサンプリングレートに変換し、ボイスごとの音量とパンを掛けて
+// 一つのステレオのfloatのブロックに足し合わせる（ハードウェアのボイスは出力先の一つだけで済む）
+// Windowsに依存しないので単体で計測できる。スレッドセーフではない（一つのスレッドから使う）
+class AudioMixer {
+public:
+
+	// 同時に鳴らせるボイス数
+	static const uint32_t kMaxVoices = 256;
+
+	// 出力のチャンネル数（ステレオ）
+	static const uint32_t kOutputChannels = 2;
+
+	// 既定の出力のサンプリングレートとブロックのフレーム数
+	static const uint32_t kDefaultSampleRate = 48000;
+	static const uint32_t kDefaultBlockFrames = 1024;
+
+	// 出力より何倍まで高いサンプリングレートの音声を扱うか
+	static const uint32_t kMaxRateRatio = 4;
+
+	// 窓付きsincのタップ数と、小数位置の分割数
+	// 出力より高いレートの音声は、遮断周波数を出力のナイキスト周波数に合わせて下げ、その分だけ係数を広げてタップを増やす
+	static const uint32_t kSincTaps = 16;
+	static const uint32_t kSincPhases = 256;
+
+	// レートの比を何分の1刻みで切り上げて係数を作り分けるか（比が1より大きいときだけ）
+	static const uint32_t kSincRatioSteps = 8;
+
+	// 一番広い係数のタップ数（4の倍数）
+	static const uint32_t kMaxSincTaps = kSincTaps * kMaxRateRatio;
+
+	// 再生できなかったときのハンドル
+	static const uint32_t kInvalidHandle = 0xFFFFFFFF;
+
+	// サンプリングレートの変換方法
+	enum class Resampler {
+		kLinear, // 線形補間（軽い）
+		kSinc,   // 窓付きsinc（高音がこもらない）
+	};
+
+	// 鳴らす音声
+	struct Source {
+		const uint8_t* data = nullptr; // 波形の先頭
+		uint32_t size = 0;             // 波形のバイト数
+		WaveFile::Format format = {};
+		std::shared_ptr<const void> owner; // 再生が終わるまで持っておくもの（無くてもよい）
+	};
+
+	// 初期化
+	void Initialize(uint32_t sampleRate = kDefaultSampleRate, uint32_t blockFrames = kDefaultBlockFrames);
+
+	// 鳴らす（扱えない形式やボイスが足りないときはkInvalidHandle）
+	// panは-1で左、0で中央、1で右。ステレオの音声には左右の音量の配分として掛ける
+	uint32_t Play(const Source& source, float gain = 1.0f, float pan = 0.0f, bool isLooping = false);
+
+	// 止める
+	void Stop(uint32_t handle);
+	void StopAll();
+
+	// 再生中か
+	bool IsPlaying(uint32_t handle) const;
+
+	// 音量とパン（次のブロックで滑らかに変わる）
+	void SetGain(uint32_t handle, float gain);
+	void SetPan(uint32_t handle, float pan);
+
+	// サンプリングレートの変換方法（全ボイス共通）
+	void SetResampler(Resampler resampler) { currentResampler = resampler; }
+	Resampler GetResampler() const { return currentResampler; }
+
+	// frameCountフレーム分を混ぜて、左右交互のfloatでoutputに書く（frameCountはブロックのフレーム数まで）
+	void Mix(float* output, uint32_t frameCount);
+
+	// 出力先が受け取れるだけブロックを混ぜて渡す
+	void Render(IAudioSink* sink);
+
+	uint32_t GetSampleRate() const { return sampleRate; }
+	uint32_t GetBlockFrames() const { return blockFrames; }
+
+	// 再生中のボイス数
+	uint32_t GetActiveVoiceCount() const { return activeVoiceCount; }
+
+	// 今までに混ぜたボイスのブロック数と、混ぜたフレーム数
+	uint64_t GetMixedVoiceBlocks() const { return mixedVoiceBlocks; }
+	uint64_t GetMixedFrames() const { return mixedFrames; }
+
+private:
+
+	// 波形のサンプルの形式
+	enum class SampleType {
+		kPcm16,
+		kPcm24,
+		kFloat,
+	};
+
+	// ボイス一つ分
+	struct Voice {
+		Source source;
+		SampleType sampleType = SampleType::kPcm16;
+		uint32_t channelCount = 0;
+		uint32_t frameCount = 0;   // 音声のフレーム数
+
+		// 読む位置（32.32の固定小数）と、出力1フレームで進む量
+		uint64_t position = 0;
+		uint64_t step = 0;
+
+		// 使う窓付きsincの係数（sincKernelsの番号）
+		uint32_t sincKernelIndex = 0;
+
+		// 目標の音量と、前のブロックの終わりの左右の音量
+		float gain = 1.0f;
+		float pan = 0.0f;
+		float currentLeftGain = 0.0f;
+		float currentRightGain = 0.0f;
+
+		uint32_t generation = 0;
+		bool isActive = false;
+		bool isLooping = false;
+	};
+
+	uint32_t sampleRate = kDefaultSampleRate;
+	uint32_t blockFrames = kDefaultBlockFrames;
+	Resampler currentResampler = Resampler::kSinc;
+
+	std::array<Voice, kMaxVoices> voices;
+	uint32_t activeVoiceCount = 0;
+
+	// 窓付きsincの係数（小数位置ごとにtapsずつ）
+	struct SincKernel {
+		uint32_t taps = 0;          // 4の倍数
+		uint32_t historyFrames = 0; // 今の位置より前に使うフレーム数（後ろはtaps / 2フレーム）
+		std::vector<float> table;
+	};
+
+	// レートの比ごとの係数（0番は比が1以下のとき。ほかは使うときに作る）
+	std::vector<SincKernel> sincKernels;
+
+	// 作業用（左右別々に並べる）
+	std::vector<float> sourceLeft;   // 変換前の音声をfloatにしたもの
+	std::vector<float> sourceRight;
+	std::vector<float> resampledLeft; // 出力のサンプリングレートにしたもの
+	std::vector<float> resampledRight;
+	std::vector<float> mixLeft;       // 全ボイスを足したもの
+	std::vector<float> mixRight;
+	std::vector<float> blockOutput;   // Renderで渡すブロック
+
+	// 統計
+	uint64_t mixedVoiceBlocks = 0;
+	uint64_t mixedFrames = 0;
+
+	// レートの比の刻み（0は比が1以下）
+	static uint32_t GetSincKernelIndex(uint64_t step);
+
+	// index番の窓付きsincの係数を作る（作ってあれば何もしない）
+	void CreateSincKernel(uint32_t index);
+
+	// ハンドルのボイス（終わっていればnullptr）
+	Voice* FindVoice(uint32_t handle);
+	const Voice* FindVoice(uint32_t handle) const;
+
+	// 一つのボイスをframeCountフレーム分混ぜる（最後まで鳴らしたらfalse）
+	bool MixVoice(Voice& voice, uint32_t frameCount);
+
+	// 音声のstartFrameからcountフレームをfloatにする（範囲外は0か、ループなら先頭から）
+	void DecodeFrames(const Voice& voice, int64_t startFrame, uint32_t count, float* left, float* right) const;
+
+	// ボイスを空きに戻す
+	void ReleaseVoice(Voice& voice);
+};
@@ -0,0 +1,46 @@
+#include "AudioRingBuffer.h"
+#include <cassert>
+
+void AudioRingBuffer::Initialize(size_t size, uint32_t count) {
+	assert(size > 0 && count > 0);
+	blockSize = size;
+	blockCount = count;
+	storage.assign(blockSize * blockCount, 0);
+	Reset();
+}
+
+uint8_t* AudioRingBuffer::AcquireBlock() {
+
+	// 返ってきた数はacquireで読み、返されたブロックの中身を書き換えてよいことを保証する
+	uint32_t submitted = submittedCount.load(std::memory_order_relaxed);
+	uint32_t released = releasedCount.load(std::memory_order_acquire);
+	if (submitted - released >= blockCount) {
+		return nullptr;
+	}
+	return storage.data() + (submitted % blockCount) * blockSize;
+}
+
+void AudioRingBuffer::SubmitBlock() {
+	uint32_t submitted = submittedCount.load(std::memory_order_relaxed);
+	assert(submitted - releasedCount.load(std::memory_order_relaxed) < blockCount);
+
+	// 書いた中身が読む側に見えるようにreleaseで進める
+	submittedCount.store(submitted + 1, std::memory_order_release);
+}
+
+void AudioRingBuffer::ReleaseBlock() {
+	uint32_t released = releasedCount.load(std::memory_order_relaxed);
+	assert(submittedCount.load(std::memory_order_acquire) != released);
+	releasedCount.store(released + 1, std::memory_order_release);
+}
+
+uint32_t AudioRingBuffer::GetQueuedCount() const {
+	uint32_t released = releasedCount.load(std::memory_order_acquire);
+	return submittedCount.load(std::memory_order_acquire) - released;
+}
+
+void AudioRingBuffer::Reset() {
+	assert(IsEmpty());
+	submittedCount.store(0, std::memory_order_relaxed);
+	releasedCount.store(0, std::memory_order_relaxed);
+}
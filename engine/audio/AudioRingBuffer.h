@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ストリーミング再生用の固定サイズのブロックのリング
+// 書き込む側（メインスレッド）が空いたブロックに波形を詰めて渡し、
+// 読む側（XAudio2のコールバックのスレッド）が再生し終わったブロックを返す。
+// 書く側・返す側がそれぞれ一つだけなので、ロックを使わずカウンタ二つで受け渡す
+class AudioRingBuffer {
+public:
+
+	// 既定のブロック数（再生中と次に再生するものの二つ）
+	static const uint32_t kDefaultBlockCount = 2;
+
+	// 初期化（使う前に一回だけ。再生中に呼んではいけない）
+	void Initialize(size_t size, uint32_t count = kDefaultBlockCount);
+
+	// 書き込める空きブロック（全部渡している間はnullptr）【書く側】
+	uint8_t* AcquireBlock();
+
+	// AcquireBlockで受け取ったブロックを書き終えて渡す【書く側】
+	void SubmitBlock();
+
+	// 渡されたブロックを使い終えて返す（渡された順に返す）【読む側】
+	void ReleaseBlock();
+
+	// 渡したまま返ってきていないブロック数（どちらのスレッドからでも呼べる）
+	uint32_t GetQueuedCount() const;
+
+	// 全部返ってきたか
+	bool IsEmpty() const { return GetQueuedCount() == 0; }
+
+	// カウンタを戻す（全部返ってきてから書く側が呼ぶ）
+	void Reset();
+
+	size_t GetBlockSize() const { return blockSize; }
+	uint32_t GetBlockCount() const { return blockCount; }
+
+	// 今までに渡したブロック数
+	uint32_t GetSubmittedCount() const { return submittedCount.load(std::memory_order_relaxed); }
+
+private:
+
+	// ブロックをつなげた領域
+	std::vector<uint8_t> storage;
+	size_t blockSize = 0;
+	uint32_t blockCount = 0;
+
+	// 渡した数と返ってきた数（それぞれ片方のスレッドしか書かない。あふれても差は正しい）
+	std::atomic<uint32_t> submittedCount{ 0 };
+	std::atomic<uint32_t> releasedCount{ 0 };
+};
@@ -0,0 +1,206 @@
+#include "SoundBank.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include "StringUtility.h"
+
+namespace {
+
+	// 境界に切り上げる
+	inline uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// 境界まで0で埋める
+	void WritePadding(std::ofstream& file, uint64_t alignment) {
+		static const char kZeros[SoundBank::kDataAlignment] = {};
+		uint64_t position = static_cast<uint64_t>(file.tellp());
+		file.write(kZeros, static_cast<std::streamsize>(AlignUp(position, alignment) - position));
+	}
+
+	// 波形を写すときのバッファのサイズ
+	const size_t kCopyBufferSize = 64 * 1024;
+}
+
+bool SoundBank::Build(const std::string& filePath, const std::vector<SourceFile>& sources) {
+	uint32_t soundCount = static_cast<uint32_t>(sources.size());
+
+	// ヘッダだけを読んで、波形の形式と位置を調べる
+	std::vector<Entry> sourceEntries(soundCount);
+	std::vector<uint64_t> sourceDataOffsets(soundCount);
+	for (uint32_t i = 0; i < soundCount; ++i) {
+		std::ifstream source(StringUtility::ConvertToPath(sources[i].filePath), std::ios::binary);
+		WaveFile::Info info;
+		if (!source || !WaveFile::ReadHeader(source, info)) {
+			return false;
+		}
+		Entry& entry = sourceEntries[i];
+		entry = {};
+		entry.nameHash = HashName(sources[i].name.data(), sources[i].name.size());
+		entry.nameLength = static_cast<uint32_t>(sources[i].name.size());
+		entry.format = info.format;
+		entry.dataSize = info.dataSize;
+		sourceDataOffsets[i] = info.dataOffset;
+	}
+
+	// ハッシュ順に並べる（同じハッシュは名前順。同じ名前は引けないので失敗にする）
+	std::vector<uint32_t> order(soundCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+		if (sourceEntries[a].nameHash != sourceEntries[b].nameHash) {
+			return sourceEntries[a].nameHash < sourceEntries[b].nameHash;
+		}
+		return sources[a].name < sources[b].name;
+		});
+	for (uint32_t i = 1; i < soundCount; ++i) {
+		if (sources[order[i - 1]].name == sources[order[i]].name) {
+			return false;
+		}
+	}
+
+	// 位置を決める
+	std::vector<Entry> fileEntries(soundCount);
+	std::string nameTable;
+	for (uint32_t i = 0; i < soundCount; ++i) {
+		fileEntries[i] = sourceEntries[order[i]];
+		fileEntries[i].nameOffset = static_cast<uint32_t>(nameTable.size());
+		nameTable += sources[order[i]].name;
+	}
+	Header fileHeader{};
+	fileHeader.magic = kMagic;
+	fileHeader.version = kVersion;
+	fileHeader.soundCount = soundCount;
+	fileHeader.nameTableSize = static_cast<uint32_t>(nameTable.size());
+	fileHeader.nameTableOffset = sizeof(Header) + sizeof(Entry) * uint64_t(soundCount);
+	uint64_t dataOffset = fileHeader.nameTableOffset + fileHeader.nameTableSize;
+	for (Entry& entry : fileEntries) {
+		entry.dataOffset = AlignUp(dataOffset, kDataAlignment);
+		dataOffset = entry.dataOffset + entry.dataSize;
+	}
+
+	std::ofstream file(StringUtility::ConvertToPath(filePath), std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+	file.write(reinterpret_cast<const char*>(fileEntries.data()), sizeof(Entry) * fileEntries.size());
+	file.write(nameTable.data(), static_cast<std::streamsize>(nameTable.size()));
+
+	// 波形（元のファイルのdataチャンクをそのまま写す）
+	std::vector<char> buffer(kCopyBufferSize);
+	for (uint32_t i = 0; i < soundCount; ++i) {
+		std::ifstream source(StringUtility::ConvertToPath(sources[order[i]].filePath), std::ios::binary);
+		source.seekg(static_cast<std::streamoff>(sourceDataOffsets[order[i]]), std::ios::beg);
+		WritePadding(file, kDataAlignment);
+		uint32_t remaining = fileEntries[i].dataSize;
+		while (remaining > 0) {
+			uint32_t copySize = std::min<uint32_t>(remaining, static_cast<uint32_t>(buffer.size()));
+			if (!source.read(buffer.data(), copySize)) {
+				return false;
+			}
+			file.write(buffer.data(), copySize);
+			remaining -= copySize;
+		}
+	}
+	return file.good();
+}
+
+uint64_t SoundBank::HashName(const char* name, size_t length) {
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < length; ++i) {
+		hash ^= static_cast<uint8_t>(name[i]);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+bool SoundBank::Open(const std::string& filePath) {
+	Close();
+	std::shared_ptr<MappedFile> mappedFile = std::make_shared<MappedFile>();
+	if (!mappedFile->Open(filePath) || mappedFile->GetSize() < sizeof(Header)) {
+		return false;
+	}
+
+	// 形式と範囲を確かめる（目次だけを見て、波形には触らない）
+	uint64_t fileSize = mappedFile->GetSize();
+	const Header* fileHeader = reinterpret_cast<const Header*>(mappedFile->GetData());
+	bool isValid = fileHeader->magic == kMagic && fileHeader->version == kVersion &&
+		sizeof(Header) + sizeof(Entry) * uint64_t(fileHeader->soundCount) <= fileHeader->nameTableOffset &&
+		fileHeader->nameTableOffset + fileHeader->nameTableSize <= fileSize;
+	if (isValid) {
+		const Entry* fileEntries = reinterpret_cast<const Entry*>(mappedFile->GetData() + sizeof(Header));
+		for (uint32_t i = 0; i < fileHeader->soundCount && isValid; ++i) {
+			const Entry& entry = fileEntries[i];
+			isValid = uint64_t(entry.nameOffset) + entry.nameLength <= fileHeader->nameTableSize &&
+				entry.format.channelCount != 0 && entry.format.sampleRate != 0 && entry.format.blockAlign != 0 &&
+				entry.dataSize % entry.format.blockAlign == 0 &&
+				entry.dataOffset % kDataAlignment == 0 && entry.dataOffset + entry.dataSize <= fileSize &&
+				(i == 0 || fileEntries[i - 1].nameHash <= entry.nameHash);
+		}
+	}
+	if (!isValid) {
+		return false;
+	}
+	header = fileHeader;
+	entries = reinterpret_cast<const Entry*>(mappedFile->GetData() + sizeof(Header));
+	names = mappedFile->GetData() + fileHeader->nameTableOffset;
+	file = std::move(mappedFile);
+	return true;
+}
+
+void SoundBank::Close() {
+	file.reset();
+	header = nullptr;
+	entries = nullptr;
+	names = nullptr;
+}
+
+uint32_t SoundBank::Find(const std::string& name) const {
+	if (header == nullptr) {
+		return kNotFound;
+	}
+
+	// ハッシュが同じ範囲を二分探索で探し、その中で名前を比べる
+	uint64_t hash = HashName(name.data(), name.size());
+	const Entry* end = entries + header->soundCount;
+	const Entry* entry = std::lower_bound(entries, end, hash,
+		[](const Entry& a, uint64_t b) { return a.nameHash < b; });
+	for (; entry != end && entry->nameHash == hash; ++entry) {
+		if (entry->nameLength == name.size() && std::memcmp(names + entry->nameOffset, name.data(), name.size()) == 0) {
+			return static_cast<uint32_t>(entry - entries);
+		}
+	}
+	return kNotFound;
+}
+
+SoundData SoundBank::GetSound(uint32_t index) const {
+	assert(index < GetSoundCount());
+	if (index >= GetSoundCount()) {
+		return {};
+	}
+	const Entry& entry = entries[index];
+	SoundData soundData = {};
+	soundData.format = entry.format;
+	soundData.pBuffer = reinterpret_cast<const uint8_t*>(file->GetData() + entry.dataOffset);
+	soundData.bufferSize = entry.dataSize;
+	soundData.storage = file;
+	return soundData;
+}
+
+SoundData SoundBank::GetSound(const std::string& name) const {
+	uint32_t index = Find(name);
+	if (index == kNotFound) {
+		return {};
+	}
+	return GetSound(index);
+}
+
+std::string SoundBank::GetName(uint32_t index) const {
+	assert(index < GetSoundCount());
+	if (index >= GetSoundCount()) {
+		return {};
+	}
+	return std::string(names + entries[index].nameOffset, entries[index].nameLength);
+}
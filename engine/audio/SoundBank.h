@@ -0,0 +1,98 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "SoundData.h"
+#include "WaveFile.h"
+
+// 多数のWAVの波形を一つにまとめたサウンドバンク（.sbank）の形式と読み書きを行うクラス
+// [Header][Entry × soundCount][名前][波形 × soundCount]
+// 波形はkDataAlignment境界に置き、開くときはマップするだけで読み込まない（SoundDataはマップを直接指す）
+// 目次は名前のハッシュ順に並べておき、名前からは二分探索で引く
+class SoundBank {
+public:
+
+	// ファイルの先頭の識別子（"SBNK"）と形式のバージョン（変えたら上げる）
+	static const uint32_t kMagic = 0x4B4E4253u;
+	static const uint32_t kVersion = 1;
+
+	// 波形を置く境界（キャッシュライン）
+	static const uint32_t kDataAlignment = 64;
+
+	// 見つからなかったときの番号
+	static const uint32_t kNotFound = 0xFFFFFFFF;
+
+	// ヘッダ
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		uint32_t soundCount;
+		uint32_t nameTableSize;   // 名前をつなげたバイト数（終端は入れない）
+		uint64_t nameTableOffset; // ファイル先頭からのバイト数
+	};
+
+	// 目次の一項目
+	struct Entry {
+		uint64_t nameHash;      // HashNameの値（この順に並んでいる）
+		uint32_t nameOffset;    // 名前の表の中の位置
+		uint32_t nameLength;
+		WaveFile::Format format;
+		uint32_t dataSize;      // 波形のバイト数
+		uint32_t reserved;
+		uint64_t dataOffset;    // ファイル先頭からのバイト数
+	};
+	static_assert(sizeof(Entry) == 72, "Entry must not contain padding");
+
+	// まとめるWAVファイル
+	struct SourceFile {
+		std::string name;     // バンクの中での名前（Findで使う）
+		std::string filePath;
+	};
+
+	~SoundBank() { Close(); }
+
+	// WAVファイルを読み、波形だけを並べて書き出す（読めないWAVや名前の重複があればfalse）
+	static bool Build(const std::string& filePath, const std::vector<SourceFile>& sources);
+
+	// 名前のハッシュ（FNV-1a 64bit）
+	static uint64_t HashName(const char* name, size_t length);
+
+	// ファイルをメモリにマップして開く（形式が合わなければfalse）
+	bool Open(const std::string& filePath);
+
+	// 閉じる（再生中の音声はマップを持っているので、鳴り終わるまでマップは残る）
+	void Close();
+
+	bool IsOpen() const { return header != nullptr; }
+
+	// 音声の数
+	uint32_t GetSoundCount() const { return header != nullptr ? header->soundCount : 0; }
+
+	// 名前から番号を引く（無ければkNotFound）
+	uint32_t Find(const std::string& name) const;
+
+	// 番号の音声（波形はマップを直接指す）
+	SoundData GetSound(uint32_t index) const;
+
+	// 名前の音声（無ければ空のSoundData）
+	SoundData GetSound(const std::string& name) const;
+
+	// 番号の名前
+	std::string GetName(uint32_t index) const;
+
+	// ファイルのサイズと、そのうち物理メモリに載っているバイト数
+	size_t GetFileSize() const { return file != nullptr ? file->GetSize() : 0; }
+	size_t GetResidentSize() const { return file != nullptr ? file->GetResidentSize() : 0; }
+
+private:
+
+	// マップしたファイル（渡したSoundDataも持つ）
+	std::shared_ptr<MappedFile> file;
+
+	// ファイルの中の目次と名前
+	const Header* header = nullptr;
+	const Entry* entries = nullptr;
+	const char* names = nullptr;
+};
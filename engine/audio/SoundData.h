@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "WaveFile.h"
+
+// 読み込んだ音声データ
+// 波形はpBufferが指す先にあり、storageが持っている（コピーしても同じ波形を指す）
+// storageはLoadWaveで読んだ配列か、サウンドバンクのマップしたファイル
+struct SoundData {
+	WaveFile::Format format; // WAVEフォーマット（WAVEFORMATEXTENSIBLEと同じ並び）
+
+	// 波形の先頭アドレスとサイズ
+	const uint8_t* pBuffer = nullptr;
+	uint32_t bufferSize = 0;
+
+	// 波形の持ち主（再生中のボイスも持つので、鳴り終わるまで解放されない）
+	std::shared_ptr<const void> storage;
+};
@@ -0,0 +1,165 @@
+#include "WaveFile.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+	// リトルエンディアンの32bit値
+	uint32_t ReadUint32(const uint8_t* data) {
+		return uint32_t(data[0]) | (uint32_t(data[1]) << 8) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 24);
+	}
+
+	// RIFFヘッダを確かめて、チャンクを読む範囲の終わりを返す（失敗したら0）
+	uint64_t GetRiffEnd(const uint8_t* header, uint64_t fileSize) {
+		if (fileSize < 12 || std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0) {
+			return 0;
+		}
+
+		// 書きかけのファイルはサイズが0や最大値のことがあるので、ファイルの終わりまでにする
+		uint64_t riffEnd = 8ull + ReadUint32(header + 4);
+		return (riffEnd < 12 || riffEnd > fileSize) ? fileSize : riffEnd;
+	}
+
+	// 次のチャンクの位置（チャンクは2バイト境界に揃っている）
+	uint64_t GetNextChunkOffset(uint64_t bodyOffset, uint32_t chunkSize) {
+		return bodyOffset + chunkSize + (chunkSize & 1);
+	}
+}
+
+uint16_t WaveFile::Format::GetSampleFormat() const {
+	if (formatTag == kFormatExtensible) {
+		return uint16_t(subFormat[0] | (subFormat[1] << 8));
+	}
+	return formatTag;
+}
+
+bool WaveFile::Parse(const void* data, size_t size, Info& info) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	info = {};
+
+	uint64_t end = GetRiffEnd(bytes, size);
+	if (end == 0) {
+		return false;
+	}
+
+	// fmtとdataが揃うまでチャンクをたどる（どちらが先でもよい）
+	bool hasFormat = false;
+	bool hasData = false;
+	uint64_t offset = 12;
+	while (offset + 8 <= end && !(hasFormat && hasData)) {
+		const uint8_t* header = bytes + offset;
+		uint32_t chunkSize = ReadUint32(header + 4);
+		uint64_t bodyOffset = offset + 8;
+		uint32_t available = uint32_t(std::min<uint64_t>(chunkSize, end - bodyOffset));
+		++info.chunkCount;
+
+		if (!hasFormat && std::memcmp(header, "fmt ", 4) == 0) {
+			if (!ParseFormat(bytes + bodyOffset, available, info.format)) {
+				return false;
+			}
+			hasFormat = true;
+		} else if (!hasData && std::memcmp(header, "data", 4) == 0) {
+			info.dataOffset = bodyOffset;
+			info.dataSize = available;
+			hasData = true;
+		} else {
+			++info.skippedChunks;
+		}
+		offset = GetNextChunkOffset(bodyOffset, chunkSize);
+	}
+	return Validate(hasFormat, hasData, info);
+}
+
+bool WaveFile::ReadHeader(std::istream& stream, Info& info) {
+	info = {};
+
+	// ファイルサイズ
+	stream.seekg(0, std::ios_base::end);
+	std::streamoff fileSize = stream.tellg();
+	stream.seekg(0, std::ios_base::beg);
+	if (!stream || fileSize < 12) {
+		return false;
+	}
+
+	uint8_t riffHeader[12];
+	if (!stream.read(reinterpret_cast<char*>(riffHeader), sizeof(riffHeader))) {
+		return false;
+	}
+	uint64_t end = GetRiffEnd(riffHeader, uint64_t(fileSize));
+	if (end == 0) {
+		return false;
+	}
+
+	// Parseと同じたどり方で、fmt以外の中身は読まずにシークする
+	bool hasFormat = false;
+	bool hasData = false;
+	uint64_t offset = 12;
+	while (offset + 8 <= end && !(hasFormat && hasData)) {
+		uint8_t header[8];
+		stream.seekg(std::streamoff(offset), std::ios_base::beg);
+		if (!stream.read(reinterpret_cast<char*>(header), sizeof(header))) {
+			return false;
+		}
+		uint32_t chunkSize = ReadUint32(header + 4);
+		uint64_t bodyOffset = offset + 8;
+		uint32_t available = uint32_t(std::min<uint64_t>(chunkSize, end - bodyOffset));
+		++info.chunkCount;
+
+		if (!hasFormat && std::memcmp(header, "fmt ", 4) == 0) {
+			// 使うのは先頭の40バイトまで
+			uint8_t formatData[sizeof(Format)] = {};
+			uint32_t readSize = std::min<uint32_t>(available, uint32_t(sizeof(Format)));
+			if (!stream.read(reinterpret_cast<char*>(formatData), readSize)) {
+				return false;
+			}
+			if (!ParseFormat(formatData, available, info.format)) {
+				return false;
+			}
+			hasFormat = true;
+		} else if (!hasData && std::memcmp(header, "data", 4) == 0) {
+			info.dataOffset = bodyOffset;
+			info.dataSize = available;
+			hasData = true;
+		} else {
+			++info.skippedChunks;
+		}
+		offset = GetNextChunkOffset(bodyOffset, chunkSize);
+	}
+	stream.clear();
+	return Validate(hasFormat, hasData, info);
+}
+
+bool WaveFile::ParseFormat(const uint8_t* data, uint32_t size, Format& format) {
+
+	// 最低でもPCMWAVEFORMATの16バイトが要る
+	if (size < 16) {
+		return false;
+	}
+	format = {};
+	std::memcpy(&format, data, std::min<uint32_t>(size, uint32_t(sizeof(Format))));
+
+	// cbSizeの無い16バイトの形式
+	if (size < 18) {
+		format.extraSize = 0;
+	}
+
+	// 拡張形式は拡張部分まで揃っていないと形式が分からない
+	if (format.formatTag == kFormatExtensible && size < sizeof(Format)) {
+		return false;
+	}
+	return true;
+}
+
+bool WaveFile::Validate(bool hasFormat, bool hasData, Info& info) {
+	if (!hasFormat || !hasData) {
+		return false;
+	}
+	const Format& format = info.format;
+	if (format.channelCount == 0 || format.sampleRate == 0 || format.blockAlign == 0) {
+		return false;
+	}
+
+	// 半端なサンプルは使わない
+	info.dataSize -= info.dataSize % format.blockAlign;
+	return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+
+// WAVファイル（RIFF）のヘッダを解析するクラス
+// チャンクは順番を問わず、fmt と data 以外（LIST、JUNK、bext など）は読み飛ばす
+// Windowsに依存しないので単体で確認できる
+class WaveFile {
+public:
+
+	// WAVE_FORMAT_* のうち扱うもの
+	static const uint16_t kFormatPcm = 0x0001;
+	static const uint16_t kFormatFloat = 0x0003;
+	static const uint16_t kFormatExtensible = 0xFFFE;
+
+	// fmtチャンクの中身（WAVEFORMATEXTENSIBLEと同じ並びで40バイト）
+#pragma pack(push, 1)
+	struct Format {
+		uint16_t formatTag;
+		uint16_t channelCount;
+		uint32_t sampleRate;
+		uint32_t byteRate;       // 1秒あたりのバイト数
+		uint16_t blockAlign;     // 全チャンネル1サンプル分のバイト数
+		uint16_t bitsPerSample;
+		uint16_t extraSize;      // 以降の拡張部分のサイズ（WAVEFORMATEXのcbSize）
+		uint16_t validBitsPerSample;
+		uint32_t channelMask;
+		uint8_t subFormat[16];   // GUID（先頭2バイトがWAVE_FORMAT_*）
+
+		// 拡張形式も含めた本当の形式（kFormatPcmかkFormatFloat。それ以外はそのまま）
+		uint16_t GetSampleFormat() const;
+	};
+#pragma pack(pop)
+	static_assert(sizeof(Format) == 40, "Format must match WAVEFORMATEXTENSIBLE");
+
+	// 解析結果
+	struct Info {
+		Format format;
+		uint64_t dataOffset;     // ファイル先頭からdataチャンクの波形までのバイト数
+		uint32_t dataSize;       // 波形のバイト数（blockAlignの倍数に切り捨て）
+		uint32_t chunkCount;     // RIFFの中のチャンク数（fmt/dataまで含む）
+		uint32_t skippedChunks;  // 読み飛ばしたチャンク数
+
+		// 拡張形式も含めた本当の形式
+		uint16_t GetSampleFormat() const { return format.GetSampleFormat(); }
+
+		// サンプル数（1チャンネル分）と秒数
+		uint32_t GetFrameCount() const { return format.blockAlign != 0 ? dataSize / format.blockAlign : 0; }
+		double GetSeconds() const { return format.sampleRate != 0 ? double(GetFrameCount()) / format.sampleRate : 0.0; }
+	};
+
+	// メモリ上のWAVファイルを解析する（失敗したらfalse）
+	// 途中で切れたファイルは、dataチャンクを残っている分だけにして読む
+	static bool Parse(const void* data, size_t size, Info& info);
+
+	// ストリームの先頭からヘッダだけを読んで解析する（波形は読まずにシークで飛ばす）
+	static bool ReadHeader(std::istream& stream, Info& info);
+
+private:
+
+	// fmtチャンクの中身を読む
+	static bool ParseFormat(const uint8_t* data, uint32_t size, Format& format);
+
+	// 見つかったfmtとdataが使えるか確かめて、dataSizeをblockAlignに揃える
+	static bool Validate(bool hasFormat, bool hasData, Info& info);
+};
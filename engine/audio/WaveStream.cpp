@@ -0,0 +1,68 @@
+#include "WaveStream.h"
+#include <algorithm>
+
+bool WaveStream::Open(const std::string& filePath) {
+	Close();
+
+	file.open(filePath, std::ios_base::binary);
+	if (!file.is_open()) {
+		return false;
+	}
+	if (!WaveFile::ReadHeader(file, info)) {
+		Close();
+		return false;
+	}
+	Rewind();
+	return true;
+}
+
+void WaveStream::Close() {
+	if (file.is_open()) {
+		file.close();
+	}
+	file.clear();
+	info = {};
+	position = 0;
+	readBytes = 0;
+}
+
+size_t WaveStream::Read(uint8_t* destination, size_t size, bool isLooping) {
+	if (!file.is_open() || info.dataSize == 0) {
+		return 0;
+	}
+
+	// 半端なサンプルを渡さないようにblockAlignに揃える
+	size -= size % info.format.blockAlign;
+
+	size_t total = 0;
+	while (total < size) {
+		if (IsEnd()) {
+			if (!isLooping) {
+				break;
+			}
+			Rewind();
+		}
+		size_t readSize = std::min<size_t>(size - total, info.dataSize - position);
+		if (!file.read(reinterpret_cast<char*>(destination + total), std::streamsize(readSize))) {
+
+			// ヘッダより短いファイルは読めた分までにする
+			readSize = size_t(file.gcount());
+			readSize -= readSize % info.format.blockAlign;
+			info.dataSize = position + uint32_t(readSize);
+			file.clear();
+			if (readSize == 0 && (!isLooping || info.dataSize == 0)) {
+				break;
+			}
+		}
+		position += uint32_t(readSize);
+		total += readSize;
+		readBytes += readSize;
+	}
+	return total;
+}
+
+void WaveStream::Rewind() {
+	position = 0;
+	file.clear();
+	file.seekg(std::streamoff(info.dataOffset), std::ios_base::beg);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "WaveFile.h"
+
+// WAVファイルの波形を少しずつ読むクラス
+// ヘッダだけを解析して開いておき、再生しながら必要な分だけを読む（ファイル全体をメモリに置かない）
+class WaveStream {
+public:
+
+	// 開いてヘッダを解析する（失敗したらfalse）
+	bool Open(const std::string& filePath);
+
+	// 閉じる
+	void Close();
+
+	bool IsOpen() const { return file.is_open(); }
+
+	// 解析結果
+	const WaveFile::Info& GetInfo() const { return info; }
+
+	// 次の波形をdestinationに読む（blockAlignの倍数だけ読む）
+	// isLoopingなら終わりで先頭に戻って続きを読む。戻り値は読んだバイト数（0なら終わり）
+	size_t Read(uint8_t* destination, size_t size, bool isLooping);
+
+	// 先頭に戻す
+	void Rewind();
+
+	// 最後まで読んだか
+	bool IsEnd() const { return position >= info.dataSize; }
+
+	// 今までにファイルから読んだバイト数
+	uint64_t GetReadBytes() const { return readBytes; }
+
+private:
+
+	std::ifstream file;
+	WaveFile::Info info = {};
+
+	// 波形の中の読む位置
+	uint32_t position = 0;
+
+	// 読んだバイト数
+	uint64_t readBytes = 0;
+};
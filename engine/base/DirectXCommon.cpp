@@ -3,7 +3,6 @@
 #include "Logger.h"
 #include <cassert>
 #include "DirectXTex/d3dx12.h"
-#include <thread>
 
 #pragma comment(lib, "d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -15,11 +14,14 @@ using namespace StringUtility;
 using namespace std;
 
 const uint32_t DirectXCommon::kMaxSRVCount = 512;
+const uint32_t DirectXCommon::kUploadFrameCount = DirectXCommon::kFramesInFlight;
+const uint64_t DirectXCommon::kUploadBufferSize = 8 * 1024 * 1024;
+const uint64_t DirectXCommon::kMaxUploadBufferSize = 256 * 1024 * 1024;
 
 void DirectXCommon::Initialize(WinApp* winApp) {
 
-	// FPS固定初期化
-	InitializeFixFps();
+	// フレームレート調整の初期化（60fps固定）
+	framePacer.Initialize(&frameClock, 60.0);
 
 	// Null
 	assert(winApp);
@@ -51,6 +53,9 @@ void DirectXCommon::Initialize(WinApp* winApp) {
 	// フェンスの生成
 	FenceInitialize();
 
+	// フレームごとのアップロードバッファの初期化
+	UploadBufferInitialize();
+
 	// ビューポート矩形の初期化
 	ViewportInitialize();
 
@@ -76,7 +81,7 @@ Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::CompileShader(
 	const std::wstring& filePath,
 	const wchar_t* profile) {
 
-	//Log(logStream, ConvertString(std::format(L"Begin CompileShader,path:{},profile:{}\n", filePath, profile)));
+	LOGEER_LOG(Level::kDebug, Category::kShader, "Begin CompileShader, path : {}, profile : {}", ConvertString(filePath), ConvertString(profile));
 
 	// hlslファイルを読む
 	Microsoft::WRL::ComPtr <IDxcBlobEncoding> shaderSource = nullptr;
@@ -116,8 +121,9 @@ Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::CompileShader(
 
 	if (shaderError != nullptr && shaderError->GetStringLength() != 0) {
 
-		// エラーがあったら出力する
-		//Log(logStream, shaderError->GetStringPointer());
+		// エラーがあったら出力する（止める前に出力し終わるのを待つ）
+		LOGEER_LOG(Level::kError, Category::kShader, "{}", shaderError->GetStringPointer());
+		Logger::GetInstance()->Flush();
 		assert(false);
 	}
 
@@ -127,7 +133,7 @@ Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::CompileShader(
 	assert(SUCCEEDED(hr));
 
 	// 成功したらログを出す
-//	Log(logStream, ConvertString(std::format(L"Compile Success,path:{},profile:{}\n", filePath, profile)));
+	LOGEER_LOG(Level::kDebug, Category::kShader, "Compile Success, path : {}, profile : {}", ConvertString(filePath), ConvertString(profile));
 
 	// shaderBlobを返す
 	return shaderBlob;
@@ -156,16 +162,24 @@ Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::CreateBufferResource(size_
 	return vertexResource;
 }
 
+namespace {
+	// metadataを基にResourceの設定を作る
+	D3D12_RESOURCE_DESC MakeTextureResourceDesc(const DirectX::TexMetadata& metadata) {
+		D3D12_RESOURCE_DESC resourceDesc{};
+		resourceDesc.Width = UINT(metadata.width); // Textureの幅
+		resourceDesc.Height = UINT(metadata.height); // Textureの高さ
+		resourceDesc.MipLevels = UINT16(metadata.mipLevels); // ミップマップの数
+		resourceDesc.DepthOrArraySize = UINT16(metadata.arraySize); // テクスチャの深さまたはアレイサイズ
+		resourceDesc.Format = metadata.format;
+		resourceDesc.SampleDesc.Count = 1;
+		resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION(metadata.dimension);
+		return resourceDesc;
+	}
+}
+
 Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::CreateTextuerResource(const DirectX::TexMetadata& metadata) {
 	// metadataを基にResourceの設定
-	D3D12_RESOURCE_DESC resourceDesc{};
-	resourceDesc.Width = UINT(metadata.width); // Textureの幅
-	resourceDesc.Height = UINT(metadata.height); // Textureの高さ
-	resourceDesc.MipLevels = UINT16(metadata.mipLevels); // ミップマップの数
-	resourceDesc.DepthOrArraySize = UINT16(metadata.arraySize); // テクスチャの深さまたはアレイサイズ
-	resourceDesc.Format = metadata.format;
-	resourceDesc.SampleDesc.Count = 1;
-	resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION(metadata.dimension);
+	D3D12_RESOURCE_DESC resourceDesc = MakeTextureResourceDesc(metadata);
 
 	// 利用するするHeapの設定
 	D3D12_HEAP_PROPERTIES heapProperties{};
@@ -184,6 +198,13 @@ Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::CreateTextuerResource(cons
 	return resource;
 }
 
+uint64_t DirectXCommon::GetTextureAllocationSize(const DirectX::TexMetadata& metadata) {
+	// 配置に必要なサイズ（アラインメント込み）
+	D3D12_RESOURCE_DESC resourceDesc = MakeTextureResourceDesc(metadata);
+	D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = device->GetResourceAllocationInfo(0, 1, &resourceDesc);
+	return allocationInfo.SizeInBytes;
+}
+
 Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::UploadTextureData(const Microsoft::WRL::ComPtr<ID3D12Resource>& texture, const DirectX::ScratchImage& mipImage) {
 	std::vector<D3D12_SUBRESOURCE_DATA> subresources;
 	DirectX::PrepareUpload(device.Get(), mipImage.GetImages(), mipImage.GetImageCount(), mipImage.GetMetadata(), subresources);
@@ -219,7 +240,7 @@ void DirectXCommon::DeviceInitialize() {
 		//
 		if (!(adapterDesc.Flags & DXGI_ADAPTER_FLAG3_SOFTWARE)) {
 
-			//Log(logStream, ConvertString(std::format(L"USE Adaptere:{}\n", adapterDesc.Description)));
+			LOGEER_LOG(Level::kInfo, Category::kGraphics, "Use Adapter : {}", ConvertString(std::wstring(adapterDesc.Description)));
 			break;
 		}
 		useAdapter = nullptr;
@@ -228,7 +249,7 @@ void DirectXCommon::DeviceInitialize() {
 	assert(useAdapter != nullptr);
 
 	D3D_FEATURE_LEVEL featureLevels[] = {
-		D3D_FEATURE_LEVEL_12_2,D3D_FEATURE_LEVEL_12_1,D3D_FEATURE_LEVEL_12_1,D3D_FEATURE_LEVEL_12_0
+		D3D_FEATURE_LEVEL_12_2,D3D_FEATURE_LEVEL_12_1,D3D_FEATURE_LEVEL_12_0
 	};
 	const char* featureLevelString[] = { "12.2","12.1","12.0" };
 
@@ -236,19 +257,19 @@ void DirectXCommon::DeviceInitialize() {
 		hr = D3D12CreateDevice(useAdapter.Get(), featureLevels[i], IID_PPV_ARGS(&device));
 
 		if (SUCCEEDED(hr)) {
-			//	Log(logStream, std::format("feturelevel : {}\n", featureLevelString[i]));
+			LOGEER_LOG(Level::kInfo, Category::kGraphics, "FeatureLevel : {}", featureLevelString[i]);
 			break;
 		}
 	}
 
 	assert(device != nullptr);
-	Log("Compleate create D3D12Device!!\n");
+	LOGEER_LOG(Level::kInfo, Category::kGraphics, "Complete create D3D12Device!!");
 
 	// logのデバッグを出力
-	Log("Hello, DirectX!\n");
+	LOGEER_LOG(Level::kInfo, Category::kGraphics, "Hello, DirectX!");
 
 	// logに画面の幅の数値を出力
-	//Log(logStream, ConvertString(std::format(L"width : {}, {}\n", WinApp::kClientWidth, WinApp::kClientHeight)));
+	LOGEER_LOG(Level::kInfo, Category::kGraphics, "width : {}, {}", int32_t(WinApp::kClientWidth), int32_t(WinApp::kClientHeight));
 
 #ifdef _DEBUG
 	Microsoft::WRL::ComPtr<ID3D12InfoQueue> infoQueue = nullptr;
@@ -280,14 +301,16 @@ void DirectXCommon::DeviceInitialize() {
 
 void DirectXCommon::CommandInitialize() {
 
-	// コマンドアロケーターを生成する
-	hr = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
-		IID_PPV_ARGS(&commandAllocator));
-	assert(SUCCEEDED(hr));
+	// コマンドアロケーターをフレームコンテキストの数だけ生成する
+	for (uint32_t i = 0; i < kFramesInFlight; ++i) {
+		hr = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+			IID_PPV_ARGS(&commandAllocators[i]));
+		assert(SUCCEEDED(hr));
+	}
 
 	// コマンドリストを生成する
 	hr = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
-		commandAllocator.Get(), nullptr, IID_PPV_ARGS(&commandList));
+		commandAllocators[0].Get(), nullptr, IID_PPV_ARGS(&commandList));
 
 	//コマンドリストの生成がうまく行かなかったので起動できない
 	assert(SUCCEEDED(hr));
@@ -384,38 +407,6 @@ D3D12_GPU_DESCRIPTOR_HANDLE DirectXCommon::GetGPUDescriptorHandle(const Microsof
 	return handleGPU;
 }
 
-void DirectXCommon::InitializeFixFps() {
-	reference_ = std::chrono::steady_clock::now();
-}
-
-void DirectXCommon::UpdateFixFps() {
-	// 1/60秒の時間
-	const std::chrono::microseconds KMinTime(uint64_t(1000000.0f / 60.0f));
-
-	// 1/60秒より短い時間
-	const std::chrono::microseconds KMinCheckTime(uint64_t(1000000.0f / 65.0f));
-
-	// 現在の時間を取得
-	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
-	// 経過時間を取得
-	std::chrono::microseconds elapsed =
-		std::chrono::duration_cast<std::chrono::microseconds>(now - reference_);
-
-	// 1/60秒立ってないとき
-	if (elapsed < KMinCheckTime) {
-
-		// 1/60経過するまでスリープを繰り返す
-		while (std::chrono::steady_clock::now() - reference_ < KMinTime) {
-
-			// 少しだけスリープ
-			std::this_thread::sleep_for(std::chrono::microseconds(1));
-		}
-	}
-
-	// 現在の時間を記録
-	reference_ = std::chrono::steady_clock::now();
-}
-
 void DirectXCommon::DescriptorHeapsInitialize() {
 
 	// DescriptorSizeを取得しておく
@@ -480,11 +471,87 @@ void DirectXCommon::DSVInitialize() {
 }
 
 void DirectXCommon::FenceInitialize() {
-	hr = device->CreateFence(fencevalue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
+	hr = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
 	assert(SUCCEEDED(hr));
 
 	fenceEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
 	assert(fenceEvent != nullptr);
+
+	// フレームコンテキストはフェンスを通してだけGPUを待つ
+	frameFence.Initialize(fence.Get(), commandQueue.Get(), fenceEvent);
+	frameContexts.Initialize(kFramesInFlight, &frameFence);
+}
+
+void DirectXCommon::FrameFence::Initialize(ID3D12Fence* fence, ID3D12CommandQueue* commandQueue, HANDLE fenceEvent) {
+	this->fence = fence;
+	this->commandQueue = commandQueue;
+	this->fenceEvent = fenceEvent;
+}
+
+uint64_t DirectXCommon::FrameFence::GetCompletedValue() const {
+	return fence->GetCompletedValue();
+}
+
+void DirectXCommon::FrameFence::Signal(uint64_t fenceValue) {
+	// GPUがここまでたどり着いたときに、fenceの値を指定した値に代入するようにSignalを送る
+	commandQueue->Signal(fence, fenceValue);
+}
+
+void DirectXCommon::FrameFence::Wait(uint64_t fenceValue) {
+	// コマンド完了待ち
+	if (fence->GetCompletedValue() < fenceValue) {
+		fence->SetEventOnCompletion(fenceValue, fenceEvent);
+		WaitForSingleObject(fenceEvent, INFINITE);
+	}
+}
+
+void DirectXCommon::UploadBufferInitialize() {
+	// 大きなバッファを一つだけ作ってフレーム数で分ける
+	uploadBuffer = CreateMappedBufferResource<uint8_t>(kUploadBufferSize);
+	uploadAllocator.Initialize(kUploadBufferSize, kUploadFrameCount);
+}
+
+DirectXCommon::UploadAllocation DirectXCommon::AllocateUpload(size_t sizeInBytes, size_t alignment) {
+	// 1フレーム分のスライスが足りなければ、バッファを大きくしてから確保する
+	if (!uploadAllocator.CanAllocate(sizeInBytes, alignment)) {
+		GrowUploadBuffer(sizeInBytes, alignment);
+	}
+	uint64_t offset = uploadAllocator.Allocate(sizeInBytes, alignment);
+
+	// 最大サイズでも足りないときは空のまま返す（ログはフレームの最初の一回だけ）
+	UploadAllocation allocation;
+	if (offset == UploadRingAllocator::kInvalidOffset) {
+		if (uploadAllocator.GetFrameFailedAllocationCount() == 1) {
+			LOGEER_LOG(Level::kError, Category::kGraphics, "Upload allocation failed : {} bytes, slice {} KiB",
+				sizeInBytes, uploadAllocator.GetSliceSize() / 1024);
+		}
+		return allocation;
+	}
+	allocation.cpuAddress = uploadBuffer.GetData() + offset;
+	allocation.gpuAddress = uploadBuffer.GetGPUVirtualAddress() + offset;
+	return allocation;
+}
+
+bool DirectXCommon::GrowUploadBuffer(size_t sizeInBytes, size_t alignment) {
+	uint64_t capacity = uploadAllocator.CalculateGrownCapacity(sizeInBytes, alignment);
+	if (capacity > kMaxUploadBufferSize) {
+		return false;
+	}
+	LOGEER_LOG(Level::kWarning, Category::kGraphics, "Upload buffer grown : {} KiB -> {} KiB",
+		uploadAllocator.GetCapacity() / 1024, capacity / 1024);
+
+	// このフレームで確保済みの領域は古いバッファにあるので、このフレームが終わるまで残す
+	retiredUploadBuffers.push_back({ 0, std::move(uploadBuffer) });
+	uploadBuffer = CreateMappedBufferResource<uint8_t>(capacity);
+	uploadAllocator.Grow(capacity);
+	return true;
+}
+
+void DirectXCommon::ReleaseRetiredUploadBuffers() {
+	uint64_t completedValue = frameFence.GetCompletedValue();
+	std::erase_if(retiredUploadBuffers, [completedValue](const RetiredUploadBuffer& retired) {
+		return retired.fenceValue != 0 && retired.fenceValue <= completedValue;
+		});
 }
 
 void DirectXCommon::ViewportInitialize() {
@@ -525,7 +592,7 @@ void DirectXCommon::ImGuiInitialize() {
 	ImGui::CreateContext();
 	ImGui::StyleColorsDark();
 	ImGui_ImplWin32_Init(winApp->GetHwnd());
-	ImGui_ImplDX12_Init(device.Get(), 2,
+	ImGui_ImplDX12_Init(device.Get(), kFramesInFlight,
 		DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
 		srvDescriptorHeap.Get(),
 		srvDescriptorHeap->GetCPUDescriptorHandleForHeapStart(),
@@ -583,53 +650,74 @@ void DirectXCommon::PostDraw() {
 
 	commandList->ResourceBarrier(1, &barrier);
 
-	// コマンドリストの内容を確定させる
-	hr = commandList->Close();
-	assert(SUCCEEDED(hr));
-
-	// GPUにコマンドリストの実行を行わせる
-	ID3D12CommandList* commandLists[] = { commandList.Get() };
-	commandQueue->ExecuteCommandLists(1, commandLists);
+	// コマンドリストの内容を確定させて、GPUに実行を行わせる
+	ExecuteCommandList();
 
 	// GPUとOSに画面の交換を行なうように通知する
 	swapChain->Present(1, 0);
 
-	// fenceの値を更新
-	fencevalue++;
-
-	// GPUがここまでたどり着いたときに、fenceの値を指定した値に代入するようにSignalを送る
-	commandQueue->Signal(fence.Get(), fencevalue);
-
-	// コマンド完了待ち
-	if (fence->GetCompletedValue() < fencevalue) {
-		fence->SetEventOnCompletion(fencevalue, fenceEvent);
+	// このフレームのフェンス値を積んで次のコンテキストへ進む（GPUの完了は待たない）
+	uint64_t fenceValue = frameContexts.EndFrame();
 
-		WaitForSingleObject(fenceEvent, INFINITE);
+	// このフレームで使ったアップロード領域はこのフェンス値で解放される
+	uploadAllocator.EndFrame(fenceValue);
+	for (RetiredUploadBuffer& retired : retiredUploadBuffers) {
+		if (retired.fenceValue == 0) {
+			retired.fenceValue = fenceValue;
+		}
 	}
 
-	// FPS固定更新
-	UpdateFixFps();
+	// 次のフレームの期限まで待つ
+	framePacer.WaitForNextFrame();
+
+	// これから使うコンテキストを前回使ったフレームだけ待つ
+	std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+	frameContexts.BeginFrame();
+	frameWaitMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
 
 	// 次のフレーム用のコマンドリストを準備
+	ID3D12CommandAllocator* commandAllocator = commandAllocators[frameContexts.GetCurrentIndex()].Get();
 	hr = commandAllocator->Reset(); // アロケーターのリセット
 	assert(SUCCEEDED(hr));
 
 	// コマンドリストのリセット
-	hr = commandList->Reset(commandAllocator.Get(), nullptr);
+	hr = commandList->Reset(commandAllocator, nullptr);
 	assert(SUCCEEDED(hr));
+
+	// 次のスライスをGPUがまだ読んでいたら待つ
+	uint64_t requiredFenceValue = uploadAllocator.GetRequiredFenceValue();
+	if (frameFence.GetCompletedValue() < requiredFenceValue) {
+		frameFence.Wait(requiredFenceValue);
+	}
+
+	// 次のフレームのアップロード領域を使い始める
+	uploadAllocator.BeginFrame(frameFence.GetCompletedValue());
+
+	// 大きくする前のバッファは、GPUが読み終わっていれば解放する
+	ReleaseRetiredUploadBuffers();
 }
 
 void DirectXCommon::WaitForGPU() {
-	fencevalue++;
-	commandQueue->Signal(fence.Get(), fencevalue);
+	// 今までに積んだ処理が全部終わるまで待つ
+	frameContexts.WaitIdle();
+}
 
-	if (fence->GetCompletedValue() < fencevalue) {
-		fence->SetEventOnCompletion(fencevalue, fenceEvent);
-		WaitForSingleObject(fenceEvent, INFINITE);
-	}
+void DirectXCommon::ExecuteCommandList() {
+	// コマンドリストの内容を確定させる
+	hr = commandList->Close();
+	assert(SUCCEEDED(hr));
+
+	// GPUにコマンドリストの実行を行わせる
+	ID3D12CommandList* commandLists[] = { commandList.Get() };
+	commandQueue->ExecuteCommandLists(1, commandLists);
+
+	// 実行した後に最初にSignalされる値で完了がわかる
+	executedCommandListCount++;
+	executedFenceValue = frameContexts.GetLastSignaledValue() + 1;
 }
 
 void DirectXCommon::ResetCommandList() {
+	ID3D12CommandAllocator* commandAllocator = commandAllocators[frameContexts.GetCurrentIndex()].Get();
 	commandAllocator->Reset();
-	commandList->Reset(commandAllocator.Get(), nullptr);
+	commandList->Reset(commandAllocator, nullptr);
 }
\ No newline at end of file
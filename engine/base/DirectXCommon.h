@@ -8,12 +8,17 @@
 #include <dxcapi.h>
 #include <string>
 #include <chrono>
+#include <vector>
 
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_dx12.h"
 #include "imgui/imgui_impl_win32.h"
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
 #include "WinApp.h"
+#include "MappedBuffer.h"
+#include "UploadRingAllocator.h"
+#include "FrameContextRing.h"
+#include "FramePacer.h"
 #include "DirectXTex/DirectXTex.h"
 
 class DirectXCommon {
@@ -36,19 +41,72 @@ public:
 
 	void ResetCommandList();
 
+	// コマンドリストを閉じて実行する（完了は次にSignalされるフェンス値でわかる）
+	void ExecuteCommandList();
+
 	// getter
 	ID3D12Device* GetDevice() { return device.Get(); }
 	ID3D12GraphicsCommandList* GetCommandList() { return commandList.Get(); }
 	ID3D12CommandQueue* GetCommandQueue() const { return commandQueue.Get(); }
-	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> GetCommandAllocator() const { return commandAllocator; }
+	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> GetCommandAllocator() const { return commandAllocators[frameContexts.GetCurrentIndex()]; }
+
+	// フレームコンテキストの取得（統計表示用）
+	const FrameContextRing& GetFrameContexts() const { return frameContexts; }
+
+	// 前のフレームでGPUを待った時間（ミリ秒）
+	double GetFrameWaitMilliseconds() const { return frameWaitMilliseconds; }
+
+	// 実行したコマンドリストの数（記録したコマンドが実行されたかの確認に使う）
+	uint64_t GetExecutedCommandListCount() const { return executedCommandListCount; }
+
+	// 最後に実行したコマンドリストが完了したときのフェンス値
+	// 記録した時点の次のフェンス値は、実行前にWaitForGPUなどでSignalされることがあるので使えない
+	uint64_t GetExecutedFenceValue() const { return executedFenceValue; }
+
+	// GPUが完了したフェンス値
+	uint64_t GetCompletedFenceValue() const { return frameFence.GetCompletedValue(); }
+
+	// フレームレート調整の取得
+	FramePacer* GetFramePacer() { return &framePacer; }
 
 	// バッファリソースの生成
 	Microsoft::WRL::ComPtr<ID3D12Resource>CreateBufferResource(size_t sizeInBytes);
 
+	// Mapしたままのバッファリソースの生成（要素数分）
+	template <typename T>
+	MappedBuffer<T> CreateMappedBufferResource(size_t count = 1) {
+		return MappedBuffer<T>(CreateBufferResource(sizeof(T) * count), count);
+	}
+
+	// フレームごとのアップロード領域
+	struct UploadAllocation {
+		void* cpuAddress = nullptr;                 // 書き込み先
+		D3D12_GPU_VIRTUAL_ADDRESS gpuAddress = 0;   // GPUから見たアドレス
+	};
+
+	// 今のフレームだけ使うアップロード領域を確保する（フレームのフェンスが完了したら再利用される）
+	// スライスが足りなければバッファを大きくして確保し直す
+	// kMaxUploadBufferSizeでも足りないときだけcpuAddressがnullptrになるので、呼んだ側はその描画を省く
+	UploadAllocation AllocateUpload(size_t sizeInBytes, size_t alignment = UploadRingAllocator::kDefaultAlignment);
+
+	// 今のフレームだけ使うアップロード領域を型付きで確保する（足りなければnullptr）
+	template <typename T>
+	T* AllocateUpload(size_t count, D3D12_GPU_VIRTUAL_ADDRESS* gpuAddress, size_t alignment = UploadRingAllocator::kDefaultAlignment) {
+		UploadAllocation allocation = AllocateUpload(sizeof(T) * count, alignment);
+		*gpuAddress = allocation.gpuAddress;
+		return static_cast<T*>(allocation.cpuAddress);
+	}
+
+	// アップロードアロケーターの取得（統計表示用）
+	const UploadRingAllocator& GetUploadAllocator() const { return uploadAllocator; }
+
 	// テクスチャーリソースの生成
 	Microsoft::WRL::ComPtr<ID3D12Resource>CreateTextuerResource(
 		const DirectX::TexMetadata& metadata);
 
+	// テクスチャーリソースがGPU上で占めるバイト数（生成はしない）
+	uint64_t GetTextureAllocationSize(const DirectX::TexMetadata& metadata);
+
 	// テクスチャーファイルの読み込み
 	Microsoft::WRL::ComPtr <ID3D12Resource> UploadTextureData(const Microsoft::WRL::ComPtr <ID3D12Resource>& texture, const DirectX::ScratchImage& mipImage);
 
@@ -60,8 +118,33 @@ public:
 	// 最大SRV数
 	static const uint32_t kMaxSRVCount;
 
+	// 同時に処理するフレーム数（2~3）
+	static const uint32_t kFramesInFlight = 2;
+
+	// アップロードバッファを分けるフレーム数
+	static const uint32_t kUploadFrameCount;
+
+	// アップロードバッファ全体の最初のサイズ
+	static const uint64_t kUploadBufferSize;
+
+	// アップロードバッファ全体の最大サイズ（これより大きくはしない）
+	static const uint64_t kMaxUploadBufferSize;
+
 private:
 
+	// D3D12のフェンスをFrameContextRingから使うためのクラス
+	class FrameFence : public IFrameFence {
+	public:
+		void Initialize(ID3D12Fence* fence, ID3D12CommandQueue* commandQueue, HANDLE fenceEvent);
+		uint64_t GetCompletedValue() const override;
+		void Signal(uint64_t fenceValue) override;
+		void Wait(uint64_t fenceValue) override;
+	private:
+		ID3D12Fence* fence = nullptr;
+		ID3D12CommandQueue* commandQueue = nullptr;
+		HANDLE fenceEvent = nullptr;
+	};
+
 	// デバイス初期化
 	void DeviceInitialize();
 
@@ -86,6 +169,15 @@ private:
 	// フェンスの生成
 	void FenceInitialize();
 
+	// フレームごとのアップロードバッファの初期化
+	void UploadBufferInitialize();
+
+	// アップロードバッファを大きくする（足りなくなったフレームの途中でも切り替える）
+	bool GrowUploadBuffer(size_t sizeInBytes, size_t alignment);
+
+	// 大きくする前のアップロードバッファを、GPUが読み終わったものから解放する
+	void ReleaseRetiredUploadBuffers();
+
 	// ビューポート矩形の初期化
 	void ViewportInitialize();
 
@@ -107,12 +199,6 @@ private:
 	// GPUディスクリプタハンドルを取得する関数
 	static D3D12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptorHandle(const Microsoft::WRL::ComPtr <ID3D12DescriptorHeap>& descriptorHeap, uint32_t descriptorSize, uint32_t index);
 
-	// FPS固定初期化
-	void InitializeFixFps();
-
-	// FPS固定更新
-	void UpdateFixFps();
-
 	// winApp
 	WinApp* winApp = nullptr;
 
@@ -125,8 +211,8 @@ private:
 	// 使用するアダプター
 	Microsoft::WRL::ComPtr <IDXGIAdapter4> useAdapter = nullptr;
 
-	// コマンドアロケーターを生成する
-	Microsoft::WRL::ComPtr <ID3D12CommandAllocator> commandAllocator = nullptr;
+	// コマンドアロケーター（フレームコンテキストごと）
+	std::array<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>, FrameContextRing::kMaxFrameCount> commandAllocators;
 
 	// コマンドリストを生成する
 	Microsoft::WRL::ComPtr <ID3D12GraphicsCommandList> commandList = nullptr;
@@ -190,11 +276,34 @@ private:
 	// fence
 	Microsoft::WRL::ComPtr <ID3D12Fence> fence = nullptr;
 
-	// 初期値0でfenceを作る
-	uint32_t fencevalue = 0;
-
 	HANDLE fenceEvent = nullptr;
 
+	// フェンスの操作
+	FrameFence frameFence;
+
+	// フレームコンテキストの使い回しとフェンス値の管理
+	FrameContextRing frameContexts;
+
+	// 前のフレームでGPUを待った時間（ミリ秒）
+	double frameWaitMilliseconds = 0.0;
+
+	// 実行したコマンドリストの数と、最後に実行したコマンドリストが完了したときのフェンス値
+	uint64_t executedCommandListCount = 0;
+	uint64_t executedFenceValue = 0;
+
+	// フレームごとのアップロードバッファ（Mapしたまま使う）
+	MappedBuffer<uint8_t> uploadBuffer;
+
+	// アップロードバッファの割り当て
+	UploadRingAllocator uploadAllocator;
+
+	// 大きくする前のアップロードバッファ（切り替えたフレームのフェンス値が完了するまで残す）
+	struct RetiredUploadBuffer {
+		uint64_t fenceValue = 0; // 0のときはまだ積んでいない（切り替えたフレームのEndFrameで決まる）
+		MappedBuffer<uint8_t> buffer;
+	};
+	std::vector<RetiredUploadBuffer> retiredUploadBuffers;
+
 	// ビューポート
 	D3D12_VIEWPORT viewport{};
 
@@ -231,6 +340,9 @@ private:
 
 	DirectX::ScratchImage image{};
 
-	// 記録時間
-	std::chrono::steady_clock::time_point reference_;
+	// フレームレート調整用の時計
+	SteadyFrameClock frameClock;
+
+	// フレームレート調整
+	FramePacer framePacer;
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include "FrameContextRing.h"
+#include <cassert>
+
+void FrameContextRing::Initialize(uint32_t frameCount, IFrameFence* fence) {
+	assert(fence);
+	assert(frameCount >= kMinFrameCount && frameCount <= kMaxFrameCount);
+
+	// 引数をメンバ変数にセット
+	this->fence = fence;
+
+	// 最初はどのコンテキストも待つ必要がない
+	contextFenceValues.assign(frameCount, 0);
+	currentIndex = 0;
+	lastSignaledValue = fence->GetCompletedValue();
+	overlappedFrames = 0;
+	waitCount = 0;
+}
+
+bool FrameContextRing::BeginFrame() {
+
+	// CPUがこのフレームを始めた時点でGPUが処理しているフレーム数
+	overlappedFrames = GetFramesInFlight();
+
+	// このコンテキストを前回使ったフレームがまだ終わっていなければ待つ
+	uint64_t fenceValue = contextFenceValues[currentIndex];
+	if (fence->GetCompletedValue() < fenceValue) {
+		fence->Wait(fenceValue);
+		waitCount++;
+		return true;
+	}
+	return false;
+}
+
+uint64_t FrameContextRing::EndFrame() {
+
+	// このコンテキストはこのフェンス値が完了するまで使えない
+	uint64_t fenceValue = Signal();
+	contextFenceValues[currentIndex] = fenceValue;
+
+	// 次のコンテキストへ（最後まで行ったら先頭に戻る）
+	currentIndex = (currentIndex + 1) % GetFrameCount();
+	return fenceValue;
+}
+
+void FrameContextRing::WaitIdle() {
+	uint64_t fenceValue = Signal();
+	if (fence->GetCompletedValue() < fenceValue) {
+		fence->Wait(fenceValue);
+	}
+}
+
+uint32_t FrameContextRing::GetFramesInFlight() const {
+	uint32_t count = 0;
+	uint64_t completedValue = fence->GetCompletedValue();
+	for (uint64_t fenceValue : contextFenceValues) {
+		if (fenceValue > completedValue) {
+			count++;
+		}
+	}
+	return count;
+}
+
+uint64_t FrameContextRing::Signal() {
+	lastSignaledValue++;
+	fence->Signal(lastSignaledValue);
+	return lastSignaledValue;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// フェンスの操作（D3D12のフェンスでも、確認用の偽物でも差し替えられる）
+class IFrameFence {
+public:
+	virtual ~IFrameFence() = default;
+
+	// GPUが完了したフェンス値
+	virtual uint64_t GetCompletedValue() const = 0;
+
+	// GPUがここまで来たらフェンス値を書き込むように積む
+	virtual void Signal(uint64_t fenceValue) = 0;
+
+	// フェンス値が完了するまでCPUを止める
+	virtual void Wait(uint64_t fenceValue) = 0;
+};
+
+// フレームコンテキストを順番に使い回し、フェンス値を管理するクラス
+// 待つのはこれから再利用するコンテキストだけで、デバイスに依存しない
+class FrameContextRing {
+public:
+
+	// 同時に処理できるフレーム数の範囲
+	static const uint32_t kMinFrameCount = 2;
+	static const uint32_t kMaxFrameCount = 3;
+
+	// 初期化
+	void Initialize(uint32_t frameCount, IFrameFence* fence);
+
+	// フレーム開始（今のコンテキストの前回の描画が終わっていなければ待つ）
+	// 待ったときはtrueを返す
+	bool BeginFrame();
+
+	// フレーム終了（今のコンテキストにフェンス値を積んで次のコンテキストへ進む）
+	uint64_t EndFrame();
+
+	// 今までに積んだ処理が全部終わるまで待つ
+	void WaitIdle();
+
+	// 今のコンテキストの番号
+	uint32_t GetCurrentIndex() const { return currentIndex; }
+
+	// コンテキストの数
+	uint32_t GetFrameCount() const { return static_cast<uint32_t>(contextFenceValues.size()); }
+
+	// 最後に積んだフェンス値
+	uint64_t GetLastSignaledValue() const { return lastSignaledValue; }
+
+	// GPUがまだ終わっていないフレーム数
+	uint32_t GetFramesInFlight() const;
+
+	// BeginFrameの時点でGPUが処理中だったフレーム数（CPUと並行して動いていた数）
+	uint32_t GetOverlappedFrames() const { return overlappedFrames; }
+
+	// BeginFrameで待った回数
+	uint64_t GetWaitCount() const { return waitCount; }
+
+private:
+
+	// フェンス
+	IFrameFence* fence = nullptr;
+
+	// コンテキストごとの、最後に積んだフェンス値
+	std::vector<uint64_t> contextFenceValues;
+
+	// 今のコンテキスト
+	uint32_t currentIndex = 0;
+
+	// 最後に積んだフェンス値
+	uint64_t lastSignaledValue = 0;
+
+	// BeginFrameの時点でGPUが処理中だったフレーム数
+	uint32_t overlappedFrames = 0;
+
+	// BeginFrameで待った回数
+	uint64_t waitCount = 0;
+
+	// フェンス値を一つ進めて積む
+	uint64_t Signal();
+};
@@ -0,0 +1,116 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+using namespace std::chrono;
+
+nanoseconds SteadyFrameClock::Now() {
+	return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch());
+}
+
+void SteadyFrameClock::Sleep(nanoseconds duration) {
+	std::this_thread::sleep_for(duration);
+}
+
+void SteadyFrameClock::Spin() {
+	// 他のスレッドに譲りつつ回す
+	std::this_thread::yield();
+}
+
+void FramePacer::Initialize(IFrameClock* clock, double targetFps) {
+	assert(clock);
+
+	// 引数をメンバ変数にセット
+	this->clock = clock;
+	SetTargetFps(targetFps);
+
+	// 今から数え始める
+	deadline = clock->Now();
+	lastFrameEnd = deadline;
+	historyCount = 0;
+	historyIndex = 0;
+	missedDeadlines = 0;
+}
+
+void FramePacer::SetTargetFps(double fps) {
+	targetFps = fps;
+
+	// 0以下なら待たない
+	frameDuration = fps > 0.0 ? duration_cast<nanoseconds>(duration<double>(1.0 / fps)) : nanoseconds::zero();
+}
+
+void FramePacer::WaitForNextFrame() {
+	nanoseconds now = clock->Now();
+
+	if (isUnlocked || frameDuration == nanoseconds::zero()) {
+		// 待たない（固定に戻したときは今から数え直す）
+		deadline = now;
+	} else {
+		// 前回の期限から1フレーム後を次の期限にする
+		deadline += frameDuration;
+
+		if (now > deadline) {
+			// 間に合わなかった
+			missedDeadlines++;
+
+			// 1フレーム以上遅れたら、取り返そうとせずに今から数え直す
+			if (now - deadline > frameDuration) {
+				deadline = now;
+			}
+		} else {
+			// 期限の少し前までは眠る
+			nanoseconds remaining = deadline - now;
+			if (remaining > spinThreshold) {
+				clock->Sleep(remaining - spinThreshold);
+			}
+
+			// 残りは空回しで待つ
+			while (clock->Now() < deadline) {
+				clock->Spin();
+			}
+		}
+	}
+
+	// フレーム時間を記録
+	nanoseconds frameEnd = clock->Now();
+	history[historyIndex] = frameEnd - lastFrameEnd;
+	historyIndex = (historyIndex + 1) % kHistorySize;
+	if (historyCount < kHistorySize) {
+		historyCount++;
+	}
+	lastFrameEnd = frameEnd;
+}
+
+double FramePacer::GetLastFrameMilliseconds() const {
+	if (historyCount == 0) {
+		return 0.0;
+	}
+	uint32_t lastIndex = (historyIndex + kHistorySize - 1) % kHistorySize;
+	return duration<double, std::milli>(history[lastIndex]).count();
+}
+
+FramePacer::Statistics FramePacer::GetStatistics() const {
+	Statistics statistics{};
+	statistics.missedDeadlines = missedDeadlines;
+	statistics.sampleCount = historyCount;
+
+	if (historyCount == 0) {
+		return statistics;
+	}
+
+	// 並べ替えてパーセンタイルを取る
+	std::array<nanoseconds, kHistorySize> sorted = history;
+	std::sort(sorted.begin(), sorted.begin() + historyCount);
+
+	nanoseconds total{};
+	for (uint32_t i = 0; i < historyCount; ++i) {
+		total += sorted[i];
+	}
+
+	statistics.meanMilliseconds = duration<double, std::milli>(total).count() / historyCount;
+	statistics.p50Milliseconds = duration<double, std::milli>(sorted[(historyCount - 1) * 50 / 100]).count();
+	statistics.p99Milliseconds = duration<double, std::milli>(sorted[(historyCount - 1) * 99 / 100]).count();
+	statistics.maxMilliseconds = duration<double, std::milli>(sorted[historyCount - 1]).count();
+	return statistics;
+}
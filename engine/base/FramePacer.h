@@ -0,0 +1,99 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+// フレームの時間を測る時計（確認用の偽物に差し替えられる）
+class IFrameClock {
+public:
+	virtual ~IFrameClock() = default;
+
+	// 現在時刻
+	virtual std::chrono::nanoseconds Now() = 0;
+
+	// 指定した時間だけスレッドを止める（精度は荒くてよい）
+	virtual void Sleep(std::chrono::nanoseconds duration) = 0;
+
+	// 期限直前の空回し一回分
+	virtual void Spin() = 0;
+};
+
+// std::chrono::steady_clockを使う時計
+class SteadyFrameClock : public IFrameClock {
+public:
+	std::chrono::nanoseconds Now() override;
+	void Sleep(std::chrono::nanoseconds duration) override;
+	void Spin() override;
+};
+
+// 目標のフレームレートに合わせて待つクラス
+// 期限の手前までは眠り、残りを空回しで待つ。期限は前回の期限から数えるので誤差がたまらない
+class FramePacer {
+public:
+
+	// フレーム時間の統計
+	struct Statistics {
+		double meanMilliseconds;  // 平均
+		double p50Milliseconds;   // 中央値
+		double p99Milliseconds;   // 99パーセンタイル
+		double maxMilliseconds;   // 最大
+		uint64_t missedDeadlines; // 期限に間に合わなかった回数
+		uint32_t sampleCount;     // 統計に使ったフレーム数
+	};
+
+	// 統計に使う直近のフレーム数
+	static const uint32_t kHistorySize = 256;
+
+	// 初期化
+	void Initialize(IFrameClock* clock, double targetFps);
+
+	// 次のフレームの期限まで待つ（毎フレーム一回呼ぶ）
+	void WaitForNextFrame();
+
+	// 目標のフレームレート
+	double GetTargetFps() const { return targetFps; }
+	void SetTargetFps(double fps);
+
+	// 待たずに回す
+	bool IsUnlocked() const { return isUnlocked; }
+	void SetUnlocked(bool unlocked) { isUnlocked = unlocked; }
+
+	// 期限のこの時間前からは眠らずに空回しする
+	std::chrono::nanoseconds GetSpinThreshold() const { return spinThreshold; }
+	void SetSpinThreshold(std::chrono::nanoseconds threshold) { spinThreshold = threshold; }
+
+	// 前のフレームの時間（ミリ秒）
+	double GetLastFrameMilliseconds() const;
+
+	// 直近のフレーム時間の統計
+	Statistics GetStatistics() const;
+
+private:
+
+	// 時計
+	IFrameClock* clock = nullptr;
+
+	// 目標のフレームレートと1フレームの時間
+	double targetFps = 60.0;
+	std::chrono::nanoseconds frameDuration{};
+
+	// 待たずに回すか
+	bool isUnlocked = false;
+
+	// 期限のこの時間前からは空回しする（Windowsのスリープは1ms程度ずれる）
+	std::chrono::nanoseconds spinThreshold = std::chrono::microseconds(2000);
+
+	// 次のフレームの期限
+	std::chrono::nanoseconds deadline{};
+
+	// 前のフレームが終わった時刻
+	std::chrono::nanoseconds lastFrameEnd{};
+
+	// 直近のフレーム時間
+	std::array<std::chrono::nanoseconds, kHistorySize> history{};
+	uint32_t historyCount = 0;
+	uint32_t historyIndex = 0;
+
+	// 期限に間に合わなかった回数
+	uint64_t missedDeadlines = 0;
+};
@@ -0,0 +1,84 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+// 生成時に一度だけMapし、破棄するときにUnmapするアップロードバッファ
+template <typename T>
+class MappedBuffer {
+public:
+
+	MappedBuffer() = default;
+
+	// リソースを受け取ってMapする
+	MappedBuffer(Microsoft::WRL::ComPtr<ID3D12Resource> bufferResource, size_t elementCount)
+		: resource(std::move(bufferResource)), count(elementCount) {
+		HRESULT hr = resource->Map(0, nullptr, reinterpret_cast<void**>(&data));
+		assert(SUCCEEDED(hr));
+	}
+
+	~MappedBuffer() { Reset(); }
+
+	// コピー禁止（Unmapが二重にならないように）
+	MappedBuffer(const MappedBuffer&) = delete;
+	MappedBuffer& operator=(const MappedBuffer&) = delete;
+
+	// ムーブは可能
+	MappedBuffer(MappedBuffer&& other) noexcept
+		: resource(std::move(other.resource)), data(other.data), count(other.count) {
+		other.data = nullptr;
+		other.count = 0;
+	}
+
+	MappedBuffer& operator=(MappedBuffer&& other) noexcept {
+		if (this != &other) {
+			Reset();
+			resource = std::move(other.resource);
+			data = other.data;
+			count = other.count;
+			other.data = nullptr;
+			other.count = 0;
+		}
+		return *this;
+	}
+
+	// Unmapしてリソースを手放す
+	void Reset() {
+		if (resource && data) {
+			resource->Unmap(0, nullptr);
+		}
+		resource.Reset();
+		data = nullptr;
+		count = 0;
+	}
+
+	// 書き込み先
+	T* GetData() const { return data; }
+	std::span<T> GetSpan() const { return { data, count }; }
+	T& operator[](size_t index) const { assert(index < count); return data[index]; }
+	T* operator->() const { return data; }
+
+	// 要素数とバイト数
+	size_t GetCount() const { return count; }
+	size_t GetSizeInBytes() const { return sizeof(T) * count; }
+
+	// リソース
+	ID3D12Resource* GetResource() const { return resource.Get(); }
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const { return resource->GetGPUVirtualAddress(); }
+
+	// 生成済みかどうか
+	explicit operator bool() const { return data != nullptr; }
+
+private:
+	// バッファリソース
+	Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+
+	// Mapしたアドレス
+	T* data = nullptr;
+
+	// 要素数
+	size_t count = 0;
+};
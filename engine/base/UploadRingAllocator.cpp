@@ -0,0 +1,104 @@
+#include "UploadRingAllocator.h"
+#include <algorithm>
+#include <cassert>
+
+void UploadRingAllocator::Initialize(uint64_t capacityInBytes, uint32_t frameCount) {
+	assert(frameCount > 0);
+
+	// スライスの境界もアライメントに揃える
+	sliceSize = (capacityInBytes / frameCount) / kDefaultAlignment * kDefaultAlignment;
+	assert(sliceSize > 0);
+
+	// どのスライスもまだGPUに使われていない
+	frameFences.assign(frameCount, 0);
+	currentFrame = 0;
+	usedBytes = 0;
+	allocationCount = 0;
+	lastFrameUsedBytes = 0;
+	lastFrameAllocationCount = 0;
+	peakUsedBytes = 0;
+	failedAllocationCount = 0;
+	frameFailedAllocationCount = 0;
+	growCount = 0;
+}
+
+uint64_t UploadRingAllocator::GetRequiredFenceValue() const {
+	uint32_t nextFrame = (currentFrame + 1) % GetFrameCount();
+	return frameFences[nextFrame];
+}
+
+void UploadRingAllocator::BeginFrame(uint64_t completedFenceValue) {
+
+	// 次のスライスへ（最後まで行ったら先頭に戻る）
+	currentFrame = (currentFrame + 1) % GetFrameCount();
+
+	// GPUがまだ読んでいるスライスは使えない
+	assert(completedFenceValue >= frameFences[currentFrame]);
+
+	// スライスを先頭から使い直す
+	usedBytes = 0;
+	allocationCount = 0;
+	frameFailedAllocationCount = 0;
+}
+
+void UploadRingAllocator::EndFrame(uint64_t fenceValue) {
+	// このフェンス値が完了するまでスライスは使えない
+	frameFences[currentFrame] = fenceValue;
+
+	// 統計はフレームごとに区切る
+	lastFrameUsedBytes = usedBytes;
+	lastFrameAllocationCount = allocationCount;
+	peakUsedBytes = std::max(peakUsedBytes, usedBytes);
+}
+
+uint64_t UploadRingAllocator::Allocate(uint64_t sizeInBytes, uint64_t alignment) {
+
+	// スライスからはみ出すときは確保しない
+	if (!CanAllocate(sizeInBytes, alignment)) {
+		failedAllocationCount++;
+		frameFailedAllocationCount++;
+		return kInvalidOffset;
+	}
+
+	// スライス内の位置をアライメントに揃える
+	uint64_t alignedOffset = (usedBytes + alignment - 1) & ~(alignment - 1);
+	usedBytes = alignedOffset + sizeInBytes;
+	allocationCount++;
+
+	// バッファ先頭からのオフセットにして返す
+	return sliceSize * currentFrame + alignedOffset;
+}
+
+bool UploadRingAllocator::CanAllocate(uint64_t sizeInBytes, uint64_t alignment) const {
+	// アライメントは2のべき乗
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+	uint64_t alignedOffset = (usedBytes + alignment - 1) & ~(alignment - 1);
+	return alignedOffset + sizeInBytes <= sliceSize;
+}
+
+uint64_t UploadRingAllocator::CalculateGrownCapacity(uint64_t sizeInBytes, uint64_t alignment) const {
+
+	// このフレームで使った分と今回の分が一つのスライスに収まるまで倍にする
+	// （切り替えた後のフレームも同じくらい使うので、今回の分だけでは足りない）
+	uint64_t requiredBytes = usedBytes + sizeInBytes + alignment;
+	uint64_t grownSliceSize = sliceSize;
+	do {
+		grownSliceSize *= 2;
+	} while (grownSliceSize < requiredBytes);
+	return grownSliceSize * GetFrameCount();
+}
+
+void UploadRingAllocator::Grow(uint64_t capacityInBytes) {
+	uint64_t grownSliceSize = (capacityInBytes / GetFrameCount()) / kDefaultAlignment * kDefaultAlignment;
+	assert(grownSliceSize > sliceSize);
+	sliceSize = grownSliceSize;
+
+	// 新しいバッファはまだGPUに使われていない
+	std::fill(frameFences.begin(), frameFences.end(), 0);
+
+	// 今のフレームも新しいスライスの先頭から詰める（それまでの分は古いバッファに残っている）
+	peakUsedBytes = std::max(peakUsedBytes, usedBytes);
+	usedBytes = 0;
+	growCount++;
+}
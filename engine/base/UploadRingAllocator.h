@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// 一つの大きなアップロードバッファをフレーム数分のスライスに分けて、
+// 毎フレームの定数や頂点を先頭から詰めていくアロケーター
+// 扱うのはオフセットとフェンス値だけなので、デバイスがなくても動作を確認できる
+class UploadRingAllocator {
+public:
+
+	// 定数バッファの配置に必要なアライメント（D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT）
+	static const uint64_t kDefaultAlignment = 256;
+
+	// 頂点やインスタンスのデータに使うアライメント（定数バッファと違って256バイト境界は要らない）
+	static const uint64_t kVertexAlignment = 16;
+
+	// 確保できなかったときのオフセット
+	static const uint64_t kInvalidOffset = UINT64_MAX;
+
+	// 初期化（全体のサイズをフレーム数で等分する）
+	void Initialize(uint64_t capacityInBytes, uint32_t frameCount);
+
+	// 次のスライスを使い始める前に完了している必要があるフェンス値
+	uint64_t GetRequiredFenceValue() const;
+
+	// フレーム開始（完了済みのフェンス値を渡して、次のスライスを回収する）
+	void BeginFrame(uint64_t completedFenceValue);
+
+	// フレーム終了（このフレームの描画が終わったときのフェンス値を記録する）
+	void EndFrame(uint64_t fenceValue);
+
+	// 確保（バッファ先頭からのオフセットを返す。足りなければkInvalidOffset）
+	uint64_t Allocate(uint64_t sizeInBytes, uint64_t alignment = kDefaultAlignment);
+
+	// 今のスライスの残りで確保できるか
+	bool CanAllocate(uint64_t sizeInBytes, uint64_t alignment = kDefaultAlignment) const;
+
+	// 今のフレームでsizeInBytesを確保するのに足りる全体のサイズ（スライスを倍々で大きくする）
+	uint64_t CalculateGrownCapacity(uint64_t sizeInBytes, uint64_t alignment = kDefaultAlignment) const;
+
+	// 大きいバッファに切り替える（スライスは全部空になり、今のフレームも新しいスライスの先頭から詰める）
+	// 切り替える前に確保した領域は、GPUが読み終わるまで呼んだ側が古いバッファごと残しておく
+	void Grow(uint64_t capacityInBytes);
+
+	// 全体のサイズ
+	uint64_t GetCapacity() const { return sliceSize * frameFences.size(); }
+
+	// スライス一つのサイズ
+	uint64_t GetSliceSize() const { return sliceSize; }
+
+	// スライスの数
+	uint32_t GetFrameCount() const { return static_cast<uint32_t>(frameFences.size()); }
+
+	// 今使っているスライス
+	uint32_t GetCurrentFrame() const { return currentFrame; }
+
+	// 今のフレームで使ったバイト数と確保回数
+	uint64_t GetFrameUsedBytes() const { return usedBytes; }
+	uint32_t GetFrameAllocationCount() const { return allocationCount; }
+
+	// 前のフレームで使ったバイト数と確保回数
+	uint64_t GetLastFrameUsedBytes() const { return lastFrameUsedBytes; }
+	uint32_t GetLastFrameAllocationCount() const { return lastFrameAllocationCount; }
+
+	// 1フレームで使ったバイト数の最大
+	uint64_t GetPeakUsedBytes() const { return peakUsedBytes; }
+
+	// スライスが足りずに確保できなかった回数（初期化してからの合計と、今のフレームの分）
+	uint64_t GetFailedAllocationCount() const { return failedAllocationCount; }
+	uint32_t GetFrameFailedAllocationCount() const { return frameFailedAllocationCount; }
+
+	// バッファを大きくした回数
+	uint32_t GetGrowCount() const { return growCount; }
+
+private:
+
+	// スライス一つのサイズ
+	uint64_t sliceSize = 0;
+
+	// スライスごとの、最後に使ったフレームのフェンス値
+	std::vector<uint64_t> frameFences;
+
+	// 今使っているスライス
+	uint32_t currentFrame = 0;
+
+	// スライス内の次の書き込み位置
+	uint64_t usedBytes = 0;
+
+	// 今のフレームで確保した回数
+	uint32_t allocationCount = 0;
+
+	// 前のフレームで使ったバイト数と確保回数
+	uint64_t lastFrameUsedBytes = 0;
+	uint32_t lastFrameAllocationCount = 0;
+
+	// 1フレームで使ったバイト数の最大
+	uint64_t peakUsedBytes = 0;
+
+	// 確保できなかった回数
+	uint64_t failedAllocationCount = 0;
+	uint32_t frameFailedAllocationCount = 0;
+
+	// バッファを大きくした回数
+	uint32_t growCount = 0;
+};
@@ -8,8 +8,16 @@
 
 extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam);
 
+WinApp::MessageListener WinApp::messageListener = nullptr;
+void* WinApp::messageListenerContext = nullptr;
+
 LRESULT CALLBACK WinApp::WindowProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
 
+	// 入力はImGuiが使うものも含めて全部渡す
+	if (messageListener != nullptr) {
+		messageListener(messageListenerContext, msg, wparam, lparam);
+	}
+
 	if (ImGui_ImplWin32_WndProcHandler(hwnd, msg, wparam, lparam)) {
 		return true;
 	}
@@ -79,17 +87,22 @@ void WinApp::Finalize() {
 
 bool WinApp::ProcessMessage() {
 	MSG msg{};
-	// メッセージが来ているかをチェックする
-	if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+	// 来ているメッセージを全部処理する（1フレームに一つずつだと入力が溜まって遅れる）
+	while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+
+		// メッセージがWM_QUITかどうかをチェックする
+		if (msg.message == WM_QUIT) {
+			return true;
+		}
 
 		// メッセージを翻訳して送る
 		TranslateMessage(&msg);
 		DispatchMessage(&msg);
 	}
-
-	// メッセージがWM_QUITかどうかをチェックする
-	if (msg.message == WM_QUIT) {
-		return true;
-	}
 	return false;
+}
+
+void WinApp::SetMessageListener(MessageListener listener, void* context) {
+	messageListener = listener;
+	messageListenerContext = context;
 }
\ No newline at end of file
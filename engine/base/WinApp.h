@@ -10,6 +10,9 @@ public: // 静的メンバ関数
 	static const int32_t kClientWidth = 1280;
 	static const int32_t kClientHeight = 720;
 
+	// ウィンドウメッセージを受け取る関数（contextは登録したときに渡したもの）
+	using MessageListener = void(*)(void* context, UINT msg, WPARAM wparam, LPARAM lparam);
+
 public: // メンバ関数
 	void Initialize();
 	void Update();
@@ -23,14 +26,21 @@ public: // メンバ関数
 	// ウィンドウクラスの取得
 	HINSTANCE GetHinstance() const { return wc.hInstance; }
 
-	// メッセージの処理
+	// メッセージの処理（溜まっているものを全部処理する）
 	bool ProcessMessage();
 
+	// ウィンドウメッセージを受け取る関数を登録する（一つだけ。nullptrで外す）
+	void SetMessageListener(MessageListener listener, void* context);
+
 private:
 	// ウィンドウハンドル
 	HWND hwnd = nullptr;
 
 	// ウィンドウクラスの登録
 	WNDCLASS wc{};
+
+	// ウィンドウメッセージを受け取る関数（WindowProcから呼ぶ）
+	static MessageListener messageListener;
+	static void* messageListenerContext;
 };
 
@@ -1,71 +1,192 @@
 #include"Input.h"
+#include "Logger.h"
+#include <windowsx.h>
+#include <algorithm>
+#include <chrono>
 
-#pragma comment(lib, "dinput8.lib")
-#pragma comment(lib, "dxguid.lib")
+namespace {
+
+	// キーのメッセージのスキャンコードをDIK_*にする
+	uint8_t GetKeyNumber(WPARAM wparam, LPARAM lparam) {
+
+		// PauseとNumLockはスキャンコードとDIK_*が入れ替わっている
+		if (wparam == VK_PAUSE) {
+			return DIK_PAUSE;
+		}
+		if (wparam == VK_NUMLOCK) {
+			return DIK_NUMLOCK;
+		}
+		UINT scanCode = static_cast<UINT>((lparam >> 16) & 0xFF);
+		if (scanCode == 0) {
+			scanCode = MapVirtualKeyW(static_cast<UINT>(wparam), MAPVK_VK_TO_VSC);
+		}
+
+		// 拡張キー（右Ctrl、矢印、テンキーのEnterなど）はDIK_*では上位ビットが立つ
+		if (lparam & (1 << 24)) {
+			scanCode |= 0x80;
+		}
+		return static_cast<uint8_t>(scanCode);
+	}
+}
+
+Input::~Input() {
+	if (winApp != nullptr) {
+		winApp->SetMessageListener(nullptr, nullptr);
+	}
+}
 
 void Input::Initialize(WinApp* winApp) {
 
 	// 借りてきたWinAppのインスタンスを記録
 	this->winApp = winApp;
 
-	/// DirectInputの初期化 -------------------------------------
-
-	// DirectInputのインスタンス作成
-	HRESULT directInputResult = DirectInput8Create(
-		winApp->GetHinstance(),
-		DIRECTINPUT_VERSION,
-		IID_IDirectInput8,
-		reinterpret_cast<void**>(directInput.GetAddressOf()),
-		nullptr);
-	assert(SUCCEEDED(directInputResult));
-
-	// キーボードデバイスの生成
-	HRESULT keyboardResult = directInput->CreateDevice(GUID_SysKeyboard,
-		keyboard.GetAddressOf(), nullptr);
-	assert(SUCCEEDED(keyboardResult));
-
-	// キーボードデバイスのデータフォーマットを設定
-	HRESULT dataFormatResult = keyboard->SetDataFormat(&c_dfDIKeyboard);
-	assert(SUCCEEDED(dataFormatResult));
-
-	// 排他制御レベルの設定
-	HRESULT cooperativeLevelResult = keyboard->SetCooperativeLevel(
-		winApp->GetHwnd(), DISCL_FOREGROUND | DISCL_NONEXCLUSIVE | DISCL_NOWINKEY);
-	assert(SUCCEEDED(cooperativeLevelResult));
+	// キーとマウスのウィンドウメッセージを受け取る
+	winApp->SetMessageListener(&Input::OnWindowMessage, this);
 }
 
 void Input::Update() {
 
-	// 前回のキー状態を保存
-	memcpy(preKey, key, sizeof(key));
-
-	// キーボードの情報取得
-	keyboard.Get()->Acquire();
-
-	// 全キーの入力状態を取得する
-	keyboard.Get()->GetDeviceState(sizeof(key), key);
+	// 今までに届いた事象を反映する（この後に届いたものは次のフレームに回る）
+	snapshot.Update(eventQueue, GetTime());
 
 	// 数字の０が押されたら
 	if (TriggerKey(DIK_0)) {
 		// 出力ウィンドウにHit0と表示
-		OutputDebugStringA("Hit 0\n");
+		LOGEER_LOG(Logeer::Level::kDebug, Logeer::Category::kInput, "Hit 0");
 	}
 }
 
-bool Input::PushKey(BYTE keyNumber) {
-	if (key[keyNumber] & 0x80) {
-		return true;
-	}
-	return false;
+bool Input::PushKey(BYTE keyNumber) const {
+	return snapshot.IsKeyDown(keyNumber);
+}
+
+bool Input::TriggerKey(BYTE keyNumber) const {
+	return snapshot.IsKeyPressed(keyNumber);
+}
+
+bool Input::ReleaseKey(BYTE keyNumber) const {
+	return snapshot.IsKeyReleased(keyNumber);
 }
 
-bool Input::TriggerKey(BYTE keyNumber) {
-	bool ret = false;
-	// 押された瞬間を検出
-	if ((key[keyNumber] & 0x80) && !(preKey[keyNumber])) {
-		ret = true;
+bool Input::PushMouse(uint32_t button) const {
+	assert(button < InputSnapshot::kMouseButtonCount);
+	return snapshot.IsMouseButtonDown(button);
+}
+
+bool Input::TriggerMouse(uint32_t button) const {
+	assert(button < InputSnapshot::kMouseButtonCount);
+	return snapshot.IsMouseButtonPressed(button);
+}
+
+uint64_t Input::GetTime() {
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t Input::GetMessageEventTime() {
+
+	// GetMessageTimeはGetTickCountと同じ基準のミリ秒なので、今のTickCountとの差だけ今の時刻から戻す
+	// （32ビットで一周しても差は正しい）
+	uint64_t now = GetTime();
+	DWORD elapsedMilliseconds = GetTickCount() - static_cast<DWORD>(GetMessageTime());
+	uint64_t elapsed = static_cast<uint64_t>(elapsedMilliseconds) * 1000000;
+	uint64_t time = elapsed < now ? now - elapsed : 0;
+
+	// TickCountの刻みで前後しないように、前の事象より前にはしない
+	time = (std::max)(time, lastEventTime);
+	lastEventTime = time;
+	return time;
+}
+
+void Input::OnWindowMessage(void* context, UINT msg, WPARAM wparam, LPARAM lparam) {
+	Input* input = static_cast<Input*>(context);
+	InputEvent event;
+
+	switch (msg) {
+	case WM_KEYDOWN:
+	case WM_SYSKEYDOWN:
+		// 押しっぱなしの繰り返しは積まない
+		if (lparam & (1 << 30)) {
+			return;
+		}
+		event.type = InputEvent::Type::kKeyDown;
+		event.code = GetKeyNumber(wparam, lparam);
+		break;
+	case WM_KEYUP:
+	case WM_SYSKEYUP:
+		event.type = InputEvent::Type::kKeyUp;
+		event.code = GetKeyNumber(wparam, lparam);
+		break;
+	case WM_LBUTTONDOWN:
+	case WM_RBUTTONDOWN:
+	case WM_MBUTTONDOWN:
+	case WM_XBUTTONDOWN:
+	case WM_LBUTTONUP:
+	case WM_RBUTTONUP:
+	case WM_MBUTTONUP:
+	case WM_XBUTTONUP:
+		event.type = (msg == WM_LBUTTONDOWN || msg == WM_RBUTTONDOWN || msg == WM_MBUTTONDOWN || msg == WM_XBUTTONDOWN) ?
+			InputEvent::Type::kMouseButtonDown : InputEvent::Type::kMouseButtonUp;
+		{
+			uint32_t button = kMouseMiddle;
+			if (msg == WM_LBUTTONDOWN || msg == WM_LBUTTONUP) {
+				button = kMouseLeft;
+			} else if (msg == WM_RBUTTONDOWN || msg == WM_RBUTTONUP) {
+				button = kMouseRight;
+			} else if (msg == WM_XBUTTONDOWN || msg == WM_XBUTTONUP) {
+				button = GET_XBUTTON_WPARAM(wparam) == XBUTTON1 ? kMouseX1 : kMouseX2;
+			}
+			event.code = static_cast<uint8_t>(button);
+		}
+		event.x = GET_X_LPARAM(lparam);
+		event.y = GET_Y_LPARAM(lparam);
+
+		// 押している間はキャプチャして、ウィンドウの外で離したときも受け取る
+		if (event.type == InputEvent::Type::kMouseButtonDown) {
+			if (input->capturedMouseButtons == 0) {
+				SetCapture(input->winApp->GetHwnd());
+			}
+			input->capturedMouseButtons |= 1u << event.code;
+		} else {
+			input->capturedMouseButtons &= ~(1u << event.code);
+			if (input->capturedMouseButtons == 0 && GetCapture() == input->winApp->GetHwnd()) {
+				ReleaseCapture();
+			}
+		}
+		break;
+	case WM_MOUSEMOVE:
+		event.type = InputEvent::Type::kMouseMove;
+		event.x = GET_X_LPARAM(lparam);
+		event.y = GET_Y_LPARAM(lparam);
+		break;
+	case WM_MOUSEWHEEL:
+		event.type = InputEvent::Type::kMouseWheel;
+		event.x = GET_WHEEL_DELTA_WPARAM(wparam);
+		break;
+	case WM_CAPTURECHANGED:
+		// 押している途中でキャプチャを取られたら、離したことを受け取れないので全部離したことにする
+		if (input->capturedMouseButtons == 0) {
+			return;
+		}
+		event.time = input->GetMessageEventTime();
+		for (uint32_t button = 0; button < InputSnapshot::kMouseButtonCount; ++button) {
+			if (input->capturedMouseButtons & (1u << button)) {
+				event.type = InputEvent::Type::kMouseButtonUp;
+				event.code = static_cast<uint8_t>(button);
+				input->eventQueue.Push(event);
+			}
+		}
+		input->capturedMouseButtons = 0;
+		return;
+	case WM_KILLFOCUS:
+		event.type = InputEvent::Type::kFocusLost;
+		input->capturedMouseButtons = 0;
+		break;
+	default:
+		return;
 	}
-	// 前回のキー状態を保存
-	preKey[keyNumber] = key[keyNumber];
-	return ret;
-}
\ No newline at end of file
+
+	// キーとマウスのメッセージはOSが積んだ時刻を使う（処理するのがフレームの始めにまとめてでも、フレームの中のどこで起きたかが分かる）
+	event.time = input->GetMessageEventTime();
+	input->eventQueue.Push(event);
+}
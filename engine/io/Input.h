@@ -3,37 +3,85 @@
 #include <windows.h>
 
 #include <dinput.h>
-#include <wrl.h>
-#include <cassert>      
+#include <cassert>
+#include <cstdint>
+#include <vector>
 
+#include "InputEventQueue.h"
+#include "InputSnapshot.h"
 #include "WinApp.h"
 
 // 入力
+// キーとマウスのウィンドウメッセージを、OSがメッセージを積んだ時刻（GetMessageTime）付きの事象にしてキューに積み、
+// Updateでフレームの始めまでに起きたものをまとめて反映する。キー番号はDirectInputと同じDIK_*
+// 今はWinApp::ProcessMessageがゲームと同じスレッドでメッセージを処理するので、キューもそのスレッドの中で受け渡している
+// （メッセージの処理を別のスレッドに移しても、キューは書く側と読む側が一つずつならそのまま使える）
 class Input {
 public:
 
+	// マウスのボタン番号
+	static const uint32_t kMouseLeft = 0;
+	static const uint32_t kMouseRight = 1;
+	static const uint32_t kMouseMiddle = 2;
+	static const uint32_t kMouseX1 = 3;
+	static const uint32_t kMouseX2 = 4;
+
+	~Input();
+
 	// 初期化
 	void Initialize(WinApp* winApp);
 
 	// 更新
 	void Update();
 
-	bool PushKey(BYTE keyNumber);
+	bool PushKey(BYTE keyNumber) const;
+
+	// トリガー判定（このフレームの間に押されたか。1フレームより短い押下も拾い、何度呼んでも同じ結果になる）
+	bool TriggerKey(BYTE keyNumber) const;
+
+	// 離した瞬間の判定
+	bool ReleaseKey(BYTE keyNumber) const;
+
+	// マウスのボタン
+	bool PushMouse(uint32_t button) const;
+	bool TriggerMouse(uint32_t button) const;
+
+	// マウスの位置（クライアント座標）と、このフレームで回したホイールの量
+	int32_t GetMouseX() const { return snapshot.GetMouseX(); }
+	int32_t GetMouseY() const { return snapshot.GetMouseY(); }
+	int32_t GetWheelDelta() const { return snapshot.GetWheelDelta(); }
 
-	// トリガー判定
-	bool TriggerKey(BYTE keyNumber);
+	// このフレームの状態と、このフレームに届いた事象（届いた順）
+	const InputSnapshot& GetSnapshot() const { return snapshot; }
+	const std::vector<InputEvent>& GetEvents() const { return snapshot.GetEvents(); }
+
+	// キューがいっぱいで捨てた事象の数
+	uint32_t GetDroppedEventCount() const { return eventQueue.GetDroppedCount(); }
+
+	// 事象の時刻と同じ基準の今の時刻（ナノ秒）
+	static uint64_t GetTime();
 
 private:
 
-	// DirectInputのインスタンス
-	Microsoft::WRL::ComPtr<IDirectInput8> directInput = nullptr;
+	// ウィンドウメッセージを事象にして積む（ウィンドウメッセージを処理するスレッドから呼ばれる）
+	static void OnWindowMessage(void* context, UINT msg, WPARAM wparam, LPARAM lparam);
+
+	// 今処理しているメッセージをOSが積んだ時刻（事象の時刻と同じ基準。前の事象より前にはしない）
+	uint64_t GetMessageEventTime();
+
+	// ウィンドウメッセージを処理するスレッドからゲームのスレッドへ事象を渡すキュー
+	InputEventQueue eventQueue;
+
+	// 最後に積んだ事象の時刻（キューの中を時刻順に保つ）
+	uint64_t lastEventTime = 0;
 
-	// キーボードデバイスの生成
-	Microsoft::WRL::ComPtr<IDirectInputDevice8> keyboard = nullptr;
+	// ウィンドウの中で押したマウスのボタン（ビットごと）
+	// 押している間はマウスをキャプチャして、ウィンドウの外で離しても離したことを受け取る
+	uint32_t capturedMouseButtons = 0;
 
-	BYTE key[256] = {};
-	BYTE preKey[256] = {};
+	// 1フレーム分の状態
+	InputSnapshot snapshot;
 
 	// WinAPI
 	WinApp* winApp = nullptr;
-};
\ No newline at end of file
+};
@@ -0,0 +1,38 @@
+#include "InputEventQueue.h"
+
+static_assert((InputEventQueue::kCapacity & (InputEventQueue::kCapacity - 1)) == 0, "kCapacity must be a power of two");
+
+bool InputEventQueue::Push(const InputEvent& event) {
+
+	// 取り出した数はacquireで読み、取り出された場所を書き換えてよいことを保証する
+	uint32_t pushed = pushedCount.load(std::memory_order_relaxed);
+	uint32_t popped = poppedCount.load(std::memory_order_acquire);
+	if (pushed - popped >= kCapacity) {
+		droppedCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	events[pushed & (kCapacity - 1)] = event;
+
+	// 書いた中身が読む側に見えるようにreleaseで進める
+	pushedCount.store(pushed + 1, std::memory_order_release);
+	return true;
+}
+
+bool InputEventQueue::Pop(InputEvent& event, uint64_t time) {
+	uint32_t popped = poppedCount.load(std::memory_order_relaxed);
+	if (pushedCount.load(std::memory_order_acquire) == popped) {
+		return false;
+	}
+	const InputEvent& front = events[popped & (kCapacity - 1)];
+	if (front.time > time) {
+		return false;
+	}
+	event = front;
+	poppedCount.store(popped + 1, std::memory_order_release);
+	return true;
+}
+
+uint32_t InputEventQueue::GetQueuedCount() const {
+	uint32_t popped = poppedCount.load(std::memory_order_acquire);
+	return pushedCount.load(std::memory_order_acquire) - popped;
+}
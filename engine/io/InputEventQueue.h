@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// 入力の事象一つ分
+struct InputEvent {
+
+	// 事象の種類
+	enum class Type : uint8_t {
+		kKeyDown,
+		kKeyUp,
+		kMouseButtonDown,
+		kMouseButtonUp,
+		kMouseMove,
+		kMouseWheel,
+		kFocusLost, // ウィンドウが非アクティブになった（押しているものを全部離したことにする）
+	};
+
+	Type type = Type::kKeyDown;
+	uint8_t code = 0;  // キー番号（DIK_*）かマウスのボタン番号
+	int32_t x = 0;     // マウスの位置（クライアント座標）。ホイールはxに回した量
+	int32_t y = 0;
+	uint64_t time = 0; // 起きた時刻（steady_clockのナノ秒）
+};
+
+// 入力の事象を受け渡すリング
+// 書く側（ウィンドウメッセージを処理するスレッド）が事象を積み、読む側（ゲームのスレッド）がフレームの始めに取り出す。
+// 二つが同じスレッドでも別のスレッドでも使える
+// 書く側・読む側がそれぞれ一つだけなので、ロックを使わずカウンタ二つで受け渡す
+// Windowsに依存しないので、作った事象を積んで単体で確認できる
+class InputEventQueue {
+public:
+
+	// 積んでおける事象の数（2の累乗）
+	static const uint32_t kCapacity = 1024;
+
+	// 積む（いっぱいなら捨ててfalse）【書く側】
+	bool Push(const InputEvent& event);
+
+	// 先頭の事象がtime以前に受け取ったものなら取り出す（無ければfalse）【読む側】
+	bool Pop(InputEvent& event, uint64_t time = UINT64_MAX);
+
+	// 積んだまま取り出されていない事象の数（どちらのスレッドからでも呼べる）
+	uint32_t GetQueuedCount() const;
+
+	// いっぱいで捨てた事象の数
+	uint32_t GetDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+
+	std::array<InputEvent, kCapacity> events;
+
+	// 積んだ数と取り出した数（それぞれ片方のスレッドしか書かない。あふれても差は正しい）
+	// 書く側と読む側が同じキャッシュラインを取り合わないように離しておく
+	alignas(64) std::atomic<uint32_t> pushedCount{ 0 };
+	alignas(64) std::atomic<uint32_t> poppedCount{ 0 };
+	std::atomic<uint32_t> droppedCount{ 0 };
+};
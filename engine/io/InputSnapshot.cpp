@@ -0,0 +1,87 @@
+#include "InputSnapshot.h"
+
+void InputSnapshot::Update(InputEventQueue& queue, uint64_t time) {
+	BeginFrame(time);
+
+	// フレームを始めた後に届いたものは次のフレームに回す
+	InputEvent event;
+	while (queue.Pop(event, time)) {
+		Apply(event);
+	}
+}
+
+void InputSnapshot::BeginFrame(uint64_t time) {
+	for (ButtonState& state : keys) {
+		state.pressCount = 0;
+		state.releaseCount = 0;
+	}
+	for (ButtonState& state : mouseButtons) {
+		state.pressCount = 0;
+		state.releaseCount = 0;
+	}
+	wheelDelta = 0;
+	events.clear();
+	previousFrameTime = frameTime;
+	frameTime = time;
+}
+
+void InputSnapshot::Apply(const InputEvent& event) {
+	events.push_back(event);
+	switch (event.type) {
+	case InputEvent::Type::kKeyDown:
+		Press(keys[event.code], event.time);
+		break;
+	case InputEvent::Type::kKeyUp:
+		Release(keys[event.code]);
+		break;
+	case InputEvent::Type::kMouseButtonDown:
+		if (event.code < kMouseButtonCount) {
+			Press(mouseButtons[event.code], event.time);
+		}
+		mouseX = event.x;
+		mouseY = event.y;
+		break;
+	case InputEvent::Type::kMouseButtonUp:
+		if (event.code < kMouseButtonCount) {
+			Release(mouseButtons[event.code]);
+		}
+		mouseX = event.x;
+		mouseY = event.y;
+		break;
+	case InputEvent::Type::kMouseMove:
+		mouseX = event.x;
+		mouseY = event.y;
+		break;
+	case InputEvent::Type::kMouseWheel:
+		wheelDelta += event.x;
+		break;
+	case InputEvent::Type::kFocusLost:
+		// 離したことを受け取れなくなるので、押しているものは全部離す
+		for (ButtonState& state : keys) {
+			Release(state);
+		}
+		for (ButtonState& state : mouseButtons) {
+			Release(state);
+		}
+		break;
+	}
+}
+
+void InputSnapshot::Press(ButtonState& state, uint64_t time) {
+	if (state.isDown) {
+		return;
+	}
+	if (state.pressCount == 0) {
+		state.pressTime = time;
+	}
+	state.isDown = true;
+	++state.pressCount;
+}
+
+void InputSnapshot::Release(ButtonState& state) {
+	if (!state.isDown) {
+		return;
+	}
+	state.isDown = false;
+	++state.releaseCount;
+}
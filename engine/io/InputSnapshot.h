@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "InputEventQueue.h"
+
+// 1フレーム分の入力の状態
+// フレームの始めにキューに溜まった事象を届いた順に反映し、フレームの終わりの押下状態に加えて
+// フレームの間に押された回数・離された回数を数えておく（1フレームより短い押下も取りこぼさない）
+// Windowsに依存しないので、作った事象をApplyで渡して単体で確認できる
+class InputSnapshot {
+public:
+
+	// キーの数（DIK_*）とマウスのボタンの数（左、右、中、X1、X2）
+	static const uint32_t kKeyCount = 256;
+	static const uint32_t kMouseButtonCount = 5;
+
+	// 新しいフレームを始め、time以前に受け取った事象をキューから全部取り出して反映する
+	void Update(InputEventQueue& queue, uint64_t time);
+
+	// 新しいフレームを始める（押下状態は引き継ぎ、回数と事象は空にする）
+	void BeginFrame(uint64_t time);
+
+	// 事象を一つ反映する
+	void Apply(const InputEvent& event);
+
+	// いま押されているか（フレームの終わりの状態）
+	bool IsKeyDown(uint8_t key) const { return keys[key].isDown; }
+
+	// このフレームの間に押されたか（押してすぐ離していてもtrue）
+	bool IsKeyPressed(uint8_t key) const { return keys[key].pressCount > 0; }
+
+	// このフレームの間に離されたか
+	bool IsKeyReleased(uint8_t key) const { return keys[key].releaseCount > 0; }
+
+	// このフレームの間に押された回数と、最初に押された時刻
+	uint32_t GetKeyPressCount(uint8_t key) const { return keys[key].pressCount; }
+	uint64_t GetKeyPressTime(uint8_t key) const { return keys[key].pressTime; }
+
+	// マウスのボタン（キーと同じ意味）
+	bool IsMouseButtonDown(uint32_t button) const { return mouseButtons[button].isDown; }
+	bool IsMouseButtonPressed(uint32_t button) const { return mouseButtons[button].pressCount > 0; }
+	bool IsMouseButtonReleased(uint32_t button) const { return mouseButtons[button].releaseCount > 0; }
+	uint32_t GetMouseButtonPressCount(uint32_t button) const { return mouseButtons[button].pressCount; }
+
+	// マウスの位置（クライアント座標）と、このフレームで回したホイールの量
+	int32_t GetMouseX() const { return mouseX; }
+	int32_t GetMouseY() const { return mouseY; }
+	int32_t GetWheelDelta() const { return wheelDelta; }
+
+	// このフレームに反映した事象（届いた順）
+	const std::vector<InputEvent>& GetEvents() const { return events; }
+
+	// このフレームと前のフレームを始めた時刻（事象の時刻と比べて、フレームの中のどこで起きたかが分かる）
+	uint64_t GetFrameTime() const { return frameTime; }
+	uint64_t GetPreviousFrameTime() const { return previousFrameTime; }
+
+private:
+
+	// キーかボタン一つ分
+	struct ButtonState {
+		bool isDown = false;
+		uint32_t pressCount = 0;
+		uint32_t releaseCount = 0;
+		uint64_t pressTime = 0;
+	};
+
+	std::array<ButtonState, kKeyCount> keys;
+	std::array<ButtonState, kMouseButtonCount> mouseButtons;
+	int32_t mouseX = 0;
+	int32_t mouseY = 0;
+	int32_t wheelDelta = 0;
+
+	std::vector<InputEvent> events;
+	uint64_t frameTime = 0;
+	uint64_t previousFrameTime = 0;
+
+	// 押した・離した（押したままの二重の押下や、押していないものを離すのは数えない）
+	static void Press(ButtonState& state, uint64_t time);
+	static void Release(ButtonState& state);
+};
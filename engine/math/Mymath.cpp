@@ -1,4 +1,5 @@
 #include "Mymath.h"
+#include <bit>
 
 using namespace std;
 
@@ -7,6 +8,23 @@ namespace Math {
 #pragma region 行列関連関数
 	// 行列の積
 	Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+#if MATH_USE_SIMD
+		return Simd::Multiply(m1, m2);
+#else
+		return Scalar::Multiply(m1, m2);
+#endif
+	}
+
+	Matrix4x4A Multiply(const Matrix4x4A& m1, const Matrix4x4A& m2) {
+#if MATH_USE_SIMD
+		return Simd::Multiply(m1, m2);
+#else
+		return Matrix4x4A{ Scalar::Multiply(m1, m2) };
+#endif
+	}
+
+	// スカラーの行列の積
+	Matrix4x4 Scalar::Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
 		Matrix4x4 result = {};
 		for (int i = 0; i < 4; i++) {
 			for (int j = 0; j < 4; j++) {
@@ -30,6 +48,15 @@ namespace Math {
 	}
 
 	Matrix4x4 Inverse(const Matrix4x4& m) {
+#if MATH_USE_SIMD
+		return Simd::Inverse(m);
+#else
+		return Scalar::Inverse(m);
+#endif
+	}
+
+	// スカラーの逆行列（余因子を一つずつ展開する）
+	Matrix4x4 Scalar::Inverse(const Matrix4x4& m) {
 		Matrix4x4 result = {};
 
 		float det =
@@ -138,10 +165,10 @@ namespace Math {
 	Matrix4x4 MakeRotXMatrix(float radian) {
 		Matrix4x4 result = {};
 		result.m[0][0] = 1.0f;
-		result.m[1][1] = std::cosf(radian);
-		result.m[1][2] = std::sinf(radian);
-		result.m[2][1] = -std::sinf(radian);
-		result.m[2][2] = std::cosf(radian);
+		result.m[1][1] = std::cos(radian);
+		result.m[1][2] = std::sin(radian);
+		result.m[2][1] = -std::sin(radian);
+		result.m[2][2] = std::cos(radian);
 		result.m[3][3] = 1.0f;
 		return result;
 	}
@@ -149,11 +176,11 @@ namespace Math {
 	// Y軸の回転行列
 	Matrix4x4 MakeRotYMatrix(float radian) {
 		Matrix4x4 result = {};
-		result.m[0][0] = std::cosf(radian);
-		result.m[0][2] = -std::sinf(radian);
+		result.m[0][0] = std::cos(radian);
+		result.m[0][2] = -std::sin(radian);
 		result.m[1][1] = 1.0f;
-		result.m[2][0] = std::sinf(radian);
-		result.m[2][2] = std::cosf(radian);
+		result.m[2][0] = std::sin(radian);
+		result.m[2][2] = std::cos(radian);
 		result.m[3][3] = 1.0f;
 		return result;
 	}
@@ -161,10 +188,10 @@ namespace Math {
 	// Z軸の回転行列
 	Matrix4x4 MakeRotZMatrix(float radian) {
 		Matrix4x4 result = {};
-		result.m[0][0] = std::cosf(radian);
-		result.m[0][1] = std::sinf(radian);
-		result.m[1][0] = -std::sinf(radian);
-		result.m[1][1] = std::cosf(radian);
+		result.m[0][0] = std::cos(radian);
+		result.m[0][1] = std::sin(radian);
+		result.m[1][0] = -std::sin(radian);
+		result.m[1][1] = std::cos(radian);
 		result.m[2][2] = 1.0f;
 		result.m[3][3] = 1.0f;
 		return result;
@@ -182,6 +209,15 @@ namespace Math {
 
 	// 3次元アフィン変換行列
 	Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
+#if MATH_USE_SIMD
+		return Simd::MakeAffineMatrix(scale, rotate, translate);
+#else
+		return Scalar::MakeAffineMatrix(scale, rotate, translate);
+#endif
+	}
+
+	// スカラーの3次元アフィン変換行列（行列を作って掛け合わせる）
+	Matrix4x4 Scalar::MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
 
 		// スケーリング行列の作成
 		Matrix4x4 matScale = MakeScaleMatrix(scale);
@@ -191,13 +227,13 @@ namespace Math {
 		Matrix4x4 matRotZ = MakeRotZMatrix(rotate.z);
 
 		// 回転行列の合成
-		Matrix4x4 matRot = Multiply(Multiply(matRotY, matRotX), matRotZ);
+		Matrix4x4 matRot = Scalar::Multiply(Scalar::Multiply(matRotY, matRotX), matRotZ);
 
 		// 平行移動行列の作成
 		Matrix4x4 matTrans = MakeTransMatrix(translate);
 
 		// スケーリング、回転、平行移動の合成
-		Matrix4x4 matTransform = Multiply(Multiply(matScale, matRot), matTrans);
+		Matrix4x4 matTransform = Scalar::Multiply(Scalar::Multiply(matScale, matRot), matTrans);
 
 		return matTransform;
 	}
@@ -205,7 +241,7 @@ namespace Math {
 	// 透視投影行列
 	Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip) {
 		Matrix4x4 result = {};
-		float f = 1.0f / std::tanf(fovY / 2.0f);
+		float f = 1.0f / std::tan(fovY / 2.0f);
 		result.m[0][0] = (f * (1.0f / aspectRatio));
 		result.m[1][1] = f;
 		result.m[2][2] = (farClip) / (farClip - nearClip);
@@ -227,4 +263,225 @@ namespace Math {
 		return result;
 	}
 #pragma endregion
+
+#pragma region クォータニオン関連関数
+	namespace {
+		// 各成分の和
+		Quaternion Add(const Quaternion& q0, const Quaternion& q1) {
+			return { q0.x + q1.x, q0.y + q1.y, q0.z + q1.z, q0.w + q1.w };
+		}
+
+		// スカラー倍
+		Quaternion Scale(const Quaternion& quaternion, float s) {
+			return { quaternion.x * s, quaternion.y * s, quaternion.z * s, quaternion.w * s };
+		}
+	}
+
+	// 単位クォータニオン
+	Quaternion IdentityQuaternion() {
+		return { 0.0f, 0.0f, 0.0f, 1.0f };
+	}
+
+	// クォータニオンの積
+	Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs) {
+		Quaternion result = {};
+		result.x = (lhs.y * rhs.z - lhs.z * rhs.y) + rhs.w * lhs.x + lhs.w * rhs.x;
+		result.y = (lhs.z * rhs.x - lhs.x * rhs.z) + rhs.w * lhs.y + lhs.w * rhs.y;
+		result.z = (lhs.x * rhs.y - lhs.y * rhs.x) + rhs.w * lhs.z + lhs.w * rhs.z;
+		result.w = lhs.w * rhs.w - (lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z);
+		return result;
+	}
+
+	// 共役クォータニオン
+	Quaternion Conjugate(const Quaternion& quaternion) {
+		return { -quaternion.x, -quaternion.y, -quaternion.z, quaternion.w };
+	}
+
+	// ノルム
+	float Norm(const Quaternion& quaternion) {
+		return sqrtf(Dot(quaternion, quaternion));
+	}
+
+	// 正規化
+	Quaternion Normalize(const Quaternion& quaternion) {
+		float norm = Norm(quaternion);
+		if (norm == 0.0f) {
+			return quaternion;
+		}
+		return Scale(quaternion, 1.0f / norm);
+	}
+
+	// 逆クォータニオン
+	Quaternion Inverse(const Quaternion& quaternion) {
+		float normSquared = Dot(quaternion, quaternion);
+		if (normSquared == 0.0f) {
+			return quaternion;
+		}
+		return Scale(Conjugate(quaternion), 1.0f / normSquared);
+	}
+
+	// 内積
+	float Dot(const Quaternion& q0, const Quaternion& q1) {
+		return q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+	}
+
+	// 任意軸回転を表すクォータニオン
+	Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle) {
+		float s = std::sin(angle * 0.5f);
+		return { axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f) };
+	}
+
+	// オイラー角を表すクォータニオン
+	// MakeAffineMatrixの回転行列 Y * X * Z（Yで回してからX、Z）と同じ回転にする
+	Quaternion MakeRotateQuaternion(const Vector3& rotate) {
+		Quaternion rotateX = MakeRotateAxisAngleQuaternion({ 1.0f, 0.0f, 0.0f }, rotate.x);
+		Quaternion rotateY = MakeRotateAxisAngleQuaternion({ 0.0f, 1.0f, 0.0f }, rotate.y);
+		Quaternion rotateZ = MakeRotateAxisAngleQuaternion({ 0.0f, 0.0f, 1.0f }, rotate.z);
+		return Multiply(rotateZ, Multiply(rotateX, rotateY));
+	}
+
+	// ベクトルをクォータニオンで回転させる
+	Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion) {
+		Quaternion result = Multiply(Multiply(quaternion, { vector.x, vector.y, vector.z, 0.0f }), Conjugate(quaternion));
+		return { result.x, result.y, result.z };
+	}
+
+	// クォータニオンから回転行列を作る
+	Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion) {
+		return MakeAffineMatrixQuaternion({ 1.0f, 1.0f, 1.0f }, quaternion, { 0.0f, 0.0f, 0.0f });
+	}
+
+	// 正規化線形補間
+	Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t) {
+		// 遠回りしないように向きをそろえる
+		Quaternion end = Dot(q0, q1) < 0.0f ? Scale(q1, -1.0f) : q1;
+		return Normalize(Add(Scale(q0, 1.0f - t), Scale(end, t)));
+	}
+
+	// 球面線形補間
+	Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t) {
+		// 遠回りしないように向きをそろえる
+		float dot = Dot(q0, q1);
+		Quaternion end = q1;
+		if (dot < 0.0f) {
+			end = Scale(q1, -1.0f);
+			dot = -dot;
+		}
+
+		// ほぼ同じ向きのときはsinθが0に近くて不安定なのでNlerpにする
+		const float kNlerpThreshold = 0.9995f;
+		if (dot > kNlerpThreshold) {
+			return Normalize(Add(Scale(q0, 1.0f - t), Scale(end, t)));
+		}
+
+		float theta = std::acos(dot);
+		float invSinTheta = 1.0f / std::sin(theta);
+		float scale0 = std::sin((1.0f - t) * theta) * invSinTheta;
+		float scale1 = std::sin(t * theta) * invSinTheta;
+		return Add(Scale(q0, scale0), Scale(end, scale1));
+	}
+
+	// クォータニオンの回転で3次元アフィン変換行列を作る
+	Matrix4x4 MakeAffineMatrixQuaternion(const Vector3& scale, const Quaternion& rotate, const Vector3& translate) {
+		float xx = rotate.x * rotate.x;
+		float yy = rotate.y * rotate.y;
+		float zz = rotate.z * rotate.z;
+		float xy = rotate.x * rotate.y;
+		float xz = rotate.x * rotate.z;
+		float yz = rotate.y * rotate.z;
+		float wx = rotate.w * rotate.x;
+		float wy = rotate.w * rotate.y;
+		float wz = rotate.w * rotate.z;
+
+		// 回転行列の各行にスケールをかける
+		Matrix4x4 result = {};
+		result.m[0][0] = (1.0f - 2.0f * (yy + zz)) * scale.x;
+		result.m[0][1] = 2.0f * (xy + wz) * scale.x;
+		result.m[0][2] = 2.0f * (xz - wy) * scale.x;
+		result.m[1][0] = 2.0f * (xy - wz) * scale.y;
+		result.m[1][1] = (1.0f - 2.0f * (xx + zz)) * scale.y;
+		result.m[1][2] = 2.0f * (yz + wx) * scale.y;
+		result.m[2][0] = 2.0f * (xz + wy) * scale.z;
+		result.m[2][1] = 2.0f * (yz - wx) * scale.z;
+		result.m[2][2] = (1.0f - 2.0f * (xx + yy)) * scale.z;
+
+		// 平行移動
+		result.m[3][0] = translate.x;
+		result.m[3][1] = translate.y;
+		result.m[3][2] = translate.z;
+		result.m[3][3] = 1.0f;
+		return result;
+	}
+
+	// 回転と平行移動からデュアルクォータニオンを作る
+	DualQuaternion MakeDualQuaternion(const Quaternion& rotate, const Vector3& translate) {
+		DualQuaternion result = {};
+		result.real = rotate;
+		result.dual = Scale(Multiply({ translate.x, translate.y, translate.z, 0.0f }, rotate), 0.5f);
+		return result;
+	}
+
+	// デュアルクォータニオンの積
+	DualQuaternion Multiply(const DualQuaternion& lhs, const DualQuaternion& rhs) {
+		DualQuaternion result = {};
+		result.real = Multiply(lhs.real, rhs.real);
+		result.dual = Add(Multiply(lhs.real, rhs.dual), Multiply(lhs.dual, rhs.real));
+		return result;
+	}
+
+	// 正規化
+	DualQuaternion Normalize(const DualQuaternion& dualQuaternion) {
+		float norm = Norm(dualQuaternion.real);
+		if (norm == 0.0f) {
+			return dualQuaternion;
+		}
+
+		// 実部を単位クォータニオンにし、双対部から実部と平行な成分を取り除く
+		DualQuaternion result = {};
+		result.real = Scale(dualQuaternion.real, 1.0f / norm);
+		result.dual = Scale(dualQuaternion.dual, 1.0f / norm);
+		result.dual = Add(result.dual, Scale(result.real, -Dot(result.real, result.dual)));
+		return result;
+	}
+
+	// 平行移動を取り出す
+	Vector3 GetTranslate(const DualQuaternion& dualQuaternion) {
+		Quaternion translate = Multiply(Scale(dualQuaternion.dual, 2.0f), Conjugate(dualQuaternion.real));
+		return { translate.x, translate.y, translate.z };
+	}
+
+	// 点を変換する
+	Vector3 TransformPoint(const Vector3& point, const DualQuaternion& dualQuaternion) {
+		Vector3 rotated = RotateVector(point, dualQuaternion.real);
+		Vector3 translate = GetTranslate(dualQuaternion);
+		return { rotated.x + translate.x, rotated.y + translate.y, rotated.z + translate.z };
+	}
+
+	// 線形補間して正規化する
+	DualQuaternion Nlerp(const DualQuaternion& d0, const DualQuaternion& d1, float t) {
+		// 遠回りしないように向きをそろえる
+		float sign = Dot(d0.real, d1.real) < 0.0f ? -1.0f : 1.0f;
+		DualQuaternion result = {};
+		result.real = Add(Scale(d0.real, 1.0f - t), Scale(d1.real, t * sign));
+		result.dual = Add(Scale(d0.dual, 1.0f - t), Scale(d1.dual, t * sign));
+		return Normalize(result);
+	}
+
+	// デュアルクォータニオンから変換行列を作る
+	Matrix4x4 MakeAffineMatrix(const DualQuaternion& dualQuaternion) {
+		DualQuaternion normalized = Normalize(dualQuaternion);
+		return MakeAffineMatrixQuaternion({ 1.0f, 1.0f, 1.0f }, normalized.real, GetTranslate(normalized));
+	}
+#pragma endregion
+
+	// 2つのfloatが何ULP離れているか
+	uint32_t UlpDistance(float a, float b) {
+		// 符号付きの整数に並べ直すと、隣り合うfloatの差が1になる（+0と-0はどちらも0）
+		int32_t ia = bit_cast<int32_t>(a);
+		int32_t ib = bit_cast<int32_t>(b);
+		int64_t orderedA = ia < 0 ? static_cast<int64_t>(INT32_MIN) - ia : ia;
+		int64_t orderedB = ib < 0 ? static_cast<int64_t>(INT32_MIN) - ib : ib;
+		int64_t distance = orderedA > orderedB ? orderedA - orderedB : orderedB - orderedA;
+		return distance > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(distance);
+	}
 }
\ No newline at end of file
@@ -2,6 +2,16 @@
 #include <cstdint>
 #include <cmath>
 
+// 行列計算にSSEの実装を使うか（1ならSSE、0ならスカラーの実装）
+// x64ならSSE2は必ず使えるので既定で有効にする
+#ifndef MATH_USE_SIMD
+#if defined(_M_X64) || defined(__SSE2__)
+#define MATH_USE_SIMD 1
+#else
+#define MATH_USE_SIMD 0
+#endif
+#endif
+
 namespace Math {
 
 	// Vector4の構造体
@@ -29,12 +39,29 @@ namespace Math {
 		float m[4][4];
 	};
 
+	// 16バイト境界に揃えたVector4（SSEでそのまま読み書きできる）
+	struct alignas(16) Vector4A : Vector4 {};
+
+	// 16バイト境界に揃えた4x4の行列（SSEでそのまま読み書きできる）
+	struct alignas(16) Matrix4x4A : Matrix4x4 {};
+
 	struct TransForm {
 		Vector3 scale;
 		Vector3 rotate;
 		Vector3 translate;
 	};
 
+	// クォータニオンの構造体（x, y, zが虚部、wが実部）
+	struct Quaternion {
+		float x, y, z, w;
+	};
+
+	// デュアルクォータニオンの構造体（realが回転、dualが平行移動を含む部分）
+	struct DualQuaternion {
+		Quaternion real;
+		Quaternion dual;
+	};
+
 	inline Vector2 operator+(const Vector2& a, const Vector2& b) {
 		return { a.x + b.x, a.y + b.y };
 	}
@@ -63,9 +90,26 @@ namespace Math {
 		return a;
 	}
 
+	inline bool operator==(const Vector2& a, const Vector2& b) {
+		return a.x == b.x && a.y == b.y;
+	}
+
+	inline bool operator!=(const Vector2& a, const Vector2& b) {
+		return !(a == b);
+	}
+
+	inline bool operator==(const Vector4& a, const Vector4& b) {
+		return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+	}
+
+	inline bool operator!=(const Vector4& a, const Vector4& b) {
+		return !(a == b);
+	}
+
 #pragma region 行列関連関数
 	// 行列の積
 	Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
+	Matrix4x4A Multiply(const Matrix4x4A& m1, const Matrix4x4A& m2);
 
 	// 逆行列
 	// 3x3行列式（余因子計算用）
@@ -111,4 +155,95 @@ namespace Math {
 	// 正射影行列
 	Matrix4x4 MakeOrthographicMatrix(float left, float top, float right, float bottom, float nearClip, float farClip);
 #pragma endregion
+
+#pragma region クォータニオン関連関数
+	// 単位クォータニオン
+	Quaternion IdentityQuaternion();
+
+	// クォータニオンの積（lhs * rhs。rhsで回してからlhsで回すのと同じ）
+	Quaternion Multiply(const Quaternion& lhs, const Quaternion& rhs);
+
+	// 共役クォータニオン
+	Quaternion Conjugate(const Quaternion& quaternion);
+
+	// ノルム
+	float Norm(const Quaternion& quaternion);
+
+	// 正規化
+	Quaternion Normalize(const Quaternion& quaternion);
+
+	// 逆クォータニオン
+	Quaternion Inverse(const Quaternion& quaternion);
+
+	// 内積
+	float Dot(const Quaternion& q0, const Quaternion& q1);
+
+	// 任意軸回転を表すクォータニオン（axisは正規化済み）
+	Quaternion MakeRotateAxisAngleQuaternion(const Vector3& axis, float angle);
+
+	// オイラー角（MakeAffineMatrixと同じ回転順）を表すクォータニオン
+	Quaternion MakeRotateQuaternion(const Vector3& rotate);
+
+	// ベクトルをクォータニオンで回転させる
+	Vector3 RotateVector(const Vector3& vector, const Quaternion& quaternion);
+
+	// クォータニオンから回転行列を作る
+	Matrix4x4 MakeRotateMatrix(const Quaternion& quaternion);
+
+	// 正規化線形補間（slerpより速いが、角速度が一定にならない）
+	Quaternion Nlerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+	// 球面線形補間（近い向きのときはNlerpにする）
+	Quaternion Slerp(const Quaternion& q0, const Quaternion& q1, float t);
+
+	// クォータニオンの回転で3次元アフィン変換行列を作る（回転行列の掛け算をしない）
+	// オイラー角の版と同じ名前にすると、MakeAffineMatrix({...}, {...}, {...})の呼び出しがあいまいになるので名前を分ける
+	Matrix4x4 MakeAffineMatrixQuaternion(const Vector3& scale, const Quaternion& rotate, const Vector3& translate);
+
+	// 回転と平行移動からデュアルクォータニオンを作る（回してから動かす）
+	DualQuaternion MakeDualQuaternion(const Quaternion& rotate, const Vector3& translate);
+
+	// デュアルクォータニオンの積（rhsの変換をしてからlhsの変換をするのと同じ）
+	DualQuaternion Multiply(const DualQuaternion& lhs, const DualQuaternion& rhs);
+
+	// 正規化
+	DualQuaternion Normalize(const DualQuaternion& dualQuaternion);
+
+	// 平行移動を取り出す
+	Vector3 GetTranslate(const DualQuaternion& dualQuaternion);
+
+	// 点を変換する
+	Vector3 TransformPoint(const Vector3& point, const DualQuaternion& dualQuaternion);
+
+	// 線形補間して正規化する（スキニングのブレンドと同じ。近道になるように符号を合わせる）
+	DualQuaternion Nlerp(const DualQuaternion& d0, const DualQuaternion& d1, float t);
+
+	// デュアルクォータニオンから変換行列を作る
+	Matrix4x4 MakeAffineMatrix(const DualQuaternion& dualQuaternion);
+#pragma endregion
+
+#pragma region 実装ごとの関数
+	// スカラーの実装（SSEの実装の検証にも使う）
+	namespace Scalar {
+		Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
+		Matrix4x4 Inverse(const Matrix4x4& m);
+		Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate);
+	}
+
+#if MATH_USE_SIMD
+	// SSEの実装
+	// Multiply、MakeAffineMatrixはスカラーの実装と同じ順番で計算するのでビット単位で一致する（0の符号は除く）
+	// Inverseは2x2の小行列で計算するので順番が違い、0に近い要素ではULPで数万ずれる（絶対誤差は3e-6程度）
+	// どちらもtools/EngineTestsのMymathTestで確かめている
+	namespace Simd {
+		Matrix4x4 Multiply(const Matrix4x4& m1, const Matrix4x4& m2);
+		Matrix4x4A Multiply(const Matrix4x4A& m1, const Matrix4x4A& m2);
+		Matrix4x4 Inverse(const Matrix4x4& m);
+		Matrix4x4 MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate);
+	}
+#endif
+
+	// 2つのfloatが何ULP離れているか（+0と-0は同じとみなす）
+	uint32_t UlpDistance(float a, float b);
+#pragma endregion
 };
\ No newline at end of file
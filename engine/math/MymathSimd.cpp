@@ -0,0 +1,165 @@
+#include "Mymath.h"
+
+#if MATH_USE_SIMD
+#include <emmintrin.h>
+
+namespace Math {
+
+	namespace {
+
+		// _mm_shuffle_psの並びを作る
+		constexpr int MakeShuffleMask(int x, int y, int z, int w) {
+			return x | (y << 2) | (z << 4) | (w << 6);
+		}
+
+		// 一つのベクトルの要素を並べ替える
+		template <int x, int y, int z, int w>
+		inline __m128 Swizzle(__m128 v) {
+			return _mm_shuffle_ps(v, v, MakeShuffleMask(x, y, z, w));
+		}
+
+		// 行列の積（m1の1行分 × m2）
+		// スカラーの実装と同じく0から順に足すので結果が一致する
+		inline __m128 MultiplyRow(__m128 row, __m128 b0, __m128 b1, __m128 b2, __m128 b3) {
+			__m128 result = _mm_add_ps(_mm_setzero_ps(), _mm_mul_ps(Swizzle<0, 0, 0, 0>(row), b0));
+			result = _mm_add_ps(result, _mm_mul_ps(Swizzle<1, 1, 1, 1>(row), b1));
+			result = _mm_add_ps(result, _mm_mul_ps(Swizzle<2, 2, 2, 2>(row), b2));
+			result = _mm_add_ps(result, _mm_mul_ps(Swizzle<3, 3, 3, 3>(row), b3));
+			return result;
+		}
+
+		// 2x2の行列（x y / z w を1本に詰めたもの）の積 A * B
+		inline __m128 Mat2Mul(__m128 a, __m128 b) {
+			return _mm_add_ps(_mm_mul_ps(a, Swizzle<0, 3, 0, 3>(b)),
+				_mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+		}
+
+		// 2x2の行列の余因子行列との積 adj(A) * B
+		inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+			return _mm_sub_ps(_mm_mul_ps(Swizzle<3, 3, 0, 0>(a), b),
+				_mm_mul_ps(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b)));
+		}
+
+		// 2x2の行列と余因子行列の積 A * adj(B)
+		inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+			return _mm_sub_ps(_mm_mul_ps(a, Swizzle<3, 0, 3, 0>(b)),
+				_mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+		}
+	}
+
+	// 行列の積
+	Matrix4x4 Simd::Multiply(const Matrix4x4& m1, const Matrix4x4& m2) {
+		__m128 b0 = _mm_loadu_ps(m2.m[0]);
+		__m128 b1 = _mm_loadu_ps(m2.m[1]);
+		__m128 b2 = _mm_loadu_ps(m2.m[2]);
+		__m128 b3 = _mm_loadu_ps(m2.m[3]);
+
+		Matrix4x4 result;
+		for (int i = 0; i < 4; i++) {
+			_mm_storeu_ps(result.m[i], MultiplyRow(_mm_loadu_ps(m1.m[i]), b0, b1, b2, b3));
+		}
+		return result;
+	}
+
+	// 行列の積（16バイト境界に揃えたもの）
+	Matrix4x4A Simd::Multiply(const Matrix4x4A& m1, const Matrix4x4A& m2) {
+		__m128 b0 = _mm_load_ps(m2.m[0]);
+		__m128 b1 = _mm_load_ps(m2.m[1]);
+		__m128 b2 = _mm_load_ps(m2.m[2]);
+		__m128 b3 = _mm_load_ps(m2.m[3]);
+
+		Matrix4x4A result;
+		for (int i = 0; i < 4; i++) {
+			_mm_store_ps(result.m[i], MultiplyRow(_mm_load_ps(m1.m[i]), b0, b1, b2, b3));
+		}
+		return result;
+	}
+
+	// 逆行列
+	// 4x4を2x2の小行列 A B / C D に分けて、小行列の行列式と余因子行列から求める
+	Matrix4x4 Simd::Inverse(const Matrix4x4& m) {
+		__m128 row0 = _mm_loadu_ps(m.m[0]);
+		__m128 row1 = _mm_loadu_ps(m.m[1]);
+		__m128 row2 = _mm_loadu_ps(m.m[2]);
+		__m128 row3 = _mm_loadu_ps(m.m[3]);
+
+		// 小行列
+		__m128 a = _mm_movelh_ps(row0, row1);
+		__m128 b = _mm_movehl_ps(row1, row0);
+		__m128 c = _mm_movelh_ps(row2, row3);
+		__m128 d = _mm_movehl_ps(row3, row2);
+
+		// 小行列の行列式（|A| |B| |C| |D|）
+		__m128 detSub = _mm_sub_ps(
+			_mm_mul_ps(_mm_shuffle_ps(row0, row2, MakeShuffleMask(0, 2, 0, 2)), _mm_shuffle_ps(row1, row3, MakeShuffleMask(1, 3, 1, 3))),
+			_mm_mul_ps(_mm_shuffle_ps(row0, row2, MakeShuffleMask(1, 3, 1, 3)), _mm_shuffle_ps(row1, row3, MakeShuffleMask(0, 2, 0, 2))));
+		__m128 detA = Swizzle<0, 0, 0, 0>(detSub);
+		__m128 detB = Swizzle<1, 1, 1, 1>(detSub);
+		__m128 detC = Swizzle<2, 2, 2, 2>(detSub);
+		__m128 detD = Swizzle<3, 3, 3, 3>(detSub);
+
+		// 逆行列を 1/|M| * (X Y / Z W) としたときの各小行列の余因子行列
+		__m128 dc = Mat2AdjMul(d, c);
+		__m128 ab = Mat2AdjMul(a, b);
+		__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc));
+		__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc));
+
+		// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+		__m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+		__m128 trace = _mm_mul_ps(ab, Swizzle<0, 2, 1, 3>(dc));
+		trace = _mm_add_ps(trace, Swizzle<2, 3, 0, 1>(trace));
+		trace = _mm_add_ps(trace, Swizzle<1, 0, 3, 2>(trace));
+		detM = _mm_sub_ps(detM, trace);
+
+		// 行列が正則でない場合はスカラーの実装と同じく0行列を返す
+		Matrix4x4 result = {};
+		if (_mm_cvtss_f32(detM) == 0.0f) {
+			return result;
+		}
+
+		// 余因子行列の符号をかけながら1/|M|倍する
+		__m128 invDetM = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+		x = _mm_mul_ps(x, invDetM);
+		y = _mm_mul_ps(y, invDetM);
+		z = _mm_mul_ps(z, invDetM);
+		w = _mm_mul_ps(w, invDetM);
+
+		// 余因子行列の並べ替えと書き出しの並べ替えをまとめて行う
+		_mm_storeu_ps(result.m[0], _mm_shuffle_ps(x, y, MakeShuffleMask(3, 1, 3, 1)));
+		_mm_storeu_ps(result.m[1], _mm_shuffle_ps(x, y, MakeShuffleMask(2, 0, 2, 0)));
+		_mm_storeu_ps(result.m[2], _mm_shuffle_ps(z, w, MakeShuffleMask(3, 1, 3, 1)));
+		_mm_storeu_ps(result.m[3], _mm_shuffle_ps(z, w, MakeShuffleMask(2, 0, 2, 0)));
+		return result;
+	}
+
+	// 3次元アフィン変換行列
+	// 回転行列（Y * X * Z）を展開した式で直接作り、各行にスケールをかけるだけにする
+	Matrix4x4 Simd::MakeAffineMatrix(const Vector3& scale, const Vector3& rotate, const Vector3& translate) {
+		float sinX = std::sin(rotate.x);
+		float cosX = std::cos(rotate.x);
+		float sinY = std::sin(rotate.y);
+		float cosY = std::cos(rotate.y);
+		float sinZ = std::sin(rotate.z);
+		float cosZ = std::cos(rotate.z);
+
+		// Y * X の行（スカラーの実装の掛け算と同じ順番にする）
+		float sinYsinX = sinY * sinX;
+		float cosYsinX = cosY * sinX;
+
+		// さらに Z をかけた回転行列の行
+		__m128 rot0 = _mm_setr_ps(cosY * cosZ - sinYsinX * sinZ, cosY * sinZ + sinYsinX * cosZ, -sinY * cosX, 0.0f);
+		__m128 rot1 = _mm_setr_ps(-(cosX * sinZ), cosX * cosZ, sinX, 0.0f);
+		__m128 rot2 = _mm_setr_ps(sinY * cosZ + cosYsinX * sinZ, sinY * sinZ - cosYsinX * cosZ, cosY * cosX, 0.0f);
+
+		// スケールをかけて平行移動を入れる
+		Matrix4x4 result;
+		_mm_storeu_ps(result.m[0], _mm_mul_ps(_mm_set1_ps(scale.x), rot0));
+		_mm_storeu_ps(result.m[1], _mm_mul_ps(_mm_set1_ps(scale.y), rot1));
+		_mm_storeu_ps(result.m[2], _mm_mul_ps(_mm_set1_ps(scale.z), rot2));
+		_mm_storeu_ps(result.m[3], _mm_setr_ps(translate.x, translate.y, translate.z, 1.0f));
+		return result;
+	}
+}
+#endif
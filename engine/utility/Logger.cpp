@@ -1,11 +1,384 @@
 #include "Logger.h"
-#include <iostream>
 #include <Windows.h>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+namespace {
+
+	// 記録の時刻（steady_clockのナノ秒）
+	uint64_t GetTimeNanoseconds() {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	// 出力に使う名前
+	const char* const kLevelNames[] = { "DEBUG", "INFO ", "WARN ", "ERROR" };
+	const char* const kCategoryNames[] = { "General ", "Graphics", "Shader  ", "Texture ", "Audio   ", "Input   ", "Bench   " };
+	static_assert(std::size(kCategoryNames) == static_cast<size_t>(Logeer::Category::kCount), "category names must match Category");
+
+	// 一度だけインスタンスを作る
+	std::once_flag createFlag;
+
+	// スレッドが持つリング（スレッドが終わったら閉じた印を付け、ドレインのスレッドが空にしてから外す）
+	struct ThreadRingOwner {
+		std::shared_ptr<Logeer::LogRing> ring;
+
+		~ThreadRingOwner() {
+			if (ring != nullptr) {
+				ring->isClosed.store(true, std::memory_order_release);
+			}
+		}
+	};
+	thread_local ThreadRingOwner threadRingOwner;
+}
 
 namespace Logeer {
-    void Log(const std::string& message) {
-        // デバッグ出力
-        OutputDebugStringA(message.c_str());
-        OutputDebugStringA("er\n");
-    }
-}
\ No newline at end of file
+
+	void Log(const std::string& message) {
+		Log<Level::kInfo, Category::kGeneral>("{}", message);
+	}
+
+	bool FileLogSink::Open(const std::string& filePath) {
+		std::filesystem::path path(filePath);
+		if (path.has_parent_path()) {
+			std::error_code errorCode;
+			std::filesystem::create_directories(path.parent_path(), errorCode);
+		}
+		file.open(path, std::ios::binary | std::ios::trunc);
+		return file.is_open();
+	}
+
+	void FileLogSink::Write(Level, Category, const std::string& line) {
+		file.write(line.data(), static_cast<std::streamsize>(line.size()));
+	}
+
+	void FileLogSink::Flush() {
+		file.flush();
+	}
+
+	void StdoutLogSink::Write(Level, Category, const std::string& line) {
+		std::fwrite(line.data(), 1, line.size(), stdout);
+	}
+
+	void StdoutLogSink::Flush() {
+		std::fflush(stdout);
+	}
+
+	void DebuggerLogSink::Write(Level, Category, const std::string& line) {
+		// デバッグ出力
+		OutputDebugStringA(line.c_str());
+	}
+
+	LogRing::LogRing() {
+		storage = std::make_unique<uint64_t[]>(kSize / sizeof(uint64_t));
+		buffer = reinterpret_cast<uint8_t*>(storage.get());
+	}
+
+	uint8_t* LogRing::Reserve(uint32_t argumentSize, Level level, Category category,
+		FormatFunction formatFunction, const char* format) {
+		uint64_t recordSize = (sizeof(RecordHeader) + uint64_t(argumentSize) + 7) & ~uint64_t(7);
+
+		// 取り出したバイト数はacquireで読み、取り出された場所を書き換えてよいことを保証する
+		uint64_t write = writeOffset.load(std::memory_order_relaxed);
+		uint64_t read = readOffset.load(std::memory_order_acquire);
+		uint32_t position = static_cast<uint32_t>(write & (kSize - 1));
+
+		// 終わりまでに収まらなければ、残りを詰め物にして先頭に置く
+		uint64_t padding = recordSize > kSize - position ? kSize - position : 0;
+		if (write + padding + recordSize - read > kSize) {
+			droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		if (padding != 0) {
+			// ヘッダも入らない端は、読む側が印を見ずに飛ばす
+			if (padding >= sizeof(RecordHeader)) {
+				RecordHeader* filler = reinterpret_cast<RecordHeader*>(buffer + position);
+				filler->size = static_cast<uint32_t>(padding);
+				filler->formatFunction = nullptr;
+			}
+			write += padding;
+			position = 0;
+		}
+
+		RecordHeader* header = reinterpret_cast<RecordHeader*>(buffer + position);
+		header->size = static_cast<uint32_t>(recordSize);
+		header->level = level;
+		header->category = category;
+		header->reserved = 0;
+		header->time = GetTimeNanoseconds();
+		header->formatFunction = formatFunction;
+		header->format = format;
+		reservedOffset = write + recordSize;
+		return reinterpret_cast<uint8_t*>(header + 1);
+	}
+
+	void LogRing::Commit() {
+		// 書いた中身が読む側に見えるようにreleaseで進める
+		writeOffset.store(reservedOffset, std::memory_order_release);
+	}
+
+	const LogRing::RecordHeader* LogRing::Peek() {
+		uint64_t read = readOffset.load(std::memory_order_relaxed);
+		uint64_t write = writeOffset.load(std::memory_order_acquire);
+		uint64_t start = read;
+		const RecordHeader* header = nullptr;
+		while (read != write) {
+			uint32_t position = static_cast<uint32_t>(read & (kSize - 1));
+
+			// 詰め物を飛ばす
+			if (kSize - position < sizeof(RecordHeader)) {
+				read += kSize - position;
+				continue;
+			}
+			const RecordHeader* candidate = reinterpret_cast<const RecordHeader*>(buffer + position);
+			if (candidate->formatFunction == nullptr) {
+				read += candidate->size;
+				continue;
+			}
+			header = candidate;
+			break;
+		}
+		if (read != start) {
+			readOffset.store(read, std::memory_order_release);
+		}
+		return header;
+	}
+
+	void LogRing::Pop() {
+		uint64_t read = readOffset.load(std::memory_order_relaxed);
+		const RecordHeader* header = reinterpret_cast<const RecordHeader*>(buffer + (read & (kSize - 1)));
+		readOffset.store(read + header->size, std::memory_order_release);
+	}
+
+	bool LogRing::IsEmpty() const {
+		uint64_t read = readOffset.load(std::memory_order_acquire);
+		return writeOffset.load(std::memory_order_acquire) == read;
+	}
+
+	Logger* Logger::instance = nullptr;
+
+	Logger* Logger::GetInstance() {
+		std::call_once(createFlag, [] {
+			instance = new Logger();
+			instance->startTime = GetTimeNanoseconds();
+			});
+		return instance;
+	}
+
+	void Logger::Initialize() {
+		assert(!drainThread.joinable());
+		isStopping.store(false);
+		drainThread = std::thread(&Logger::DrainMain, this);
+	}
+
+	void Logger::Finalize() {
+		if (instance == nullptr) {
+			return;
+		}
+
+		// ドレインのスレッドは積まれているものが無くなってから止まる
+		if (instance->drainThread.joinable()) {
+			{
+				std::lock_guard<std::mutex> lock(instance->drainMutex);
+				instance->isStopping.store(true);
+			}
+			instance->drainCondition.notify_one();
+			instance->drainThread.join();
+		}
+		delete instance;
+		instance = nullptr;
+	}
+
+	void Logger::AddSink(std::unique_ptr<ILogSink> sink, uint32_t categoryMask) {
+		std::lock_guard<std::mutex> lock(sinkMutex);
+		sinks.push_back({ std::move(sink), categoryMask });
+	}
+
+	void Logger::Flush() {
+		if (!drainThread.joinable()) {
+			return;
+		}
+		std::unique_lock<std::mutex> lock(drainMutex);
+		uint64_t request = ++requestedFlushes;
+		drainCondition.notify_one();
+		flushCondition.wait(lock, [&] { return completedFlushes >= request; });
+	}
+
+	Logger::Statistics Logger::GetStatistics() const {
+		Statistics statistics = {};
+		statistics.writtenRecords = writtenRecords.load(std::memory_order_relaxed);
+		statistics.droppedRecords = retiredDroppedRecords.load(std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lock(ringMutex);
+		for (const std::shared_ptr<LogRing>& ring : rings) {
+			statistics.droppedRecords += ring->GetDroppedCount();
+		}
+		statistics.threadCount = static_cast<uint32_t>(rings.size());
+		return statistics;
+	}
+
+	LogRing* Logger::GetThreadRing() {
+		if (threadRingOwner.ring == nullptr) {
+			Logger* logger = GetInstance();
+			if (logger == nullptr) {
+				return nullptr;
+			}
+			threadRingOwner.ring = logger->RegisterThreadRing();
+		}
+		return threadRingOwner.ring.get();
+	}
+
+	std::shared_ptr<LogRing> Logger::RegisterThreadRing() {
+		std::shared_ptr<LogRing> ring = std::make_shared<LogRing>();
+		std::lock_guard<std::mutex> lock(ringMutex);
+		ring->threadIndex = nextThreadIndex++;
+		rings.push_back(ring);
+		ringGeneration.fetch_add(1, std::memory_order_release);
+		return ring;
+	}
+
+	void Logger::DrainMain() {
+		std::vector<std::shared_ptr<LogRing>> drainRings;
+		uint32_t generation = 0xFFFFFFFF;
+		std::string line;
+		while (true) {
+
+			// Flushの受付（これより前に積まれたものは、リングが空になるまで出力してから終わらせる）
+			uint64_t flushRequest = 0;
+			{
+				std::lock_guard<std::mutex> lock(drainMutex);
+				flushRequest = requestedFlushes;
+			}
+
+			// リングが増えたり減ったりしていたら写し直す
+			if (ringGeneration.load(std::memory_order_acquire) != generation) {
+				std::lock_guard<std::mutex> lock(ringMutex);
+				drainRings = rings;
+				generation = ringGeneration.load(std::memory_order_relaxed);
+			}
+
+			// 各リングの先頭で一番古いものから順に出力する（スレッドをまたいでも時刻順になる）
+			uint32_t drainedCount = 0;
+			bool isDrained = false;
+			{
+				std::lock_guard<std::mutex> lock(sinkMutex);
+				while (drainedCount < kMaxBatchRecords) {
+					LogRing* oldestRing = nullptr;
+					const LogRing::RecordHeader* oldest = nullptr;
+					for (const std::shared_ptr<LogRing>& ring : drainRings) {
+						const LogRing::RecordHeader* header = ring->Peek();
+						if (header != nullptr && (oldest == nullptr || header->time < oldest->time)) {
+							oldest = header;
+							oldestRing = ring.get();
+						}
+					}
+					if (oldest == nullptr) {
+						isDrained = true;
+						break;
+					}
+					WriteRecord(*oldest, oldestRing->threadIndex, line);
+					oldestRing->Pop();
+					++drainedCount;
+				}
+
+				// 捨てたものがあれば知らせる
+				for (const std::shared_ptr<LogRing>& ring : drainRings) {
+					uint64_t droppedCount = ring->GetDroppedCount();
+					if (droppedCount != ring->reportedDroppedCount) {
+						line = std::format("[Logger] {} records dropped on thread {} (ring full)\n",
+							droppedCount - ring->reportedDroppedCount, ring->threadIndex);
+						WriteAllSinks(Level::kWarning, Category::kGeneral, line);
+						ring->reportedDroppedCount = droppedCount;
+					}
+				}
+				if (isDrained && flushRequest != completedFlushes) {
+					for (SinkEntry& entry : sinks) {
+						entry.sink->Flush();
+					}
+				}
+			}
+			writtenRecords.fetch_add(drainedCount, std::memory_order_relaxed);
+
+			// 終わったスレッドのリングは、空になったら外す
+			bool hasClosedRing = false;
+			for (const std::shared_ptr<LogRing>& ring : drainRings) {
+				hasClosedRing |= ring->isClosed.load(std::memory_order_acquire) && ring->Peek() == nullptr;
+			}
+			if (hasClosedRing) {
+				std::lock_guard<std::mutex> lock(ringMutex);
+				std::erase_if(rings, [&](const std::shared_ptr<LogRing>& ring) {
+					if (!ring->isClosed.load(std::memory_order_acquire) || ring->Peek() != nullptr) {
+						return false;
+					}
+					retiredDroppedRecords.fetch_add(ring->GetDroppedCount(), std::memory_order_relaxed);
+					return true;
+					});
+				ringGeneration.fetch_add(1, std::memory_order_release);
+			}
+
+			std::unique_lock<std::mutex> lock(drainMutex);
+			if (isDrained && completedFlushes < flushRequest) {
+				completedFlushes = flushRequest;
+				flushCondition.notify_all();
+			}
+			if (drainedCount == 0) {
+				if (isStopping.load()) {
+					break;
+				}
+				drainCondition.wait_for(lock, std::chrono::milliseconds(kIdleWaitMilliseconds),
+					[&] { return isStopping.load() || requestedFlushes != flushRequest; });
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(sinkMutex);
+		for (SinkEntry& entry : sinks) {
+			entry.sink->Flush();
+		}
+	}
+
+	void Logger::WriteRecord(const LogRing::RecordHeader& header, uint32_t threadIndex, std::string& line) {
+		bool isFormatted = false;
+		for (SinkEntry& entry : sinks) {
+			if ((entry.categoryMask & GetCategoryBit(header.category)) == 0) {
+				continue;
+			}
+			if (!isFormatted) {
+				FormatLine(header, threadIndex, line);
+				isFormatted = true;
+			}
+			entry.sink->Write(header.level, header.category, line);
+		}
+	}
+
+	void Logger::FormatLine(const LogRing::RecordHeader& header, uint32_t threadIndex, std::string& line) const {
+		line.clear();
+		double seconds = static_cast<double>(static_cast<int64_t>(header.time - startTime)) / 1000000000.0;
+		std::format_to(std::back_inserter(line), "[{:10.4f}] [{}] [{}] [T{}] ", seconds,
+			kLevelNames[static_cast<uint32_t>(header.level)], kCategoryNames[static_cast<uint32_t>(header.category)], threadIndex);
+
+		// 書式と引数が合わなければ、書式をそのまま出す
+		size_t prefixSize = line.size();
+		try {
+			header.formatFunction(line, header.format, reinterpret_cast<const uint8_t*>(&header + 1));
+		} catch (const std::format_error& error) {
+			line.resize(prefixSize);
+			line += header.format;
+			line += " (format error : ";
+			line += error.what();
+			line += ")";
+		}
+
+		// 改行は一つに揃える
+		while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+			line.pop_back();
+		}
+		line += '\n';
+	}
+
+	void Logger::WriteAllSinks(Level level, Category category, const std::string& line) {
+		for (SinkEntry& entry : sinks) {
+			entry.sink->Write(level, category, line);
+		}
+	}
+}
@@ -1,6 +1,370 @@
 #pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
+// コンパイル時に捨てるログ
+// LOGEER_MIN_LEVELより重要度の低いもの（Levelの値）と、LOGEER_CATEGORY_MASKのビットが立っていない分類は、呼び出しごと消える
+// プロジェクトの設定か、Logger.hより前の#defineで変えられる
+#ifndef LOGEER_MIN_LEVEL
+#ifdef _DEBUG
+#define LOGEER_MIN_LEVEL 0
+#else
+#define LOGEER_MIN_LEVEL 1
+#endif
+#endif
+#ifndef LOGEER_CATEGORY_MASK
+#define LOGEER_CATEGORY_MASK 0xFFFFFFFFu
+#endif
+
+// ログ
+// 呼んだスレッドは自分のスレッド専用のリングに、書式（文字列リテラル）と引数をバイナリのまま積むだけで戻る
+// 書式化と出力先（ファイル、標準出力、デバッガ）への書き込みは、ドレインのスレッドがまとめて行う
 namespace Logeer {
+
+	// 重要度
+	enum class Level : uint8_t {
+		kDebug,
+		kInfo,
+		kWarning,
+		kError,
+	};
+
+	// 分類
+	enum class Category : uint8_t {
+		kGeneral,
+		kGraphics,
+		kShader,
+		kTexture,
+		kAudio,
+		kInput,
+		kBenchmark,
+		kCount,
+	};
+
+	// 全部の分類
+	const uint32_t kAllCategories = (1u << static_cast<uint32_t>(Category::kCount)) - 1;
+
+	// 分類のビット
+	constexpr uint32_t GetCategoryBit(Category category) {
+		return 1u << static_cast<uint32_t>(category);
+	}
+
+	// コンパイル時の設定で残るログか
+	constexpr bool IsEnabled(Level level, Category category) {
+		return static_cast<uint32_t>(level) >= LOGEER_MIN_LEVEL && (LOGEER_CATEGORY_MASK & GetCategoryBit(category)) != 0;
+	}
+
+	// 出力先（ドレインのスレッドだけから呼ばれる）
+	class ILogSink {
+	public:
+		virtual ~ILogSink() = default;
+
+		// 一行（改行込み）を書く
+		virtual void Write(Level level, Category category, const std::string& line) = 0;
+
+		// 溜めているものを書き出す
+		virtual void Flush() {}
+	};
+
+	// ファイルに書く出力先
+	class FileLogSink : public ILogSink {
+	public:
+
+		// 開く（フォルダが無ければ作る。失敗したらfalse）
+		bool Open(const std::string& filePath);
+
+		void Write(Level level, Category category, const std::string& line) override;
+		void Flush() override;
+
+	private:
+		std::ofstream file;
+	};
+
+	// 標準出力に書く出力先
+	class StdoutLogSink : public ILogSink {
+	public:
+		void Write(Level level, Category category, const std::string& line) override;
+		void Flush() override;
+	};
+
+	// デバッガの出力ウィンドウに書く出力先（OutputDebugStringA）
+	class DebuggerLogSink : public ILogSink {
+	public:
+		void Write(Level level, Category category, const std::string& line) override;
+	};
+
+	// 一つのスレッドが積み、ドレインのスレッドが取り出す可変長の記録のリング
+	// 書く側・読む側がそれぞれ一つだけなので、ロックを使わずバイト数のカウンタ二つで受け渡す
+	class LogRing {
+	public:
+
+		// リングのバイト数（2の累乗）
+		static const uint32_t kSize = 128 * 1024;
+
+		// 引数を読んで書式化する関数（書式と引数の型ごとに作られる）
+		using FormatFunction = void(*)(std::string& output, const char* format, const uint8_t* arguments);
+
+		// 記録の先頭（後ろに引数が続く）
+		struct RecordHeader {
+			uint32_t size;      // ヘッダ込みのバイト数（8の倍数）
+			Level level;
+			Category category;
+			uint16_t reserved;
+			uint64_t time;      // 積んだ時刻（steady_clockのナノ秒）
+			FormatFunction formatFunction; // nullptrなら折り返しの詰め物
+			const char* format;
+		};
+
+		LogRing();
+
+		// 引数のバイト数を渡して記録を一つ確保し、引数を書く先を返す（空きが無ければ捨てて数え、nullptr）【書く側】
+		uint8_t* Reserve(uint32_t argumentSize, Level level, Category category,
+			FormatFunction formatFunction, const char* format);
+
+		// Reserveした記録を渡す【書く側】
+		void Commit();
+
+		// 先頭の記録（無ければnullptr）【読む側】
+		const RecordHeader* Peek();
+
+		// 先頭の記録を捨てる【読む側】
+		void Pop();
+
+		// 空か、空きが無くて捨てた記録の数
+		bool IsEmpty() const;
+		uint64_t GetDroppedCount() const { return droppedCount.load(std::memory_order_relaxed); }
+
+		// スレッドの番号（出力に使う）と、スレッドが終わったか
+		uint32_t threadIndex = 0;
+		std::atomic<bool> isClosed{ false };
+
+		// 捨てたことを出力済みの数【読む側】
+		uint64_t reportedDroppedCount = 0;
+
+	private:
+
+		// 8バイト境界に揃えた領域
+		std::unique_ptr<uint64_t[]> storage;
+		uint8_t* buffer = nullptr;
+
+		// 積んだバイト数と取り出したバイト数（それぞれ片方のスレッドしか書かない）
+		// 書く側と読む側が同じキャッシュラインを取り合わないように離しておく
+		alignas(64) std::atomic<uint64_t> writeOffset{ 0 };
+		uint64_t reservedOffset = 0; // Reserveした記録の終わり【書く側】
+		std::atomic<uint64_t> droppedCount{ 0 };
+		alignas(64) std::atomic<uint64_t> readOffset{ 0 };
+	};
+
+	// ログのリングを集めて出力するドレインのスレッド
+	class Logger {
+	public:
+
+		// ドレインのスレッドが何もないときに待つ時間
+		static const uint32_t kIdleWaitMilliseconds = 2;
+
+		// 一回にまとめて出力する記録の数（Flushやリングの登録を待たせすぎない）
+		static const uint32_t kMaxBatchRecords = 4096;
+
+		// 使われ方
+		struct Statistics {
+			uint64_t writtenRecords;  // 出力した記録の数
+			uint64_t droppedRecords;  // リングがいっぱいで捨てた記録の数
+			uint32_t threadCount;     // リングを持っているスレッドの数
+		};
+
+		// シングルトンインスタンスの取得（どのスレッドから最初に呼んでもよい。Finalizeの後はnullptr）
+		static Logger* GetInstance();
+
+		// 初期化（ドレインのスレッドを始める。これより前に積んだログもここから出力される）
+		void Initialize();
+
+		// 終了（積まれているログを全部出力してからスレッドを止める）
+		static void Finalize();
+
+		// 出力先を足す（categoryMaskのビットが立っている分類だけを受け取る）
+		void AddSink(std::unique_ptr<ILogSink> sink, uint32_t categoryMask = kAllCategories);
+
+		// 呼ぶ前に積んだログが全部出力されるまで待つ
+		void Flush();
+
+		// ドレインのスレッドを起こす（エラーをすぐに出したいとき）
+		void Wake() { drainCondition.notify_one(); }
+
+		Statistics GetStatistics() const;
+
+		// 呼んだスレッドのリング（初めて呼んだときに作って登録する。Finalizeの後はnullptr）
+		static LogRing* GetThreadRing();
+
+	private:
+
+		// 出力先と受け取る分類
+		struct SinkEntry {
+			std::unique_ptr<ILogSink> sink;
+			uint32_t categoryMask;
+		};
+
+		static Logger* instance;
+
+		Logger() = default;
+		~Logger() = default;
+		Logger(Logger&) = delete;
+		Logger& operator=(const Logger&) = delete;
+
+		// ドレインのスレッド
+		std::thread drainThread;
+		std::atomic<bool> isStopping{ false };
+
+		// 出力先（ドレインのスレッドと足す側で守る）
+		std::mutex sinkMutex;
+		std::vector<SinkEntry> sinks;
+
+		// スレッドごとのリング（登録と取り出しで守る。ドレインは変わったときだけ写す）
+		mutable std::mutex ringMutex;
+		std::vector<std::shared_ptr<LogRing>> rings;
+		std::atomic<uint32_t> ringGeneration{ 0 };
+		uint32_t nextThreadIndex = 0;
+
+		// ドレインのスレッドを起こす・Flushを待つ
+		std::mutex drainMutex;
+		std::condition_variable drainCondition;
+		std::condition_variable flushCondition;
+		uint64_t requestedFlushes = 0;
+		uint64_t completedFlushes = 0;
+
+		// 統計
+		std::atomic<uint64_t> writtenRecords{ 0 };
+		std::atomic<uint64_t> retiredDroppedRecords{ 0 }; // 外したリングで捨てていた数
+
+		// 時刻の基準（作った時刻）
+		uint64_t startTime = 0;
+
+		// リングを登録する
+		std::shared_ptr<LogRing> RegisterThreadRing();
+
+		// ドレインのスレッドの処理
+		void DrainMain();
+
+		// 記録を受け取る出力先に書く（どの出力先も受け取らなければ書式化もしない）
+		void WriteRecord(const LogRing::RecordHeader& header, uint32_t threadIndex, std::string& line);
+
+		// 記録を一行にする
+		void FormatLine(const LogRing::RecordHeader& header, uint32_t threadIndex, std::string& line) const;
+
+		// 出力先全部に一行書く
+		void WriteAllSinks(Level level, Category category, const std::string& line);
+	};
+
+	// 引数として積める型（数値と文字列）
+	template <typename T>
+	constexpr bool kIsLogArgument = std::is_arithmetic_v<T> || std::is_convertible_v<const T&, std::string_view>;
+
+	// リングから読んだ引数の型（数値はそのまま、文字列はリングの中を指すstring_view）
+	template <typename T>
+	using StoredLogArgument = std::conditional_t<std::is_arithmetic_v<T>, T, std::string_view>;
+
+	// 引数を積むのに要るバイト数
+	template <typename T>
+	uint32_t GetLogArgumentSize(const T& value) {
+		if constexpr (std::is_arithmetic_v<T>) {
+			return sizeof(T);
+		} else {
+			return static_cast<uint32_t>(sizeof(uint32_t) + std::string_view(value).size());
+		}
+	}
+
+	// 引数を書き、次に書く位置を返す（文字列は長さと中身）
+	template <typename T>
+	uint8_t* WriteLogArgument(uint8_t* output, const T& value) {
+		if constexpr (std::is_arithmetic_v<T>) {
+			std::memcpy(output, &value, sizeof(T));
+			return output + sizeof(T);
+		} else {
+			std::string_view text(value);
+			uint32_t length = static_cast<uint32_t>(text.size());
+			std::memcpy(output, &length, sizeof(length));
+			std::memcpy(output + sizeof(length), text.data(), length);
+			return output + sizeof(length) + length;
+		}
+	}
+
+	// 引数を読み、読む位置を進める
+	template <typename T>
+	StoredLogArgument<T> ReadLogArgument(const uint8_t*& input) {
+		if constexpr (std::is_arithmetic_v<T>) {
+			T value;
+			std::memcpy(&value, input, sizeof(T));
+			input += sizeof(T);
+			return value;
+		} else {
+			uint32_t length;
+			std::memcpy(&length, input, sizeof(length));
+			std::string_view text(reinterpret_cast<const char*>(input + sizeof(length)), length);
+			input += sizeof(length) + length;
+			return text;
+		}
+	}
+
+	// 積んだ引数を読んで書式化する（ドレインのスレッドで呼ばれる）
+	template <typename... Args>
+	void FormatLogArguments(std::string& output, const char* format, const uint8_t* arguments) {
+		// 波括弧の初期化は左から順に評価されるので、積んだ順に読める
+		[[maybe_unused]] const uint8_t* input = arguments;
+		std::tuple<StoredLogArgument<Args>...> values{ ReadLogArgument<Args>(input)... };
+		std::apply([&](const auto&... value) {
+			std::vformat_to(std::back_inserter(output), format, std::make_format_args(value...));
+			}, values);
+	}
+
+	// 今までどおりの文字列のログ（Info、General。末尾の改行は出力先で揃える）
 	void Log(const std::string& message);
-}
\ No newline at end of file
+
+	// 書式付きのログ（formatはstd::formatの書式で、文字列リテラルなど終了まで残るもの）
+	// 呼ぶときは引数の評価も消せるLOGEER_LOGを使う
+	template <Level level, Category category, typename... Args>
+	void Log(const char* format, const Args&... args) {
+		if constexpr (IsEnabled(level, category)) {
+			static_assert((kIsLogArgument<Args> && ...), "log arguments must be numbers or strings");
+			uint32_t argumentSize = (0u + ... + GetLogArgumentSize(args));
+			LogRing* ring = Logger::GetThreadRing();
+			if (ring == nullptr) {
+				return;
+			}
+			uint8_t* output = ring->Reserve(argumentSize, level, category, &FormatLogArguments<Args...>, format);
+			if (output == nullptr) {
+				return;
+			}
+			((output = WriteLogArgument(output, args)), ...);
+			ring->Commit();
+
+			// エラーは待たずに出力させる
+			if constexpr (level == Level::kError) {
+				if (Logger* logger = Logger::GetInstance()) {
+					logger->Wake();
+				}
+			}
+		}
+	}
+}
+
+// 書式付きのログを、引数の評価ごと消せる形で出す
+// Log<level, category>は中身を消せても、引数（ConvertStringなど）は呼ぶ側で評価されてしまうので、呼び出しはこちらを使う
+// 例 : LOGEER_LOG(Logeer::Level::kInfo, Logeer::Category::kTexture, "Texture {} : {:.3f} ms", filePath, milliseconds);
+#define LOGEER_LOG(level, category, ...) \
+	do { \
+		if constexpr (::Logeer::IsEnabled(level, category)) { \
+			::Logeer::Log<level, category>(__VA_ARGS__); \
+		} \
+	} while (0)
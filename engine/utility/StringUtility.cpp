@@ -1,5 +1,7 @@
 #include "StringUtility.h"
-#include <Windows.h>
+
+// WindowsのwstringはUTF-16なので、char16_tとしてそのまま書き込む
+static_assert(sizeof(wchar_t) == sizeof(char16_t), "wstring must be UTF-16");
 
 std::wstring StringUtility::ConvertString(const std::string& str)
 {
@@ -7,12 +9,11 @@ std::wstring StringUtility::ConvertString(const std::string& str)
 		return std::wstring();
 	}
 
-	auto sizeNeeded = MultiByteToWideChar(CP_UTF8, 0, reinterpret_cast<const char*>(&str[0]), static_cast<int>(str.size()), NULL, 0);
-	if (sizeNeeded == 0) {
-		return std::wstring();
-	}
-	std::wstring result(sizeNeeded, 0);
-	MultiByteToWideChar(CP_UTF8, 0, reinterpret_cast<const char*>(&str[0]), static_cast<int>(str.size()), &result[0], sizeNeeded);
+	// 上限の長さで一度だけ確保し、変換した長さに縮める
+	std::wstring result(UtfConverter::GetMaxUtf16Length(str.size()), 0);
+	UtfConverter::Result converted = UtfConverter::Utf8ToUtf16(str.data(), str.size(),
+		reinterpret_cast<char16_t*>(result.data()), result.size());
+	result.resize(converted.written);
 	return result;
 }
 
@@ -22,11 +23,30 @@ std::string StringUtility::ConvertString(const std::wstring& str)
 		return std::string();
 	}
 
-	auto sizeNeeded = WideCharToMultiByte(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), NULL, 0, NULL, NULL);
-	if (sizeNeeded == 0) {
-		return std::string();
-	}
-	std::string result(sizeNeeded, 0);
-	WideCharToMultiByte(CP_UTF8, 0, str.data(), static_cast<int>(str.size()), result.data(), sizeNeeded, NULL, NULL);
+	std::string result(UtfConverter::GetMaxUtf8Length(str.size()), 0);
+	UtfConverter::Result converted = UtfConverter::Utf16ToUtf8(reinterpret_cast<const char16_t*>(str.data()), str.size(),
+		result.data(), result.size());
+	result.resize(converted.written);
 	return result;
 }
+
+const wchar_t* StringUtility::ConvertString(std::string_view str, WideStringBuffer& buffer)
+{
+	size_t capacity = UtfConverter::GetMaxUtf16Length(str.size());
+	wchar_t* data = buffer.Prepare(capacity);
+	UtfConverter::Result converted = UtfConverter::Utf8ToUtf16(str.data(), str.size(),
+		reinterpret_cast<char16_t*>(data), capacity);
+	buffer.SetSize(converted.written);
+	return buffer.c_str();
+}
+
+std::filesystem::path StringUtility::ConvertToPath(std::string_view str)
+{
+	return std::filesystem::path(std::u8string(str.begin(), str.end()));
+}
+
+std::string StringUtility::ConvertPathToString(const std::filesystem::path& path)
+{
+	std::u8string utf8 = path.generic_u8string();
+	return std::string(utf8.begin(), utf8.end());
+}
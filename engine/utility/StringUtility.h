@@ -1,11 +1,27 @@
 #pragma once
+#include <filesystem>
 #include <string>
+#include <string_view>
+#include "UtfConverter.h"
 
 namespace StringUtility {
+
+	// 確保せずに変換を受け取る置き場所（MAX_PATHまでは確保しない）
+	using WideStringBuffer = SmallStringBuffer<wchar_t, 260>;
+
 	/// ログを変換する関数
 	// stringをwstringに変換
 	std::wstring ConvertString(const std::string& str);
 
 	// wstringをstringに変換
 	std::string ConvertString(const std::wstring& str);
-}
\ No newline at end of file
+
+	// stringをbufferに変換して、終端の0付きの文字列を返す（パスをWindowsのAPIに渡すとき用）
+	const wchar_t* ConvertString(std::string_view str, WideStringBuffer& buffer);
+
+	// UTF-8のstringをパスにする（path(std::string)はWindowsではANSIのコードページとして読まれる）
+	std::filesystem::path ConvertToPath(std::string_view str);
+
+	// パスをUTF-8のstringにする（区切りは/）
+	std::string ConvertPathToString(const std::filesystem::path& path);
+}
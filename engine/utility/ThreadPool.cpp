@@ -0,0 +1,136 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+void ThreadPool::Initialize(uint32_t threadCount,
+	std::function<void()> onThreadBegin,
+	std::function<void()> onThreadEnd) {
+
+	assert(threadCount > 0);
+	assert(workers.empty());
+
+	// 引数をメンバ変数にセット
+	this->onThreadBegin = std::move(onThreadBegin);
+	this->onThreadEnd = std::move(onThreadEnd);
+	isStopping = false;
+
+	// ワーカースレッドを起動
+	workers.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; ++i) {
+		workers.emplace_back(&ThreadPool::WorkerMain, this);
+	}
+}
+
+void ThreadPool::Finalize() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+	taskCondition.notify_all();
+
+	// 全部のワーカーが終わるのを待つ
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+	workers.clear();
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+	assert(!workers.empty());
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	taskCondition.notify_one();
+}
+
+void ThreadPool::WaitIdle() {
+	std::unique_lock<std::mutex> lock(mutex);
+	idleCondition.wait(lock, [this]() { return tasks.empty() && activeTaskCount == 0; });
+}
+
+void ThreadPool::ParallelFor(uint32_t count, uint32_t chunkSize,
+	const std::function<void(uint32_t begin, uint32_t end)>& function) {
+
+	assert(chunkSize > 0);
+	uint32_t chunkCount = (count + chunkSize - 1) / chunkSize;
+	if (chunkCount == 0) {
+		return;
+	}
+
+	// 次に処理する塊の番号（取り合いで進める）
+	std::atomic<uint32_t> nextChunk = 0;
+	auto processChunks = [&]() {
+		for (uint32_t chunk = nextChunk.fetch_add(1); chunk < chunkCount; chunk = nextChunk.fetch_add(1)) {
+			uint32_t begin = chunk * chunkSize;
+			uint32_t end = (std::min)(begin + chunkSize, count);
+			function(begin, end);
+		}
+	};
+
+	// 手伝うワーカーの数（呼び出したスレッドも処理するので塊の数-1まで）
+	uint32_t helperCount = (std::min)(GetThreadCount(), chunkCount - 1);
+
+	// 手伝いが全部終わったかどうか（ローカル変数を参照しているので終わるまで戻れない）
+	std::mutex helperMutex;
+	std::condition_variable helperCondition;
+	uint32_t runningHelperCount = helperCount;
+	for (uint32_t i = 0; i < helperCount; ++i) {
+		Submit([&]() {
+			processChunks();
+			std::lock_guard<std::mutex> lock(helperMutex);
+			if (--runningHelperCount == 0) {
+				helperCondition.notify_one();
+			}
+		});
+	}
+
+	// ワーカーが他の仕事で埋まっていても、呼び出したスレッドだけで最後まで進められる
+	processChunks();
+
+	std::unique_lock<std::mutex> lock(helperMutex);
+	helperCondition.wait(lock, [&]() { return runningHelperCount == 0; });
+}
+
+uint32_t ThreadPool::GetDefaultThreadCount() {
+	uint32_t hardwareThreadCount = std::thread::hardware_concurrency();
+	return hardwareThreadCount > 1 ? hardwareThreadCount - 1 : 1;
+}
+
+void ThreadPool::WorkerMain() {
+	if (onThreadBegin) {
+		onThreadBegin();
+	}
+
+	while (true) {
+		std::function<void()> task;
+		{
+			// 仕事が積まれるか、止めるまで待つ
+			std::unique_lock<std::mutex> lock(mutex);
+			taskCondition.wait(lock, [this]() { return isStopping || !tasks.empty(); });
+
+			// 止めるときも積まれている仕事は最後まで処理する
+			if (tasks.empty()) {
+				break;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+			activeTaskCount++;
+		}
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			activeTaskCount--;
+			if (tasks.empty() && activeTaskCount == 0) {
+				idleCondition.notify_all();
+			}
+		}
+	}
+
+	if (onThreadEnd) {
+		onThreadEnd();
+	}
+}
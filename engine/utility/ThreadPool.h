@@ -0,0 +1,70 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 決まった数のワーカースレッドで仕事を順に処理するクラス
+class ThreadPool {
+public:
+
+	~ThreadPool() { Finalize(); }
+
+	// 初期化（ワーカーの開始時・終了時に呼ぶ処理を渡せる。COMの初期化など）
+	void Initialize(uint32_t threadCount,
+		std::function<void()> onThreadBegin = nullptr,
+		std::function<void()> onThreadEnd = nullptr);
+
+	// 終了（積まれている仕事を終わらせてからスレッドを止める）
+	void Finalize();
+
+	// 仕事を積む
+	void Submit(std::function<void()> task);
+
+	// 積んだ仕事が全部終わるまで待つ
+	void WaitIdle();
+
+	// [0, count)をchunkSizeずつに分けて、ワーカーと呼び出したスレッドで並行に処理する
+	// 全部終わるまで戻らない（他に積まれている仕事は待たない）
+	void ParallelFor(uint32_t count, uint32_t chunkSize,
+		const std::function<void(uint32_t begin, uint32_t end)>& function);
+
+	// ワーカースレッドの数
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers.size()); }
+
+	// 論理コア数からメインスレッドの分を引いた数（最低1）
+	static uint32_t GetDefaultThreadCount();
+
+private:
+
+	// ワーカースレッドの処理
+	void WorkerMain();
+
+	// ワーカースレッド
+	std::vector<std::thread> workers;
+
+	// 積まれた仕事
+	std::deque<std::function<void()>> tasks;
+
+	// 仕事のキューを守る
+	std::mutex mutex;
+
+	// 仕事が積まれたときの通知
+	std::condition_variable taskCondition;
+
+	// 仕事が全部終わったときの通知
+	std::condition_variable idleCondition;
+
+	// 処理中の仕事の数
+	uint32_t activeTaskCount = 0;
+
+	// 止めるところか
+	bool isStopping = false;
+
+	// ワーカーの開始時・終了時に呼ぶ処理
+	std::function<void()> onThreadBegin;
+	std::function<void()> onThreadEnd;
+};
@@ -0,0 +1,223 @@
+#include "UtfConverter.h"
+
+// x64ならSSE2は必ず使えるので既定で有効にする
+#ifndef UTF_USE_SIMD
+#if defined(_M_X64) || defined(__SSE2__)
+#define UTF_USE_SIMD 1
+#else
+#define UTF_USE_SIMD 0
+#endif
+#endif
+
+#if UTF_USE_SIMD
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+	// 続きのバイト（10xxxxxx）か
+	bool IsContinuation(uint8_t byte) {
+		return (byte & 0xC0) == 0x80;
+	}
+
+	// UTF-8の1文字を読む（不正ならU+FFFDにして、最長の正しい部分だけ進める）
+	// 戻り値は読んだバイト数
+	size_t DecodeUtf8(const uint8_t* input, size_t available, char32_t& codePoint, bool& isValid) {
+		uint8_t lead = input[0];
+		isValid = false;
+		if (lead < 0x80) {
+			codePoint = lead;
+			isValid = true;
+			return 1;
+		}
+
+		// 先頭のバイトから、続くバイト数と2バイト目の範囲を決める
+		// （2バイト目の範囲で長すぎる表現、サロゲート、U+10FFFFを超えるものを弾く）
+		size_t followCount = 0;
+		uint8_t secondMin = 0x80;
+		uint8_t secondMax = 0xBF;
+		if (lead >= 0xC2 && lead <= 0xDF) {
+			followCount = 1;
+			codePoint = lead & 0x1F;
+		} else if (lead >= 0xE0 && lead <= 0xEF) {
+			followCount = 2;
+			secondMin = lead == 0xE0 ? 0xA0 : 0x80;
+			secondMax = lead == 0xED ? 0x9F : 0xBF;
+			codePoint = lead & 0x0F;
+		} else if (lead >= 0xF0 && lead <= 0xF4) {
+			followCount = 3;
+			secondMin = lead == 0xF0 ? 0x90 : 0x80;
+			secondMax = lead == 0xF4 ? 0x8F : 0xBF;
+			codePoint = lead & 0x07;
+		} else {
+			codePoint = UtfConverter::kReplacementCharacter;
+			return 1;
+		}
+
+		for (size_t i = 1; i <= followCount; ++i) {
+			if (i >= available) {
+				codePoint = UtfConverter::kReplacementCharacter;
+				return i;
+			}
+			uint8_t byte = input[i];
+			bool isFollowing = i == 1 ? (byte >= secondMin && byte <= secondMax) : IsContinuation(byte);
+			if (!isFollowing) {
+				codePoint = UtfConverter::kReplacementCharacter;
+				return i;
+			}
+			codePoint = (codePoint << 6) | (byte & 0x3F);
+		}
+		isValid = true;
+		return followCount + 1;
+	}
+
+	// UTF-8にしたときのバイト数
+	size_t GetUtf8Size(char32_t codePoint) {
+		return codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : codePoint < 0x10000 ? 3 : 4;
+	}
+}
+
+UtfConverter::Result UtfConverter::Utf8ToUtf16(const char* input, size_t length, char16_t* output, size_t capacity) {
+	const uint8_t* in = reinterpret_cast<const uint8_t*>(input);
+	const uint8_t* inEnd = in + length;
+	char16_t* out = output;
+	char16_t* outEnd = output + capacity;
+	Result result = {};
+
+	bool isFull = false;
+	while (in < inEnd && !isFull) {
+#if UTF_USE_SIMD
+		// ASCIIの16バイトは、上位に0を挟んで16文字に広げる
+		const __m128i zero = _mm_setzero_si128();
+		while (inEnd - in >= 16 && outEnd - out >= 16) {
+			__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+			if (_mm_movemask_epi8(bytes) != 0) {
+				break;
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(bytes, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(bytes, zero));
+			in += 16;
+			out += 16;
+		}
+#endif
+
+		// 残りのASCIIはそのまま
+		while (in < inEnd && *in < 0x80) {
+			if (out == outEnd) {
+				isFull = true;
+				break;
+			}
+			*out++ = *in++;
+		}
+
+		// ASCII以外が続く間は1文字ずつ変換する（まとめて変換するのはASCIIに戻ってから試す）
+		while (!isFull && in < inEnd && *in >= 0x80) {
+			char32_t codePoint = 0;
+			bool isValid = false;
+			size_t readSize = DecodeUtf8(in, size_t(inEnd - in), codePoint, isValid);
+			size_t writeSize = codePoint < 0x10000 ? 1 : 2;
+			if (size_t(outEnd - out) < writeSize) {
+				isFull = true;
+				break;
+			}
+			if (writeSize == 1) {
+				*out++ = static_cast<char16_t>(codePoint);
+			} else {
+				// サロゲートペアにする
+				codePoint -= 0x10000;
+				*out++ = static_cast<char16_t>(0xD800 + (codePoint >> 10));
+				*out++ = static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+			}
+			result.replaced += isValid ? 0 : 1;
+			in += readSize;
+		}
+	}
+
+	result.read = size_t(in - reinterpret_cast<const uint8_t*>(input));
+	result.written = size_t(out - output);
+	result.isComplete = in == inEnd;
+	return result;
+}
+
+UtfConverter::Result UtfConverter::Utf16ToUtf8(const char16_t* input, size_t length, char* output, size_t capacity) {
+	const char16_t* in = input;
+	const char16_t* inEnd = input + length;
+	uint8_t* out = reinterpret_cast<uint8_t*>(output);
+	uint8_t* outEnd = out + capacity;
+	Result result = {};
+
+	bool isFull = false;
+	while (in < inEnd && !isFull) {
+#if UTF_USE_SIMD
+		// ASCIIの16文字は、上位の0を落として16バイトに詰める
+		const __m128i asciiMask = _mm_set1_epi16(static_cast<short>(0xFF80));
+		const __m128i zero = _mm_setzero_si128();
+		while (inEnd - in >= 16 && outEnd - out >= 16) {
+			__m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+			__m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8));
+			__m128i nonAscii = _mm_and_si128(_mm_or_si128(low, high), asciiMask);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, zero)) != 0xFFFF) {
+				break;
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(low, high));
+			in += 16;
+			out += 16;
+		}
+#endif
+
+		// 残りのASCIIはそのまま
+		while (in < inEnd && *in < 0x80) {
+			if (out == outEnd) {
+				isFull = true;
+				break;
+			}
+			*out++ = static_cast<uint8_t>(*in++);
+		}
+
+		// ASCII以外が続く間は1文字ずつ変換する
+		while (!isFull && in < inEnd && *in >= 0x80) {
+
+			// サロゲートペアは対になっているときだけ1文字にする
+			char16_t unit = *in;
+			char32_t codePoint = unit;
+			size_t readSize = 1;
+			bool isValid = true;
+			if (unit >= 0xD800 && unit <= 0xDFFF) {
+				if (unit <= 0xDBFF && inEnd - in >= 2 && in[1] >= 0xDC00 && in[1] <= 0xDFFF) {
+					codePoint = 0x10000 + ((char32_t(unit) - 0xD800) << 10) + (char32_t(in[1]) - 0xDC00);
+					readSize = 2;
+				} else {
+					codePoint = kReplacementCharacter;
+					isValid = false;
+				}
+			}
+
+			size_t writeSize = GetUtf8Size(codePoint);
+			if (size_t(outEnd - out) < writeSize) {
+				isFull = true;
+				break;
+			}
+			if (writeSize == 2) {
+				out[0] = static_cast<uint8_t>(0xC0 | (codePoint >> 6));
+				out[1] = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+			} else if (writeSize == 3) {
+				out[0] = static_cast<uint8_t>(0xE0 | (codePoint >> 12));
+				out[1] = static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+				out[2] = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+			} else {
+				out[0] = static_cast<uint8_t>(0xF0 | (codePoint >> 18));
+				out[1] = static_cast<uint8_t>(0x80 | ((codePoint >> 12) & 0x3F));
+				out[2] = static_cast<uint8_t>(0x80 | ((codePoint >> 6) & 0x3F));
+				out[3] = static_cast<uint8_t>(0x80 | (codePoint & 0x3F));
+			}
+			result.replaced += isValid ? 0 : 1;
+			out += writeSize;
+			in += readSize;
+		}
+	}
+
+	result.read = size_t(in - input);
+	result.written = size_t(out - reinterpret_cast<uint8_t*>(output));
+	result.isComplete = in == inEnd;
+	return result;
+}
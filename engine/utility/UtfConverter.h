@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// UTF-8とUTF-16を相互に変換するクラス
+// ASCIIが続く間はSSE2で16文字ずつまとめて変換し、それ以外は1文字ずつ変換する
+// 不正な並び（途中で切れた並び、長すぎる表現、サロゲートの符号化、対になっていないサロゲート）は
+// U+FFFDに置き換える（UTF-8はUnicodeの推奨どおり、最長の正しい部分ごとに一つ）
+// Windowsに依存しないので単体で確認できる
+class UtfConverter {
+public:
+
+	// 置き換える文字
+	static const char32_t kReplacementCharacter = 0xFFFD;
+
+	// 変換結果
+	struct Result {
+		size_t read;         // 読んだ要素数
+		size_t written;      // 書いた要素数
+		size_t replaced;     // U+FFFDに置き換えた数
+		bool isComplete;     // 最後まで変換できたか（falseなら出力先が足りず、文字の区切りで止めている）
+	};
+
+	// 変換後の長さの上限（この長さの出力先があれば必ず最後まで変換できる）
+	static size_t GetMaxUtf16Length(size_t utf8Length) { return utf8Length; }
+	static size_t GetMaxUtf8Length(size_t utf16Length) { return utf16Length * 3; }
+
+	// UTF-8をUTF-16にする（outputにcapacity要素まで書く。終端の0は書かない）
+	static Result Utf8ToUtf16(const char* input, size_t length, char16_t* output, size_t capacity);
+
+	// UTF-16をUTF-8にする（outputにcapacity要素まで書く。終端の0は書かない）
+	static Result Utf16ToUtf8(const char16_t* input, size_t length, char* output, size_t capacity);
+};
+
+// 短いうちは確保せずに持つ、終端の0付きの文字列の置き場所（変換の出力先に使う）
+// kInlineCapacityを超えたときだけヒープに確保し、以降は使い回す
+template <typename Char, size_t kInlineCapacity>
+class SmallStringBuffer {
+public:
+	SmallStringBuffer() { inlineData[0] = 0; }
+	SmallStringBuffer(const SmallStringBuffer&) = delete;
+	SmallStringBuffer& operator=(const SmallStringBuffer&) = delete;
+
+	// size要素を書ける場所を用意して先頭を返す（中身は残らない）
+	Char* Prepare(size_t size) {
+		if (size > kInlineCapacity && size > heapCapacity) {
+			heapData = std::make_unique<Char[]>(size + 1);
+			heapCapacity = size;
+		}
+		length = 0;
+		Char* data = GetData();
+		data[0] = 0;
+		return data;
+	}
+
+	// 書いた長さを決めて終端の0を置く
+	void SetSize(size_t size) {
+		length = size;
+		GetData()[size] = 0;
+	}
+
+	Char* GetData() { return heapCapacity > 0 ? heapData.get() : inlineData; }
+	const Char* GetData() const { return heapCapacity > 0 ? heapData.get() : inlineData; }
+	const Char* c_str() const { return GetData(); }
+	size_t GetSize() const { return length; }
+
+	// ヒープを使っているか
+	bool IsOnHeap() const { return heapCapacity > 0; }
+
+private:
+	Char inlineData[kInlineCapacity + 1];
+	std::unique_ptr<Char[]> heapData;
+	size_t heapCapacity = 0;
+	size_t length = 0;
+};
@@ -12,7 +12,6 @@ extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hwnd, UINT msg
 #include "externals/DirectXTex/d3dx12.h"
 
 #include <wrl.h>
-#include <xaudio2.h>
 #include "Input.h"
 #include "WinApp.h"
 #include "DirectXCommon.h"
@@ -21,10 +20,19 @@ extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hwnd, UINT msg
 #include "Sprite.h"
 #include "Mymath.h"
 #include "TextureManager.h"
+#include "ViewCulling.h"
+#include "ObjLoader.h"
+#include "Model.h"
+#include "TransformSystem.h"
+#include "Audio.h"
+#include "SoundBank.h"
+#include "Logger.h"
 #include <iostream>
+#include <atomic>
+#include <filesystem>
+#include <cstring>
 
 #pragma comment(lib,"dxcompiler.lib")
-#pragma comment(lib, "xaudio2.lib")
 
 using namespace Math;
 
@@ -34,36 +42,6 @@ struct DirectionalLight {
 	float intensity;
 };
 
-// チャンクヘッダの構造体
-struct ChunkHeader {
-	char id[4];
-	int32_t size;
-};
-
-
-// RIFFチャンクの構造体
-struct RiffHeder {
-	ChunkHeader chunk; // チャンクヘッダ
-	char type[4]; // フォーマット（RIFFの場合は"RIFF"）
-};
-
-// FMTチャンクの構造体
-struct FomatChunk {
-	ChunkHeader chunk;
-	WAVEFORMATEX fmt; // WAVEフォーマット
-};
-
-// 音声データ
-struct SoundData {
-	WAVEFORMATEX wfex; // WAVEフォーマット
-
-	// バッファの先頭アドレス
-	BYTE* pBuffer;
-
-	// バッファのサイズ
-	unsigned int bufferSize;
-};
-
 // DepthStencilTexTure
 Microsoft::WRL::ComPtr <ID3D12Resource> CreateDepthStencilTexturResource(const Microsoft::WRL::ComPtr <ID3D12Device>& device, int32_t width, int32_t height) {
 	
@@ -101,233 +79,47 @@ Microsoft::WRL::ComPtr <ID3D12Resource> CreateDepthStencilTexturResource(const M
 	return resource;
 }
 
-struct MaterialData {
-	std::string textureFilePath; // テクスチャファイルのパス
-	Vector4 color = { 1.0f,1.0f,1.0f,1.0f }; // 拡散反射色
-};
-/*
-// マテリアルデータを読み込む関数
-MaterialData LoadMaterialTemplateFile(const std::string& directoryPath, const std::string& filename) {
-	// マテリアルファイルを読み込む
-	MaterialData materialData;
-
-	// ファイルから一行格納する
-	std::string line;
-
-	// ファイルを開く
-	std::ifstream file(directoryPath + "/" + filename);
-
-	// 開けないと止める
-	assert(file.is_open());
-
-	while (std::getline(file, line)) {
-		std::istringstream s(line);
-		std::string identifier;
-		s >> identifier;
-
-		// identifierに応じた処理
-		if (identifier == "map_Kd") {
-			std::string textureFilename;
-			// テクスチャファイルのパスを取得
-			s >> textureFilename;
-			// 連結して、ファイルパスにする
-			materialData.textureFilePath = directoryPath + "/" + textureFilename;
-		} else if (identifier == "Kd") {
-			// 拡散反射色をcolorに設定、アルファ値は1.0固定
-			s >> materialData.color.x >> materialData.color.y >> materialData.color.z;
-			materialData.color.w = 1.0f;
+// 立方体を格子状に並べ、オブジェクトごとにマテリアルを交互に使うObjテキストを作る（マテリアルはmultiMaterial.mtl）
+std::string MakeCubeGridObjText(uint32_t cubeCount) {
+	// 角（x,y,zをビットで表す）と面（外から見て反時計回り）
+	static const uint32_t kFaces[6][4] = {
+		{ 1,3,7,5 }, { 0,4,6,2 }, { 2,6,7,3 }, { 0,1,5,4 }, { 4,5,7,6 }, { 0,2,3,1 } };
+	static const char* const kMaterialNames[2] = { "Material", "Material.001" };
+
+	std::string text = "mtllib multiMaterial.mtl\nvt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+		"vn 1 0 0\nvn -1 0 0\nvn 0 1 0\nvn 0 -1 0\nvn 0 0 1\nvn 0 0 -1\n";
+	char line[128];
+	for (uint32_t cube = 0; cube < cubeCount; ++cube) {
+		float x = float(cube % 4) * 2.0f - 3.0f;
+		float y = float(cube / 4) * 2.0f - 3.0f;
+		text.append(line, std::snprintf(line, sizeof(line), "o Cube.%03u\n", cube));
+		for (uint32_t corner = 0; corner < 8; ++corner) {
+			text.append(line, std::snprintf(line, sizeof(line), "v %.2f %.2f %.2f\n",
+				x + float(corner & 1) - 0.5f, y + float((corner >> 1) & 1) - 0.5f, float((corner >> 2) & 1) - 0.5f));
 		}
-	}
-
-	// 読み込んだマテリアルデータを返す
-	return materialData;
-}
-
-struct ModelData {
-	std::vector<VertexData> vertices; // 頂点データ
-	MaterialData material; // マテリアルデータ
-};
-
-// Objファイルを読み込む関数
-ModelData LoadObjFile(const std::string& directoryPath, const std::string& filename) {
-	ModelData modelData;
-	std::vector<Vector4> positions; // 頂点位置
-	std::vector<Vector3> normals; // 法線
-	std::vector<Vector2> texcoords; // テクスチャ座標
-	std::string line;
-
-	// ファイルを開く
-	std::ifstream file(directoryPath + "/" + filename);
-	assert(file.is_open());
-	while (std::getline(file, line)) {
-		std::string identifier;
-		std::istringstream s(line);
-		s >> identifier;
-
-		// identifierに応じた処理
-		if (identifier == "v") {
-
-			// 頂点位置
-			Vector4 position;
-			s >> position.x >> position.y >> position.z;
-			position.w = 1.0f; // w成分は1.0fに設定
-			positions.push_back(position);
-		} else if (identifier == "vt") {
-
-			// テクスチャ座標
-			Vector2 texcoord;
-			s >> texcoord.x >> texcoord.y;
-			texcoord.y = 1.0f - texcoord.y; // OpenGLとDirectXでY軸の方向が逆なので反転
-			texcoords.push_back(texcoord);
-		} else if (identifier == "vn") {
-
-			// 法線
-			Vector3 normal;
-			s >> normal.x >> normal.y >> normal.z;
-			normals.push_back(normal);
-		} else if (identifier == "f") {
-
-			VertexData triangle[3];
-
-			// 面の定義
-			for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex) {
-				std::string vertexDefinition;
-				s >> vertexDefinition;
-
-				// 頂点要素へのindexは「位置/UV/法線」で格納されているので分解してindexを取得する
-				std::istringstream v(vertexDefinition);
-				uint32_t elementIndices[3];
-				for (int32_t element = 0; element < 3; ++element) {
-					std::string index;
-					std::getline(v, index, '/');
-					elementIndices[element] = std::stoi(index);
-				}
-
-				// 要素へのIndexから実際の要素の値を取得して、頂点を構築する
-				Vector4 position = positions[elementIndices[0] - 1]; // Objファイルは1始まりなので-1する
-				Vector2 texcoord = texcoords[elementIndices[1] - 1]; // Objファイルは1始まりなので-1する
-				Vector3 normal = normals[elementIndices[2] - 1]; // Objファイルは1始まりなので-1する
-
-				position.x *= -1.0f; // X軸を反転する（DirectXとOpenGLで座標系が異なるため）
-				normal.x *= -1.0f; // 法線も反転する
-				triangle[faceVertex] = { position, texcoord, normal };
-			}
-
-			// 頂点を逆順に登録する
-			modelData.vertices.push_back(triangle[2]);
-			modelData.vertices.push_back(triangle[1]);
-			modelData.vertices.push_back(triangle[0]);
-		} else if (identifier == "mtllib") {
-			// マテリアルファイルの読み込み
-			std::string materialFilename;
-			s >> materialFilename;
-			modelData.material = LoadMaterialTemplateFile(directoryPath, materialFilename);
+		text.append(line, std::snprintf(line, sizeof(line), "usemtl %s\n", kMaterialNames[cube % 2]));
+		for (uint32_t face = 0; face < 6; ++face) {
+			// 位置はこの立方体の8頂点からの相対
+			const uint32_t* c = kFaces[face];
+			text.append(line, std::snprintf(line, sizeof(line), "f %d/1/%u %d/2/%u %d/3/%u %d/4/%u\n",
+				int32_t(c[0]) - 8, face + 1, int32_t(c[1]) - 8, face + 1, int32_t(c[2]) - 8, face + 1, int32_t(c[3]) - 8, face + 1));
 		}
 	}
-
-	// ファイルを閉じる
-	file.close();
-	// 読み込んだ頂点データを返す
-	return modelData;
-}*/
-
-SoundData SoundLoadWave(const char* filename) {
-
-	// ファイルオープン
-	std::ifstream file;
-
-	// .wavファイルをバイナリモードで開く
-	file.open(filename, std::ios_base::binary);
-
-	// エラー処理
-	assert(file.is_open());
-
-	// RIFFヘッダの読み込み
-	RiffHeder riff;
-	file.read((char*)&riff, sizeof(riff));
-	// RIFFヘッダのチェック
-	if (strncmp(riff.chunk.id, "RIFF", 4) != 0) {
-		assert(0);
-	}
-
-	// WAVEヘッダのチェック
-	if (strncmp(riff.type, "WAVE", 4) != 0) {
-		assert(0);
-	}
-
-	// fmtチャンクの読み込み
-	FomatChunk format = {};
-	file.read((char*)&format, sizeof(ChunkHeader));
-	if (strncmp(format.chunk.id, "fmt ", 4) != 0) {
-		assert(0);
-	}
-
-	// fmtチャンクのサイズをチェック
-	assert(format.chunk.size <= sizeof(format.fmt));
-	file.read((char*)&format.fmt, format.chunk.size);
-
-	// dataチャンクの読み込み
-	ChunkHeader data;
-	file.read((char*)&data, sizeof(data));
-	// JUNKチャンクの読み飛ばし
-	if (strncmp(data.id, "JUNK", 4) == 0) {
-		// JUNKチャンクのサイズを読み飛ばす
-		file.seekg(data.size, std::ios_base::cur);
-		// 次のチャンクヘッダを読み込む
-		file.read((char*)&data, sizeof(data));
-	}
-
-	if (strncmp(data.id, "data", 4) != 0) {
-		assert(0);
-	}
-
-	// データチャンクのサイズをチェック
-	char* pBuffer = new char[data.size];
-	file.read(pBuffer, data.size);
-
-	file.close();
-
-	// returnする為の音声データ
-	SoundData soundData = {};
-	soundData.wfex = format.fmt; // WAVEフォーマット
-	soundData.pBuffer = reinterpret_cast<BYTE*>(pBuffer); // 音声データのポインタ
-	soundData.bufferSize = data.size; // 音声データのサイズ
-	return soundData;
-}
-
-// 音声データの解放
-void SoundUnload(SoundData* soundData) {
-	// バッファのメモリを解放
-	delete[] soundData->pBuffer;
-
-	soundData->pBuffer = 0; // ポインタを0にする
-	soundData->bufferSize = 0; // サイズを0にする
-	soundData->wfex = {}; // WAVEフォーマットを初期化
-}
-
-// 音声再生
-void SoundPlayWave(IXAudio2* xAudio2, const SoundData& soundData) {
-	HRESULT result;
-
-	// 波形フォーマットを元にサウンドエフェクトを作成
-	IXAudio2SourceVoice* pSourceVoice = nullptr;
-	result = xAudio2->CreateSourceVoice(&pSourceVoice, &soundData.wfex);
-	assert(SUCCEEDED(result));
-
-	// 音声データを再生する
-	XAUDIO2_BUFFER buf = {};
-	buf.pAudioData = soundData.pBuffer; // 音声データのポインタ
-	buf.AudioBytes = soundData.bufferSize; // 音声データのサイズ
-	buf.Flags = XAUDIO2_END_OF_STREAM; // 音声データの終端を示すフラグ
-
-	// 波形データの再生	
-	result = pSourceVoice->SubmitSourceBuffer(&buf);
-	result = pSourceVoice->Start();
+	return text;
 }
 
 // windowsアプリでのエントリーポイント(main関数)
 int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
+	// ログの初期化（ファイルとデバッガに出す。計測用の分類は出さない）
+	Logeer::Logger::GetInstance()->Initialize();
+	uint32_t logCategories = Logeer::kAllCategories & ~Logeer::GetCategoryBit(Logeer::Category::kBenchmark);
+	Logeer::Logger::GetInstance()->AddSink(std::make_unique<Logeer::DebuggerLogSink>(), logCategories);
+	std::unique_ptr<Logeer::FileLogSink> fileLogSink = std::make_unique<Logeer::FileLogSink>();
+	if (fileLogSink->Open("logs/engine.log")) {
+		Logeer::Logger::GetInstance()->AddSink(std::move(fileLogSink), logCategories);
+	}
+
 	// リリースチェック
 	D3DResourceLeakChecker resourceLeakChecker;
 #ifdef _DEBUG
@@ -355,19 +147,67 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	input = new Input();
 	input->Initialize(winApp);
 
+	// 音声の初期化
+	Audio::GetInstance()->Initialize();
+
+	// 効果音は焼いたサウンドバンクがあればそこから引き（マップするだけで読み込まない）、無ければ波形だけを読み込んでおく
+	// BGMはPlayStreamでファイルから少しずつ読む
+	std::chrono::steady_clock::time_point soundLoadStart = std::chrono::steady_clock::now();
+	SoundBank soundBank;
+	SoundData fanfareSound;
+	if (soundBank.Open("resources/sounds.sbank")) {
+		fanfareSound = soundBank.GetSound("fanfare.wav");
+	}
+	bool isFanfareFromBank = fanfareSound.pBuffer != nullptr;
+	if (!isFanfareFromBank) {
+		fanfareSound = Audio::LoadWave("resources/fanfare.wav");
+	}
+	double soundLoadMilliseconds = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - soundLoadStart).count();
+	uint32_t streamHandle = Audio::kInvalidHandle;
+	bool isStreamLooping = false;
+	float mixerPan = 0.0f;
+
+	// 入力の事象（スペースキーの押下を、届いた事象で数えた場合とフレームの終わりの状態だけで数えた場合）
+	uint32_t spaceEventPresses = 0;
+	uint32_t spacePolledPresses = 0;
+	bool wasSpaceDown = false;
+	std::vector<InputEvent> recentInputEvents;
+	std::vector<double> recentInputOffsets; // 事象が前のフレームの始めから何ミリ秒後に届いたか
+
 	// テクスチャマネージャーの初期化
 	TextureManager::GetInstance()->Initialize(dxCommon);
 
-	// Textureの読んで転送する
-	TextureManager::GetInstance()->LoadTexture("resources/uvChecker.png");
+	// Textureの読み込みをまとめて頼む（デコードはワーカーで並行に行う）
+	// TextureCookerで焼いた.ddsがあればそちらを読む
+	std::chrono::steady_clock::time_point textureLoadStart = std::chrono::steady_clock::now();
+	TextureManager::GetInstance()->LoadTextureAsync("resources/uvChecker.png");
 
-	// 2枚目のTextureの読んで転送する
-	TextureManager::GetInstance()->LoadTexture("resources/monsterBall.png");
+	// 2枚目のTextureの読み込みを頼む
+	TextureManager::GetInstance()->LoadTextureAsync("resources/monsterBall.png");
+
+	// 転送は一回の実行でまとめて待つ
+	TextureManager::GetInstance()->WaitForAll();
+	double startupTextureMilliseconds = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - textureLoadStart).count();
 
 	// スプライトの初期化
 	SpriteCommon* spriteCommon = new SpriteCommon();
 	spriteCommon->Initialize(dxCommon);
 
+	// モデルの初期化
+	ModelCommon* modelCommon = new ModelCommon();
+	modelCommon->Initialize(dxCommon);
+
+	// 複数のオブジェクトとマテリアルを持つモデル（Objがあればそれを、無ければ同じマテリアルを使う立方体の並びを作る）
+	Model* multiMaterialModel = new Model();
+	if (std::filesystem::exists("resources/multiMaterial.obj")) {
+		multiMaterialModel->Initialize(modelCommon, "resources", "multiMaterial.obj");
+	} else {
+		std::string cubeGridText = MakeCubeGridObjText(16);
+		multiMaterialModel->Initialize(modelCommon, ObjLoader::ParseObj(cubeGridText.data(), cubeGridText.size(), "resources"));
+	}
+
 	std::vector<std::string> textures = {
 	"resources/uvChecker.png",
 	"resources/monsterBall.png"
@@ -441,9 +281,9 @@ assert(SUCCEEDED(hr));
 	assert(pixelShaderBlob != nullptr);
 
 // モデル読み込み
-//ModelData modelData = LoadObjFile("resources", "plane.obj");
+//ObjLoader::ModelData modelData = ObjLoader::LoadObjFile("resources", "plane.obj");
 
-//DirectX::ScratchImage mipImages2 = dxCommon->LoadTexture(modelData.material.textureFilePath);
+//DirectX::ScratchImage mipImages2 = dxCommon->LoadTexture(modelData.materials[0].textureFilePath);
 
 /*	// 頂点リソースを作る
 	//Microsoft::WRL::ComPtr <ID3D12Resource> vertexResource = dxCommon->CreateBufferResource(sizeof(VertexData) * modelData.vertices.size());
@@ -533,21 +373,11 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 	};
 
 
-	// 平行光源用のデータ
-	DirectionalLight* directionalLightData = nullptr;
-
-	// 平行光源用のリソースを作成
-	Microsoft::WRL::ComPtr <ID3D12Resource> directionalLightResource = dxCommon->CreateBufferResource(sizeof(DirectionalLight));
-
-	// 書き込むアドレスを取得する
-	directionalLightResource->Map(0, nullptr, reinterpret_cast<void**>(&directionalLightData));
-
-	// アドレスに書き込む
-	directionalLightData->color = Vector4{ 1.0f,1.0f,1.0f,1.0f }; // 白色
-	directionalLightData->direction = { 0.0f,-1.0f,0.0f }; // 向き
-	directionalLightData->intensity = 1.0f; // 強さ
-
-	directionalLightResource->Unmap(0, nullptr);
+	// 平行光源用のデータ（描画するフレームごとにアップロード領域へ書き込む）
+	DirectionalLight directionalLightData{};
+	directionalLightData.color = Vector4{ 1.0f,1.0f,1.0f,1.0f }; // 白色
+	directionalLightData.direction = { 0.0f,-1.0f,0.0f }; // 向き
+	directionalLightData.intensity = 1.0f; // 強さ
 
 	// ビューポート
 	D3D12_VIEWPORT viewport{};
@@ -624,13 +454,13 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 	vertexDataSprite[3].nomal = { 0.0f,0.0f,1.0f };
 */
 // Indexの頂点リソース
-	Microsoft::WRL::ComPtr <ID3D12Resource> indexResourceSprite = dxCommon->CreateBufferResource(sizeof(uint32_t) * 6);
+	MappedBuffer<uint32_t> indexDataSprite = dxCommon->CreateMappedBufferResource<uint32_t>(6);
 
 	// index
 	D3D12_INDEX_BUFFER_VIEW indexBufferViewSprite{};
 
 	// リソースの先頭アドレスから使う
-	indexBufferViewSprite.BufferLocation = indexResourceSprite->GetGPUVirtualAddress();
+	indexBufferViewSprite.BufferLocation = indexDataSprite.GetGPUVirtualAddress();
 
 	// 使用するリソースのサイズインデックス6つ分のサイズ
 	indexBufferViewSprite.SizeInBytes = sizeof(uint32_t) * 6;
@@ -639,8 +469,6 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 	indexBufferViewSprite.Format = DXGI_FORMAT_R32_UINT;
 
 	// インデックスリソースにデータを書き込む
-	uint32_t* indexDataSprite = nullptr;
-	indexResourceSprite->Map(0, nullptr, reinterpret_cast<void**>(&indexDataSprite));
 	indexDataSprite[0] = 0; indexDataSprite[1] = 1; indexDataSprite[2] = 2;
 	indexDataSprite[3] = 1; indexDataSprite[4] = 3; indexDataSprite[5] = 2;
 
@@ -656,6 +484,36 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 	// 単位行列を書き込む
 //	transeformationMatrixDataSprite->World = makeIdentity4x4();
 
+	// Mapの計測用リソース（毎回Mapする場合と、Mapしたままの場合）
+	Microsoft::WRL::ComPtr <ID3D12Resource> mapPerFrameResource = dxCommon->CreateBufferResource(sizeof(SpriteCommon::TransfomationMatrix));
+	MappedBuffer<SpriteCommon::TransfomationMatrix> persistentMappedBuffer = dxCommon->CreateMappedBufferResource<SpriteCommon::TransfomationMatrix>();
+	double mapPerFrameMicroseconds = 0.0;
+	double persistentMapMicroseconds = 0.0;
+
+	// テクスチャのデコードの計測結果（1スレッドの場合と、ワーカーで並行する場合）
+	double serialDecodeMilliseconds = 0.0;
+	double parallelDecodeMilliseconds = 0.0;
+
+	// PNG（WICで読んでミップマップ生成）とDDS（焼いたものを読むだけ）の比較結果
+	double wicDecodeMilliseconds = 0.0;
+	double ddsDecodeMilliseconds = 0.0;
+	uint64_t wicGpuBytes = 0;
+	uint64_t ddsGpuBytes = 0;
+	uint32_t cookedFoundCount = 0;
+
+	// スプライトのカリング（描画順のまま、画面内のものだけ更新・描画する）
+	std::vector<Sprite*> cullTargets = sprites;
+	cullTargets.push_back(bigSprite);
+	ViewCulling spriteCulling;
+	const ViewCulling::Rect kScreenRect = { 0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight) };
+
+	// モデルの描画（並べて描く数と回転）
+	int32_t modelInstanceCount = 4;
+	float modelRotate = 0.0f;
+
+	// 並べたモデルの座標変換（まとめて計算してアップロード領域に直接書き込む）
+	TransformSystem modelTransforms;
+
 	// transformの初期化
 	TransForm transform{ {1.0f,1.0f,1.0f},{0.0f,0.0f,0.0f} ,{0.0f,0.0f,0.0f} };
 	TransForm cameraTransform{ {1.0f,1.0f,1.0f},{0.0f,0.0f,0.0f} ,{0.0f,0.0f,-5.0f} };
@@ -687,6 +545,9 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 
 		input->Update();
 
+		// 再生の終わったボイスを空きに戻し、ストリーミングの続きを詰める
+		Audio::GetInstance()->Update();
+
 		//===========================
 		// ゲーム処理
 		//===========================
@@ -704,13 +565,13 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 		// ImGuiで三角形のスケールを変える
 		ImGui::DragFloat3("Scale", reinterpret_cast<float*>(&transform.scale.x), 0.01f);
 		// ImGuiで光源の向きを変える
-		ImGui::DragFloat3("LightDirection", reinterpret_cast<float*>(&directionalLightData->direction.x), 0.01f);
+		ImGui::DragFloat3("LightDirection", reinterpret_cast<float*>(&directionalLightData.direction.x), 0.01f);
 		// 光源を正規化する
-		directionalLightData->direction = Normalize(directionalLightData->direction);
+		directionalLightData.direction = Normalize(directionalLightData.direction);
 		// ImGuiで光源の色を変える
-		ImGui::ColorEdit3("LightColor", reinterpret_cast<float*>(&directionalLightData->color.x));
+		ImGui::ColorEdit3("LightColor", reinterpret_cast<float*>(&directionalLightData.color.x));
 		// ImGuiで光源の強さを変える
-		ImGui::DragFloat("LightIntensity", &directionalLightData->intensity, 0.01f, 0.0f, 10.0f);
+		ImGui::DragFloat("LightIntensity", &directionalLightData.intensity, 0.01f, 0.0f, 10.0f);
 		// ImGuiでTextureを切り替える
 		ImGui::Checkbox("useMonsterBall", &useMonsterBall);
 		// ImGuiのウィンドウを閉じる
@@ -773,13 +634,305 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 
 		ImGui::End();
 
-		// spriteの更新
-		for (Sprite* sprite : sprites) {
-			sprite->Update();
+		// スプライトの描画方式
+		ImGui::Begin("SpriteBatch");
+		int drawMode = static_cast<int>(spriteCommon->GetDrawMode());
+		ImGui::RadioButton("Individual", &drawMode, static_cast<int>(SpriteCommon::DrawMode::kIndividual));
+		ImGui::RadioButton("Batch", &drawMode, static_cast<int>(SpriteCommon::DrawMode::kBatch));
+		ImGui::RadioButton("Instanced", &drawMode, static_cast<int>(SpriteCommon::DrawMode::kInstanced));
+		spriteCommon->SetDrawMode(static_cast<SpriteCommon::DrawMode>(drawMode));
+		ImGui::Text("Recomputed : %u / %u sprites", spriteCommon->GetRecomputedSpriteCount(), static_cast<uint32_t>(sprites.size() + 1));
+		ImGui::Text("Uploaded : %u / %u sprites", spriteCommon->GetUploadedSpriteCount(), static_cast<uint32_t>(sprites.size() + 1));
+		ImGui::Text("Dropped : %u sprites (upload allocation failed)", spriteCommon->GetDroppedSpriteCount());
+		const SpriteBatch& spriteBatch = spriteCommon->GetSpriteBatch();
+		ImGui::Text("Sprites : %u", spriteBatch.GetSpriteCount());
+		ImGui::Text("DrawCalls : %u (%u runs)", spriteCommon->GetBatchDrawCallCount(), static_cast<uint32_t>(spriteBatch.GetRuns().size()));
+		ImGui::Text("Build : %.3f ms (%.1f sprites/ms)", spriteBatch.GetBuildMilliseconds(), spriteBatch.GetSpritesPerMillisecond());
+
+		// インスタンス描画の統計とメモリ比較
+		const SpriteInstancer& spriteInstancer = spriteCommon->GetSpriteInstancer();
+		ImGui::Text("Instances : %u (DrawCalls : %u)", spriteInstancer.GetInstanceCount(), static_cast<uint32_t>(spriteInstancer.GetRuns().size()));
+		SpriteInstancer::MemoryReport memoryReport = SpriteInstancer::MakeMemoryReport(DirectXCommon::kUploadFrameCount);
+		ImGui::Text("Legacy : %u resources, %llu bytes used, %llu bytes committed / sprite",
+			memoryReport.legacyResourcesPerSprite,
+			memoryReport.legacyPayloadBytesPerSprite,
+			memoryReport.legacyCommittedBytesPerSprite);
+		ImGui::Text("Instanced : %llu bytes / sprite (+%llu bytes shared)",
+			memoryReport.instancedBytesPerSprite,
+			memoryReport.instancedSharedBytes);
+
+		// フレームごとのアップロード領域の使用量（前のフレームの値）
+		const UploadRingAllocator& uploadAllocator = dxCommon->GetUploadAllocator();
+		ImGui::Text("Upload : %llu / %llu bytes, %u allocations (peak %llu bytes, %u grows, %llu failed)",
+			uploadAllocator.GetLastFrameUsedBytes(),
+			uploadAllocator.GetSliceSize(),
+			uploadAllocator.GetLastFrameAllocationCount(),
+			uploadAllocator.GetPeakUsedBytes(),
+			uploadAllocator.GetGrowCount(),
+			uploadAllocator.GetFailedAllocationCount());
+		ImGui::End();
+
+		// 毎回Mapする場合とMapしたままの場合の書き込み時間を比べる
+		ImGui::Begin("MappedBuffer");
+		if (ImGui::Button("Measure")) {
+			const uint32_t kIterations = 10000;
+			SpriteCommon::TransfomationMatrix matrix = { makeIdentity4x4(), makeIdentity4x4() };
+
+			// 毎回Mapして書き込んでUnmapする
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (uint32_t i = 0; i < kIterations; ++i) {
+				SpriteCommon::TransfomationMatrix* data = nullptr;
+				mapPerFrameResource->Map(0, nullptr, reinterpret_cast<void**>(&data));
+				*data = matrix;
+				mapPerFrameResource->Unmap(0, nullptr);
+			}
+			std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+
+			// Mapしたまま書き込む
+			for (uint32_t i = 0; i < kIterations; ++i) {
+				*persistentMappedBuffer.GetData() = matrix;
+				// 書き込みがまとめられないようにする
+				std::atomic_signal_fence(std::memory_order_seq_cst);
+			}
+			std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+			mapPerFrameMicroseconds = std::chrono::duration<double, std::micro>(middle - start).count() / kIterations;
+			persistentMapMicroseconds = std::chrono::duration<double, std::micro>(end - middle).count() / kIterations;
+		}
+		ImGui::Text("Map per write : %.4f us", mapPerFrameMicroseconds);
+		ImGui::Text("Persistent    : %.4f us", persistentMapMicroseconds);
+		ImGui::End();
+
+		// テクスチャの読み込み状況と、デコード・ミップマップ生成だけの時間（GPUは使わない）
+		ImGui::Begin("TextureLoad");
+		TextureManager* textureManager = TextureManager::GetInstance();
+		ImGui::Text("Ready : %u / %u textures (%u failed)", textureManager->GetReadyTextureCount(), textureManager->GetTextureCount(),
+			textureManager->GetFailedTextureCount());
+		if (ImGui::Button("Measure Decode x16")) {
+			const uint32_t kDecodeCount = 16;
+			std::vector<DirectX::ScratchImage> mipImages(kDecodeCount);
+
+			// 1スレッドで順にデコードする
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for (uint32_t i = 0; i < kDecodeCount; ++i) {
+				TextureManager::DecodeTexture(textures[i % textures.size()], mipImages[i]);
+			}
+			std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+
+			// ワーカーで並行にデコードする
+			for (uint32_t i = 0; i < kDecodeCount; ++i) {
+				textureManager->GetThreadPool()->Submit([&mipImages, &textures, i]() {
+					TextureManager::DecodeTexture(textures[i % textures.size()], mipImages[i]);
+				});
+			}
+			textureManager->GetThreadPool()->WaitIdle();
+			std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+			serialDecodeMilliseconds = std::chrono::duration<double, std::milli>(middle - start).count();
+			parallelDecodeMilliseconds = std::chrono::duration<double, std::milli>(end - middle).count();
+		}
+		ImGui::Text("Serial   : %.3f ms", serialDecodeMilliseconds);
+		ImGui::Text("Parallel : %.3f ms (%u workers)", parallelDecodeMilliseconds, textureManager->GetThreadPool()->GetThreadCount());
+		ImGui::End();
+
+		// 起動時の読み込みと、PNGとDDSのデコード時間・GPUメモリの比較
+		ImGui::Begin("TextureCook");
+		ImGui::Text("Startup : %.3f ms (%u / %u from dds)", startupTextureMilliseconds,
+			textureManager->GetCookedTextureCount(), textureManager->GetTextureCount());
+		ImGui::Text("Decode  : %.3f ms total", textureManager->GetTotalDecodeMilliseconds());
+		ImGui::Text("GPU     : %llu KiB", textureManager->GetTotalGpuBytes() / 1024);
+		if (ImGui::Button("Compare png / dds")) {
+			wicDecodeMilliseconds = 0.0;
+			ddsDecodeMilliseconds = 0.0;
+			wicGpuBytes = 0;
+			ddsGpuBytes = 0;
+			cookedFoundCount = 0;
+			for (const std::string& texture : textures) {
+				// PNGをWICで読んでミップマップを作る
+				DirectX::ScratchImage wicImage;
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				TextureManager::DecodeTexture(texture, wicImage, false);
+				std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+				wicDecodeMilliseconds += std::chrono::duration<double, std::milli>(middle - start).count();
+				wicGpuBytes += dxCommon->GetTextureAllocationSize(wicImage.GetMetadata());
+
+				// 焼いたDDSを読む（無ければ数えない）
+				DirectX::ScratchImage ddsImage;
+				bool isCooked = false;
+				middle = std::chrono::steady_clock::now();
+				TextureManager::DecodeTexture(texture, ddsImage, true, &isCooked);
+				std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+				if (isCooked) {
+					ddsDecodeMilliseconds += std::chrono::duration<double, std::milli>(end - middle).count();
+					ddsGpuBytes += dxCommon->GetTextureAllocationSize(ddsImage.GetMetadata());
+					cookedFoundCount++;
+				}
+			}
+		}
+		ImGui::Text("png : %.3f ms, %llu KiB", wicDecodeMilliseconds, wicGpuBytes / 1024);
+		ImGui::Text("dds : %.3f ms, %llu KiB (%u / %zu cooked)", ddsDecodeMilliseconds, ddsGpuBytes / 1024,
+			cookedFoundCount, textures.size());
+		ImGui::End();
+
+		// スプライトのカリングの結果
+		ImGui::Begin("Culling");
+		uint32_t visibleSpriteCount = static_cast<uint32_t>(spriteCulling.GetVisibleRects().size());
+		ImGui::Text("Sprites : visible %u / culled %u", visibleSpriteCount, spriteCulling.GetRectCount() - visibleSpriteCount);
+		ImGui::End();
+
+		// モデルの描画（サブメッシュをマテリアル順に並べたときの状態の切り替え回数）
+		ImGui::Begin("Model");
+		bool isModelSortEnabled = modelCommon->IsSortEnabled();
+		ImGui::Checkbox("Sort", &isModelSortEnabled);
+		modelCommon->SetSortEnabled(isModelSortEnabled);
+		ImGui::SliderInt("Instances", &modelInstanceCount, 1, 16);
+		ImGui::Text("Submeshes : %zu, Materials : %u", multiMaterialModel->GetSubmeshes().size(),
+			multiMaterialModel->GetMaterialCount());
+		const ModelDrawList& modelDrawList = modelCommon->GetDrawList();
+		const ModelDrawList::StateChanges& sortedChanges = modelDrawList.GetStateChanges();
+		const ModelDrawList::StateChanges& submittedChanges = modelDrawList.GetSubmittedStateChanges();
+		ImGui::Text("Draws : %u (sort %.3f ms)", modelDrawList.GetDrawCount(), modelDrawList.GetBuildMilliseconds());
+		ImGui::Text("State changes : %u (submitted order %u)", sortedChanges.GetTotal(), submittedChanges.GetTotal());
+		ImGui::Text("  Texture %u / Material %u / Geometry %u / Transform %u",
+			sortedChanges.texture, sortedChanges.material, sortedChanges.geometry, sortedChanges.transform);
+		ImGui::End();
+
+		// 入力（ウィンドウメッセージを時刻付きの事象にしてキューで受け渡す）
+		ImGui::Begin("Input");
+		const InputSnapshot& inputSnapshot = input->GetSnapshot();
+		spaceEventPresses += inputSnapshot.GetKeyPressCount(DIK_SPACE);
+		bool isSpaceDown = input->PushKey(DIK_SPACE);
+		if (isSpaceDown && !wasSpaceDown) {
+			spacePolledPresses++;
+		}
+		wasSpaceDown = isSpaceDown;
+		for (const InputEvent& event : input->GetEvents()) {
+			if (event.type == InputEvent::Type::kMouseMove) {
+				continue;
+			}
+			recentInputEvents.push_back(event);
+			recentInputOffsets.push_back(double(int64_t(event.time - inputSnapshot.GetPreviousFrameTime())) / 1000000.0);
 		}
+		const size_t kRecentInputEventCount = 12;
+		if (recentInputEvents.size() > kRecentInputEventCount) {
+			size_t eraseCount = recentInputEvents.size() - kRecentInputEventCount;
+			recentInputEvents.erase(recentInputEvents.begin(), recentInputEvents.begin() + eraseCount);
+			recentInputOffsets.erase(recentInputOffsets.begin(), recentInputOffsets.begin() + eraseCount);
+		}
+		ImGui::Text("Events this frame : %zu, dropped %u", input->GetEvents().size(), input->GetDroppedEventCount());
+		ImGui::Text("Mouse : (%d, %d) wheel %d, buttons %c%c%c", input->GetMouseX(), input->GetMouseY(), input->GetWheelDelta(),
+			input->PushMouse(Input::kMouseLeft) ? 'L' : '-', input->PushMouse(Input::kMouseMiddle) ? 'M' : '-',
+			input->PushMouse(Input::kMouseRight) ? 'R' : '-');
+		ImGui::Text("Space presses : %u from events, %u from end-of-frame polling", spaceEventPresses, spacePolledPresses);
+		const char* inputEventNames[] = { "KeyDown", "KeyUp", "MouseDown", "MouseUp", "MouseMove", "Wheel", "FocusLost" };
+		for (size_t i = 0; i < recentInputEvents.size(); ++i) {
+			const InputEvent& event = recentInputEvents[i];
+			ImGui::Text("%-9s code 0x%02X  +%.3f ms", inputEventNames[uint32_t(event.type)], event.code, recentInputOffsets[i]);
+		}
+		ImGui::End();
 
-		// でかいスプライトの更新
-		bigSprite->Update();
+		// 音声（ボイスは決まった数を使い回し、ストリーミングは二つのブロックを交互に詰める）
+		ImGui::Begin("Audio");
+		ImGui::Text("fanfare.wav : %u Hz / %u ch / %u bit, %u bytes (%s %.3f ms)",
+			fanfareSound.format.sampleRate, fanfareSound.format.channelCount, fanfareSound.format.bitsPerSample,
+			fanfareSound.bufferSize, isFanfareFromBank ? "bank" : "load", soundLoadMilliseconds);
+		if (ImGui::Button("Play")) {
+			Audio::GetInstance()->PlayWave(fanfareSound);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Play x8")) {
+			for (uint32_t i = 0; i < 8; ++i) {
+				Audio::GetInstance()->PlayWave(fanfareSound, 0.25f);
+			}
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Stream")) {
+			Audio::GetInstance()->Stop(streamHandle);
+			streamHandle = Audio::GetInstance()->PlayStream("resources/fanfare.wav", 1.0f, isStreamLooping);
+		}
+		ImGui::SameLine();
+		ImGui::Checkbox("Loop", &isStreamLooping);
+		ImGui::SameLine();
+		if (ImGui::Button("Stop All")) {
+			Audio::GetInstance()->StopAll();
+		}
+		Audio::Statistics audioStatistics = Audio::GetInstance()->GetStatistics();
+		uint32_t maxVoices = Audio::kMaxVoices;
+		ImGui::Text("Voices : %u / %u active", audioStatistics.activeVoices, maxVoices);
+		ImGui::Text("Created %u / Reused %u / Rejected %u",
+			audioStatistics.createdVoices, audioStatistics.reusedVoices, audioStatistics.rejectedPlays);
+		ImGui::Text("Stream : %s, %.1f KB read, underruns %u",
+			Audio::GetInstance()->IsPlaying(streamHandle) ? "playing" : "stopped",
+			audioStatistics.streamedBytes / 1024.0, audioStatistics.streamUnderruns);
+
+		// ソフトウェアミキサー（何個鳴らしてもハードウェアのボイスは一つ）
+		ImGui::Separator();
+		AudioMixer* mixer = Audio::GetInstance()->GetMixer();
+		int resamplerIndex = mixer->GetResampler() == AudioMixer::Resampler::kSinc ? 1 : 0;
+		if (ImGui::Combo("Resampler", &resamplerIndex, "Linear\0" "Sinc\0")) {
+			mixer->SetResampler(resamplerIndex == 1 ? AudioMixer::Resampler::kSinc : AudioMixer::Resampler::kLinear);
+		}
+		ImGui::SliderFloat("Pan", &mixerPan, -1.0f, 1.0f);
+		if (ImGui::Button("Play Mixed")) {
+			Audio::GetInstance()->PlayMixed(fanfareSound, 1.0f, mixerPan);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Play Mixed x32")) {
+			for (uint32_t i = 0; i < 32; ++i) {
+				Audio::GetInstance()->PlayMixed(fanfareSound, 1.0f / 32.0f, float(i) / 31.0f * 2.0f - 1.0f);
+			}
+		}
+		ImGui::Text("Mixer : %u voices, underruns %u", audioStatistics.mixerVoices, audioStatistics.mixerUnderruns);
+		ImGui::End();
+
+		// ロガー（Log<>は自分のリングに積むだけで、書式化と出力はドレインのスレッドで行う）
+		ImGui::Begin("Logger");
+		Logeer::Logger::Statistics logStatistics = Logeer::Logger::GetInstance()->GetStatistics();
+		ImGui::Text("Written : %llu, Dropped : %llu, Threads : %u",
+			logStatistics.writtenRecords, logStatistics.droppedRecords, logStatistics.threadCount);
+		if (ImGui::Button("Log Test")) {
+			LOGEER_LOG(Logeer::Level::kInfo, Logeer::Category::kGeneral, "Log Test : frame time {:.3f} ms",
+				ImGui::GetIO().DeltaTime * 1000.0f);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Flush")) {
+			Logeer::Logger::GetInstance()->Flush();
+		}
+		ImGui::End();
+
+		// CPUとGPUの並行具合（前のフレームの値）
+		ImGui::Begin("Frame");
+		const FrameContextRing& frameContexts = dxCommon->GetFrameContexts();
+		ImGui::Text("FramesInFlight : %u (overlapped %u)", frameContexts.GetFrameCount(), frameContexts.GetOverlappedFrames());
+		ImGui::Text("GPU Wait : %.3f ms (total waits %llu)", dxCommon->GetFrameWaitMilliseconds(), frameContexts.GetWaitCount());
+
+		// フレームレート調整
+		FramePacer* framePacer = dxCommon->GetFramePacer();
+		bool isUnlocked = framePacer->IsUnlocked();
+		ImGui::Checkbox("Unlocked", &isUnlocked);
+		framePacer->SetUnlocked(isUnlocked);
+		float targetFps = static_cast<float>(framePacer->GetTargetFps());
+		if (ImGui::DragFloat("TargetFps", &targetFps, 1.0f, 10.0f, 240.0f)) {
+			framePacer->SetTargetFps(targetFps);
+		}
+		FramePacer::Statistics frameStatistics = framePacer->GetStatistics();
+		ImGui::Text("FrameTime : mean %.3f / p50 %.3f / p99 %.3f / max %.3f ms",
+			frameStatistics.meanMilliseconds, frameStatistics.p50Milliseconds,
+			frameStatistics.p99Milliseconds, frameStatistics.maxMilliseconds);
+		ImGui::Text("Missed : %llu (last %u frames)", frameStatistics.missedDeadlines, frameStatistics.sampleCount);
+		ImGui::End();
+
+		// 画面外のスプライトを省く
+		spriteCulling.Clear();
+		for (Sprite* sprite : cullTargets) {
+			spriteCulling.AddRect(sprite->GetScreenRect());
+		}
+		spriteCulling.CullRects(kScreenRect);
+
+		// 見えるspriteだけ更新
+		for (uint32_t index : spriteCulling.GetVisibleRects()) {
+			cullTargets[index]->Update();
+		}
 
 		// 変更を反映させる
 
@@ -807,9 +960,31 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 		// 書き込むアドレスを取得する
 		//wvpResource->Map(0, nullptr, reinterpret_cast<void**>(&wvpData));
 
+		// 読み込みが終わったテクスチャの転送を積む
+		TextureManager::GetInstance()->Update();
+
 		// 描画前処理
 		dxCommon->PreDraw();
 
+		// モデルの描画（並べて少し回す）
+		modelRotate += 0.01f;
+		modelCommon->SetCommonDrawSetting(Multiply(
+			Inverse(MakeAffineMatrix(cameraTransform.scale, cameraTransform.rotate, cameraTransform.translate)),
+			MakePerspectiveFovMatrix(0.45f, float(WinApp::kClientWidth) / float(WinApp::kClientHeight), 0.1f, 100.0f)));
+		modelTransforms.Clear();
+		for (int32_t i = 0; i < modelInstanceCount; ++i) {
+			float x = float(i % 4) * 5.0f - 7.5f;
+			float y = float(i / 4) * 5.0f - 7.5f;
+			modelTransforms.Add({ { 0.5f,0.5f,0.5f }, { 0.0f,modelRotate,0.0f }, { x,y,30.0f } });
+		}
+		uint32_t firstModelTransform = modelCommon->AddTransforms(modelTransforms);
+		if (firstModelTransform != ModelCommon::kInvalidTransform) {
+			for (uint32_t i = 0; i < modelTransforms.GetCount(); ++i) {
+				multiMaterialModel->Draw(firstModelTransform + i);
+			}
+		}
+		modelCommon->DrawModels();
+
 		// Sprite描画前処理
 		spriteCommon->SetCommonDrawSetting();
 
@@ -828,7 +1003,9 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 		//dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(1, wvpResource->GetGPUVirtualAddress());
 
 		// 平行光源用のCBufferを設定
-		//dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(3, directionalLightResource->GetGPUVirtualAddress());
+		//D3D12_GPU_VIRTUAL_ADDRESS directionalLightAddress = 0;
+		//*dxCommon->AllocateUpload<DirectionalLight>(1, &directionalLightAddress) = directionalLightData;
+		//dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(3, directionalLightAddress);
 
 		// SRVのDescriptorTableの設定
 		//dxCommon->GetCommandList()->SetGraphicsRootDescriptorTable(2, useMonsterBall ? textureSrvHandleGPU2 : textureSrvHandleGPU);
@@ -852,12 +1029,13 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 		// Spriteの表示する画像を設定
 		//dxCommon->GetCommandList()->SetGraphicsRootDescriptorTable(2, textureSrvHandleGPU);
 
-		for (Sprite* sprite : sprites) {
-			sprite->Draw();
+		// 見えるspriteだけ描画（でかいスプライトは最後）
+		for (uint32_t index : spriteCulling.GetVisibleRects()) {
+			cullTargets[index]->Draw();
 		}
 
-		// でかいスプライトの描画
-		bigSprite->Draw();
+		// バッチにたまったスプライトをまとめて描画
+		spriteCommon->DrawBatch();
 
 		// Spriteの描画
 		//dxCommon->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferViewSprite);
@@ -872,6 +1050,9 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 		dxCommon->PostDraw();
 	}
 
+	// GPUが処理中のフレームが終わるまで待つ
+	dxCommon->WaitForGPU();
+
 	// 解放処理
 	ImGui_ImplDX12_Shutdown();
 	ImGui_ImplWin32_Shutdown();
@@ -880,6 +1061,11 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 	// WindowsAPIの終了処理
 	winApp->Finalize();
 
+	// 音声の終了処理（ボイスを全部破棄してから波形を解放する）
+	Audio::GetInstance()->Finalize();
+	Audio::UnloadWave(&fanfareSound);
+	soundBank.Close();
+
 	// テクスチャマネージャーの終了処理
 	TextureManager::GetInstance()->Finalize();
 
@@ -890,6 +1076,11 @@ materialDataSprite->uvTranseform = makeIdentity4x4();
 	}
 	delete bigSprite;
 	delete spriteCommon;
+	delete multiMaterialModel;
+	delete modelCommon;
 	delete dxCommon;
+
+	// ログの終了処理（積まれているものを全部出力してから止める）
+	Logeer::Logger::Finalize();
 	return 0;
 }
\ No newline at end of file
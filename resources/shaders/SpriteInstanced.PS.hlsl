@@ -0,0 +1,17 @@
+#include "SpriteInstanced.hlsli"
+
+struct PixelShaderOutput
+{
+    float32_t4 color : SV_Target;
+};
+
+Texture2D<float32_t4> gTexture : register(t0);
+
+SamplerState gSampler : register(s0);
+
+PixelShaderOutput main(VertexShaderOutput input)
+{
+    PixelShaderOutput output;
+    output.color = input.color * gTexture.Sample(gSampler, input.texcoord);
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "SpriteInstanced.hlsli"
+
+struct SpriteInstance
+{
+    float32_t4x4 WVP;
+    float32_t4 color;
+    float32_t4 uvRect;
+    float32_t2 anchorPoint;
+    uint32_t flipFlags;
+    float padding;
+};
+StructuredBuffer<SpriteInstance> gSpriteInstances : register(t1);
+
+struct InstanceOffset
+{
+    uint32_t start;
+};
+ConstantBuffer<InstanceOffset> gInstanceOffset : register(b0);
+
+struct VertexShaderInput
+{
+    float32_t4 position : POSITION0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t3 normal : NORMAL0;
+};
+
+VertexShaderOutput main(VertexShaderInput input, uint32_t instanceId : SV_InstanceID)
+{
+    SpriteInstance instance = gSpriteInstances[gInstanceOffset.start + instanceId];
+
+    // アンカーとフリップを反映した頂点座標
+    float32_t2 local = input.position.xy - instance.anchorPoint;
+    if (instance.flipFlags & 1)
+    {
+        local.x = -local.x;
+    }
+    if (instance.flipFlags & 2)
+    {
+        local.y = -local.y;
+    }
+
+    VertexShaderOutput output;
+    output.position = mul(float32_t4(local, 0.0f, 1.0f), instance.WVP);
+    output.texcoord = lerp(instance.uvRect.xy, instance.uvRect.zw, input.texcoord);
+    output.color = instance.color;
+    return output;
+}
\ No newline at end of file
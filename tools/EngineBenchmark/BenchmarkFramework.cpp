@@ -0,0 +1,51 @@
+#include "BenchmarkFramework.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+	// 登録された計測
+	struct BenchmarkCase {
+		const char* name;
+		Benchmark::BenchmarkFunction function;
+	};
+
+	// 静的初期化の順番に依存しないように、関数の中で作る
+	std::vector<BenchmarkCase>& GetBenchmarkCases() {
+		static std::vector<BenchmarkCase> benchmarkCases;
+		return benchmarkCases;
+	}
+
+	// KeepResultで受け取った値の合計
+	volatile double keptResult = 0.0;
+}
+
+namespace Benchmark {
+
+	Registrar::Registrar(const char* name, BenchmarkFunction function) {
+		GetBenchmarkCases().push_back({ name, function });
+	}
+
+	int RunAll(const char* filter) {
+		int runCount = 0;
+		for (const BenchmarkCase& benchmarkCase : GetBenchmarkCases()) {
+			if (filter != nullptr && std::strstr(benchmarkCase.name, filter) == nullptr) {
+				continue;
+			}
+			std::printf("[ RUN ] %s\n", benchmarkCase.name);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			benchmarkCase.function();
+			double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			std::printf("[  END ] %s (%.1f ms)\n", benchmarkCase.name, milliseconds);
+			runCount++;
+		}
+		std::printf("%d benchmarks run\n", runCount);
+		return runCount;
+	}
+
+	void KeepResult(double value) {
+		keptResult = keptResult + value;
+	}
+}
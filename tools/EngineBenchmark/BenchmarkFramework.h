@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+// デバイスに依存しないエンジンの部分の処理速度を測る、小さな計測の仕組み
+// BENCHMARKで書いた計測は静的初期化で登録され、mainのRunAllでまとめて実行される
+// 結果は標準出力に書く（合否は無いので、正しさはEngineTestsで確かめる）
+namespace Benchmark {
+
+	// 計測の本体
+	using BenchmarkFunction = void(*)();
+
+	// 計測を登録する（BENCHMARKから使う）
+	struct Registrar {
+		Registrar(const char* name, BenchmarkFunction function);
+	};
+
+	// 名前にfilterを含む計測を全部実行して、実行した数を返す（nullptrなら全部）
+	int RunAll(const char* filter);
+
+	// 最適化で計算が消されないように、結果を受け取っておく
+	void KeepResult(double value);
+}
+
+// 計測を定義する
+#define BENCHMARK(name) \
+	static void name(); \
+	static Benchmark::Registrar name##Registrar(#name, &name); \
+	static void name()
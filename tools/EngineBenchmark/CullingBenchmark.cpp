@@ -0,0 +1,58 @@
+#include "BenchmarkFramework.h"
+#include "ViewCulling.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+using namespace Math;
+
+// カメラの周りにばらまいた球、AABB、矩形をカリングする時間
+BENCHMARK(ViewCullingCull) {
+	const uint32_t kCullingCounts[] = { 100000, 1000000 };
+
+	// ゲームのカメラと同じ位置と画角（1280x720）
+	const TransForm cameraTransform{ {1.0f,1.0f,1.0f},{0.0f,0.0f,0.0f} ,{0.0f,0.0f,-5.0f} };
+	ViewCulling::Frustum frustum = ViewCulling::MakeFrustum(Multiply(
+		Inverse(MakeAffineMatrix(cameraTransform.scale, cameraTransform.rotate, cameraTransform.translate)),
+		MakePerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f)));
+	const ViewCulling::Rect kScreenRect = { 0.0f, 0.0f, 1280.0f, 720.0f };
+
+	for (uint32_t cullingCount : kCullingCounts) {
+		std::mt19937 random(1213);
+		std::uniform_real_distribution<float> distribution(-50.0f, 50.0f);
+		std::uniform_real_distribution<float> sizeDistribution(0.1f, 2.0f);
+		std::uniform_real_distribution<float> screenDistribution(-2000.0f, 2000.0f);
+		ViewCulling culling;
+		for (uint32_t i = 0; i < cullingCount; ++i) {
+			Vector3 center = { distribution(random), distribution(random), distribution(random) };
+			float radius = sizeDistribution(random);
+			culling.AddSphere(center, radius);
+			culling.AddAABB({ center.x - radius, center.y - radius, center.z - radius },
+				{ center.x + radius, center.y + radius, center.z + radius });
+			float left = screenDistribution(random);
+			float top = screenDistribution(random);
+			culling.AddRect({ left, top, left + radius * 100.0f, top + radius * 100.0f });
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		culling.CullSpheres(frustum);
+		std::chrono::steady_clock::time_point sphereEnd = std::chrono::steady_clock::now();
+		culling.CullAABBs(frustum);
+		std::chrono::steady_clock::time_point aabbEnd = std::chrono::steady_clock::now();
+		culling.CullRects(kScreenRect);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+		uint32_t visibleSphereCount = static_cast<uint32_t>(culling.GetVisibleSpheres().size());
+		uint32_t visibleAABBCount = static_cast<uint32_t>(culling.GetVisibleAABBs().size());
+		uint32_t visibleRectCount = static_cast<uint32_t>(culling.GetVisibleRects().size());
+		std::printf("%7u Sphere : %.3f ms (visible %u / culled %u)\n", cullingCount,
+			std::chrono::duration<double, std::milli>(sphereEnd - start).count(),
+			visibleSphereCount, culling.GetSphereCount() - visibleSphereCount);
+		std::printf("%7u AABB   : %.3f ms (visible %u / culled %u)\n", cullingCount,
+			std::chrono::duration<double, std::milli>(aabbEnd - sphereEnd).count(),
+			visibleAABBCount, culling.GetAABBCount() - visibleAABBCount);
+		std::printf("%7u Rect   : %.3f ms (visible %u / culled %u)\n", cullingCount,
+			std::chrono::duration<double, std::milli>(end - aabbEnd).count(),
+			visibleRectCount, culling.GetRectCount() - visibleRectCount);
+	}
+}
@@ -0,0 +1,79 @@
+#include "BenchmarkFramework.h"
+#ifdef _WIN32
+#include <windows.h>
+#include "Logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 比べる元がOutputDebugStringAなので、Windowsだけで計測する
+namespace {
+
+	// threadCount個のスレッドで同時にlogFunctionをcallCount回ずつ呼び、1回の呼び出しにかかる時間を返す
+	// 全スレッドが揃ってから一斉に始め、それぞれのかかった時間を足す
+	template <typename LogFunction>
+	double MeasureLogCalls(uint32_t threadCount, uint32_t callCount, LogFunction logFunction) {
+		std::atomic<uint32_t> readyCount = 0;
+		std::atomic<uint64_t> totalNanoseconds = 0;
+		std::vector<std::thread> threads;
+		for (uint32_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
+			threads.emplace_back([&, threadIndex] {
+				readyCount.fetch_add(1);
+				while (readyCount.load() < threadCount) {
+					std::this_thread::yield();
+				}
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				for (uint32_t i = 0; i < callCount; ++i) {
+					logFunction(threadIndex, i);
+				}
+				totalNanoseconds.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start).count()));
+				});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		uint64_t totalCalls = uint64_t(callCount) * threadCount;
+		return totalCalls > 0 ? double(totalNanoseconds.load()) / double(totalCalls) : 0.0;
+	}
+}
+
+// 複数のスレッドで同時にログを出す（Log<>は自分のリングに積むだけで、書式化と出力はドレインのスレッドで行う）
+// 比べる元は書式化してOutputDebugStringAを呼ぶ今までのやり方（遅いので回数を減らす）
+BENCHMARK(LoggerAsyncVsSync) {
+	const uint32_t kThreadCounts[] = { 1, 4, 8, 16 };
+	const uint32_t kAsyncCalls = 2000;
+	const uint32_t kSyncCalls = 200;
+
+	// 出力先は付けない（ドレインのスレッドは動くが、どこにも書かない）
+	Logeer::Logger* logger = Logeer::Logger::GetInstance();
+	logger->Initialize();
+
+	for (uint32_t threadCount : kThreadCounts) {
+		uint64_t droppedBefore = logger->GetStatistics().droppedRecords;
+		double asyncNanoseconds = MeasureLogCalls(threadCount, kAsyncCalls, [](uint32_t threadIndex, uint32_t i) {
+			LOGEER_LOG(Logeer::Level::kInfo, Logeer::Category::kBenchmark, "thread {} call {} value {:.3f}", threadIndex, i, i * 0.5);
+			});
+		std::chrono::steady_clock::time_point flushStart = std::chrono::steady_clock::now();
+		logger->Flush();
+		double flushMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - flushStart).count();
+		uint64_t droppedRecords = logger->GetStatistics().droppedRecords - droppedBefore;
+
+		// 同期（呼んだスレッドで書式化して出力する）
+		double syncNanoseconds = MeasureLogCalls(threadCount, kSyncCalls, [](uint32_t threadIndex, uint32_t i) {
+			std::string line = std::format("thread {} call {} value {:.3f}\n", threadIndex, i, i * 0.5);
+			OutputDebugStringA(line.c_str());
+			});
+
+		std::printf("%2u threads : async %.1f ns per call (%u calls each, %llu dropped, flush %.3f ms), "
+			"OutputDebugStringA %.1f ns per call (%u calls each), x%.1f\n",
+			threadCount, asyncNanoseconds, kAsyncCalls, droppedRecords, flushMilliseconds,
+			syncNanoseconds, kSyncCalls, asyncNanoseconds > 0.0 ? syncNanoseconds / asyncNanoseconds : 0.0);
+	}
+	Logeer::Logger::Finalize();
+}
+#endif
@@ -0,0 +1,126 @@
+#include "BenchmarkFramework.h"
+#include "Mymath.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+#if MATH_USE_SIMD
+// 行列計算のスカラーとSSEの比較（SSEの結果をスカラーの結果とULPで比べる）
+BENCHMARK(MathScalarVsSimd) {
+	const uint32_t kMatrixCount = 100000;
+
+	// 逆行列が求まるようにアフィン変換行列を入力にする
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+	std::vector<Vector3> scales(kMatrixCount);
+	std::vector<Vector3> rotates(kMatrixCount);
+	std::vector<Vector3> translates(kMatrixCount);
+	std::vector<Matrix4x4> inputs(kMatrixCount);
+	for (uint32_t i = 0; i < kMatrixCount; ++i) {
+		scales[i] = { 0.5f + std::fabs(distribution(random)), 0.5f + std::fabs(distribution(random)), 0.5f + std::fabs(distribution(random)) };
+		rotates[i] = { distribution(random), distribution(random), distribution(random) };
+		translates[i] = { distribution(random), distribution(random), distribution(random) };
+		inputs[i] = Scalar::MakeAffineMatrix(scales[i], rotates[i], translates[i]);
+	}
+	std::vector<Matrix4x4> scalarResults(kMatrixCount);
+	std::vector<Matrix4x4> simdResults(kMatrixCount);
+
+	// 一つのカーネルをスカラーとSSEで計測して比べる
+	auto measure = [&](const char* name, auto scalarKernel, auto simdKernel) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < kMatrixCount; ++i) {
+			scalarResults[i] = scalarKernel(i);
+		}
+		std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < kMatrixCount; ++i) {
+			simdResults[i] = simdKernel(i);
+		}
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+		uint32_t maxUlpDistance = 0;
+		for (uint32_t i = 0; i < kMatrixCount; ++i) {
+			for (int row = 0; row < 4; ++row) {
+				for (int column = 0; column < 4; ++column) {
+					maxUlpDistance = (std::max)(maxUlpDistance,
+						UlpDistance(scalarResults[i].m[row][column], simdResults[i].m[row][column]));
+				}
+			}
+			Benchmark::KeepResult(simdResults[i].m[3][0]);
+		}
+		std::printf("%-8s : scalar %.2f M/s, sse %.2f M/s, max %u ulp\n", name,
+			kMatrixCount / std::chrono::duration<double>(middle - start).count() / 1000000.0,
+			kMatrixCount / std::chrono::duration<double>(end - middle).count() / 1000000.0, maxUlpDistance);
+	};
+
+	measure("Multiply",
+		[&](uint32_t i) { return Scalar::Multiply(inputs[i], inputs[(i + 1) % kMatrixCount]); },
+		[&](uint32_t i) { return Simd::Multiply(inputs[i], inputs[(i + 1) % kMatrixCount]); });
+	measure("Inverse",
+		[&](uint32_t i) { return Scalar::Inverse(inputs[i]); },
+		[&](uint32_t i) { return Simd::Inverse(inputs[i]); });
+	measure("Affine",
+		[&](uint32_t i) { return Scalar::MakeAffineMatrix(scales[i], rotates[i], translates[i]); },
+		[&](uint32_t i) { return Simd::MakeAffineMatrix(scales[i], rotates[i], translates[i]); });
+}
+#endif
+
+// 10000個のアニメーションを補間して行列にするまでの時間
+// オイラー角を補間して行列を作り直す場合と、クォータニオンで補間する場合
+BENCHMARK(QuaternionAnimation) {
+	const uint32_t kAnimationCount = 10000;
+
+	// キーフレームを2つずつ用意する
+	std::mt19937 random(91011);
+	std::uniform_real_distribution<float> distribution(-3.0f, 3.0f);
+	std::vector<Vector3> startRotates(kAnimationCount);
+	std::vector<Vector3> endRotates(kAnimationCount);
+	std::vector<Quaternion> startQuaternions(kAnimationCount);
+	std::vector<Quaternion> endQuaternions(kAnimationCount);
+	for (uint32_t i = 0; i < kAnimationCount; ++i) {
+		startRotates[i] = { distribution(random), distribution(random), distribution(random) };
+		endRotates[i] = { distribution(random), distribution(random), distribution(random) };
+		startQuaternions[i] = MakeRotateQuaternion(startRotates[i]);
+		endQuaternions[i] = MakeRotateQuaternion(endRotates[i]);
+	}
+	std::vector<Matrix4x4> animationMatrices(kAnimationCount);
+	const Vector3 kScale = { 1.0f,1.0f,1.0f };
+	const Vector3 kTranslate = { 0.0f,0.0f,0.0f };
+
+	// オイラー角を補間して回転行列から作り直す
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < kAnimationCount; ++i) {
+		float t = float(i) / kAnimationCount;
+		Vector3 rotate = {
+			startRotates[i].x + (endRotates[i].x - startRotates[i].x) * t,
+			startRotates[i].y + (endRotates[i].y - startRotates[i].y) * t,
+			startRotates[i].z + (endRotates[i].z - startRotates[i].z) * t };
+		animationMatrices[i] = Scalar::MakeAffineMatrix(kScale, rotate, kTranslate);
+	}
+	std::chrono::steady_clock::time_point eulerEnd = std::chrono::steady_clock::now();
+	Benchmark::KeepResult(animationMatrices[kAnimationCount - 1].m[0][0]);
+
+	// クォータニオンを球面線形補間して直接行列にする
+	for (uint32_t i = 0; i < kAnimationCount; ++i) {
+		float t = float(i) / kAnimationCount;
+		animationMatrices[i] = MakeAffineMatrixQuaternion(kScale, Slerp(startQuaternions[i], endQuaternions[i], t), kTranslate);
+	}
+	std::chrono::steady_clock::time_point slerpEnd = std::chrono::steady_clock::now();
+	Benchmark::KeepResult(animationMatrices[kAnimationCount - 1].m[0][0]);
+
+	// クォータニオンを正規化線形補間して直接行列にする
+	for (uint32_t i = 0; i < kAnimationCount; ++i) {
+		float t = float(i) / kAnimationCount;
+		animationMatrices[i] = MakeAffineMatrixQuaternion(kScale, Nlerp(startQuaternions[i], endQuaternions[i], t), kTranslate);
+	}
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	Benchmark::KeepResult(animationMatrices[kAnimationCount - 1].m[0][0]);
+
+	std::printf("Euler : %.3f ms\n", std::chrono::duration<double, std::milli>(eulerEnd - start).count());
+	std::printf("Slerp : %.3f ms\n", std::chrono::duration<double, std::milli>(slerpEnd - eulerEnd).count());
+	std::printf("Nlerp : %.3f ms\n", std::chrono::duration<double, std::milli>(end - slerpEnd).count());
+}
@@ -0,0 +1,173 @@
+#include "BenchmarkFramework.h"
+#ifdef _WIN32
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "MeshWelder.h"
+#include "ObjLoader.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// ObjLoaderとMeshFileはMappedFile（Win32のファイルマッピング）で読むので、Windowsだけで計測する
+namespace {
+
+	// 計測用のファイルを書き出す場所（計測の最後に消す）
+	std::string GetMeshBenchmarkDirectory() {
+		return (std::filesystem::temp_directory_path() / "meshBenchmark").generic_string();
+	}
+
+	// 格子状の四角形（v/vt/vn付き）のObjファイルを書き出す
+	// 戻り値は書いたバイト数
+	uint64_t WriteGridObjFile(const std::string& filePath, uint32_t grid) {
+		std::ofstream file(filePath, std::ios::binary);
+		char line[128];
+		for (uint32_t y = 0; y <= grid; ++y) {
+			for (uint32_t x = 0; x <= grid; ++x) {
+				file.write(line, std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n",
+					x * 0.01f, y * 0.01f, std::sin(x * 0.1f) * std::cos(y * 0.1f)));
+				file.write(line, std::snprintf(line, sizeof(line), "vt %.6f %.6f\n", float(x) / grid, float(y) / grid));
+			}
+		}
+		file << "vn 0.000000 0.000000 1.000000\n";
+		for (uint32_t y = 0; y < grid; ++y) {
+			for (uint32_t x = 0; x < grid; ++x) {
+				uint32_t index = y * (grid + 1) + x + 1;
+				file.write(line, std::snprintf(line, sizeof(line), "f %u/%u/1 %u/%u/1 %u/%u/1 %u/%u/1\n",
+					index, index, index + 1, index + 1, index + grid + 2, index + grid + 2, index + grid + 1, index + grid + 1));
+			}
+		}
+		return static_cast<uint64_t>(file.tellp());
+	}
+
+	// 一つのObjを、テキストから読む場合と焼いた.meshをマップする場合とで、
+	// 頂点とインデックスをバッファに詰めるまでを測る（GPUのバッファの代わりにメモリに詰める）
+	void MeasureMeshLoad(const std::string& directoryPath, const std::string& filename, ThreadPool* threadPool) {
+		std::string objPath = directoryPath + "/" + filename;
+		std::string meshPath = MeshFile::GetCookedFilePath(objPath);
+
+		// 焼いたファイルが無ければ先に焼いておく（ゲーム中はMeshCookerで焼いたものを使う）
+		if (!std::filesystem::exists(meshPath) && !MeshFile::CookObjFile(directoryPath, filename, threadPool)) {
+			std::printf("%s : cook failed\n", filename.c_str());
+			return;
+		}
+		uint64_t objBytes = std::filesystem::file_size(objPath);
+		uint64_t meshBytes = std::filesystem::file_size(meshPath);
+
+		// テキストから : 解析して頂点をまとめ、インデックスの幅を合わせて詰める
+		uint32_t triangleCount = 0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		{
+			ObjLoader::ModelData modelData = ObjLoader::LoadObjFile(directoryPath, filename, threadPool);
+			IndexedMesh mesh = MeshWelder::Weld(modelData.vertices);
+			std::vector<uint8_t> vertexBuffer(mesh.GetVertexBytes());
+			std::vector<uint8_t> indexBuffer(mesh.GetIndexBytes());
+			std::memcpy(vertexBuffer.data(), mesh.vertices.data(), mesh.GetVertexBytes());
+			mesh.WriteIndices(indexBuffer.data());
+			triangleCount = static_cast<uint32_t>(mesh.indices.size() / 3);
+			Benchmark::KeepResult(double(vertexBuffer.size() + indexBuffer.size()));
+		}
+		std::chrono::steady_clock::time_point objEnd = std::chrono::steady_clock::now();
+
+		// 焼いたものから : マップしてそのままコピーする
+		{
+			MeshFile meshFile;
+			if (!meshFile.Open(meshPath)) {
+				std::printf("%s : open failed\n", filename.c_str());
+				return;
+			}
+			std::vector<uint8_t> vertexBuffer(meshFile.GetVertexBytes());
+			std::vector<uint8_t> indexBuffer(meshFile.GetIndexBytes());
+			std::memcpy(vertexBuffer.data(), meshFile.GetVertexData(), meshFile.GetVertexBytes());
+			std::memcpy(indexBuffer.data(), meshFile.GetIndexData(), meshFile.GetIndexBytes());
+			Benchmark::KeepResult(double(vertexBuffer.size() + indexBuffer.size()));
+		}
+		std::chrono::steady_clock::time_point meshEnd = std::chrono::steady_clock::now();
+
+		double objMilliseconds = std::chrono::duration<double, std::milli>(objEnd - start).count();
+		double meshMilliseconds = std::chrono::duration<double, std::milli>(meshEnd - objEnd).count();
+		std::printf("%s : %u triangles, %.1f KB -> %.1f KB\n", filename.c_str(), triangleCount,
+			objBytes / 1024.0, meshBytes / 1024.0);
+		std::printf("  Obj : %.3f ms, Mesh : %.3f ms (x%.1f)\n", objMilliseconds, meshMilliseconds,
+			meshMilliseconds > 0.0 ? objMilliseconds / meshMilliseconds : 0.0);
+	}
+}
+
+// 生成した大きなObjファイルを1スレッドと並行で読み、頂点をまとめて並べ替える
+BENCHMARK(ObjLoaderLoad) {
+	const uint32_t kObjGridCounts[] = { 1024, 2048 };
+	const std::string directoryPath = GetMeshBenchmarkDirectory();
+	const std::string filename = "objLoaderBenchmark.obj";
+	std::filesystem::create_directories(directoryPath);
+
+	ThreadPool threadPool;
+	threadPool.Initialize(ThreadPool::GetDefaultThreadCount());
+
+	for (uint32_t grid : kObjGridCounts) {
+		uint64_t objBytes = WriteGridObjFile(directoryPath + "/" + filename, grid);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		ObjLoader::ModelData singleModel = ObjLoader::LoadObjFile(directoryPath, filename);
+		std::chrono::steady_clock::time_point singleEnd = std::chrono::steady_clock::now();
+		ObjLoader::ModelData parallelModel = ObjLoader::LoadObjFile(directoryPath, filename, &threadPool);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		double singleMilliseconds = std::chrono::duration<double, std::milli>(singleEnd - start).count();
+		double parallelMilliseconds = std::chrono::duration<double, std::milli>(end - singleEnd).count();
+
+		// 同じ頂点をまとめてインデックスバッファを作る
+		MeshWelder::Report weldReport;
+		IndexedMesh mesh = MeshWelder::Weld(parallelModel.vertices, &weldReport);
+
+		// 頂点キャッシュに合わせて並べ替える
+		MeshOptimizer::Report optimizeReport = MeshOptimizer::Optimize(mesh);
+
+		double objMegabytes = objBytes / (1024.0 * 1024.0);
+		std::printf("%ux%u : %.1f MB, %zu triangles\n", grid, grid, objMegabytes, parallelModel.vertices.size() / 3);
+		std::printf("  1T : %.3f ms (%.1f MB/s)\n", singleMilliseconds,
+			singleMilliseconds > 0.0 ? objMegabytes / (singleMilliseconds / 1000.0) : 0.0);
+		std::printf("  %uT : %.3f ms (%.1f MB/s)%s\n", threadPool.GetThreadCount() + 1, parallelMilliseconds,
+			parallelMilliseconds > 0.0 ? objMegabytes / (parallelMilliseconds / 1000.0) : 0.0,
+			singleModel.vertices.size() == parallelModel.vertices.size() ? "" : " (MISMATCH)");
+		std::printf("  Weld : %u -> %u vertices (x%.2f), %u-bit indices, %.3f ms\n",
+			weldReport.inputVertexCount, weldReport.outputVertexCount, weldReport.GetReductionRatio(),
+			weldReport.indexStride * 8, weldReport.milliseconds);
+		std::printf("  Memory : %.1f MB -> %.1f MB (saved %.1f MB)\n",
+			weldReport.inputBytes / (1024.0 * 1024.0), weldReport.outputBytes / (1024.0 * 1024.0),
+			weldReport.GetSavedBytes() / (1024.0 * 1024.0));
+		std::printf("  ACMR : %.3f -> %.3f, ATVR : %.3f -> %.3f (FIFO %u)\n",
+			optimizeReport.before.acmr, optimizeReport.after.acmr,
+			optimizeReport.before.atvr, optimizeReport.after.atvr, MeshOptimizer::kDefaultCacheSize);
+		std::printf("  Optimize : %.3f ms (%u clusters)\n", optimizeReport.milliseconds, optimizeReport.clusterCount);
+	}
+	std::filesystem::remove_all(directoryPath);
+}
+
+// 焼いたメッシュの読み込み速度（生成した約100万三角形のメッシュと、resourcesにあるObj）
+BENCHMARK(MeshFileLoad) {
+	const uint32_t kMeshFileGrid = 708; // 708x708の四角形で約100万三角形
+	const std::string directoryPath = GetMeshBenchmarkDirectory();
+	const std::string filename = "meshFileBenchmark.obj";
+	std::filesystem::create_directories(directoryPath);
+
+	ThreadPool threadPool;
+	threadPool.Initialize(ThreadPool::GetDefaultThreadCount());
+
+	WriteGridObjFile(directoryPath + "/" + filename, kMeshFileGrid);
+	MeasureMeshLoad(directoryPath, filename, &threadPool);
+	std::filesystem::remove_all(directoryPath);
+
+	// resourcesにあるObjは、焼いたものが無ければ隣に焼く（MeshCookerと同じ）
+	if (std::filesystem::is_directory("resources")) {
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator("resources")) {
+			if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+				MeasureMeshLoad("resources", entry.path().filename().string(), &threadPool);
+			}
+		}
+	}
+}
+#endif
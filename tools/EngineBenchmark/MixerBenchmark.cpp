@@ -0,0 +1,106 @@
+#include "BenchmarkFramework.h"
+#include "AudioMixer.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+	// ソフトウェアミキサーの計測結果
+	struct MixerBenchmarkResult {
+		uint32_t voiceCount = 0;
+		double audioMilliseconds = 0.0;    // 混ぜた音声の長さ
+		double cpuMilliseconds = 0.0;      // 混ぜるのにかかった時間
+		double voicesPerMillisecond = 0.0; // 1ミリ秒で混ぜられる48kHzのボイス数（ボイス1つの1ミリ秒分を1と数える）
+	};
+
+	// 形式もサンプリングレートも違う合成した正弦波をvoiceCount個ループで鳴らし、
+	// 出力先の無いミキサーで約1秒分を混ぜる時間を測る
+	MixerBenchmarkResult RunMixerBenchmark(AudioMixer::Resampler resampler, uint32_t voiceCount) {
+
+		// PCM16ステレオ44.1kHz、PCM24モノラル32kHz、floatステレオ22.05kHz
+		struct SourceSetting {
+			uint16_t formatTag;
+			uint16_t channelCount;
+			uint32_t sampleRate;
+			uint16_t bitsPerSample;
+		};
+		const SourceSetting settings[] = {
+			{ WaveFile::kFormatPcm, 2, 44100, 16 },
+			{ WaveFile::kFormatPcm, 1, 32000, 24 },
+			{ WaveFile::kFormatFloat, 2, 22050, 32 },
+		};
+		std::vector<AudioMixer::Source> sources;
+		for (const SourceSetting& setting : settings) {
+			AudioMixer::Source& source = sources.emplace_back();
+			source.format.formatTag = setting.formatTag;
+			source.format.channelCount = setting.channelCount;
+			source.format.sampleRate = setting.sampleRate;
+			source.format.bitsPerSample = setting.bitsPerSample;
+			source.format.blockAlign = uint16_t(setting.channelCount * setting.bitsPerSample / 8);
+			source.format.byteRate = setting.sampleRate * source.format.blockAlign;
+
+			// 1秒の440Hz
+			std::shared_ptr<std::vector<uint8_t>> data =
+				std::make_shared<std::vector<uint8_t>>(size_t(setting.sampleRate) * source.format.blockAlign);
+			uint8_t* out = data->data();
+			for (uint32_t i = 0; i < setting.sampleRate * setting.channelCount; ++i) {
+				float value = 0.5f * std::sin(6.2831853f * 440.0f * float(i / setting.channelCount) / setting.sampleRate);
+				if (setting.bitsPerSample == 16) {
+					int16_t sample = int16_t(value * 32767.0f);
+					std::memcpy(out, &sample, sizeof(sample));
+				} else if (setting.bitsPerSample == 24) {
+					int32_t sample = int32_t(value * 8388607.0f);
+					out[0] = uint8_t(sample);
+					out[1] = uint8_t(sample >> 8);
+					out[2] = uint8_t(sample >> 16);
+				} else {
+					std::memcpy(out, &value, sizeof(value));
+				}
+				out += setting.bitsPerSample / 8;
+			}
+			source.data = data->data();
+			source.size = uint32_t(data->size());
+			source.owner = data;
+		}
+
+		AudioMixer mixer;
+		mixer.Initialize();
+		mixer.SetResampler(resampler);
+		for (uint32_t i = 0; i < voiceCount; ++i) {
+			float pan = voiceCount > 1 ? float(i) / float(voiceCount - 1) * 2.0f - 1.0f : 0.0f;
+			mixer.Play(sources[i % sources.size()], 1.0f / float(voiceCount), pan, true);
+		}
+
+		// 約1秒分のブロックを一度に受け取る出力先
+		NullAudioSink sink;
+		sink.SetWritableBlockCount(mixer.GetSampleRate() / mixer.GetBlockFrames());
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		mixer.Render(&sink);
+		double cpuMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		Benchmark::KeepResult(sink.GetPeak());
+
+		MixerBenchmarkResult result;
+		result.voiceCount = voiceCount;
+		result.audioMilliseconds = double(sink.GetWrittenFrames()) * 1000.0 / mixer.GetSampleRate();
+		result.cpuMilliseconds = cpuMilliseconds;
+		result.voicesPerMillisecond = cpuMilliseconds > 0.0 ? voiceCount * result.audioMilliseconds / cpuMilliseconds : 0.0;
+		return result;
+	}
+}
+
+// 出力先の無いミキサーでの計測（48kHz、1024フレームのブロック）
+BENCHMARK(MixerVoicesPerMillisecond) {
+	const AudioMixer::Resampler resamplers[] = { AudioMixer::Resampler::kLinear, AudioMixer::Resampler::kSinc };
+	const char* resamplerNames[] = { "Linear", "Sinc" };
+	const uint32_t voiceCounts[] = { 1, 16, 64, AudioMixer::kMaxVoices };
+	for (uint32_t i = 0; i < 2; ++i) {
+		for (uint32_t voiceCount : voiceCounts) {
+			MixerBenchmarkResult result = RunMixerBenchmark(resamplers[i], voiceCount);
+			std::printf("%-6s : %3u voices, %.0f ms of audio in %.3f ms, %.0f voices per ms\n",
+				resamplerNames[i], result.voiceCount, result.audioMilliseconds, result.cpuMilliseconds,
+				result.voicesPerMillisecond);
+		}
+	}
+}
@@ -0,0 +1,127 @@
+#include "BenchmarkFramework.h"
+#ifdef _WIN32
+#include "Audio.h"
+#include "SoundBank.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// SoundBankはMappedFile（Win32のファイルマッピング）でマップするので、Windowsだけで計測する
+namespace {
+
+	// 減衰する正弦波のPCM16モノラルのWAVファイルを書き出す
+	// 戻り値は書いたバイト数
+	uint64_t WriteToneWaveFile(const std::string& filePath, uint32_t sampleRate, uint32_t frameCount, float frequency) {
+		WaveFile::Format format = {};
+		format.formatTag = WaveFile::kFormatPcm;
+		format.channelCount = 1;
+		format.sampleRate = sampleRate;
+		format.blockAlign = 2;
+		format.byteRate = sampleRate * format.blockAlign;
+		format.bitsPerSample = 16;
+		uint32_t dataSize = frameCount * format.blockAlign;
+		uint32_t formatSize = 16;
+		uint32_t riffSize = 4 + (8 + formatSize) + (8 + dataSize);
+
+		std::vector<int16_t> samples(frameCount);
+		for (uint32_t i = 0; i < frameCount; ++i) {
+			float time = float(i) / sampleRate;
+			samples[i] = int16_t(12000.0f * std::exp(-6.0f * time) * std::sin(6.2831853f * frequency * time));
+		}
+
+		std::ofstream file(filePath, std::ios::binary);
+		file.write("RIFF", 4);
+		file.write(reinterpret_cast<const char*>(&riffSize), sizeof(riffSize));
+		file.write("WAVEfmt ", 8);
+		file.write(reinterpret_cast<const char*>(&formatSize), sizeof(formatSize));
+		file.write(reinterpret_cast<const char*>(&format), formatSize);
+		file.write("data", 4);
+		file.write(reinterpret_cast<const char*>(&dataSize), sizeof(dataSize));
+		file.write(reinterpret_cast<const char*>(samples.data()), dataSize);
+		return static_cast<uint64_t>(file.tellp());
+	}
+}
+
+// 500個の短い効果音のWAVを書き出し、1ファイルずつ読む場合とバンクにまとめてマップする場合を比べる
+// 書いた直後なのでどちらもファイルはOSのキャッシュに載っている。書いたファイルは最後に消す
+BENCHMARK(SoundBankLoad) {
+	const uint32_t kSoundCount = 500;
+	const std::string directoryPath = (std::filesystem::temp_directory_path() / "soundBankBenchmark").generic_string();
+
+	// 0.1秒から0.5秒の長さで音程の違う効果音
+	std::filesystem::create_directories(directoryPath);
+	std::vector<SoundBank::SourceFile> sources(kSoundCount);
+	uint64_t sourceBytes = 0;
+	for (uint32_t i = 0; i < kSoundCount; ++i) {
+		char name[32];
+		std::snprintf(name, sizeof(name), "se_%03u.wav", i);
+		sources[i].name = name;
+		sources[i].filePath = directoryPath + "/" + name;
+		uint32_t frameCount = 4410 + (i % 5) * 4410;
+		sourceBytes += WriteToneWaveFile(sources[i].filePath, 44100, frameCount, 220.0f * std::pow(2.0f, float(i % 48) / 12.0f));
+	}
+
+	std::string bankPath = directoryPath + "/soundBankBenchmark.sbank";
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	bool isBuilt = SoundBank::Build(bankPath, sources);
+	double cookMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	if (!isBuilt) {
+		std::printf("build failed\n");
+		std::filesystem::remove_all(directoryPath);
+		return;
+	}
+
+	// 1ファイルずつ読む（全部の波形がヒープに常駐する）
+	start = std::chrono::steady_clock::now();
+	std::vector<SoundData> loadedSounds(kSoundCount);
+	uint64_t fileHeapBytes = 0;
+	for (uint32_t i = 0; i < kSoundCount; ++i) {
+		loadedSounds[i] = Audio::LoadWave(sources[i].filePath);
+		fileHeapBytes += loadedSounds[i].bufferSize;
+	}
+	double fileLoadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	for (SoundData& soundData : loadedSounds) {
+		Audio::UnloadWave(&soundData);
+	}
+
+	// バンクを開いて全部の名前を引く（波形には触らない）
+	SoundBank soundBank;
+	start = std::chrono::steady_clock::now();
+	bool isOpened = soundBank.Open(bankPath);
+	std::chrono::steady_clock::time_point lookupStart = std::chrono::steady_clock::now();
+	std::vector<SoundData> bankSounds(kSoundCount);
+	for (uint32_t i = 0; i < kSoundCount && isOpened; ++i) {
+		bankSounds[i] = soundBank.GetSound(sources[i].name);
+	}
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	double bankOpenMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+	double bankLookupNanoseconds = std::chrono::duration<double, std::nano>(end - lookupStart).count() / kSoundCount;
+	uint64_t bankBytes = soundBank.GetFileSize();
+	uint64_t bankResidentBytes = soundBank.GetResidentSize();
+
+	// 全部の波形に触ると、触ったページだけが載る（再生したときと同じ）
+	uint32_t touchedSum = 0;
+	for (const SoundData& soundData : bankSounds) {
+		for (uint32_t offset = 0; offset < soundData.bufferSize; offset += 64) {
+			touchedSum += soundData.pBuffer[offset];
+		}
+	}
+	Benchmark::KeepResult(double(touchedSum));
+	uint64_t touchedResidentBytes = soundBank.GetResidentSize();
+
+	std::printf("%u sounds : %.1f KB of wav -> %.1f KB bank (cook %.1f ms)\n",
+		kSoundCount, sourceBytes / 1024.0, bankBytes / 1024.0, cookMilliseconds);
+	std::printf("Per file : %.3f ms, %.1f KB resident on the heap\n", fileLoadMilliseconds, fileHeapBytes / 1024.0);
+	std::printf("Bank     : %.3f ms (%.0f ns per lookup), %.1f KB resident, %.1f KB after touching all%s\n",
+		bankOpenMilliseconds, bankLookupNanoseconds, bankResidentBytes / 1024.0, touchedResidentBytes / 1024.0,
+		isOpened ? "" : " (open failed)");
+
+	// マップを外してから消す
+	soundBank.Close();
+	std::filesystem::remove_all(directoryPath);
+}
+#endif
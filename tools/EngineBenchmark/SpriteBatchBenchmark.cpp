@@ -0,0 +1,40 @@
+#include "BenchmarkFramework.h"
+#include "SpriteBatch.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+// 座標変換済みのスプライトを集めて、テクスチャ順の頂点列を作る速さ（GPUは使わない）
+BENCHMARK(SpriteBatchBuild) {
+	const uint32_t kSpriteCounts[] = { 1000, 10000, 100000 };
+	const uint32_t kTextureCount = 16;
+
+	std::mt19937 random(1415);
+	std::uniform_real_distribution<float> distribution(0.0f, 1280.0f);
+	std::uniform_int_distribution<uint32_t> textureDistribution(0, kTextureCount - 1);
+	SpriteBatch spriteBatch;
+	for (uint32_t spriteCount : kSpriteCounts) {
+
+		// テクスチャがばらばらに並んだスプライトを追加する
+		spriteBatch.Begin();
+		for (uint32_t i = 0; i < spriteCount; ++i) {
+			float left = distribution(random);
+			float top = distribution(random);
+			const SpriteBatch::VertexData vertices[SpriteBatch::kVertexPerSprite] = {
+				{ { left, top + 32.0f, 0.0f, 1.0f }, { 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } },
+				{ { left, top, 0.0f, 1.0f }, { 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
+				{ { left + 32.0f, top + 32.0f, 0.0f, 1.0f }, { 1.0f, 1.0f }, { 0.0f, 0.0f, -1.0f } },
+				{ { left + 32.0f, top, 0.0f, 1.0f }, { 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } },
+			};
+			spriteBatch.Submit(textureDistribution(random), { 1.0f, 1.0f, 1.0f, 1.0f }, vertices);
+		}
+		spriteBatch.End();
+		Benchmark::KeepResult(spriteBatch.GetVertices().back().position.x);
+
+		std::printf("%6u sprites : %.3f ms (%.1f sprites/ms), %u runs\n", spriteCount,
+			spriteBatch.GetBuildMilliseconds(), spriteBatch.GetSpritesPerMillisecond(),
+			static_cast<uint32_t>(spriteBatch.GetRuns().size()));
+	}
+}
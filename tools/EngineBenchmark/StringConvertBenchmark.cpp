@@ -0,0 +1,117 @@
+#include "BenchmarkFramework.h"
+#include "UtfConverter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include "StringUtility.h"
+#endif
+
+namespace {
+
+	// 文字コード変換の計測結果（1つの文字列について）
+	struct StringConvertBenchmarkResult {
+		uint64_t utf8Bytes = 0;                  // 変換元のバイト数
+		double win32GigabytesPerSecond = 0.0;    // MultiByteToWideCharを2回呼んで確保する今までのやり方（Windowsだけ）
+		double utf8To16GigabytesPerSecond = 0.0; // UtfConverterで用意した出力先に書く
+		double utf16To8GigabytesPerSecond = 0.0; // 戻す向き（UTF-16のバイト数で数える）
+		bool isMatched = false;                  // 元に戻ったか（WindowsではWin32の結果とも一致したか）
+	};
+
+	// text（UTF-8）をrepeatCount回変換する速さを、UtfConverterと（WindowsではWin32のAPIと）で比べる
+	StringConvertBenchmarkResult RunStringConvertBenchmark(const std::string& text, uint32_t repeatCount) {
+		StringConvertBenchmarkResult result;
+		result.utf8Bytes = text.size();
+		double totalBytes = double(text.size()) * repeatCount;
+
+		// 上限の長さの出力先を一度だけ用意して使い回す
+		std::vector<char16_t> utf16(UtfConverter::GetMaxUtf16Length(text.size()));
+		UtfConverter::Result converted = {};
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < repeatCount; ++i) {
+			converted = UtfConverter::Utf8ToUtf16(text.data(), text.size(), utf16.data(), utf16.size());
+		}
+		double utf8To16Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::vector<char> utf8(UtfConverter::GetMaxUtf8Length(converted.written));
+		UtfConverter::Result restored = {};
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < repeatCount; ++i) {
+			restored = UtfConverter::Utf16ToUtf8(utf16.data(), converted.written, utf8.data(), utf8.size());
+		}
+		double utf16To8Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		result.utf8To16GigabytesPerSecond = utf8To16Seconds > 0.0 ? totalBytes / utf8To16Seconds / 1e9 : 0.0;
+		result.utf16To8GigabytesPerSecond = utf16To8Seconds > 0.0 ?
+			double(converted.written) * sizeof(char16_t) * repeatCount / utf16To8Seconds / 1e9 : 0.0;
+		result.isMatched = restored.written == text.size() && std::memcmp(utf8.data(), text.data(), text.size()) == 0;
+		Benchmark::KeepResult(double(converted.written + restored.written));
+
+#ifdef _WIN32
+		// 今までのConvertStringと同じ（長さを聞いてから確保して変換する）
+		int textLength = static_cast<int>(text.size());
+		std::wstring win32Text;
+		start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < repeatCount; ++i) {
+			int sizeNeeded = MultiByteToWideChar(CP_UTF8, 0, text.data(), textLength, nullptr, 0);
+			win32Text = std::wstring(sizeNeeded, 0);
+			MultiByteToWideChar(CP_UTF8, 0, text.data(), textLength, win32Text.data(), sizeNeeded);
+		}
+		double win32Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.win32GigabytesPerSecond = win32Seconds > 0.0 ? totalBytes / win32Seconds / 1e9 : 0.0;
+		result.isMatched = result.isMatched && converted.written == win32Text.size() &&
+			std::memcmp(utf16.data(), win32Text.data(), converted.written * sizeof(char16_t)) == 0;
+#endif
+		return result;
+	}
+}
+
+// 1MBの文字列を20回変換する（ASCIIだけのパスと、日本語を含むパスを繰り返したもの）
+BENCHMARK(StringConvertGigabytesPerSecond) {
+	const char* const corpusNames[] = { "ASCII", "Japanese" };
+	const char* const paths[] = { "resources/textures/uvChecker.png;", "resources/テクスチャ/地面_01.png;" };
+	for (uint32_t i = 0; i < 2; ++i) {
+		std::string text;
+		while (text.size() < 1024 * 1024) {
+			text += paths[i];
+		}
+		StringConvertBenchmarkResult result = RunStringConvertBenchmark(text, 20);
+		std::printf("%-8s (%.1f MB) : UTF-8 -> 16 %.2f GB/s, UTF-16 -> 8 %.2f GB/s",
+			corpusNames[i], result.utf8Bytes / (1024.0 * 1024.0),
+			result.utf8To16GigabytesPerSecond, result.utf16To8GigabytesPerSecond);
+#ifdef _WIN32
+		std::printf(", Win32 %.2f GB/s", result.win32GigabytesPerSecond);
+#endif
+		std::printf(" %s\n", result.isMatched ? "" : "(MISMATCH)");
+	}
+}
+
+#ifdef _WIN32
+// 短いパス1つ（今までのConvertStringと、確保しないConvertString）
+BENCHMARK(StringConvertShortPath) {
+	const std::string shortPath = "resources/uvChecker.png";
+	const uint32_t kShortPathCount = 100000;
+	StringUtility::WideStringBuffer wShortPath;
+	size_t totalLength = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < kShortPathCount; ++i) {
+		int sizeNeeded = MultiByteToWideChar(CP_UTF8, 0, shortPath.data(), static_cast<int>(shortPath.size()), nullptr, 0);
+		std::wstring wide(sizeNeeded, 0);
+		MultiByteToWideChar(CP_UTF8, 0, shortPath.data(), static_cast<int>(shortPath.size()), wide.data(), sizeNeeded);
+		totalLength += wide.size();
+	}
+	double win32Nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kShortPathCount;
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < kShortPathCount; ++i) {
+		StringUtility::ConvertString(shortPath, wShortPath);
+		totalLength += wShortPath.GetSize();
+	}
+	double bufferNanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kShortPathCount;
+	Benchmark::KeepResult(double(totalLength));
+	std::printf("Short path : Win32 + wstring %.1f ns, buffer %.1f ns %s\n", win32Nanoseconds, bufferNanoseconds,
+		totalLength == shortPath.size() * kShortPathCount * 2 ? "" : "(MISMATCH)");
+}
+#endif
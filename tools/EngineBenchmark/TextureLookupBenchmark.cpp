@@ -0,0 +1,46 @@
+#include "BenchmarkFramework.h"
+#include "TexturePathTable.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// 4096枚のテクスチャに対して10万枚のスプライトがテクスチャを引く時間を比べる
+BENCHMARK(TextureLookup) {
+	const uint32_t kTextureCount = 4096;
+	const uint32_t kSpriteCount = 100000;
+
+	// 計測用のパスを作る
+	std::vector<std::string> texturePaths;
+	TexturePathTable texturePathTable;
+	for (uint32_t i = 0; i < kTextureCount; ++i) {
+		texturePaths.push_back("resources/texture_" + std::to_string(i) + ".png");
+		texturePathTable.Insert(texturePaths.back(), i);
+	}
+
+	// 全パスと文字列で比べる（LoadTextureとGetTextureIndexByFilePathで2回引いていた）
+	uint64_t linearChecksum = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < kSpriteCount; ++i) {
+		const std::string& filePath = texturePaths[(i * 7919u) % kTextureCount];
+		for (uint32_t j = 0; j < 2; ++j) {
+			auto it = std::find_if(texturePaths.begin(), texturePaths.end(),
+				[&filePath](const std::string& path) { return path == filePath; });
+			linearChecksum += std::distance(texturePaths.begin(), it);
+		}
+	}
+	std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+
+	// 表から1回だけ引く
+	uint64_t hashedChecksum = 0;
+	for (uint32_t i = 0; i < kSpriteCount; ++i) {
+		const std::string& filePath = texturePaths[(i * 7919u) % kTextureCount];
+		hashedChecksum += texturePathTable.Find(filePath) * 2ull;
+	}
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	std::printf("find_if : %.3f ms\n", std::chrono::duration<double, std::milli>(middle - start).count());
+	std::printf("Table   : %.3f ms (match %s)\n", std::chrono::duration<double, std::milli>(end - middle).count(),
+		linearChecksum == hashedChecksum ? "yes" : "no");
+}
@@ -0,0 +1,60 @@
+#include "BenchmarkFramework.h"
+#include "ThreadPool.h"
+#include "TransformSystem.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+// 座標変換を一つずつ計算する場合と、TransformSystemでまとめて計算する場合の比較
+BENCHMARK(TransformSystemUpdate) {
+	const uint32_t kTransformCounts[] = { 10000, 100000, 1000000 };
+
+	ThreadPool threadPool;
+	threadPool.Initialize(ThreadPool::GetDefaultThreadCount());
+
+	// ゲームのカメラと同じ位置と画角（1280x720）
+	const TransForm cameraTransform{ {1.0f,1.0f,1.0f},{0.0f,0.0f,0.0f} ,{0.0f,0.0f,-5.0f} };
+	Matrix4x4 viewProjection = Multiply(
+		Inverse(MakeAffineMatrix(cameraTransform.scale, cameraTransform.rotate, cameraTransform.translate)),
+		MakePerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f));
+
+	for (uint32_t transformCount : kTransformCounts) {
+		std::mt19937 random(5678);
+		std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+		TransformSystem transformSystem;
+		transformSystem.Reserve(transformCount);
+		for (uint32_t i = 0; i < transformCount; ++i) {
+			transformSystem.Add({ {1.0f,1.0f,1.0f},
+				{ distribution(random), distribution(random), distribution(random) },
+				{ distribution(random), distribution(random), distribution(random) } });
+		}
+		std::vector<TransformSystem::TransformationMatrix> transformOutputs(transformCount);
+
+		// 今までと同じく一つずつMakeAffineMatrixとMultiplyで計算する
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < transformCount; ++i) {
+			TransForm objectTransform = transformSystem.GetTransform(i);
+			transformOutputs[i].World = MakeAffineMatrix(objectTransform.scale, objectTransform.rotate, objectTransform.translate);
+			transformOutputs[i].WVP = Multiply(transformOutputs[i].World, viewProjection);
+		}
+		std::chrono::steady_clock::time_point perObjectEnd = std::chrono::steady_clock::now();
+
+		// SoAで4つずつ計算する
+		transformSystem.Update(viewProjection, transformOutputs.data());
+		std::chrono::steady_clock::time_point singleEnd = std::chrono::steady_clock::now();
+
+		// さらに塊ごとにワーカーで並行に計算する
+		transformSystem.Update(viewProjection, transformOutputs.data(), &threadPool);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		Benchmark::KeepResult(transformOutputs.back().WVP.m[3][0]);
+
+		std::printf("%7u : PerObject %.3f ms, SoA 1T %.3f ms, SoA %uT %.3f ms\n", transformCount,
+			std::chrono::duration<double, std::milli>(perObjectEnd - start).count(),
+			std::chrono::duration<double, std::milli>(singleEnd - perObjectEnd).count(),
+			threadPool.GetThreadCount() + 1,
+			std::chrono::duration<double, std::milli>(end - singleEnd).count());
+	}
+}
@@ -0,0 +1,8 @@
+#include "BenchmarkFramework.h"
+
+// 引数を渡すと、名前にその文字列を含む計測だけを実行する
+// リソースを読む計測があるので、リポジトリの直下で実行する
+int main(int argc, char* argv[]) {
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+	return Benchmark::RunAll(filter) > 0 ? 0 : 1;
+}
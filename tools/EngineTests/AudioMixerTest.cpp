@@ -0,0 +1,224 @@
+#include "TestFramework.h"
+#include "AudioMixer.h"
+#include <cstring>
+#include <vector>
+
+namespace {
+
+	// 合成した音声（鳴らしている間は持っておく）
+	struct SyntheticSource {
+		std::vector<uint8_t> data;
+		AudioMixer::Source source;
+	};
+
+	// 形式を設定する
+	WaveFile::Format MakeFormat(uint16_t formatTag, uint16_t channelCount, uint32_t sampleRate, uint16_t bitsPerSample) {
+		WaveFile::Format format = {};
+		format.formatTag = formatTag;
+		format.channelCount = channelCount;
+		format.sampleRate = sampleRate;
+		format.bitsPerSample = bitsPerSample;
+		format.blockAlign = uint16_t(channelCount * bitsPerSample / 8);
+		format.byteRate = sampleRate * format.blockAlign;
+		return format;
+	}
+
+	// floatの波形（チャンネルは交互に並べる）から音声を作る
+	void MakeFloatSource(SyntheticSource& synthetic, uint16_t channelCount, uint32_t sampleRate, const std::vector<float>& samples) {
+		synthetic.data.resize(samples.size() * sizeof(float));
+		std::memcpy(synthetic.data.data(), samples.data(), synthetic.data.size());
+		synthetic.source.format = MakeFormat(WaveFile::kFormatFloat, channelCount, sampleRate, 32);
+		synthetic.source.data = synthetic.data.data();
+		synthetic.source.size = uint32_t(synthetic.data.size());
+	}
+
+	// frequencyの正弦波（モノラル）
+	std::vector<float> MakeSine(uint32_t sampleRate, uint32_t frameCount, float frequency, float amplitude) {
+		std::vector<float> samples(frameCount);
+		for (uint32_t i = 0; i < frameCount; ++i) {
+			samples[i] = amplitude * std::sin(6.2831853f * frequency * float(i) / float(sampleRate));
+		}
+		return samples;
+	}
+
+	// 左右交互の出力のうち、start以降の最大振幅
+	float GetPeak(const std::vector<float>& output, size_t start) {
+		float peak = 0.0f;
+		for (size_t i = start; i < output.size(); ++i) {
+			peak = (std::max)(peak, std::fabs(output[i]));
+		}
+		return peak;
+	}
+
+	const float kHalfPower = 0.70710678f;
+}
+
+// 出力先が受け取れるだけブロックを渡し、鳴らしていなければ無音
+TEST_CASE(AudioMixerRendersSilenceToNullSink) {
+	AudioMixer mixer;
+	mixer.Initialize(48000, 256);
+	NullAudioSink sink;
+	sink.SetWritableBlockCount(3);
+	mixer.Render(&sink);
+	CHECK(sink.GetWrittenFrames() == 3 * 256);
+	CHECK(sink.GetPeak() == 0.0f);
+	CHECK(mixer.GetMixedFrames() == 3 * 256);
+	CHECK(mixer.GetMixedVoiceBlocks() == 0);
+}
+
+// 同じレートのモノラルは中央で左右に1/√2ずつ、そのまま混ざる
+TEST_CASE(AudioMixerMixesMonoAtCenter) {
+	std::vector<float> samples(128);
+	for (uint32_t i = 0; i < samples.size(); ++i) {
+		samples[i] = float(i) / 128.0f - 0.5f;
+	}
+	SyntheticSource synthetic;
+	MakeFloatSource(synthetic, 1, 48000, samples);
+
+	AudioMixer mixer;
+	mixer.Initialize(48000, 64);
+	uint32_t handle = mixer.Play(synthetic.source, 1.0f, 0.0f, false);
+	CHECK(handle != AudioMixer::kInvalidHandle);
+
+	std::vector<float> output(64 * 2);
+	mixer.Mix(output.data(), 64);
+	bool isMatched = true;
+	for (uint32_t i = 0; i < 64; ++i) {
+		isMatched = isMatched && std::fabs(output[i * 2] - samples[i] * kHalfPower) < 1e-6f;
+		isMatched = isMatched && std::fabs(output[i * 2 + 1] - samples[i] * kHalfPower) < 1e-6f;
+	}
+	CHECK(isMatched);
+}
+
+// PCM16/PCM24のステレオは左右をそのまま読み、右に振ると左だけ絞る
+TEST_CASE(AudioMixerDecodesPcmStereo) {
+	const int16_t pcm16[] = { 16384, -8192, 16384, -8192, 16384, -8192, 16384, -8192 };
+	SyntheticSource synthetic16;
+	synthetic16.data.resize(sizeof(pcm16));
+	std::memcpy(synthetic16.data.data(), pcm16, sizeof(pcm16));
+	synthetic16.source.format = MakeFormat(WaveFile::kFormatPcm, 2, 48000, 16);
+	synthetic16.source.data = synthetic16.data.data();
+	synthetic16.source.size = uint32_t(synthetic16.data.size());
+
+	// 0x400000 = 0.5、0xE00000 = -0.25（リトルエンディアンの3バイト）
+	SyntheticSource synthetic24;
+	for (uint32_t i = 0; i < 4; ++i) {
+		const uint8_t frame[] = { 0x00, 0x00, 0x40, 0x00, 0x00, 0xE0 };
+		synthetic24.data.insert(synthetic24.data.end(), frame, frame + sizeof(frame));
+	}
+	synthetic24.source.format = MakeFormat(WaveFile::kFormatPcm, 2, 48000, 24);
+	synthetic24.source.data = synthetic24.data.data();
+	synthetic24.source.size = uint32_t(synthetic24.data.size());
+
+	for (const SyntheticSource* synthetic : { &synthetic16, &synthetic24 }) {
+		AudioMixer mixer;
+		mixer.Initialize(48000, 4);
+		CHECK(mixer.Play(synthetic->source, 1.0f, 0.5f, false) != AudioMixer::kInvalidHandle);
+		std::vector<float> output(4 * 2);
+		mixer.Mix(output.data(), 4);
+		CHECK_NEAR(output[0], 0.25f, 1e-6f);
+		CHECK_NEAR(output[1], -0.25f, 1e-6f);
+		CHECK_NEAR(output[6], 0.25f, 1e-6f);
+		CHECK_NEAR(output[7], -0.25f, 1e-6f);
+	}
+}
+
+// ループしないボイスは最後まで鳴らしたら空きに戻り、ループするボイスは鳴り続ける
+TEST_CASE(AudioMixerReleasesFinishedVoices) {
+	SyntheticSource synthetic;
+	MakeFloatSource(synthetic, 1, 48000, std::vector<float>(100, 0.25f));
+
+	AudioMixer mixer;
+	mixer.Initialize(48000, 64);
+	uint32_t oneShot = mixer.Play(synthetic.source, 1.0f, 0.0f, false);
+	uint32_t looping = mixer.Play(synthetic.source, 1.0f, 0.0f, true);
+	CHECK(mixer.GetActiveVoiceCount() == 2);
+
+	std::vector<float> output(64 * 2);
+	mixer.Mix(output.data(), 64);
+	CHECK(mixer.IsPlaying(oneShot));
+	mixer.Mix(output.data(), 64);
+	CHECK(!mixer.IsPlaying(oneShot));
+	CHECK(mixer.IsPlaying(looping));
+	CHECK(mixer.GetActiveVoiceCount() == 1);
+
+	// ループは終わりから先頭へつながるので、無音にならない
+	mixer.Mix(output.data(), 64);
+	CHECK_NEAR(GetPeak(output, 0), 0.25f * kHalfPower, 1e-6f);
+
+	// 止めたハンドルは、同じボイスが使い回されても無効のまま
+	mixer.Stop(looping);
+	CHECK(!mixer.IsPlaying(looping));
+	uint32_t reused = mixer.Play(synthetic.source, 1.0f, 0.0f, true);
+	CHECK(reused != looping);
+	CHECK(!mixer.IsPlaying(looping));
+	CHECK(mixer.IsPlaying(reused));
+}
+
+// 扱えない形式や、出力より高すぎるレートは鳴らさない
+TEST_CASE(AudioMixerRejectsUnsupportedSources) {
+	SyntheticSource synthetic;
+	MakeFloatSource(synthetic, 1, 48000, std::vector<float>(16, 0.0f));
+
+	AudioMixer mixer;
+	mixer.Initialize(48000, 64);
+
+	AudioMixer::Source pcm8 = synthetic.source;
+	pcm8.format = MakeFormat(WaveFile::kFormatPcm, 1, 48000, 8);
+	CHECK(mixer.Play(pcm8) == AudioMixer::kInvalidHandle);
+
+	AudioMixer::Source tooFast = synthetic.source;
+	tooFast.format = MakeFormat(WaveFile::kFormatFloat, 1, 48000 * AudioMixer::kMaxRateRatio + 1, 32);
+	CHECK(mixer.Play(tooFast) == AudioMixer::kInvalidHandle);
+
+	AudioMixer::Source empty = synthetic.source;
+	empty.size = 0;
+	CHECK(mixer.Play(empty) == AudioMixer::kInvalidHandle);
+	CHECK(mixer.GetActiveVoiceCount() == 0);
+
+	// ボイスが足りなければ鳴らさない
+	for (uint32_t i = 0; i < AudioMixer::kMaxVoices; ++i) {
+		mixer.Play(synthetic.source, 1.0f, 0.0f, true);
+	}
+	CHECK(mixer.Play(synthetic.source) == AudioMixer::kInvalidHandle);
+	CHECK(mixer.GetActiveVoiceCount() == AudioMixer::kMaxVoices);
+}
+
+// 低いレートの正弦波を上げても、線形補間・sincのどちらも振幅が保たれる
+TEST_CASE(AudioMixerUpsamplesKeepingAmplitude) {
+	SyntheticSource synthetic;
+	MakeFloatSource(synthetic, 1, 22050, MakeSine(22050, 22050, 441.0f, 0.5f));
+
+	for (AudioMixer::Resampler resampler : { AudioMixer::Resampler::kLinear, AudioMixer::Resampler::kSinc }) {
+		AudioMixer mixer;
+		mixer.Initialize(48000, 1024);
+		mixer.SetResampler(resampler);
+		mixer.Play(synthetic.source, 1.0f, 0.0f, true);
+		std::vector<float> output(1024 * 2);
+		mixer.Mix(output.data(), 1024);
+		mixer.Mix(output.data(), 1024);
+		CHECK_NEAR(GetPeak(output, 0), 0.5f * kHalfPower, 0.01f);
+	}
+}
+
+// 高いレートから下げるとき、sincは出力のナイキスト周波数より上の音を落とす（線形補間は折り返して残る）
+TEST_CASE(AudioMixerSincRejectsAliasingWhenDownsampling) {
+	SyntheticSource synthetic;
+	MakeFloatSource(synthetic, 1, 96000, MakeSine(96000, 96000, 30000.0f, 0.5f));
+
+	AudioMixer mixer;
+	mixer.Initialize(48000, 1024);
+	mixer.SetResampler(AudioMixer::Resampler::kSinc);
+	mixer.Play(synthetic.source, 1.0f, 0.0f, true);
+	std::vector<float> output(1024 * 2);
+	mixer.Mix(output.data(), 1024);
+	mixer.Mix(output.data(), 1024);
+	float sincPeak = GetPeak(output, 0);
+
+	mixer.SetResampler(AudioMixer::Resampler::kLinear);
+	mixer.Mix(output.data(), 1024);
+	float linearPeak = GetPeak(output, 0);
+
+	CHECK(sincPeak < 0.02f);
+	CHECK(linearPeak > 0.1f);
+}
@@ -0,0 +1,87 @@
+#include "TestFramework.h"
+#include "AudioRingBuffer.h"
+#include <cstring>
+#include <thread>
+
+// ブロックは順番に使い回し、全部渡している間は書けない
+TEST_CASE(AudioRingBufferRotatesBlocks) {
+	AudioRingBuffer ring;
+	ring.Initialize(64, 3);
+	CHECK(ring.GetBlockSize() == 64);
+	CHECK(ring.GetBlockCount() == 3);
+	CHECK(ring.IsEmpty());
+
+	uint8_t* blocks[3] = {};
+	for (uint32_t i = 0; i < 3; ++i) {
+		blocks[i] = ring.AcquireBlock();
+		CHECK(blocks[i] != nullptr);
+		// 渡すまでは同じブロック
+		CHECK(ring.AcquireBlock() == blocks[i]);
+		ring.SubmitBlock();
+	}
+	CHECK(blocks[1] == blocks[0] + 64);
+	CHECK(blocks[2] == blocks[1] + 64);
+	CHECK(ring.GetQueuedCount() == 3);
+	CHECK(ring.AcquireBlock() == nullptr);
+
+	// 返ってきたら、最初のブロックから使い回す
+	ring.ReleaseBlock();
+	CHECK(ring.GetQueuedCount() == 2);
+	CHECK(ring.AcquireBlock() == blocks[0]);
+	ring.SubmitBlock();
+	CHECK(ring.GetSubmittedCount() == 4);
+
+	ring.ReleaseBlock();
+	ring.ReleaseBlock();
+	ring.ReleaseBlock();
+	CHECK(ring.IsEmpty());
+
+	// 全部返ってきたら先頭から
+	ring.Reset();
+	CHECK(ring.AcquireBlock() == blocks[0]);
+	CHECK(ring.GetSubmittedCount() == 0);
+}
+
+// 別のスレッドの読む側に、書いた中身が順番どおりに届く
+TEST_CASE(AudioRingBufferPassesBlocksBetweenThreads) {
+	const uint32_t kBlockCount = 4;
+	const uint32_t kTransferCount = 100000;
+	AudioRingBuffer ring;
+	ring.Initialize(sizeof(uint32_t) * 16, kBlockCount);
+
+	// 読む側はXAudio2と同じく、渡された順にブロックの先頭から読む
+	uint8_t* firstBlock = ring.AcquireBlock();
+	bool isInOrder = true;
+	std::thread reader([&ring, &isInOrder, firstBlock, kBlockCount, kTransferCount]() {
+		for (uint32_t i = 0; i < kTransferCount; ++i) {
+			while (ring.GetQueuedCount() == 0) {
+				std::this_thread::yield();
+			}
+			const uint8_t* block = firstBlock + (i % kBlockCount) * ring.GetBlockSize();
+			uint32_t values[16];
+			std::memcpy(values, block, sizeof(values));
+			for (uint32_t value : values) {
+				isInOrder = isInOrder && value == i;
+			}
+			ring.ReleaseBlock();
+		}
+	});
+
+	for (uint32_t i = 0; i < kTransferCount; ++i) {
+		uint8_t* block = nullptr;
+		while ((block = ring.AcquireBlock()) == nullptr) {
+			std::this_thread::yield();
+		}
+		uint32_t values[16];
+		for (uint32_t& value : values) {
+			value = i;
+		}
+		std::memcpy(block, values, sizeof(values));
+		ring.SubmitBlock();
+	}
+	reader.join();
+
+	CHECK(isInOrder);
+	CHECK(ring.IsEmpty());
+	CHECK(ring.GetSubmittedCount() == kTransferCount);
+}
@@ -0,0 +1,134 @@
+#include "TestFramework.h"
+#include "FrameContextRing.h"
+#include <vector>
+
+namespace {
+
+	// GPUの代わりに、完了したフェンス値をテストから進める偽物のフェンス
+	class FakeFrameFence : public IFrameFence {
+	public:
+		uint64_t GetCompletedValue() const override { return completedValue; }
+
+		void Signal(uint64_t fenceValue) override { signaledValues.push_back(fenceValue); }
+
+		// 待った値を覚えて、GPUがそこまで終わったことにする
+		void Wait(uint64_t fenceValue) override {
+			waitedValues.push_back(fenceValue);
+			completedValue = fenceValue;
+		}
+
+		uint64_t completedValue = 0;
+		std::vector<uint64_t> signaledValues;
+		std::vector<uint64_t> waitedValues;
+	};
+}
+
+// フェンス値は1つずつ増え、コンテキストは順番に使い回す
+TEST_CASE(FrameContextRingSignalsAndRotates) {
+	FakeFrameFence fence;
+	FrameContextRing ring;
+	ring.Initialize(3, &fence);
+
+	for (uint32_t frame = 0; frame < 7; ++frame) {
+		CHECK(ring.GetCurrentIndex() == frame % 3);
+		ring.BeginFrame();
+		CHECK(ring.EndFrame() == frame + 1);
+		fence.completedValue = frame + 1;
+	}
+	CHECK((fence.signaledValues == std::vector<uint64_t>{ 1, 2, 3, 4, 5, 6, 7 }));
+	CHECK(ring.GetLastSignaledValue() == 7);
+	CHECK(fence.waitedValues.empty());
+	CHECK(ring.GetWaitCount() == 0);
+}
+
+// 再利用するコンテキストの前回のフレームが終わっていないときだけ、そのフェンス値を待つ
+TEST_CASE(FrameContextRingWaitsOnlyForReusedContext) {
+	FakeFrameFence fence;
+	FrameContextRing ring;
+	ring.Initialize(2, &fence);
+
+	// GPUが何も終わらせないまま、コンテキストの数だけは待たずに進める
+	CHECK(!ring.BeginFrame());
+	CHECK(ring.EndFrame() == 1);
+	CHECK(!ring.BeginFrame());
+	CHECK(ring.EndFrame() == 2);
+
+	// コンテキスト0を使い直すので、フレーム1（フェンス値1）だけを待つ
+	CHECK(ring.BeginFrame());
+	CHECK((fence.waitedValues == std::vector<uint64_t>{ 1 }));
+	CHECK(ring.GetWaitCount() == 1);
+	CHECK(ring.EndFrame() == 3);
+
+	// GPUがフレーム2まで終わっていれば、コンテキスト1は待たない
+	fence.completedValue = 2;
+	CHECK(!ring.BeginFrame());
+	CHECK(ring.GetWaitCount() == 1);
+	CHECK(ring.EndFrame() == 4);
+
+	// コンテキスト0はフレーム3が終わっていないので待つ
+	CHECK(ring.BeginFrame());
+	CHECK((fence.waitedValues == std::vector<uint64_t>{ 1, 3 }));
+	CHECK(ring.GetWaitCount() == 2);
+}
+
+// WaitIdleは新しいフェンス値を積んで、それが終わるまで待つ
+TEST_CASE(FrameContextRingWaitIdle) {
+	FakeFrameFence fence;
+	FrameContextRing ring;
+	ring.Initialize(3, &fence);
+
+	ring.BeginFrame();
+	ring.EndFrame();
+	ring.BeginFrame();
+	ring.EndFrame();
+	ring.WaitIdle();
+	CHECK((fence.signaledValues == std::vector<uint64_t>{ 1, 2, 3 }));
+	CHECK((fence.waitedValues == std::vector<uint64_t>{ 3 }));
+	CHECK(ring.GetLastSignaledValue() == 3);
+	CHECK(ring.GetFramesInFlight() == 0);
+
+	// 待ってもBeginFrameの待ち回数には数えない
+	CHECK(ring.GetWaitCount() == 0);
+
+	// 既に終わっていれば待たない
+	fence.completedValue = 10;
+	ring.WaitIdle();
+	CHECK(fence.waitedValues.size() == 1);
+
+	// 終わった後はどのコンテキストも待たずに使える
+	CHECK(!ring.BeginFrame());
+	CHECK(ring.EndFrame() == 5);
+}
+
+// 重なっていたフレーム数は、BeginFrameの時点でGPUが終わっていないフレームを数える
+TEST_CASE(FrameContextRingCountsOverlappedFrames) {
+	FakeFrameFence fence;
+	FrameContextRing ring;
+	ring.Initialize(3, &fence);
+
+	ring.BeginFrame();
+	CHECK(ring.GetOverlappedFrames() == 0);
+	ring.EndFrame();
+	CHECK(ring.GetFramesInFlight() == 1);
+
+	ring.BeginFrame();
+	CHECK(ring.GetOverlappedFrames() == 1);
+	ring.EndFrame();
+
+	ring.BeginFrame();
+	CHECK(ring.GetOverlappedFrames() == 2);
+	ring.EndFrame();
+	CHECK(ring.GetFramesInFlight() == 3);
+
+	// フレーム1が終わっていれば、重なっているのは残りの2フレーム
+	fence.completedValue = 1;
+	CHECK(!ring.BeginFrame());
+	CHECK(ring.GetOverlappedFrames() == 2);
+	ring.EndFrame();
+
+	// 全部終わっていれば重なりは無い
+	fence.completedValue = ring.GetLastSignaledValue();
+	ring.BeginFrame();
+	CHECK(ring.GetOverlappedFrames() == 0);
+	CHECK(ring.GetFramesInFlight() == 0);
+}
@@ -0,0 +1,143 @@
+#include "TestFramework.h"
+#include "FramePacer.h"
+
+using namespace std::chrono;
+
+namespace {
+
+	// テストから進める偽物の時計（スリープは指定より少し長く眠る）
+	class FakeFrameClock : public IFrameClock {
+	public:
+		nanoseconds Now() override { return now; }
+
+		void Sleep(nanoseconds duration) override {
+			now += duration + oversleep;
+			sleepCount++;
+		}
+
+		void Spin() override {
+			now += spinStep;
+			spinCount++;
+		}
+
+		nanoseconds now = seconds(1);
+		nanoseconds oversleep = microseconds(500);
+		nanoseconds spinStep = microseconds(100);
+		uint32_t sleepCount = 0;
+		uint32_t spinCount = 0;
+	};
+
+	// workだけ処理をしてから次のフレームまで待ち、待ち終わった時刻を返す
+	nanoseconds RunFrame(FakeFrameClock& clock, FramePacer& pacer, nanoseconds work) {
+		clock.now += work;
+		pacer.WaitForNextFrame();
+		return clock.now;
+	}
+}
+
+// 期限は前回の期限から数えるので、眠りすぎや少しの遅れがあってもずれがたまらない
+TEST_CASE(FramePacerAccumulatesDeadlines) {
+	FakeFrameClock clock;
+	FramePacer pacer;
+	pacer.Initialize(&clock, 100.0);
+	const nanoseconds start = clock.now;
+
+	// 期限の2ms前まで眠り、残りを空回しして期限ちょうどに終わる
+	CHECK(RunFrame(clock, pacer, milliseconds(3)) == start + milliseconds(10));
+	CHECK(clock.sleepCount == 1);
+	CHECK(clock.spinCount == 15);
+	CHECK(RunFrame(clock, pacer, milliseconds(9)) == start + milliseconds(20));
+	CHECK(clock.sleepCount == 1);
+
+	// 1フレームより短い遅れは数え直さず、次の期限で元の周期に戻る
+	CHECK(RunFrame(clock, pacer, milliseconds(14)) == start + milliseconds(34));
+	CHECK(RunFrame(clock, pacer, milliseconds(3)) == start + milliseconds(40));
+
+	bool isOnPhase = true;
+	for (uint32_t frame = 5; frame <= 100; ++frame) {
+		isOnPhase = isOnPhase && RunFrame(clock, pacer, milliseconds(frame % 7)) == start + milliseconds(10 * frame);
+	}
+	CHECK(isOnPhase);
+	CHECK(pacer.GetStatistics().missedDeadlines == 1);
+	CHECK_NEAR(pacer.GetLastFrameMilliseconds(), 10.0, 1e-9);
+}
+
+// 1フレーム以上遅れたら取り返そうとせず、遅れた時刻から数え直す
+TEST_CASE(FramePacerResyncsAfterMissedDeadline) {
+	FakeFrameClock clock;
+	FramePacer pacer;
+	pacer.Initialize(&clock, 100.0);
+	const nanoseconds start = clock.now;
+
+	RunFrame(clock, pacer, milliseconds(3));
+	RunFrame(clock, pacer, milliseconds(3));
+
+	// 期限30msに対して45msに終わった
+	CHECK(RunFrame(clock, pacer, milliseconds(25)) == start + milliseconds(45));
+	CHECK(pacer.GetStatistics().missedDeadlines == 1);
+
+	// 次は45msから1フレーム後で、続けて詰めて回すことはしない
+	CHECK(RunFrame(clock, pacer, milliseconds(1)) == start + milliseconds(55));
+	CHECK(RunFrame(clock, pacer, milliseconds(1)) == start + milliseconds(65));
+	CHECK(pacer.GetStatistics().missedDeadlines == 1);
+	CHECK_NEAR(pacer.GetLastFrameMilliseconds(), 10.0, 1e-9);
+}
+
+// 待たずに回すときは眠りも空回しもせず、固定に戻したら今から数え直す
+TEST_CASE(FramePacerUnlockedDoesNotWait) {
+	FakeFrameClock clock;
+	FramePacer pacer;
+	pacer.Initialize(&clock, 100.0);
+	pacer.SetUnlocked(true);
+	const nanoseconds start = clock.now;
+
+	CHECK(RunFrame(clock, pacer, milliseconds(3)) == start + milliseconds(3));
+	CHECK(RunFrame(clock, pacer, milliseconds(4)) == start + milliseconds(7));
+	CHECK(clock.sleepCount == 0 && clock.spinCount == 0);
+	CHECK_NEAR(pacer.GetLastFrameMilliseconds(), 4.0, 1e-9);
+
+	// 戻したときは今（7ms）から1フレーム後が期限で、間に合わなかったことにはしない
+	pacer.SetUnlocked(false);
+	CHECK(RunFrame(clock, pacer, milliseconds(2)) == start + milliseconds(17));
+	CHECK(pacer.GetStatistics().missedDeadlines == 0);
+
+	// フレームレートが0以下でも待たない
+	pacer.SetTargetFps(0.0);
+	CHECK(RunFrame(clock, pacer, milliseconds(5)) == start + milliseconds(22));
+	CHECK(clock.sleepCount == 1);
+}
+
+// 統計は直近のkHistorySizeフレームから取る
+TEST_CASE(FramePacerStatistics) {
+	FakeFrameClock clock;
+	FramePacer pacer;
+	pacer.Initialize(&clock, 100.0);
+	pacer.SetUnlocked(true);
+
+	CHECK(pacer.GetStatistics().sampleCount == 0);
+	CHECK(pacer.GetLastFrameMilliseconds() == 0.0);
+
+	// 1msから100msのフレームを順番を混ぜて記録する
+	for (uint32_t i = 0; i < 100; ++i) {
+		RunFrame(clock, pacer, milliseconds((i * 37) % 100 + 1));
+	}
+	FramePacer::Statistics statistics = pacer.GetStatistics();
+	CHECK(statistics.sampleCount == 100);
+	CHECK_NEAR(statistics.meanMilliseconds, 50.5, 1e-9);
+	CHECK_NEAR(statistics.p50Milliseconds, 50.0, 1e-9);
+	CHECK_NEAR(statistics.p99Milliseconds, 99.0, 1e-9);
+	CHECK_NEAR(statistics.maxMilliseconds, 100.0, 1e-9);
+
+	// 古いフレームは押し出される（1msから300msを順番に記録すると、残るのは45msから300ms）
+	pacer.Initialize(&clock, 100.0);
+	for (uint32_t i = 1; i <= 300; ++i) {
+		RunFrame(clock, pacer, milliseconds(i));
+	}
+	statistics = pacer.GetStatistics();
+	CHECK(statistics.sampleCount == FramePacer::kHistorySize);
+	CHECK_NEAR(statistics.meanMilliseconds, (45.0 + 300.0) / 2.0, 1e-9);
+	CHECK_NEAR(statistics.p50Milliseconds, 45.0 + 127.0, 1e-9);
+	CHECK_NEAR(statistics.p99Milliseconds, 45.0 + 252.0, 1e-9);
+	CHECK_NEAR(statistics.maxMilliseconds, 300.0, 1e-9);
+	CHECK(statistics.missedDeadlines == 0);
+}
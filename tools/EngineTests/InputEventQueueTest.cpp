@@ -0,0 +1,103 @@
+#include "TestFramework.h"
+#include "InputEventQueue.h"
+#include <memory>
+#include <thread>
+
+namespace {
+
+	// キーの事象を作る
+	InputEvent MakeKeyEvent(InputEvent::Type type, uint8_t key, uint64_t time) {
+		InputEvent event;
+		event.type = type;
+		event.code = key;
+		event.time = time;
+		return event;
+	}
+}
+
+// 積んだ順に取り出せる
+TEST_CASE(InputEventQueuePopsInOrder) {
+	std::unique_ptr<InputEventQueue> queue = std::make_unique<InputEventQueue>();
+	CHECK(queue->Push(MakeKeyEvent(InputEvent::Type::kKeyDown, 1, 10)));
+	CHECK(queue->Push(MakeKeyEvent(InputEvent::Type::kKeyUp, 1, 20)));
+	CHECK(queue->GetQueuedCount() == 2);
+
+	InputEvent event;
+	CHECK(queue->Pop(event));
+	CHECK(event.type == InputEvent::Type::kKeyDown && event.time == 10);
+	CHECK(queue->Pop(event));
+	CHECK(event.type == InputEvent::Type::kKeyUp && event.time == 20);
+	CHECK(!queue->Pop(event));
+	CHECK(queue->GetQueuedCount() == 0);
+}
+
+// 指定した時刻より後の事象は残す
+TEST_CASE(InputEventQueueKeepsLaterEvents) {
+	std::unique_ptr<InputEventQueue> queue = std::make_unique<InputEventQueue>();
+	queue->Push(MakeKeyEvent(InputEvent::Type::kKeyDown, 1, 10));
+	queue->Push(MakeKeyEvent(InputEvent::Type::kKeyUp, 1, 30));
+
+	InputEvent event;
+	CHECK(queue->Pop(event, 20));
+	CHECK(event.time == 10);
+	CHECK(!queue->Pop(event, 20));
+	CHECK(queue->GetQueuedCount() == 1);
+	CHECK(queue->Pop(event, 30));
+	CHECK(event.time == 30);
+}
+
+// いっぱいなら捨てて数え、取り出した分はまた積める
+TEST_CASE(InputEventQueueDropsWhenFull) {
+	std::unique_ptr<InputEventQueue> queue = std::make_unique<InputEventQueue>();
+	for (uint32_t i = 0; i < InputEventQueue::kCapacity; ++i) {
+		CHECK(queue->Push(MakeKeyEvent(InputEvent::Type::kKeyDown, 1, i)));
+	}
+	CHECK(!queue->Push(MakeKeyEvent(InputEvent::Type::kKeyDown, 1, 0)));
+	CHECK(queue->GetDroppedCount() == 1);
+
+	InputEvent event;
+	CHECK(queue->Pop(event));
+	CHECK(event.time == 0);
+	CHECK(queue->Push(MakeKeyEvent(InputEvent::Type::kKeyDown, 1, InputEventQueue::kCapacity)));
+
+	// 先頭から順に、最後に積んだものまで出てくる（一周しても順番は変わらない）
+	uint64_t expectedTime = 1;
+	while (queue->Pop(event)) {
+		CHECK(event.time == expectedTime);
+		expectedTime++;
+	}
+	CHECK(expectedTime == InputEventQueue::kCapacity + 1);
+}
+
+// 別のスレッドから積んだものを、抜けも重複もなく順番どおりに受け取れる
+TEST_CASE(InputEventQueuePassesEventsBetweenThreads) {
+	std::unique_ptr<InputEventQueue> queue = std::make_unique<InputEventQueue>();
+	const uint64_t kEventCount = 200000;
+
+	std::thread producer([&queue, kEventCount]() {
+		for (uint64_t i = 0; i < kEventCount; ++i) {
+			InputEvent event = MakeKeyEvent(InputEvent::Type::kMouseMove, 0, i);
+			event.x = static_cast<int32_t>(i);
+			// いっぱいのときは読む側が追いつくまで待つ
+			while (!queue->Push(event)) {
+				std::this_thread::yield();
+			}
+		}
+		});
+
+	uint64_t expectedTime = 0;
+	bool isInOrder = true;
+	while (expectedTime < kEventCount) {
+		InputEvent event;
+		if (!queue->Pop(event)) {
+			std::this_thread::yield();
+			continue;
+		}
+		isInOrder = isInOrder && event.time == expectedTime && event.x == static_cast<int32_t>(expectedTime);
+		expectedTime++;
+	}
+	producer.join();
+
+	CHECK(isInOrder);
+	CHECK(queue->GetQueuedCount() == 0);
+}
@@ -0,0 +1,141 @@
+#include "TestFramework.h"
+#include "InputSnapshot.h"
+#include <memory>
+
+namespace {
+
+	// 事象を作る
+	InputEvent MakeEvent(InputEvent::Type type, uint8_t code, uint64_t time, int32_t x = 0, int32_t y = 0) {
+		InputEvent event;
+		event.type = type;
+		event.code = code;
+		event.time = time;
+		event.x = x;
+		event.y = y;
+		return event;
+	}
+
+	// キーの番号（DIK_SPACE、DIK_A）
+	const uint8_t kKeySpace = 0x39;
+	const uint8_t kKeyA = 0x1E;
+}
+
+// 押したフレームだけトリガーになり、押している間はPushのまま
+TEST_CASE(InputSnapshotDetectsPressAndHold) {
+	InputSnapshot snapshot;
+	snapshot.BeginFrame(100);
+	snapshot.Apply(MakeEvent(InputEvent::Type::kKeyDown, kKeySpace, 50));
+	CHECK(snapshot.IsKeyDown(kKeySpace));
+	CHECK(snapshot.IsKeyPressed(kKeySpace));
+	CHECK(!snapshot.IsKeyReleased(kKeySpace));
+	CHECK(snapshot.GetKeyPressTime(kKeySpace) == 50);
+
+	// 何度聞いても同じ答え
+	CHECK(snapshot.IsKeyPressed(kKeySpace));
+
+	snapshot.BeginFrame(200);
+	CHECK(snapshot.IsKeyDown(kKeySpace));
+	CHECK(!snapshot.IsKeyPressed(kKeySpace));
+
+	snapshot.BeginFrame(300);
+	snapshot.Apply(MakeEvent(InputEvent::Type::kKeyUp, kKeySpace, 250));
+	CHECK(!snapshot.IsKeyDown(kKeySpace));
+	CHECK(snapshot.IsKeyReleased(kKeySpace));
+	CHECK(!snapshot.IsKeyPressed(kKeySpace));
+}
+
+// 1フレームの間に押して離しても、押したことを取りこぼさない
+TEST_CASE(InputSnapshotKeepsSubFramePress) {
+	InputSnapshot snapshot;
+	snapshot.BeginFrame(100);
+	snapshot.Apply(MakeEvent(InputEvent::Type::kKeyDown, kKeyA, 10));
+	snapshot.Apply(MakeEvent(InputEvent::Type::kKeyUp, kKeyA, 20));
+	snapshot.Apply(MakeEvent(InputEvent::Type::kKeyDown, kKeyA, 30));
+	snapshot.Apply(MakeEvent(InputEvent::Type::kKeyUp, kKeyA, 40));
+	CHECK(!snapshot.IsKeyDown(kKeyA));
+	CHECK(snapshot.IsKeyPressed(kKeyA));
+	CHECK(snapshot.IsKeyReleased(kKeyA));
+	CHECK(snapshot.GetKeyPressCount(kKeyA) == 2);
+	CHECK(snapshot.GetKeyPressTime(kKeyA) == 10);
+	CHECK(snapshot.GetEvents().size() == 4);
+
+	// 次のフレームには持ち越さない
+	snapshot.BeginFrame(200);
+	CHECK(!snapshot.IsKeyPressed(kKeyA));
+	CHECK(!snapshot.IsKeyReleased(kKeyA));
+	CHECK(snapshot.GetEvents().empty());
+}
+
+// 押したままの二重の押下や、押していないものを離すのは数えない
+TEST_CASE(InputSnapshotIgnoresRepeatedEdges) {
+	InputSnapshot snapshot;
+	snapshot.BeginFrame(100);
+	snapshot.Apply(MakeEvent(InputEvent::Type::kKeyUp, kKeyA, 10));
+	CHECK(!snapshot.IsKeyReleased(kKeyA));
+	snapshot.Apply(MakeEvent(InputEvent::Type::kKeyDown, kKeyA, 20));
+	snapshot.Apply(MakeEvent(InputEvent::Type::kKeyDown, kKeyA, 30));
+	CHECK(snapshot.GetKeyPressCount(kKeyA) == 1);
+	CHECK(snapshot.GetKeyPressTime(kKeyA) == 20);
+}
+
+// フレームを始めた後に起きた事象は次のフレームに回す
+TEST_CASE(InputSnapshotDefersLaterEvents) {
+	std::unique_ptr<InputEventQueue> queue = std::make_unique<InputEventQueue>();
+	queue->Push(MakeEvent(InputEvent::Type::kKeyDown, kKeySpace, 90));
+	queue->Push(MakeEvent(InputEvent::Type::kKeyUp, kKeySpace, 150));
+
+	InputSnapshot snapshot;
+	snapshot.Update(*queue, 100);
+	CHECK(snapshot.IsKeyPressed(kKeySpace));
+	CHECK(snapshot.IsKeyDown(kKeySpace));
+	CHECK(snapshot.GetFrameTime() == 100);
+	CHECK(queue->GetQueuedCount() == 1);
+
+	snapshot.Update(*queue, 200);
+	CHECK(snapshot.IsKeyReleased(kKeySpace));
+	CHECK(!snapshot.IsKeyDown(kKeySpace));
+	CHECK(snapshot.GetPreviousFrameTime() == 100);
+	CHECK(queue->GetQueuedCount() == 0);
+}
+
+// マウスのボタン・位置・ホイール
+TEST_CASE(InputSnapshotTracksMouse) {
+	InputSnapshot snapshot;
+	snapshot.BeginFrame(100);
+	snapshot.Apply(MakeEvent(InputEvent::Type::kMouseMove, 0, 10, 5, 6));
+	snapshot.Apply(MakeEvent(InputEvent::Type::kMouseButtonDown, 0, 20, 7, 8));
+	snapshot.Apply(MakeEvent(InputEvent::Type::kMouseWheel, 0, 30, 120));
+	snapshot.Apply(MakeEvent(InputEvent::Type::kMouseWheel, 0, 40, -240));
+	CHECK(snapshot.IsMouseButtonDown(0));
+	CHECK(snapshot.IsMouseButtonPressed(0));
+	CHECK(snapshot.GetMouseX() == 7 && snapshot.GetMouseY() == 8);
+	CHECK(snapshot.GetWheelDelta() == -120);
+
+	// ウィンドウの外で離しても、キャプチャしていれば負の座標で届く
+	snapshot.BeginFrame(200);
+	snapshot.Apply(MakeEvent(InputEvent::Type::kMouseButtonUp, 0, 150, -3, -4));
+	CHECK(!snapshot.IsMouseButtonDown(0));
+	CHECK(snapshot.IsMouseButtonReleased(0));
+	CHECK(snapshot.GetMouseX() == -3 && snapshot.GetMouseY() == -4);
+	CHECK(snapshot.GetWheelDelta() == 0);
+
+	// 範囲外のボタン番号は無視する
+	snapshot.Apply(MakeEvent(InputEvent::Type::kMouseButtonDown, InputSnapshot::kMouseButtonCount, 160));
+	CHECK(snapshot.GetMouseButtonPressCount(0) == 0);
+}
+
+// 非アクティブになったら押しているものは全部離す
+TEST_CASE(InputSnapshotReleasesAllOnFocusLost) {
+	InputSnapshot snapshot;
+	snapshot.BeginFrame(100);
+	snapshot.Apply(MakeEvent(InputEvent::Type::kKeyDown, kKeyA, 10));
+	snapshot.Apply(MakeEvent(InputEvent::Type::kMouseButtonDown, 1, 20));
+
+	snapshot.BeginFrame(200);
+	snapshot.Apply(MakeEvent(InputEvent::Type::kFocusLost, 0, 150));
+	CHECK(!snapshot.IsKeyDown(kKeyA));
+	CHECK(snapshot.IsKeyReleased(kKeyA));
+	CHECK(!snapshot.IsMouseButtonDown(1));
+	CHECK(snapshot.IsMouseButtonReleased(1));
+	CHECK(!snapshot.IsKeyReleased(kKeySpace));
+}
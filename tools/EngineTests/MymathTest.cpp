@@ -0,0 +1,133 @@
+#include "TestFramework.h"
+#include "Mymath.h"
+#include <random>
+#include <vector>
+
+using namespace Math;
+
+namespace {
+
+	// 逆行列が求まるアフィン変換の入力（main.cppの計測と同じ範囲）
+	struct AffineInput {
+		Vector3 scale;
+		Vector3 rotate;
+		Vector3 translate;
+	};
+
+	// 決まった種から入力を作る
+	std::vector<AffineInput> MakeAffineInputs(uint32_t count) {
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+		std::vector<AffineInput> inputs(count);
+		for (AffineInput& input : inputs) {
+			input.scale = { 0.5f + std::fabs(distribution(random)), 0.5f + std::fabs(distribution(random)), 0.5f + std::fabs(distribution(random)) };
+			input.rotate = { distribution(random), distribution(random), distribution(random) };
+			input.translate = { distribution(random), distribution(random), distribution(random) };
+		}
+		return inputs;
+	}
+
+	// ビット単位で一致しない要素の数（+0と-0は同じとみなす）
+	uint32_t CountMismatches(const Matrix4x4& a, const Matrix4x4& b) {
+		uint32_t count = 0;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				if (UlpDistance(a.m[row][column], b.m[row][column]) != 0) {
+					count++;
+				}
+			}
+		}
+		return count;
+	}
+
+	// 許容差を超える要素の数（絶対誤差と相対誤差を合わせた許容差）
+	uint32_t CountOutOfTolerance(const Matrix4x4& actual, const Matrix4x4& expected, float absoluteTolerance, float relativeTolerance) {
+		uint32_t count = 0;
+		for (int row = 0; row < 4; ++row) {
+			for (int column = 0; column < 4; ++column) {
+				float difference = std::fabs(actual.m[row][column] - expected.m[row][column]);
+				if (difference > absoluteTolerance + relativeTolerance * std::fabs(expected.m[row][column])) {
+					count++;
+				}
+			}
+		}
+		return count;
+	}
+
+	const uint32_t kInputCount = 10000;
+}
+
+// UlpDistanceは隣のfloatを1と数え、+0と-0は同じとみなす
+TEST_CASE(MymathUlpDistance) {
+	CHECK(UlpDistance(1.0f, 1.0f) == 0);
+	CHECK(UlpDistance(0.0f, -0.0f) == 0);
+	CHECK(UlpDistance(1.0f, std::nextafter(1.0f, 2.0f)) == 1);
+	CHECK(UlpDistance(std::nextafter(0.0f, 1.0f), std::nextafter(0.0f, -1.0f)) == 2);
+}
+
+// 逆行列を掛けると単位行列に戻る
+TEST_CASE(MymathInverseRestoresIdentity) {
+	std::vector<AffineInput> inputs = MakeAffineInputs(kInputCount);
+	Matrix4x4 identity = makeIdentity4x4();
+	uint32_t failedCount = 0;
+	for (const AffineInput& input : inputs) {
+		Matrix4x4 m = MakeAffineMatrix(input.scale, input.rotate, input.translate);
+		failedCount += CountOutOfTolerance(Multiply(m, Inverse(m)), identity, 1e-4f, 0.0f);
+	}
+	CHECK(failedCount == 0);
+}
+
+// 波かっこで書いたオイラー角の呼び出しがあいまいにならない（コンパイルできること自体が確認）
+// クォータニオン版は同じ回転のオイラー角版と一致する
+TEST_CASE(MymathAffineMatrixOverloads) {
+	Matrix4x4 euler = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.0f, 0.2f, 0.0f }, { 0.0f, 0.0f, -5.0f });
+	Matrix4x4 quaternion = MakeAffineMatrixQuaternion({ 1.0f, 1.0f, 1.0f },
+		MakeRotateAxisAngleQuaternion({ 0.0f, 1.0f, 0.0f }, 0.2f), { 0.0f, 0.0f, -5.0f });
+	CHECK(CountOutOfTolerance(quaternion, euler, 1e-6f, 0.0f) == 0);
+}
+
+#if MATH_USE_SIMD
+// MultiplyはSSEとスカラーでビット単位で一致する
+TEST_CASE(MymathSimdMultiplyMatchesScalar) {
+	std::vector<AffineInput> inputs = MakeAffineInputs(kInputCount);
+	uint32_t mismatchCount = 0;
+	uint32_t alignedMismatchCount = 0;
+	for (uint32_t i = 0; i < kInputCount; ++i) {
+		const AffineInput& a = inputs[i];
+		const AffineInput& b = inputs[(i + 1) % kInputCount];
+		Matrix4x4A m1;
+		Matrix4x4A m2;
+		static_cast<Matrix4x4&>(m1) = Scalar::MakeAffineMatrix(a.scale, a.rotate, a.translate);
+		static_cast<Matrix4x4&>(m2) = Scalar::Inverse(Scalar::MakeAffineMatrix(b.scale, b.rotate, b.translate));
+
+		Matrix4x4 expected = Scalar::Multiply(m1, m2);
+		mismatchCount += CountMismatches(Simd::Multiply(static_cast<const Matrix4x4&>(m1), static_cast<const Matrix4x4&>(m2)), expected);
+		alignedMismatchCount += CountMismatches(Simd::Multiply(m1, m2), expected);
+	}
+	CHECK(mismatchCount == 0);
+	CHECK(alignedMismatchCount == 0);
+}
+
+// MakeAffineMatrixはSSEとスカラーでビット単位で一致する
+TEST_CASE(MymathSimdAffineMatchesScalar) {
+	std::vector<AffineInput> inputs = MakeAffineInputs(kInputCount);
+	uint32_t mismatchCount = 0;
+	for (const AffineInput& input : inputs) {
+		mismatchCount += CountMismatches(Simd::MakeAffineMatrix(input.scale, input.rotate, input.translate),
+			Scalar::MakeAffineMatrix(input.scale, input.rotate, input.translate));
+	}
+	CHECK(mismatchCount == 0);
+}
+
+// InverseはSSEとスカラーで計算の順番が違うので、ULPではなく許容差で比べる
+// 0に近い要素はULPでは数万ずれるが、絶対誤差は3e-6程度に収まる
+TEST_CASE(MymathSimdInverseMatchesScalar) {
+	std::vector<AffineInput> inputs = MakeAffineInputs(kInputCount);
+	uint32_t failedCount = 0;
+	for (const AffineInput& input : inputs) {
+		Matrix4x4 m = Scalar::MakeAffineMatrix(input.scale, input.rotate, input.translate);
+		failedCount += CountOutOfTolerance(Simd::Inverse(m), Scalar::Inverse(m), 1e-5f, 1e-5f);
+	}
+	CHECK(failedCount == 0);
+}
+#endif
@@ -0,0 +1,55 @@
+#include "TestFramework.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+	// 登録されたテスト
+	struct TestCase {
+		const char* name;
+		Test::TestFunction function;
+	};
+
+	// 静的初期化の順番に依存しないように、関数の中で作る
+	std::vector<TestCase>& GetTestCases() {
+		static std::vector<TestCase> testCases;
+		return testCases;
+	}
+
+	// 実行中のテストの失敗数
+	int currentFailureCount = 0;
+}
+
+namespace Test {
+
+	Registrar::Registrar(const char* name, TestFunction function) {
+		GetTestCases().push_back({ name, function });
+	}
+
+	void ReportFailure(const char* file, int line, const char* expression) {
+		std::printf("%s(%d): CHECK(%s) failed\n", file, line, expression);
+		currentFailureCount++;
+	}
+
+	int RunAll(const char* filter) {
+		int failedTestCount = 0;
+		int runTestCount = 0;
+		for (const TestCase& testCase : GetTestCases()) {
+			if (filter != nullptr && std::strstr(testCase.name, filter) == nullptr) {
+				continue;
+			}
+			currentFailureCount = 0;
+			testCase.function();
+			runTestCount++;
+			if (currentFailureCount > 0) {
+				std::printf("[FAILED] %s\n", testCase.name);
+				failedTestCount++;
+			} else {
+				std::printf("[    OK] %s\n", testCase.name);
+			}
+		}
+		std::printf("%d / %d tests passed\n", runTestCount - failedTestCount, runTestCount);
+		return failedTestCount;
+	}
+}
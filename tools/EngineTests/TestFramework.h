@@ -0,0 +1,39 @@
+#pragma once
+#include <cmath>
+
+// デバイスに依存しないエンジンの部分を確かめる、小さなテストの仕組み
+// TEST_CASEで書いたテストは静的初期化で登録され、mainのRunAllでまとめて実行される
+namespace Test {
+
+	// テストの本体
+	using TestFunction = void(*)();
+
+	// テストを登録する（TEST_CASEから使う）
+	struct Registrar {
+		Registrar(const char* name, TestFunction function);
+	};
+
+	// 失敗を記録する（CHECKから使う）
+	void ReportFailure(const char* file, int line, const char* expression);
+
+	// 名前にfilterを含むテストを全部実行して、失敗したテストの数を返す（nullptrなら全部）
+	int RunAll(const char* filter);
+}
+
+// テストを定義する
+#define TEST_CASE(name) \
+	static void name(); \
+	static Test::Registrar name##Registrar(#name, &name); \
+	static void name()
+
+// 条件が成り立たなければ失敗として記録する（テストは続ける）
+#define CHECK(expression) \
+	do { \
+		if (!(expression)) { \
+			Test::ReportFailure(__FILE__, __LINE__, #expression); \
+		} \
+	} while (0)
+
+// 差がtolerance以下でなければ失敗として記録する
+#define CHECK_NEAR(actual, expected, tolerance) \
+	CHECK(std::abs((actual) - (expected)) <= (tolerance))
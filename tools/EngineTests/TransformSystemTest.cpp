@@ -0,0 +1,80 @@
+#include "TestFramework.h"
+#include "TransformSystem.h"
+#include "ThreadPool.h"
+#include <cstring>
+#include <vector>
+
+using namespace Math;
+
+namespace {
+
+	// 定数バッファの境界と同じ間隔
+	const size_t kStride = 256;
+
+	// 端数が出る数（4の倍数でない）
+	const uint32_t kObjectCount = 1030;
+
+	// 決まった並びのSRTを追加する
+	void AddObjects(TransformSystem& transforms, uint32_t count) {
+		for (uint32_t i = 0; i < count; ++i) {
+			float value = float(i);
+			transforms.Add({ { 1.0f + value * 0.01f, 1.0f, 2.0f },
+				{ value * 0.1f, value * 0.2f, value * 0.3f },
+				{ value, -value, value * 0.5f } });
+		}
+	}
+
+	Matrix4x4 MakeViewProjection() {
+		return Multiply(
+			Inverse(MakeAffineMatrix(Vector3{ 1.0f,1.0f,1.0f }, Vector3{ 0.0f,0.0f,0.0f }, Vector3{ 0.0f,0.0f,-5.0f })),
+			MakePerspectiveFovMatrix(0.45f, 1280.0f / 720.0f, 0.1f, 100.0f));
+	}
+}
+
+// 間隔を空けて書いても、詰めて書いたときと同じ行列になり、間のバイトには触らない
+TEST_CASE(TransformSystemStridedOutputMatchesPacked) {
+	TransformSystem transforms;
+	AddObjects(transforms, kObjectCount);
+	Matrix4x4 viewProjection = MakeViewProjection();
+
+	std::vector<TransformSystem::TransformationMatrix> packed(kObjectCount);
+	transforms.Update(viewProjection, packed.data());
+
+	const unsigned char kFill = 0xCD;
+	std::vector<unsigned char> strided(kStride * kObjectCount, kFill);
+	transforms.Update(viewProjection, strided.data(), kStride);
+
+	uint32_t mismatchCount = 0;
+	uint32_t touchedCount = 0;
+	for (uint32_t i = 0; i < kObjectCount; ++i) {
+		const unsigned char* element = &strided[kStride * i];
+		if (std::memcmp(element, &packed[i], sizeof(TransformSystem::TransformationMatrix)) != 0) {
+			mismatchCount++;
+		}
+		for (size_t byte = sizeof(TransformSystem::TransformationMatrix); byte < kStride; ++byte) {
+			if (element[byte] != kFill) {
+				touchedCount++;
+			}
+		}
+	}
+	CHECK(mismatchCount == 0);
+	CHECK(touchedCount == 0);
+}
+
+// ThreadPoolで塊ごとに計算しても、1スレッドのときと同じ結果になる
+TEST_CASE(TransformSystemStridedOutputWithThreadPool) {
+	TransformSystem transforms;
+	AddObjects(transforms, kObjectCount);
+	Matrix4x4 viewProjection = MakeViewProjection();
+
+	std::vector<unsigned char> single(kStride * kObjectCount, 0);
+	transforms.Update(viewProjection, single.data(), kStride);
+
+	ThreadPool threadPool;
+	threadPool.Initialize(2);
+	std::vector<unsigned char> parallel(kStride * kObjectCount, 0);
+	transforms.Update(viewProjection, parallel.data(), kStride, &threadPool, 256);
+	threadPool.Finalize();
+
+	CHECK(single == parallel);
+}
@@ -0,0 +1,154 @@
+#include "TestFramework.h"
+#include "UploadRingAllocator.h"
+
+// 確保したオフセットがアライメントに揃い、前の確保と重ならない
+TEST_CASE(UploadRingAllocatorAlignsAllocations) {
+	UploadRingAllocator allocator;
+	allocator.Initialize(4096, 2);
+	CHECK(allocator.GetSliceSize() == 2048);
+
+	CHECK(allocator.Allocate(10) == 0);
+	CHECK(allocator.Allocate(10) == 256);
+
+	// 頂点用の16バイト境界なら定数バッファの直後に詰められる
+	CHECK(allocator.Allocate(100, UploadRingAllocator::kVertexAlignment) == 272);
+	CHECK(allocator.Allocate(4, 4) == 372);
+	CHECK(allocator.Allocate(1) == 512);
+	CHECK(allocator.GetFrameUsedBytes() == 513);
+	CHECK(allocator.GetFrameAllocationCount() == 5);
+}
+
+// スライスの大きさも定数バッファの境界に揃える
+TEST_CASE(UploadRingAllocatorAlignsSliceSize) {
+	UploadRingAllocator allocator;
+	allocator.Initialize(3 * 1000, 3);
+	CHECK(allocator.GetSliceSize() == 768);
+	CHECK(allocator.GetCapacity() == 3 * 768);
+}
+
+// フレームごとに次のスライスへ進み、最後まで行ったら先頭に戻る
+TEST_CASE(UploadRingAllocatorRotatesSlices) {
+	UploadRingAllocator allocator;
+	allocator.Initialize(3 * 1024, 3);
+
+	CHECK(allocator.GetCurrentFrame() == 0);
+	CHECK(allocator.Allocate(16) == 0);
+	allocator.EndFrame(1);
+
+	allocator.BeginFrame(0);
+	CHECK(allocator.GetCurrentFrame() == 1);
+	CHECK(allocator.Allocate(16) == 1024);
+	allocator.EndFrame(2);
+
+	allocator.BeginFrame(0);
+	CHECK(allocator.GetCurrentFrame() == 2);
+	CHECK(allocator.Allocate(16) == 2048);
+	allocator.EndFrame(3);
+
+	// 先頭のスライスは使い直すので、前の確保に関係なく先頭から詰める
+	allocator.BeginFrame(1);
+	CHECK(allocator.GetCurrentFrame() == 0);
+	CHECK(allocator.GetFrameUsedBytes() == 0);
+	CHECK(allocator.Allocate(16) == 0);
+}
+
+// 次に使うスライスを最後に使ったフレームのフェンス値が分かる
+TEST_CASE(UploadRingAllocatorRetiresSlicesByFence) {
+	UploadRingAllocator allocator;
+	allocator.Initialize(2 * 1024, 2);
+
+	// まだ使っていないスライスは待たなくてよい
+	CHECK(allocator.GetRequiredFenceValue() == 0);
+	allocator.EndFrame(5);
+	CHECK(allocator.GetRequiredFenceValue() == 0);
+
+	allocator.BeginFrame(0);
+	allocator.EndFrame(6);
+
+	// スライス0はフェンス値5が完了するまで使えない
+	CHECK(allocator.GetRequiredFenceValue() == 5);
+	allocator.BeginFrame(5);
+	CHECK(allocator.GetCurrentFrame() == 0);
+	allocator.EndFrame(7);
+
+	// 次はスライス1（フェンス値6）
+	CHECK(allocator.GetRequiredFenceValue() == 6);
+}
+
+// スライスに収まらない確保は失敗として数え、それまでの確保は残る
+TEST_CASE(UploadRingAllocatorFailsWhenSliceIsFull) {
+	UploadRingAllocator allocator;
+	allocator.Initialize(2 * 1024, 2);
+
+	CHECK(allocator.CanAllocate(1024));
+	CHECK(!allocator.CanAllocate(1025));
+	CHECK(allocator.Allocate(1000) == 0);
+	CHECK(!allocator.CanAllocate(16));
+	CHECK(allocator.Allocate(16) == UploadRingAllocator::kInvalidOffset);
+	CHECK(allocator.Allocate(24, 8) == 1000);
+	CHECK(allocator.GetFrameFailedAllocationCount() == 1);
+	CHECK(allocator.GetFailedAllocationCount() == 1);
+	CHECK(allocator.GetFrameUsedBytes() == 1024);
+
+	// フレームの失敗数だけ区切る
+	allocator.EndFrame(1);
+	allocator.BeginFrame(0);
+	CHECK(allocator.GetFrameFailedAllocationCount() == 0);
+	CHECK(allocator.GetFailedAllocationCount() == 1);
+}
+
+// 前のフレームの使用量と最大が残る
+TEST_CASE(UploadRingAllocatorKeepsFrameStatistics) {
+	UploadRingAllocator allocator;
+	allocator.Initialize(2 * 4096, 2);
+
+	allocator.Allocate(1000);
+	allocator.Allocate(1000);
+	allocator.EndFrame(1);
+	CHECK(allocator.GetLastFrameUsedBytes() == 2024);
+	CHECK(allocator.GetLastFrameAllocationCount() == 2);
+
+	allocator.BeginFrame(0);
+	allocator.Allocate(100);
+	allocator.EndFrame(2);
+	CHECK(allocator.GetLastFrameUsedBytes() == 100);
+	CHECK(allocator.GetLastFrameAllocationCount() == 1);
+	CHECK(allocator.GetPeakUsedBytes() == 2024);
+}
+
+// 足りなくなったら、このフレームの使用量と要求が収まる大きさまで倍々で大きくする
+TEST_CASE(UploadRingAllocatorGrowsToFitFrame) {
+	UploadRingAllocator allocator;
+	allocator.Initialize(2 * 1024, 2);
+	allocator.EndFrame(1);
+	allocator.BeginFrame(0);
+	allocator.EndFrame(2);
+	allocator.BeginFrame(1);
+	CHECK(allocator.GetCurrentFrame() == 0);
+	CHECK(allocator.GetRequiredFenceValue() == 2);
+
+	CHECK(allocator.Allocate(900) == 0);
+	CHECK(!allocator.CanAllocate(900));
+
+	// 900 + 900 + 256 が収まるのは1024の倍の倍
+	uint64_t capacity = allocator.CalculateGrownCapacity(900);
+	CHECK(capacity == 2 * 4096);
+
+	allocator.Grow(capacity);
+	CHECK(allocator.GetSliceSize() == 4096);
+	CHECK(allocator.GetGrowCount() == 1);
+
+	// 新しいバッファは誰も使っていないので待たなくてよく、今のフレームも先頭から詰める
+	CHECK(allocator.GetRequiredFenceValue() == 0);
+	CHECK(allocator.GetCurrentFrame() == 0);
+	CHECK(allocator.Allocate(900) == 0);
+	CHECK(allocator.Allocate(900) == 1024);
+	CHECK(allocator.GetFailedAllocationCount() == 0);
+
+	// 大きくした後も普通に回る
+	allocator.EndFrame(3);
+	CHECK(allocator.GetRequiredFenceValue() == 0);
+	allocator.BeginFrame(2);
+	CHECK(allocator.Allocate(16) == 4096);
+	CHECK(allocator.GetPeakUsedBytes() == 1924);
+}
@@ -0,0 +1,231 @@
+#include "TestFramework.h"
+#include "UtfConverter.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+	// 比べるための1文字ずつの符号化（UtfConverterとは別に書いたもの）
+	void AppendUtf8(std::string& text, char32_t codePoint) {
+		if (codePoint < 0x80) {
+			text += char(codePoint);
+		} else if (codePoint < 0x800) {
+			text += char(0xC0 | (codePoint >> 6));
+			text += char(0x80 | (codePoint & 0x3F));
+		} else if (codePoint < 0x10000) {
+			text += char(0xE0 | (codePoint >> 12));
+			text += char(0x80 | ((codePoint >> 6) & 0x3F));
+			text += char(0x80 | (codePoint & 0x3F));
+		} else {
+			text += char(0xF0 | (codePoint >> 18));
+			text += char(0x80 | ((codePoint >> 12) & 0x3F));
+			text += char(0x80 | ((codePoint >> 6) & 0x3F));
+			text += char(0x80 | (codePoint & 0x3F));
+		}
+	}
+
+	void AppendUtf16(std::u16string& text, char32_t codePoint) {
+		if (codePoint < 0x10000) {
+			text += char16_t(codePoint);
+		} else {
+			text += char16_t(0xD800 + ((codePoint - 0x10000) >> 10));
+			text += char16_t(0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+		}
+	}
+
+	// 上限の長さの出力先で変換する
+	std::u16string ToUtf16(const std::string& text, UtfConverter::Result* result = nullptr) {
+		std::u16string output(UtfConverter::GetMaxUtf16Length(text.size()), u'\0');
+		UtfConverter::Result converted = UtfConverter::Utf8ToUtf16(text.data(), text.size(), output.data(), output.size());
+		output.resize(converted.written);
+		if (result) {
+			*result = converted;
+		}
+		return output;
+	}
+
+	std::string ToUtf8(const std::u16string& text, UtfConverter::Result* result = nullptr) {
+		std::string output(UtfConverter::GetMaxUtf8Length(text.size()), '\0');
+		UtfConverter::Result converted = UtfConverter::Utf16ToUtf8(text.data(), text.size(), output.data(), output.size());
+		output.resize(converted.written);
+		if (result) {
+			*result = converted;
+		}
+		return output;
+	}
+
+	// バイト列から文字列を作る
+	std::string MakeBytes(std::initializer_list<uint8_t> bytes) {
+		return std::string(bytes.begin(), bytes.end());
+	}
+
+	// UTF-8をUTF-16にして、expectedと置き換えた数が一致するか
+	bool DecodesTo(const std::string& text, const std::u16string& expected, size_t expectedReplaced) {
+		UtfConverter::Result result = {};
+		std::u16string output = ToUtf16(text, &result);
+		return output == expected && result.replaced == expectedReplaced && result.isComplete && result.read == text.size();
+	}
+
+	const char16_t kFffd = u'\xFFFD';
+}
+
+// すべてのスカラー値が両方向で正しく変換され、元に戻る
+TEST_CASE(UtfConverterRoundTripsAllScalarValues) {
+	std::string utf8;
+	std::u16string utf16;
+	for (char32_t codePoint = 0; codePoint <= 0x10FFFF; ++codePoint) {
+		if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+			continue;
+		}
+		AppendUtf8(utf8, codePoint);
+		AppendUtf16(utf16, codePoint);
+	}
+
+	UtfConverter::Result result = {};
+	CHECK(ToUtf16(utf8, &result) == utf16);
+	CHECK(result.replaced == 0 && result.isComplete);
+	CHECK(ToUtf8(utf16, &result) == utf8);
+	CHECK(result.replaced == 0 && result.isComplete);
+}
+
+// 長すぎる表現は、最長の正しい部分ごとにU+FFFDにする
+TEST_CASE(UtfConverterReplacesOverlongForms) {
+	CHECK(DecodesTo(MakeBytes({ 0xC0, 0x80 }), { kFffd, kFffd }, 2));
+	CHECK(DecodesTo(MakeBytes({ 0xC1, 0xBF }), { kFffd, kFffd }, 2));
+	CHECK(DecodesTo(MakeBytes({ 0xE0, 0x80, 0x80 }), { kFffd, kFffd, kFffd }, 3));
+	CHECK(DecodesTo(MakeBytes({ 0xE0, 0x9F, 0xBF }), { kFffd, kFffd, kFffd }, 3));
+	CHECK(DecodesTo(MakeBytes({ 0xF0, 0x80, 0x80, 0x80 }), { kFffd, kFffd, kFffd, kFffd }, 4));
+	CHECK(DecodesTo(MakeBytes({ 0xF0, 0x8F, 0xBF, 0xBF }), { kFffd, kFffd, kFffd, kFffd }, 4));
+
+	// 一番短い表現の境目は正しい
+	CHECK(DecodesTo(MakeBytes({ 0xC2, 0x80 }), { u'\x80' }, 0));
+	CHECK(DecodesTo(MakeBytes({ 0xE0, 0xA0, 0x80 }), { u'\x800' }, 0));
+	CHECK(DecodesTo(MakeBytes({ 0xF0, 0x90, 0x80, 0x80 }), { 0xD800, 0xDC00 }, 0));
+}
+
+// サロゲートを符号化したUTF-8と、対になっていないUTF-16のサロゲート
+TEST_CASE(UtfConverterReplacesSurrogates) {
+	CHECK(DecodesTo(MakeBytes({ 0xED, 0xA0, 0x80 }), { kFffd, kFffd, kFffd }, 3));
+	CHECK(DecodesTo(MakeBytes({ 0xED, 0xBF, 0xBF }), { kFffd, kFffd, kFffd }, 3));
+	CHECK(DecodesTo(MakeBytes({ 0xED, 0x9F, 0xBF }), { u'\xD7FF' }, 0));
+	CHECK(DecodesTo(MakeBytes({ 0xEE, 0x80, 0x80 }), { u'\xE000' }, 0));
+
+	UtfConverter::Result result = {};
+	CHECK(ToUtf8({ 0xD800 }, &result) == "\xEF\xBF\xBD");
+	CHECK(result.replaced == 1);
+	CHECK(ToUtf8({ 0xDC00, u'A' }, &result) == "\xEF\xBF\xBD" "A");
+	CHECK(result.replaced == 1);
+	CHECK(ToUtf8({ 0xD800, u'A', 0xDBFF, 0xDFFF }, &result) == "\xEF\xBF\xBD" "A" "\xF4\x8F\xBF\xBF");
+	CHECK(result.replaced == 1);
+	CHECK(ToUtf8({ 0xDBFF, 0xDBFF, 0xDC00 }, &result) == "\xEF\xBF\xBD" "\xF4\x8F\xB0\x80");
+	CHECK(result.replaced == 1);
+}
+
+// U+10FFFFを超える値と、使われない先頭のバイト
+TEST_CASE(UtfConverterReplacesValuesAboveMaximum) {
+	CHECK(DecodesTo(MakeBytes({ 0xF4, 0x8F, 0xBF, 0xBF }), { 0xDBFF, 0xDFFF }, 0));
+	CHECK(DecodesTo(MakeBytes({ 0xF4, 0x90, 0x80, 0x80 }), { kFffd, kFffd, kFffd, kFffd }, 4));
+	CHECK(DecodesTo(MakeBytes({ 0xF5, 0x80, 0x80, 0x80 }), { kFffd, kFffd, kFffd, kFffd }, 4));
+	CHECK(DecodesTo(MakeBytes({ 0xF8, 0x88, 0x80, 0x80, 0x80 }), { kFffd, kFffd, kFffd, kFffd, kFffd }, 5));
+	CHECK(DecodesTo(MakeBytes({ 0xFE, 0xFF }), { kFffd, kFffd }, 2));
+}
+
+// 途中で切れた並びは、正しい部分までをまとめて一つのU+FFFDにする
+TEST_CASE(UtfConverterReplacesTruncatedSequences) {
+	CHECK(DecodesTo(MakeBytes({ 0xE3, 0x81 }), { kFffd }, 1));
+	CHECK(DecodesTo(MakeBytes({ 0xE3, 0x81, 0x41 }), { kFffd, u'A' }, 1));
+	CHECK(DecodesTo(MakeBytes({ 0xF0, 0x9F, 0x98 }), { kFffd }, 1));
+	CHECK(DecodesTo(MakeBytes({ 0xF0, 0x9F, 0x98, 0xE3, 0x81, 0x82 }), { kFffd, u'\x3042' }, 1));
+	CHECK(DecodesTo(MakeBytes({ 0x80, 0xBF }), { kFffd, kFffd }, 2));
+	CHECK(DecodesTo(MakeBytes({ 0xC2 }), { kFffd }, 1));
+}
+
+// UTF-8からの出力先が足りないときは、文字の区切りで止めて読んだ分を返す
+TEST_CASE(UtfConverterStopsAtUtf16Capacity) {
+	std::string text = "ab";
+	AppendUtf8(text, 0x1D11E);
+	text += "c";
+
+	char16_t output[8] = {};
+	UtfConverter::Result result = UtfConverter::Utf8ToUtf16(text.data(), text.size(), output, 3);
+	CHECK(!result.isComplete);
+	CHECK(result.read == 2 && result.written == 2);
+
+	result = UtfConverter::Utf8ToUtf16(text.data(), text.size(), output, 4);
+	CHECK(!result.isComplete);
+	CHECK(result.read == 6 && result.written == 4);
+	CHECK(output[2] == 0xD834 && output[3] == 0xDD1E);
+
+	result = UtfConverter::Utf8ToUtf16(text.data(), text.size(), output, 0);
+	CHECK(!result.isComplete && result.read == 0 && result.written == 0);
+
+	// 続きから変換すると同じ結果になる
+	result = UtfConverter::Utf8ToUtf16(text.data(), text.size(), output, 3);
+	UtfConverter::Result rest = UtfConverter::Utf8ToUtf16(text.data() + result.read, text.size() - result.read,
+		output + result.written, 8 - result.written);
+	CHECK(rest.isComplete);
+	CHECK(std::u16string(output, result.written + rest.written) == ToUtf16(text));
+}
+
+// UTF-16からの出力先が足りないときも、文字の区切りで止める
+TEST_CASE(UtfConverterStopsAtUtf8Capacity) {
+	std::u16string text = u"a\x3042";
+	AppendUtf16(text, 0x1F600);
+
+	char output[16] = {};
+	UtfConverter::Result result = UtfConverter::Utf16ToUtf8(text.data(), text.size(), output, 3);
+	CHECK(!result.isComplete);
+	CHECK(result.read == 1 && result.written == 1);
+
+	result = UtfConverter::Utf16ToUtf8(text.data(), text.size(), output, 7);
+	CHECK(!result.isComplete);
+	CHECK(result.read == 2 && result.written == 4);
+
+	result = UtfConverter::Utf16ToUtf8(text.data(), text.size(), output, 8);
+	CHECK(result.isComplete);
+	CHECK(result.read == 4 && result.written == 8);
+
+	// 上限の長さなら、対になっていないサロゲートばかりでも最後まで変換できる
+	std::u16string loneSurrogates(5, char16_t(0xDC00));
+	std::string utf8(UtfConverter::GetMaxUtf8Length(loneSurrogates.size()), '\0');
+	result = UtfConverter::Utf16ToUtf8(loneSurrogates.data(), loneSurrogates.size(), utf8.data(), utf8.size());
+	CHECK(result.isComplete && result.written == utf8.size() && result.replaced == 5);
+}
+
+// SSE2で16文字ずつ変換する部分と1文字ずつの部分の境目で、結果が変わらない
+TEST_CASE(UtfConverterHandlesSimdBoundaries) {
+	const char32_t codePoints[] = { 0xE9, 0x3042, 0x1F600 };
+	bool isMatched = true;
+	for (size_t length = 0; length <= 48; ++length) {
+		for (size_t position = 0; position <= length; ++position) {
+			for (char32_t codePoint : codePoints) {
+				// position文字目だけASCII以外にした文字列
+				std::string utf8;
+				std::u16string utf16;
+				for (size_t i = 0; i < length; ++i) {
+					char32_t c = i == position ? codePoint : char32_t('a' + i % 26);
+					AppendUtf8(utf8, c);
+					AppendUtf16(utf16, c);
+				}
+				isMatched = isMatched && ToUtf16(utf8) == utf16 && ToUtf8(utf16) == utf8;
+			}
+		}
+	}
+	CHECK(isMatched);
+
+	// ASCIIだけの文字列を、16の前後の出力先の大きさで止める
+	std::string ascii(40, 'x');
+	std::u16string wideAscii(40, u'x');
+	bool isStopped = true;
+	for (size_t capacity = 0; capacity <= 40; ++capacity) {
+		std::vector<char16_t> utf16(capacity + 1, u'#');
+		UtfConverter::Result toUtf16 = UtfConverter::Utf8ToUtf16(ascii.data(), ascii.size(), utf16.data(), capacity);
+		std::vector<char> utf8(capacity + 1, '#');
+		UtfConverter::Result toUtf8 = UtfConverter::Utf16ToUtf8(wideAscii.data(), wideAscii.size(), utf8.data(), capacity);
+		isStopped = isStopped && toUtf16.written == capacity && toUtf16.read == capacity && toUtf16.isComplete == (capacity == 40);
+		isStopped = isStopped && toUtf8.written == capacity && toUtf8.read == capacity && toUtf8.isComplete == (capacity == 40);
+		// 出力先の外には書かない
+		isStopped = isStopped && utf16[capacity] == u'#' && utf8[capacity] == '#';
+	}
+	CHECK(isStopped);
+}
@@ -0,0 +1,237 @@
+#include "TestFramework.h"
+#include "WaveFile.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+	// チャンクを並べてWAVファイルを作る
+	class WaveBuilder {
+	public:
+
+		// チャンクを足す（declaredSizeを指定すると、ヘッダのサイズだけその値にする）
+		WaveBuilder& AddChunk(const char* id, const std::vector<uint8_t>& body, uint32_t declaredSize = 0xFFFFFFFF) {
+			bytes.insert(bytes.end(), id, id + 4);
+			AppendUint32(declaredSize != 0xFFFFFFFF ? declaredSize : uint32_t(body.size()));
+			bytes.insert(bytes.end(), body.begin(), body.end());
+			// 奇数サイズのチャンクの後ろには1バイトの詰め物が入る
+			if (body.size() % 2 != 0) {
+				bytes.push_back(0xCD);
+			}
+			return *this;
+		}
+
+		// RIFFヘッダを付けたファイル（riffSizeを指定すると、RIFFのサイズだけその値にする）
+		std::vector<uint8_t> Build(uint32_t riffSize = 0xFFFFFFFF) const {
+			std::vector<uint8_t> file = { 'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A', 'V', 'E' };
+			uint32_t size = riffSize != 0xFFFFFFFF ? riffSize : uint32_t(bytes.size() + 4);
+			std::memcpy(file.data() + 4, &size, sizeof(size));
+			file.insert(file.end(), bytes.begin(), bytes.end());
+			return file;
+		}
+
+	private:
+		std::vector<uint8_t> bytes;
+
+		void AppendUint32(uint32_t value) {
+			for (int i = 0; i < 4; ++i) {
+				bytes.push_back(uint8_t(value >> (i * 8)));
+			}
+		}
+	};
+
+	// fmtチャンクの中身（sizeバイトまで）
+	std::vector<uint8_t> MakeFormatBody(uint16_t formatTag, uint16_t channelCount, uint32_t sampleRate, uint16_t bitsPerSample,
+		size_t size = 16) {
+		WaveFile::Format format = {};
+		format.formatTag = formatTag;
+		format.channelCount = channelCount;
+		format.sampleRate = sampleRate;
+		format.bitsPerSample = bitsPerSample;
+		format.blockAlign = uint16_t(channelCount * bitsPerSample / 8);
+		format.byteRate = sampleRate * format.blockAlign;
+		if (size >= 18) {
+			format.extraSize = uint16_t(size - 18);
+		}
+		const uint8_t* begin = reinterpret_cast<const uint8_t*>(&format);
+		return std::vector<uint8_t>(begin, begin + size);
+	}
+
+	// 16bitステレオ44.1kHzのfmt
+	std::vector<uint8_t> MakePcm16StereoFormat() {
+		return MakeFormatBody(WaveFile::kFormatPcm, 2, 44100, 16);
+	}
+
+	// メモリからとストリームからの両方で解析して、結果が同じか確かめる
+	bool ParseBoth(const std::vector<uint8_t>& file, WaveFile::Info& info) {
+		bool isParsed = WaveFile::Parse(file.data(), file.size(), info);
+
+		std::istringstream stream(std::string(file.begin(), file.end()), std::ios_base::binary);
+		WaveFile::Info streamInfo;
+		bool isRead = WaveFile::ReadHeader(stream, streamInfo);
+		CHECK(isParsed == isRead);
+		if (isParsed && isRead) {
+			CHECK(std::memcmp(&info.format, &streamInfo.format, sizeof(WaveFile::Format)) == 0);
+			CHECK(info.dataOffset == streamInfo.dataOffset);
+			CHECK(info.dataSize == streamInfo.dataSize);
+			CHECK(info.chunkCount == streamInfo.chunkCount);
+			CHECK(info.skippedChunks == streamInfo.skippedChunks);
+		}
+		return isParsed;
+	}
+}
+
+// リポジトリのfanfare.wav（PCM16ステレオ44.1kHz、fmtとdataだけ）
+TEST_CASE(WaveFileParsesFanfare) {
+	std::ifstream file("resources/fanfare.wav", std::ios_base::binary);
+	CHECK(file.is_open());
+	std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	CHECK(bytes.size() == 720432);
+
+	WaveFile::Info info;
+	CHECK(ParseBoth(bytes, info));
+	CHECK(info.GetSampleFormat() == WaveFile::kFormatPcm);
+	CHECK(info.format.channelCount == 2);
+	CHECK(info.format.sampleRate == 44100);
+	CHECK(info.format.bitsPerSample == 16);
+	CHECK(info.format.blockAlign == 4);
+	CHECK(info.dataOffset == 44);
+	CHECK(info.dataSize == 720388);
+	CHECK(info.GetFrameCount() == 180097);
+	CHECK(info.chunkCount == 2);
+	CHECK(info.skippedChunks == 0);
+}
+
+// JUNKやLISTは読み飛ばし、奇数サイズのチャンクの詰め物も飛ばす
+TEST_CASE(WaveFileSkipsUnknownAndOddChunks) {
+	std::vector<uint8_t> samples(40, 0x11);
+	std::vector<uint8_t> file = WaveBuilder()
+		.AddChunk("JUNK", std::vector<uint8_t>(28, 0))
+		.AddChunk("LIST", { 'I', 'N', 'F', 'O', 'a' })
+		.AddChunk("fmt ", MakePcm16StereoFormat())
+		.AddChunk("bext", std::vector<uint8_t>(3, 0))
+		.AddChunk("data", samples)
+		.Build();
+
+	WaveFile::Info info;
+	CHECK(ParseBoth(file, info));
+	CHECK(info.chunkCount == 5);
+	CHECK(info.skippedChunks == 3);
+	CHECK(info.dataSize == 40);
+	CHECK(info.dataOffset + info.dataSize == file.size());
+	CHECK(std::memcmp(file.data() + info.dataOffset, samples.data(), samples.size()) == 0);
+}
+
+// dataがfmtより先にあってもよく、両方見つかったら後ろは読まない
+TEST_CASE(WaveFileAcceptsDataBeforeFormat) {
+	std::vector<uint8_t> file = WaveBuilder()
+		.AddChunk("data", std::vector<uint8_t>(16, 0x22))
+		.AddChunk("fmt ", MakePcm16StereoFormat())
+		.AddChunk("LIST", std::vector<uint8_t>(8, 0))
+		.Build();
+
+	WaveFile::Info info;
+	CHECK(ParseBoth(file, info));
+	CHECK(info.dataOffset == 20);
+	CHECK(info.dataSize == 16);
+	CHECK(info.chunkCount == 2);
+	CHECK(info.format.sampleRate == 44100);
+}
+
+// 途中で切れたファイルは、dataを残っている分だけにしてblockAlignで切り捨てる
+TEST_CASE(WaveFileReadsTruncatedData) {
+	std::vector<uint8_t> file = WaveBuilder()
+		.AddChunk("fmt ", MakePcm16StereoFormat())
+		.AddChunk("data", std::vector<uint8_t>(4000, 0x33))
+		.Build();
+	file.erase(file.end() - (4000 - 103), file.end());
+
+	WaveFile::Info info;
+	CHECK(ParseBoth(file, info));
+	CHECK(info.dataSize == 100);
+
+	// 書きかけでRIFFのサイズが0や最大値のファイルも、ファイルの終わりまで読む
+	for (uint32_t riffSize : { 0u, 0xFFFFFFF0u }) {
+		std::vector<uint8_t> unfinished = WaveBuilder()
+			.AddChunk("fmt ", MakePcm16StereoFormat())
+			.AddChunk("data", std::vector<uint8_t>(64, 0x44))
+			.Build(riffSize);
+		CHECK(ParseBoth(unfinished, info));
+		CHECK(info.dataSize == 64);
+	}
+
+	// dataのヘッダまで切れていたら失敗
+	std::vector<uint8_t> headerOnly = WaveBuilder()
+		.AddChunk("fmt ", MakePcm16StereoFormat())
+		.Build();
+	headerOnly.insert(headerOnly.end(), { 'd', 'a', 't' });
+	CHECK(!ParseBoth(headerOnly, info));
+}
+
+// 波形の半端なバイトは使わない
+TEST_CASE(WaveFileTrimsPartialFrames) {
+	std::vector<uint8_t> file = WaveBuilder()
+		.AddChunk("fmt ", MakePcm16StereoFormat())
+		.AddChunk("data", std::vector<uint8_t>(41, 0x55))
+		.Build();
+
+	WaveFile::Info info;
+	CHECK(ParseBoth(file, info));
+	CHECK(info.dataSize == 40);
+	CHECK(info.GetFrameCount() == 10);
+}
+
+// 拡張形式はsubFormatの先頭2バイトが本当の形式
+TEST_CASE(WaveFileReadsExtensibleFormat) {
+	std::vector<uint8_t> formatBody = MakeFormatBody(WaveFile::kFormatExtensible, 2, 48000, 32, 40);
+	formatBody[24] = uint8_t(WaveFile::kFormatFloat);
+	std::vector<uint8_t> file = WaveBuilder()
+		.AddChunk("fmt ", formatBody)
+		.AddChunk("data", std::vector<uint8_t>(80, 0))
+		.Build();
+
+	WaveFile::Info info;
+	CHECK(ParseBoth(file, info));
+	CHECK(info.format.formatTag == WaveFile::kFormatExtensible);
+	CHECK(info.GetSampleFormat() == WaveFile::kFormatFloat);
+	CHECK(info.format.extraSize == 22);
+	CHECK(info.GetFrameCount() == 10);
+
+	// 拡張部分が無い拡張形式は形式が分からないので失敗
+	std::vector<uint8_t> shortFile = WaveBuilder()
+		.AddChunk("fmt ", MakeFormatBody(WaveFile::kFormatExtensible, 2, 48000, 32, 18))
+		.AddChunk("data", std::vector<uint8_t>(80, 0))
+		.Build();
+	CHECK(!ParseBoth(shortFile, info));
+}
+
+// WAVでないものや、fmt・dataが足りないものは失敗
+TEST_CASE(WaveFileRejectsInvalidFiles) {
+	WaveFile::Info info;
+
+	std::vector<uint8_t> notRiff = WaveBuilder().AddChunk("fmt ", MakePcm16StereoFormat()).Build();
+	notRiff[0] = 'X';
+	CHECK(!ParseBoth(notRiff, info));
+
+	std::vector<uint8_t> tooShort = { 'R', 'I', 'F', 'F' };
+	CHECK(!ParseBoth(tooShort, info));
+
+	CHECK(!ParseBoth(WaveBuilder().AddChunk("fmt ", MakePcm16StereoFormat()).Build(), info));
+	CHECK(!ParseBoth(WaveBuilder().AddChunk("data", std::vector<uint8_t>(8, 0)).Build(), info));
+
+	// 16バイトに足りないfmt
+	CHECK(!ParseBoth(WaveBuilder()
+		.AddChunk("fmt ", std::vector<uint8_t>(14, 0))
+		.AddChunk("data", std::vector<uint8_t>(8, 0))
+		.Build(), info));
+
+	// チャンネル数が0
+	CHECK(!ParseBoth(WaveBuilder()
+		.AddChunk("fmt ", MakeFormatBody(WaveFile::kFormatPcm, 0, 44100, 16))
+		.AddChunk("data", std::vector<uint8_t>(8, 0))
+		.Build(), info));
+}
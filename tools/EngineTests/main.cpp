@@ -0,0 +1,8 @@
+#include "TestFramework.h"
+
+// 引数を渡すと、名前にその文字列を含むテストだけを実行する
+// リソースを読むテストがあるので、リポジトリの直下で実行する
+int main(int argc, char* argv[]) {
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+	return Test::RunAll(filter) == 0 ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+#include <Windows.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "MeshFile.h"
+#include "StringUtility.h"
+#include "ThreadPool.h"
+
+// Objを頂点をまとめて並べ替えたバイナリのメッシュ（.mesh）に焼くツール
+// 使い方 : MeshCooker [--force] [フォルダかファイル...]（省略時はresources）
+// 出力は入力と同じ場所に拡張子を.meshにして書き出す
+// 入力（Objと同じフォルダのMtl）の中身のハッシュを.mesh.hashに残しておき、変わっていなければ焼き直さない
+
+namespace {
+
+	// 処理を変えたら上げる（古い.meshを焼き直させる）
+	const uint64_t kCookerVersion = 2;
+
+	// FNV-1a 64bit
+	uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// ファイルの中身をハッシュに混ぜる
+	bool HashFile(const std::filesystem::path& path, uint64_t& hash) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		hash = HashBytes(bytes.data(), bytes.size(), hash);
+		return true;
+	}
+
+	// 入力のObjと、同じフォルダのMtl（どれを参照しているかは読むまで分からないので全部）からハッシュを作る
+	bool MakeContentHash(const std::filesystem::path& sourcePath, uint64_t& hash) {
+		hash = HashBytes(&kCookerVersion, sizeof(kCookerVersion));
+		uint32_t fileVersion = MeshFile::kVersion;
+		hash = HashBytes(&fileVersion, sizeof(fileVersion), hash);
+		if (!HashFile(sourcePath, hash)) {
+			return false;
+		}
+		std::vector<std::filesystem::path> materialPaths;
+		for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(sourcePath.parent_path())) {
+			if (entry.is_regular_file() && entry.path().extension() == ".mtl") {
+				materialPaths.push_back(entry.path());
+			}
+		}
+		std::sort(materialPaths.begin(), materialPaths.end());
+		for (const std::filesystem::path& materialPath : materialPaths) {
+			HashFile(materialPath, hash);
+		}
+		return true;
+	}
+
+	// 前回焼いたときのハッシュを読む
+	bool ReadHashFile(const std::filesystem::path& hashPath, uint64_t& hash) {
+		std::ifstream file(hashPath);
+		if (!file) {
+			return false;
+		}
+		file >> std::hex >> hash;
+		return !file.fail();
+	}
+
+	// 焼いたときのハッシュを書く
+	void WriteHashFile(const std::filesystem::path& hashPath, uint64_t hash) {
+		std::ofstream file(hashPath, std::ios::trunc);
+		file << std::hex << hash << std::endl;
+	}
+
+	// 焼いた結果
+	enum class CookResult {
+		kCooked,
+		kUpToDate,
+		kFailed,
+	};
+
+	// 一つ焼く
+	CookResult CookMesh(const std::filesystem::path& sourcePath, bool force, ThreadPool* threadPool) {
+		std::filesystem::path meshPath = sourcePath;
+		meshPath.replace_extension(".mesh");
+		std::filesystem::path hashPath = meshPath;
+		hashPath += ".hash";
+
+		// 中身が変わっていなければ何もしない
+		uint64_t hash = 0;
+		if (!MakeContentHash(sourcePath, hash)) {
+			std::printf("failed to read %s\n", sourcePath.string().c_str());
+			return CookResult::kFailed;
+		}
+		uint64_t cookedHash = 0;
+		if (!force && std::filesystem::exists(meshPath) &&
+			ReadHashFile(hashPath, cookedHash) && cookedHash == hash) {
+			return CookResult::kUpToDate;
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		// ランタイムと同じくフォルダとファイル名に分けて渡す（Mtlとテクスチャのパスはフォルダからの相対）
+		// エンジンは文字列のパスをUTF-8として読むので、ANSIのコードページのgeneric_stringは使わない
+		std::string directoryPath = StringUtility::ConvertPathToString(sourcePath.parent_path());
+		std::string filename = StringUtility::ConvertPathToString(sourcePath.filename());
+		if (!MeshFile::CookObjFile(directoryPath, filename, threadPool)) {
+			std::printf("failed to write %s\n", meshPath.string().c_str());
+			return CookResult::kFailed;
+		}
+		WriteHashFile(hashPath, hash);
+
+		// 書いたものを開き直して確かめる
+		MeshFile meshFile;
+		if (!meshFile.Open(StringUtility::ConvertPathToString(meshPath))) {
+			std::printf("failed to verify %s\n", meshPath.string().c_str());
+			return CookResult::kFailed;
+		}
+		const MeshFile::Header& header = meshFile.GetHeader();
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		std::printf("cooked %s : %u vertices, %u indices (%u-bit), %u submeshes, %llu KiB -> %llu KiB, %.1f ms\n",
+			meshPath.string().c_str(), header.vertexCount, header.indexCount, header.indexStride * 8, header.submeshCount,
+			static_cast<unsigned long long>(std::filesystem::file_size(sourcePath) / 1024),
+			static_cast<unsigned long long>(std::filesystem::file_size(meshPath) / 1024),
+			std::chrono::duration<double, std::milli>(end - start).count());
+		return CookResult::kCooked;
+	}
+
+	// 焼く対象のObjを集める（フォルダは中を再帰的に見る）
+	void CollectSources(const std::filesystem::path& path, std::vector<std::filesystem::path>& sources) {
+		if (std::filesystem::is_directory(path)) {
+			for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(path)) {
+				if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+					sources.push_back(entry.path());
+				}
+			}
+		} else if (std::filesystem::exists(path)) {
+			sources.push_back(path);
+		}
+	}
+}
+
+int wmain(int argc, wchar_t* argv[]) {
+
+	// 引数の解析
+	bool force = false;
+	std::vector<std::filesystem::path> inputs;
+	for (int i = 1; i < argc; ++i) {
+		std::wstring argument = argv[i];
+		if (argument == L"--force") {
+			force = true;
+		} else {
+			inputs.push_back(argument);
+		}
+	}
+	if (inputs.empty()) {
+		inputs.push_back(L"resources");
+	}
+
+	std::vector<std::filesystem::path> sources;
+	for (const std::filesystem::path& input : inputs) {
+		CollectSources(input, sources);
+	}
+
+	// 大きなObjは塊ごとに並行で読む
+	ThreadPool threadPool;
+	threadPool.Initialize(ThreadPool::GetDefaultThreadCount());
+
+	uint32_t cookedCount = 0;
+	uint32_t upToDateCount = 0;
+	uint32_t failedCount = 0;
+	for (const std::filesystem::path& source : sources) {
+		switch (CookMesh(source, force, &threadPool)) {
+		case CookResult::kCooked: cookedCount++; break;
+		case CookResult::kUpToDate: upToDateCount++; break;
+		case CookResult::kFailed: failedCount++; break;
+		}
+	}
+	std::printf("%u cooked, %u up-to-date, %u failed\n", cookedCount, upToDateCount, failedCount);
+	return failedCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+#include <Windows.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "SoundBank.h"
+#include "StringUtility.h"
+
+// WAVをまとめてサウンドバンク（.sbank）に焼くツール
+// 使い方 : SoundBankCooker [--force] [-o 出力] [フォルダかファイル...]（省略時はresourcesをresources/sounds.sbankに）
+// バンクの中の名前はフォルダからの相対パス（区切りは/）、ファイルを直接渡したときはファイル名
+// 入力の名前と中身のハッシュを出力.hashに残しておき、変わっていなければ焼き直さない
+
+namespace {
+
+	// 処理を変えたら上げる（古い.sbankを焼き直させる）
+	const uint64_t kCookerVersion = 1;
+
+	// FNV-1a 64bit
+	uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// ファイルの中身をハッシュに混ぜる
+	bool HashFile(const std::filesystem::path& path, uint64_t& hash) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		hash = HashBytes(bytes.data(), bytes.size(), hash);
+		return true;
+	}
+
+	// 全部の入力の名前と中身からハッシュを作る（入力は名前順に並んでいる）
+	bool MakeContentHash(const std::vector<SoundBank::SourceFile>& sources, uint64_t& hash) {
+		hash = HashBytes(&kCookerVersion, sizeof(kCookerVersion));
+		uint32_t fileVersion = SoundBank::kVersion;
+		hash = HashBytes(&fileVersion, sizeof(fileVersion), hash);
+		for (const SoundBank::SourceFile& source : sources) {
+			hash = HashBytes(source.name.data(), source.name.size() + 1, hash);
+			if (!HashFile(StringUtility::ConvertToPath(source.filePath), hash)) {
+				std::printf("failed to read %s\n", source.filePath.c_str());
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// 前回焼いたときのハッシュを読む
+	bool ReadHashFile(const std::filesystem::path& hashPath, uint64_t& hash) {
+		std::ifstream file(hashPath);
+		if (!file) {
+			return false;
+		}
+		file >> std::hex >> hash;
+		return !file.fail();
+	}
+
+	// 焼いたときのハッシュを書く
+	void WriteHashFile(const std::filesystem::path& hashPath, uint64_t hash) {
+		std::ofstream file(hashPath, std::ios::trunc);
+		file << std::hex << hash << std::endl;
+	}
+
+	// まとめるWAVを集める（フォルダは中を再帰的に見る）
+	void CollectSources(const std::filesystem::path& path, std::vector<SoundBank::SourceFile>& sources) {
+		if (std::filesystem::is_directory(path)) {
+			for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(path)) {
+				if (entry.is_regular_file() && entry.path().extension() == ".wav") {
+					sources.push_back({ StringUtility::ConvertPathToString(entry.path().lexically_relative(path)), StringUtility::ConvertPathToString(entry.path()) });
+				}
+			}
+		} else if (std::filesystem::exists(path)) {
+			sources.push_back({ StringUtility::ConvertPathToString(path.filename()), StringUtility::ConvertPathToString(path) });
+		}
+	}
+}
+
+int wmain(int argc, wchar_t* argv[]) {
+
+	// 引数の解析
+	bool force = false;
+	std::filesystem::path outputPath = L"resources/sounds.sbank";
+	std::vector<std::filesystem::path> inputs;
+	for (int i = 1; i < argc; ++i) {
+		std::wstring argument = argv[i];
+		if (argument == L"--force") {
+			force = true;
+		} else if (argument == L"-o" && i + 1 < argc) {
+			outputPath = argv[++i];
+		} else {
+			inputs.push_back(argument);
+		}
+	}
+	if (inputs.empty()) {
+		inputs.push_back(L"resources");
+	}
+
+	std::vector<SoundBank::SourceFile> sources;
+	for (const std::filesystem::path& input : inputs) {
+		CollectSources(input, sources);
+	}
+
+	// 集めた順に左右されないように名前順にする
+	std::sort(sources.begin(), sources.end(), [](const SoundBank::SourceFile& a, const SoundBank::SourceFile& b) {
+		return a.name < b.name;
+		});
+
+	// 中身が変わっていなければ何もしない
+	std::filesystem::path hashPath = outputPath;
+	hashPath += ".hash";
+	uint64_t hash = 0;
+	if (!MakeContentHash(sources, hash)) {
+		return 1;
+	}
+	uint64_t cookedHash = 0;
+	if (!force && std::filesystem::exists(outputPath) &&
+		ReadHashFile(hashPath, cookedHash) && cookedHash == hash) {
+		std::printf("%s is up-to-date (%zu sounds)\n", outputPath.string().c_str(), sources.size());
+		return 0;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (!SoundBank::Build(StringUtility::ConvertPathToString(outputPath), sources)) {
+		std::printf("failed to write %s (unreadable wav or duplicate name)\n", outputPath.string().c_str());
+		return 1;
+	}
+	WriteHashFile(hashPath, hash);
+
+	// 書いたものを開き直して確かめる
+	SoundBank soundBank;
+	if (!soundBank.Open(StringUtility::ConvertPathToString(outputPath))) {
+		std::printf("failed to verify %s\n", outputPath.string().c_str());
+		return 1;
+	}
+	uint64_t sourceBytes = 0;
+	for (const SoundBank::SourceFile& source : sources) {
+		sourceBytes += std::filesystem::file_size(StringUtility::ConvertToPath(source.filePath));
+	}
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	std::printf("cooked %s : %u sounds, %llu KiB -> %llu KiB, %.1f ms\n",
+		outputPath.string().c_str(), soundBank.GetSoundCount(),
+		static_cast<unsigned long long>(sourceBytes / 1024),
+		static_cast<unsigned long long>(soundBank.GetFileSize() / 1024),
+		std::chrono::duration<double, std::milli>(end - start).count());
+	return 0;
+}
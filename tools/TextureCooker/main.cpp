@@ -0,0 +1,204 @@
+#include <Windows.h>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "DirectXTex/DirectXTex.h"
+
+// PNGをミップマップ入りのブロック圧縮DDSに焼くツール
+// 使い方 : TextureCooker [--bc1] [--force] [フォルダかファイル...]（省略時はresources）
+// 出力は入力と同じ場所に拡張子を.ddsにして書き出す（TextureManagerはそちらを優先して読む）
+// 入力の中身と設定のハッシュを.dds.hashに残しておき、変わっていなければ焼き直さない
+
+namespace {
+
+	// 出力の形式や処理を変えたら上げる（古いDDSを焼き直させる）
+	const uint64_t kCookerVersion = 1;
+
+	// 焼き方の設定
+	struct CookSettings {
+		bool useBC1 = false; // アルファを使わないテクスチャ向け（BC7の半分のサイズ）
+		bool force = false;  // ハッシュが一致していても焼き直す
+	};
+
+	// FNV-1a 64bit
+	uint64_t HashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i) {
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// 入力ファイルの中身と設定からハッシュを作る
+	bool MakeContentHash(const std::filesystem::path& sourcePath, const CookSettings& settings, uint64_t& hash) {
+		std::ifstream file(sourcePath, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		hash = HashBytes(bytes.data(), bytes.size());
+		hash = HashBytes(&kCookerVersion, sizeof(kCookerVersion), hash);
+		uint8_t format = settings.useBC1 ? 1 : 0;
+		hash = HashBytes(&format, sizeof(format), hash);
+		return true;
+	}
+
+	// 前回焼いたときのハッシュを読む
+	bool ReadHashFile(const std::filesystem::path& hashPath, uint64_t& hash) {
+		std::ifstream file(hashPath);
+		if (!file) {
+			return false;
+		}
+		file >> std::hex >> hash;
+		return !file.fail();
+	}
+
+	// 焼いたときのハッシュを書く
+	void WriteHashFile(const std::filesystem::path& hashPath, uint64_t hash) {
+		std::ofstream file(hashPath, std::ios::trunc);
+		file << std::hex << hash << std::endl;
+	}
+
+	// 焼いた結果
+	enum class CookResult {
+		kCooked,
+		kUpToDate,
+		kFailed,
+	};
+
+	// 一枚焼く
+	CookResult CookTexture(const std::filesystem::path& sourcePath, const CookSettings& settings) {
+		std::filesystem::path ddsPath = sourcePath;
+		ddsPath.replace_extension(".dds");
+		std::filesystem::path hashPath = ddsPath;
+		hashPath += ".hash";
+
+		// 中身が変わっていなければ何もしない
+		uint64_t hash = 0;
+		if (!MakeContentHash(sourcePath, settings, hash)) {
+			std::printf("failed to read %s\n", sourcePath.string().c_str());
+			return CookResult::kFailed;
+		}
+		uint64_t cookedHash = 0;
+		if (!settings.force && std::filesystem::exists(ddsPath) &&
+			ReadHashFile(hashPath, cookedHash) && cookedHash == hash) {
+			return CookResult::kUpToDate;
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		// ランタイムと同じ読み方・同じフィルタでミップマップを作る
+		DirectX::ScratchImage image{};
+		HRESULT hr = DirectX::LoadFromWICFile(sourcePath.c_str(), DirectX::WIC_FLAGS_NONE, nullptr, image);
+		if (FAILED(hr)) {
+			std::printf("failed to load %s (0x%08lx)\n", sourcePath.string().c_str(), hr);
+			return CookResult::kFailed;
+		}
+		DirectX::ScratchImage mipImage{};
+		hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImage);
+		if (FAILED(hr)) {
+			std::printf("failed to generate mips %s (0x%08lx)\n", sourcePath.string().c_str(), hr);
+			return CookResult::kFailed;
+		}
+
+		// ブロック圧縮はトップの幅と高さが4の倍数でないとD3D12でリソースを作れないので、そのときは非圧縮のまま書く
+		const DirectX::TexMetadata& metadata = mipImage.GetMetadata();
+		DirectX::ScratchImage compressedImage{};
+		const DirectX::ScratchImage* outputImage = &mipImage;
+		if (metadata.width % 4 == 0 && metadata.height % 4 == 0) {
+			// WICで読んだときと同じ色空間（UNORM）のまま圧縮する
+			DXGI_FORMAT format = settings.useBC1 ? DXGI_FORMAT_BC1_UNORM : DXGI_FORMAT_BC7_UNORM;
+			hr = DirectX::Compress(mipImage.GetImages(), mipImage.GetImageCount(), metadata,
+				format, DirectX::TEX_COMPRESS_PARALLEL, DirectX::TEX_THRESHOLD_DEFAULT, compressedImage);
+			if (FAILED(hr)) {
+				std::printf("failed to compress %s (0x%08lx)\n", sourcePath.string().c_str(), hr);
+				return CookResult::kFailed;
+			}
+			outputImage = &compressedImage;
+		} else {
+			std::printf("%s is not a multiple of 4, writing uncompressed\n", sourcePath.string().c_str());
+		}
+
+		hr = DirectX::SaveToDDSFile(outputImage->GetImages(), outputImage->GetImageCount(), outputImage->GetMetadata(),
+			DirectX::DDS_FLAGS_NONE, ddsPath.c_str());
+		if (FAILED(hr)) {
+			std::printf("failed to save %s (0x%08lx)\n", ddsPath.string().c_str(), hr);
+			return CookResult::kFailed;
+		}
+		WriteHashFile(hashPath, hash);
+
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		std::printf("cooked %s : %zux%zu mips %zu, %llu KiB -> %llu KiB, %.1f ms\n",
+			ddsPath.string().c_str(), metadata.width, metadata.height, metadata.mipLevels,
+			static_cast<unsigned long long>(mipImage.GetPixelsSize() / 1024),
+			static_cast<unsigned long long>(outputImage->GetPixelsSize() / 1024),
+			std::chrono::duration<double, std::milli>(end - start).count());
+		return CookResult::kCooked;
+	}
+
+	// 焼く対象のPNGを集める（フォルダは中を再帰的に見る）
+	void CollectSources(const std::filesystem::path& path, std::vector<std::filesystem::path>& sources) {
+		if (std::filesystem::is_directory(path)) {
+			for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(path)) {
+				if (entry.is_regular_file() && entry.path().extension() == ".png") {
+					sources.push_back(entry.path());
+				}
+			}
+		} else if (std::filesystem::exists(path)) {
+			sources.push_back(path);
+		}
+	}
+}
+
+int wmain(int argc, wchar_t* argv[]) {
+
+	// 引数の解析
+	CookSettings settings;
+	std::vector<std::filesystem::path> inputs;
+	for (int i = 1; i < argc; ++i) {
+		std::wstring argument = argv[i];
+		if (argument == L"--bc1") {
+			settings.useBC1 = true;
+		} else if (argument == L"--force") {
+			settings.force = true;
+		} else {
+			inputs.push_back(argument);
+		}
+	}
+	if (inputs.empty()) {
+		inputs.push_back(L"resources");
+	}
+
+	std::vector<std::filesystem::path> sources;
+	for (const std::filesystem::path& input : inputs) {
+		CollectSources(input, sources);
+	}
+
+	// WICを使うのでCOMを初期化
+	HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+	if (FAILED(hr)) {
+		return 1;
+	}
+
+	uint32_t cookedCount = 0;
+	uint32_t upToDateCount = 0;
+	uint32_t failedCount = 0;
+	for (const std::filesystem::path& source : sources) {
+		switch (CookTexture(source, settings)) {
+		case CookResult::kCooked: cookedCount++; break;
+		case CookResult::kUpToDate: upToDateCount++; break;
+		case CookResult::kFailed: failedCount++; break;
+		}
+	}
+	std::printf("%u cooked, %u up-to-date, %u failed\n", cookedCount, upToDateCount, failedCount);
+
+	CoUninitialize();
+	return failedCount == 0 ? 0 : 1;
+}